@@ -10,15 +10,28 @@
 ///
 /// NOTE: 
 ///   - BLE beacon names must match exactly with those hardcoded below.
+///   - Compact beacons advertise a binary artifact ID in manufacturer data instead
+///     of the name; IDs must match the artifact_id provisioned on each beacon
+///     (tools/beacon_nvs.py, compiled default in main.cpp).
+///   - Beacons built with CONFIG_BEACON_TELEMETRY append supply voltage, uptime
+///     and reset reason after the artifact ID; they are logged, never shown.
 ///   - Artifact story content must be hosted and accessible via Android browser.
+///   - On Linux (gallery kiosks) advertisements are read by the native scanner
+///     engine linked into the runner (native/, linux/runner/scanner_channel.cc);
+///     only matched artifacts reach Dart, through the 'cham_story/scanner'
+///     event channel.
 
 library;
 
 import 'dart:async';
+import 'dart:io' show Platform;
+import 'dart:typed_data';
 import 'package:flutter/material.dart';
+import 'package:flutter/services.dart';                              // For the native scanner event channel (Linux)
 import 'package:flutter_reactive_ble/flutter_reactive_ble.dart';     // For passive BLE scanning
 import 'package:url_launcher/url_launcher.dart';                     // For launching web stories in default browser
 import 'package:permission_handler/permission_handler.dart' as perm; // For requesting runtime Android permissions
+import 'native_matcher.dart';                                        // Perfect-hash artifact matcher via dart:ffi
 
 void main() {
   runApp(const MyApp()); // Start Flutter UI wrapper (minimal)
@@ -40,13 +53,29 @@ class _MyAppState extends State<MyApp> {
     'Tara_Bodhisattva_Statue': 'https://www.youtube.com', // Replace with production URL e.g., 'https://museum.vn/tara'
   };
 
+  /// 🔢 Compact Artifact IDs
+  /// Binary artifact ID carried in manufacturer data (company ID 0xFFFF,
+  /// format version 1) mapped to the artifact name used above
+  static const beaconIdToName = {
+    0x0001: 'TraKieu_Apsara_Relief',
+    0x0002: 'Tara_Bodhisattva_Statue',
+  };
+
   final Map<String, DateTime> _lastLaunchTimes = {};      // Used to suppress rapid repeat launches per device
   final Duration _cooldown = const Duration(seconds: 30); // Cooldown duration to prevent spamming (adjustable per field testing)
 
-  late StreamSubscription<DiscoveredDevice> _scanSubscription; // Active subscription to BLE scanning stream
-  final FlutterReactiveBle _ble = FlutterReactiveBle();        // BLE plugin instance
+  StreamSubscription<Object?>? _scanSubscription; // Active subscription to BLE scanning stream
+  Timer? _scanDutyTimer; // Flushes quiet batch windows, asks for scan mode changes (null: fixed lowLatency)
+  ScanMode? _requestedScanMode; // Latest mode asked of _scanWith
+  bool _scanRestarting = false; // A restart is awaiting the old scan's cancel
+  final FlutterReactiveBle _ble = FlutterReactiveBle(); // BLE plugin instance (Android/iOS)
+
+  /// Native scanner engine in the Linux runner: matched artifacts only
+  static const _nativeScanner = EventChannel('cham_story/scanner');
+
+  String? _nearestArtifact; // Artifact the visitor stands at (proximity engine decision; shown in the UI)
 
-  String? _lastDetectedDeviceName; // Cache of last valid artifact name detected (used for display + logic filtering)
+  NativeMatcher? _matcher; // Native matcher (null: library not built for this platform, match in Dart)
 
   @override
   void initState() {
@@ -54,10 +83,67 @@ class _MyAppState extends State<MyApp> {
     _startScanning(); // Initiate BLE scan on app startup
   }
 
+  /// 🔎 Decode the compact artifact ID from manufacturer data
+  /// Layout: company ID (2, LE) | version << 4 | ID length | ID (2–4, LE) | flags
+  /// Returns null for any advertisement that is not a compact artifact beacon
+  static int? _compactArtifactId(Uint8List data) {
+    if (data.length < 6 || data[0] != 0xFF || data[1] != 0xFF) return null;
+    final version = data[2] >> 4;
+    final idLen = data[2] & 0x0F;
+    if (version != 1 || idLen < 2 || idLen > 4 || data.length < 3 + idLen + 1) return null;
+    var id = 0;
+    for (var i = 0; i < idLen; i++) {
+      id |= data[3 + i] << (8 * i);
+    }
+    return id;
+  }
+
+  /// 🔋 Decode the optional supply/health telemetry that follows the flags byte
+  /// Layout: supply (25 mV steps) | uptime minutes (2, LE) | reset reason | health << 4
+  /// Returns null when the beacon does not advertise telemetry (flag bit 0 clear)
+  static String? _compactTelemetry(Uint8List data) {
+    if (data.length < 6) return null;
+    final idLen = data[2] & 0x0F;
+    final flagsAt = 3 + idLen;
+    if (data.length < flagsAt + 1 + 4 || (data[flagsAt] & 0x01) == 0) return null;
+    final t = flagsAt + 1;
+    final supplyMv = data[t] * 25;
+    final uptimeMin = data[t + 1] | (data[t + 2] << 8);
+    final reset = data[t + 3] & 0x0F;
+    final health = data[t + 3] >> 4;
+    final low = (health & 0x1) != 0 ? ' LOW SUPPLY' : '';
+    return 'supply ${supplyMv}mV, up ${uptimeMin}min, reset $reset, health 0x${health.toRadixString(16)}$low';
+  }
+
+  /// Artifact name for an advertisement when matching in Dart (no native
+  /// library): compact ID first, then the local name
+  String? _artifactName(DiscoveredDevice device) {
+    final id = _compactArtifactId(device.manufacturerData);
+    if (id != null) return beaconIdToName[id];
+    if (device.name.isNotEmpty && beaconToUrl.containsKey(device.name)) return device.name;
+    return null;
+  }
+
+  /// Artifact table handed to the native scanner: every compact ID with its
+  /// name, plus name-only beacons (ID 0)
+  static List<Map<String, Object>> _nativeArtifacts() {
+    final artifacts = [
+      for (final e in beaconIdToName.entries) {'id': e.key, 'name': e.value},
+    ];
+    for (final name in beaconToUrl.keys) {
+      if (!beaconIdToName.containsValue(name)) artifacts.add({'id': 0, 'name': name});
+    }
+    return artifacts;
+  }
+
   /// 📶 Start scanning for advertising BLE packets (broadcasted by ESP32)
   /// Matches device names against known Cham artifact beacons
   void _startScanning() async {
     print('Starting BLE scan...');
+    if (Platform.isLinux) {
+      _startNativeScanning();
+      return;
+    }
     try {
       // Request runtime permissions required for BLE scanning on Android
       var loc = await perm.Permission.location.request();
@@ -68,40 +154,159 @@ class _MyAppState extends State<MyApp> {
       // Catch and report if permission plugin fails (rare case)
       print('WARNING: permission_handler not available or failed: $e');
     }
+    if (!mounted) return; // Disposed while the permission dialogs were up
 
-    // Begin scanning for all advertising devices with high frequency (lowLatency scan mode)
-    _scanSubscription = _ble.scanForDevices(withServices: [], scanMode: ScanMode.lowLatency).listen((device) {
-      print('Device: ${device.id} Name: ${device.name}');
-      
-      // Only proceed if device name is non-empty and recognized in our mapping dictionary
-      if (device.name.isNotEmpty && beaconToUrl.containsKey(device.name)) {
-        setState(() {
-          _lastDetectedDeviceName = device.name;
-        });
-
-        final now = DateTime.now();
-        final lastLaunch = _lastLaunchTimes[device.name];
-
-        // Launch storytelling URL if cooldown has expired or first-time detection
-        if (lastLaunch == null || now.difference(lastLaunch) > _cooldown) {
-          _lastLaunchTimes[device.name] = now;
-          print('MATCHED: ${device.name} - launching URL after delay');
-
-          // Add 2-second delay to avoid race condition from rapid multiple matches
-          Future.delayed(const Duration(seconds: 2), () {
-            if (_lastDetectedDeviceName == device.name) {
-              _launchUrl(beaconToUrl[device.name]!);
-            }
-          });
-        } else {
-          print('MATCHED: ${device.name} - cooldown active, not launching');
-        }
-      }
+    _matcher = NativeMatcher.open(beaconIdToName, beaconToUrl.keys);
+
+    if (_matcher == null) {
+      // Matching in Dart: scan at high frequency (lowLatency scan mode) throughout
+      _scanWith(ScanMode.lowLatency);
+      return;
+    }
+    // Native duty cycle: low power until an artifact is heard, lowLatency
+    // while one is near and through the cooldown after a story opens
+    _scanWith(ScanMode.lowPower);
+    _scanDutyTimer = Timer.periodic(const Duration(milliseconds: 250), (_) => _onDutyTick());
+  }
+
+  /// Android scan modes by native scan_mode_t number
+  static const _scanModes = [ScanMode.lowPower, ScanMode.balanced, ScanMode.lowLatency];
+
+  /// (Re)start the BLE scan in `mode`; the native matcher keeps Android's
+  /// limit of five scan starts per 30 seconds. Restarts run one at a time:
+  /// a request made while one is in progress only updates the mode it ends in
+  Future<void> _scanWith(ScanMode mode) async {
+    _requestedScanMode = mode;
+    if (_scanRestarting) return;
+    _scanRestarting = true;
+    try {
+      ScanMode next;
+      do {
+        next = _requestedScanMode!;
+        final previous = _scanSubscription;
+        _scanSubscription = null;
+        await previous?.cancel();
+        // Disposed (or duty cycle stopped) while cancelling: start nothing
+        if (!mounted || (_scanDutyTimer != null && !_scanDutyTimer!.isActive)) return;
+      } while (next != _requestedScanMode);
+      print('BLE scan mode: ${next.name}');
+      _scanSubscription = _ble.scanForDevices(withServices: [], scanMode: next).listen(_onDevice, onError: (e) {
+        print('BLE scan error: $e'); // Handle BLE scan failure silently
+      });
+    } finally {
+      _scanRestarting = false;
+    }
+  }
+
+  /// ⏱️ Duty timer: deliver a batch window that closed with nothing heard
+  /// after it (the last beacon walked out of range), then the scan mode
+  void _onDutyTick() {
+    final matcher = _matcher;
+    if (matcher != null && matcher.tick()) {
+      final batch = matcher.flush();
+      if (batch != null) _onBatch(batch);
+    }
+    _checkScanMode();
+  }
+
+  /// Restart the scan when the native duty cycle wants another mode
+  void _checkScanMode() {
+    final mode = _matcher?.scanModeChange();
+    if (mode != null) _scanWith(_scanModes[mode]);
+  }
+
+  /// 📡 One advertisement from the BLE scan (any device)
+  void _onDevice(DiscoveredDevice device) {
+    final matcher = _matcher;
+    if (matcher == null) {
+      // Only proceed if the advertisement carries a known artifact (compact ID or name)
+      final artifact = _artifactName(device);
+      if (artifact != null) _onLastHeard(artifact, device.manufacturerData);
+      return;
+    }
+    // Batched natively: the UI only hears decisions and new telemetry
+    if (matcher.report(device.manufacturerData, device.name, device.rssi)) {
+      final batch = matcher.flush();
+      if (batch != null) _onBatch(batch);
+      _checkScanMode();
+    }
+  }
+
+  /// 🖥️ Linux kiosk: the runner's native engine reads the adapter (or a
+  /// recorded capture), batches what it matched and sends only decisions
+  /// and new telemetry
+  void _startNativeScanning() {
+    _scanSubscription = _nativeScanner.receiveBroadcastStream(_nativeArtifacts()).listen((event) {
+      final batch = event as Map<Object?, Object?>;
+      _onBatch(ScanBatch(batch['nearest'] as String?, {
+        for (final beacon in (batch['beacons'] as List<Object?>).cast<Map<Object?, Object?>>())
+          beacon['artifact'] as String: beacon['manufacturerData'] as Uint8List,
+      }));
     }, onError: (e) {
-      print('BLE scan error: $e'); // Handle BLE scan failure silently
+      print('BLE scan error: $e'); // No adapter, missing capabilities or unreadable capture
+    }, onDone: () {
+      print('BLE scan replay finished');
     });
   }
 
+  /// 📦 A scan batch: beacon telemetry the app has not seen, then the decision
+  void _onBatch(ScanBatch batch) {
+    batch.manufacturerData.forEach(_onArtifact);
+    _onNearest(batch.nearest);
+  }
+
+  /// 🎯 A known artifact was heard (manufacturerData empty for name-mode beacons)
+  void _onArtifact(String artifact, Uint8List manufacturerData) {
+    // Staff diagnostics only: visitors never see beacon health
+    final telemetry = _compactTelemetry(manufacturerData);
+    if (telemetry != null) print('Beacon health: $artifact $telemetry');
+  }
+
+  /// 📍 The proximity engine's decision after a report: launch as soon as it
+  /// settles on a new artifact (no fixed wait; adjacent cases are told apart
+  /// by smoothed RSSI, not by whichever beacon was heard last)
+  void _onNearest(String? nearest) {
+    if (nearest == _nearestArtifact) return;
+    setState(() {
+      _nearestArtifact = nearest;
+    });
+    if (nearest != null) _launchWithCooldown(nearest);
+  }
+
+  /// Fallback without the native library: launch if the artifact is still
+  /// the last one heard 2 seconds later
+  void _onLastHeard(String artifact, Uint8List manufacturerData) {
+    _onArtifact(artifact, manufacturerData);
+    if (artifact != _nearestArtifact) {
+      setState(() {
+        _nearestArtifact = artifact;
+      });
+    }
+    if (!_cooldownExpired(artifact)) return;
+    _lastLaunchTimes[artifact] = DateTime.now();
+    print('MATCHED: $artifact - launching URL after delay');
+    Future.delayed(const Duration(seconds: 2), () {
+      if (_nearestArtifact == artifact) _launchUrl(beaconToUrl[artifact]!);
+    });
+  }
+
+  bool _cooldownExpired(String artifact) {
+    final lastLaunch = _lastLaunchTimes[artifact];
+    return lastLaunch == null || DateTime.now().difference(lastLaunch) > _cooldown;
+  }
+
+  /// Launch storytelling URL if cooldown has expired or first-time detection
+  void _launchWithCooldown(String artifact) {
+    if (!_cooldownExpired(artifact)) {
+      print('NEAREST: $artifact - cooldown active, not launching');
+      return;
+    }
+    _lastLaunchTimes[artifact] = DateTime.now();
+    print('NEAREST: $artifact - launching URL');
+    _matcher?.launched();
+    _launchUrl(beaconToUrl[artifact]!);
+  }
+
   /// 🌐 Launch associated artifact story in external browser
   /// Ensures non-intrusive, respectful delivery aligned with museum experience
   Future<void> _launchUrl(String url) async {
@@ -118,8 +323,10 @@ class _MyAppState extends State<MyApp> {
 
   @override
   void dispose() {
-    _scanSubscription.cancel(); // Stop BLE scan when widget is destroyed
-    _ble.deinitialize(); // Deinit BLE engine safely
+    _scanDutyTimer?.cancel();
+    _scanSubscription?.cancel(); // Stop BLE scan when widget is destroyed
+    if (!Platform.isLinux) _ble.deinitialize(); // Deinit BLE engine safely
+    _matcher?.dispose();
     super.dispose();
   }
 
@@ -128,8 +335,8 @@ class _MyAppState extends State<MyApp> {
   @override
   Widget build(BuildContext context) {
     String displayText;
-    if (_lastDetectedDeviceName != null) {
-      final artifactName = _lastDetectedDeviceName!.replaceAll('_', ' '); // Improve readability for end users
+    if (_nearestArtifact != null) {
+      final artifactName = _nearestArtifact!.replaceAll('_', ' '); // Improve readability for end users
       displayText = 'Opening $artifactName Artifact Story...';
     } else {
       displayText = 'Scanning for BLE beacons...';
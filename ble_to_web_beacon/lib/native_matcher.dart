@@ -0,0 +1,183 @@
+/// COS10025 BLE-to-Web Cultural Storytelling System
+/// dart:ffi binding of the native artifact matcher (native/include/scan_ffi.h)
+///
+///   - The advertisement's manufacturer data and name are written into the
+///     matcher's own buffer (mapped once as a Uint8List) and matched there
+///     through perfect hashes: no Map lookup on strings, no allocation per
+///     advertisement
+///   - [report] hands every advertisement to the native batcher; [flush]
+///     returns a [ScanBatch] only when the proximity engine's decision
+///     changed or a beacon's telemetry is new, so the UI is not woken per
+///     advertisement; [tick] catches windows that close with nothing heard
+///   - [scanModeChange] says when to restart the scan in another mode:
+///     low power with no artifact around, low latency while one is near or
+///     a story just opened (native/include/scan_duty.h)
+///   - Built on Android as libcham_scan_ffi.so (android/app/build.gradle.kts);
+///     where the library is missing [NativeMatcher.open] returns null and the
+///     app keeps matching in Dart
+
+library;
+
+import 'dart:ffi';
+import 'dart:io' show Platform;
+import 'dart:typed_data';
+
+typedef _NewC = Pointer<Void> Function();
+typedef _FreeC = Void Function(Pointer<Void>);
+typedef _FreeDart = void Function(Pointer<Void>);
+typedef _BufferC = Pointer<Uint8> Function(Pointer<Void>);
+typedef _AddC = Int32 Function(Pointer<Void>, Uint32, Int32);
+typedef _AddDart = int Function(Pointer<Void>, int, int);
+typedef _MatchFieldsC = Int32 Function(Pointer<Void>, Int32, Int32);
+typedef _MatchFieldsDart = int Function(Pointer<Void>, int, int);
+typedef _ReportC = Int32 Function(Pointer<Void>, Int32, Int32, Int32, Int64);
+typedef _ReportDart = int Function(Pointer<Void>, int, int, int, int);
+typedef _FlushC = Int32 Function(Pointer<Void>, Int64);
+typedef _FlushDart = int Function(Pointer<Void>, int);
+typedef _LaunchedC = Void Function(Pointer<Void>, Int64);
+typedef _LaunchedDart = void Function(Pointer<Void>, int);
+
+/// 📦 What a scan batch tells the app: the artifact the visitor is nearest to
+/// (null: none yet) and manufacturer data of beacons not seen in that form
+class ScanBatch {
+  final String? nearest;
+  final Map<String, Uint8List> manufacturerData; // Artifact → data
+  const ScanBatch(this.nearest, this.manufacturerData);
+}
+
+class NativeMatcher {
+  static const _bufferSize = 64; // CHAM_MATCHER_BUFFER
+  static const _reportFlush = 2; // CHAM_REPORT_FLUSH
+
+  final Pointer<Void> _handle;
+  final Uint8List _buffer;
+  final _FreeDart _free;
+  final _MatchFieldsDart _matchFields;
+  final _ReportDart _report;
+  final _FlushDart _flush;
+  final _LaunchedDart _launched;
+  final _FlushDart _scanMode; // Same signature as flush
+  final _FlushDart _tick; // Same signature as flush
+  final List<String> _names; // Artifact index → name, in registration order
+  final Stopwatch _clock = Stopwatch()..start(); // Monotonic time for the batcher
+
+  NativeMatcher._(this._handle, this._buffer, this._free, this._matchFields, this._report, this._flush, this._launched,
+      this._scanMode, this._tick, this._names);
+
+  /// Load the library and register the app's artifacts (ID → name; names
+  /// without an ID are registered with ID 0 for name-mode beacons)
+  static NativeMatcher? open(Map<int, String> idToName, Iterable<String> names) {
+    // Every symbol is resolved before anything is created: a stale library
+    // missing one throws ArgumentError here and the app falls back to Dart
+    final _NewC create;
+    final _BufferC bufferOf;
+    final _FreeDart clear, free;
+    final _AddDart add;
+    final _MatchFieldsDart matchFields;
+    final _ReportDart report;
+    final _FlushDart flush, scanMode, tick;
+    final _LaunchedDart launched;
+    try {
+      final lib = Platform.isIOS || Platform.isMacOS
+          ? DynamicLibrary.process()
+          : DynamicLibrary.open(Platform.isWindows ? 'cham_scan_ffi.dll' : 'libcham_scan_ffi.so');
+      create = lib.lookupFunction<_NewC, _NewC>('cham_matcher_new');
+      bufferOf = lib.lookupFunction<_BufferC, _BufferC>('cham_matcher_buffer');
+      clear = lib.lookupFunction<_FreeC, _FreeDart>('cham_matcher_clear');
+      add = lib.lookupFunction<_AddC, _AddDart>('cham_matcher_add');
+      free = lib.lookupFunction<_FreeC, _FreeDart>('cham_matcher_free');
+      matchFields = lib.lookupFunction<_MatchFieldsC, _MatchFieldsDart>('cham_matcher_match_fields');
+      report = lib.lookupFunction<_ReportC, _ReportDart>('cham_matcher_report');
+      flush = lib.lookupFunction<_FlushC, _FlushDart>('cham_matcher_flush');
+      launched = lib.lookupFunction<_LaunchedC, _LaunchedDart>('cham_matcher_launched');
+      scanMode = lib.lookupFunction<_FlushC, _FlushDart>('cham_matcher_scan_mode');
+      tick = lib.lookupFunction<_FlushC, _FlushDart>('cham_matcher_tick');
+    } on ArgumentError catch (e) {
+      print('Native matcher not available ($e), matching in Dart');
+      return null;
+    }
+
+    final handle = create();
+    final buffer = bufferOf(handle).asTypedList(_bufferSize);
+    final matcher = NativeMatcher._(handle, buffer, free, matchFields, report, flush, launched, scanMode, tick, []);
+
+    clear(handle);
+    final entries = [
+      for (final e in idToName.entries) MapEntry(e.key, e.value),
+      for (final name in names)
+        if (!idToName.containsValue(name)) MapEntry(0, name),
+    ];
+    for (final e in entries) {
+      final len = matcher._put(0, e.value);
+      if (len <= 0 || add(handle, e.key, len) < 0) {
+        print('Native matcher rejected artifact ${e.value}, matching in Dart');
+        matcher.dispose();
+        return null;
+      }
+      matcher._names.add(e.value);
+    }
+    return matcher;
+  }
+
+  /// Artifact name for an advertisement's manufacturer data and name, or null
+  String? match(Uint8List manufacturerData, String name) {
+    final (mfrLen, nameLen) = _putFields(manufacturerData, name);
+    final index = _matchFields(_handle, mfrLen, nameLen);
+    return index >= 0 ? _names[index] : null;
+  }
+
+  /// Hand one advertisement (any device) to the batcher; true when [flush]
+  /// is due (window over, or the nearest artifact changed)
+  bool report(Uint8List manufacturerData, String name, int rssi) {
+    final (mfrLen, nameLen) = _putFields(manufacturerData, name);
+    return _report(_handle, mfrLen, nameLen, rssi, _clock.elapsedMicroseconds) == _reportFlush;
+  }
+
+  /// Timer tick while nothing may be heard: true when [flush] is due (the
+  /// window is over, or the decision changed as beacons went silent)
+  bool tick() => _tick(_handle, _clock.elapsedMicroseconds) == _reportFlush;
+
+  /// Close the batch window; null when there is nothing new for the app
+  ScanBatch? flush() {
+    final n = _flush(_handle, _clock.elapsedMicroseconds);
+    if (n == 0) return null;
+    final data = <String, Uint8List>{};
+    for (var i = 1; i + 2 <= n; i += 2 + _buffer[i + 1]) {
+      data[_names[_buffer[i]]] = _buffer.sublist(i + 2, i + 2 + _buffer[i + 1]);
+    }
+    return ScanBatch(_buffer[0] == 0 ? null : _names[_buffer[0] - 1], data);
+  }
+
+  /// A story opened: scanning stays in low latency through the cooldown
+  void launched() => _launched(_handle, _clock.elapsedMicroseconds);
+
+  /// Android scan mode number to restart the scan in (0 low power,
+  /// 1 balanced, 2 low latency), or null to keep scanning as it is; the
+  /// scan starts in low power when the matcher opens
+  int? scanModeChange() {
+    final mode = _scanMode(_handle, _clock.elapsedMicroseconds);
+    return mode >= 0 ? mode : null;
+  }
+
+  void dispose() => _free(_handle);
+
+  /// Manufacturer data then name into the buffer; their lengths
+  (int, int) _putFields(Uint8List manufacturerData, String name) {
+    final mfrLen = manufacturerData.length <= _bufferSize ? manufacturerData.length : 0;
+    _buffer.setRange(0, mfrLen, manufacturerData);
+    final nameLen = _put(mfrLen, name);
+    return (mfrLen, nameLen < 0 ? 0 : nameLen);
+  }
+
+  /// Write an ASCII name into the buffer at `at`; -1 if it cannot be an
+  /// artifact name (non-ASCII or too long), so it is not matched by name
+  int _put(int at, String name) {
+    if (at + name.length > _bufferSize) return -1;
+    for (var i = 0; i < name.length; i++) {
+      final unit = name.codeUnitAt(i);
+      if (unit > 0x7F) return -1;
+      _buffer[at + i] = unit;
+    }
+    return name.length;
+  }
+}
@@ -0,0 +1,261 @@
+#include "scanner_channel.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <atomic>
+
+#include "scan_batch.h"
+#include "scan_hci.h"
+#include "scan_replay.h"
+
+static constexpr char kChannelName[] = "cham_story/scanner";
+static constexpr uint32_t kBatchWindowUs = 250000;
+
+struct ScannerChannel {
+  FlEventChannel* channel;
+  scan_engine_t engine;
+  scan_hci_t hci;
+  scan_replay_t replay;
+  // Only the reader thread touches it while the engine runs.
+  scan_batch_t batch;
+  bool replaying;
+  bool listening;
+  // Bumped on every listen/cancel; events queued for an older stream are dropped.
+  std::atomic<guint> generation;
+};
+
+// One batch the app has to hear about, copied off the reader thread.
+struct BatchEvent {
+  ScannerChannel* scanner;
+  guint generation;
+  int nearest;
+  uint8_t count;
+  scan_batch_beacon_t beacons[SCAN_BATCH_BEACONS];
+};
+
+struct ExitEvent {
+  ScannerChannel* scanner;
+  guint generation;
+  scan_err_t err;
+};
+
+static ScannerChannel* scanner = nullptr;
+
+static FlValue* artifact_name(ScannerChannel* self, int artifact) {
+  return artifact >= 0
+             ? fl_value_new_string(self->engine.artifacts.items[artifact].name)
+             : fl_value_new_null();
+}
+
+// Runs on the GTK main thread: platform channels are not thread-safe.
+static gboolean send_batch(gpointer data) {
+  BatchEvent* ev = static_cast<BatchEvent*>(data);
+  ScannerChannel* self = ev->scanner;
+  if (!self->listening || ev->generation != self->generation) {
+    return G_SOURCE_REMOVE;
+  }
+
+  g_autoptr(FlValue) beacons = fl_value_new_list();
+  for (uint8_t i = 0; i < ev->count; i++) {
+    const scan_batch_beacon_t* b = &ev->beacons[i];
+    g_autofree gchar* address = g_strdup_printf(
+        "%02X:%02X:%02X:%02X:%02X:%02X", b->addr[5], b->addr[4], b->addr[3],
+        b->addr[2], b->addr[1], b->addr[0]);
+    FlValue* beacon = fl_value_new_map();
+    fl_value_set_string_take(beacon, "artifact",
+                             artifact_name(self, b->artifact));
+    fl_value_set_string_take(beacon, "reports", fl_value_new_int(b->reports));
+    fl_value_set_string_take(
+        beacon, "rssi",
+        fl_value_new_int(b->reports ? b->rssi_sum / b->reports : 0));
+    fl_value_set_string_take(beacon, "address", fl_value_new_string(address));
+    fl_value_set_string_take(beacon, "manufacturerData",
+                             fl_value_new_uint8_list(b->mfr, b->mfr_len));
+    fl_value_append_take(beacons, beacon);
+  }
+  g_autoptr(FlValue) event = fl_value_new_map();
+  fl_value_set_string_take(event, "nearest", artifact_name(self, ev->nearest));
+  fl_value_set_string(event, "beacons", beacons);
+
+  g_autoptr(GError) error = nullptr;
+  if (!fl_event_channel_send(self->channel, event, nullptr, &error)) {
+    g_warning("Failed to send scan event: %s", error->message);
+  }
+  return G_SOURCE_REMOVE;
+}
+
+static gboolean send_exit(gpointer data) {
+  ExitEvent* ev = static_cast<ExitEvent*>(data);
+  ScannerChannel* self = ev->scanner;
+  if (!self->listening || ev->generation != self->generation) {
+    return G_SOURCE_REMOVE;
+  }
+
+  scan_engine_stop(&self->engine);
+  if (self->replaying) {
+    scan_replay_close(&self->replay);
+  }
+  self->listening = false;
+
+  g_autoptr(GError) error = nullptr;
+  if (ev->err == SCAN_ERR_END) {
+    g_message("Scan replay finished: %lu reports, %lu matched, %lu sent",
+              (unsigned long)self->engine.stats.reports,
+              (unsigned long)self->engine.stats.matched,
+              (unsigned long)self->batch.stats.notifications);
+    fl_event_channel_send_end_of_stream(self->channel, nullptr, &error);
+  } else {
+    fl_event_channel_send_error(self->channel, "scan_failed",
+                                scan_err_name(ev->err), nullptr, nullptr,
+                                &error);
+  }
+  return G_SOURCE_REMOVE;
+}
+
+// Reader thread callbacks.
+static void on_match(void* arg, const scan_match_t* match) {
+  ScannerChannel* self = static_cast<ScannerChannel*>(arg);
+  if (!scan_batch_add(&self->batch, match)) {
+    return;
+  }
+  scan_batch_notice_t notice;
+  if (!scan_batch_flush(&self->batch, match->ts_us, &notice)) {
+    return;
+  }
+
+  BatchEvent* ev = g_new0(BatchEvent, 1);
+  ev->scanner = self;
+  ev->generation = self->generation;
+  ev->nearest = notice.nearest;
+  ev->count = notice.changed;
+  for (uint8_t i = 0; i < notice.changed; i++) {
+    ev->beacons[i] = *notice.beacons[i];
+    scan_batch_sent(&self->batch, notice.beacons[i]);
+  }
+  g_main_context_invoke_full(nullptr, G_PRIORITY_DEFAULT, send_batch, ev,
+                             g_free);
+}
+
+static void on_exit(void* arg, scan_err_t err) {
+  ScannerChannel* self = static_cast<ScannerChannel*>(arg);
+  ExitEvent* ev = g_new0(ExitEvent, 1);
+  ev->scanner = self;
+  ev->generation = self->generation;
+  ev->err = err;
+  g_main_context_invoke_full(nullptr, G_PRIORITY_DEFAULT, send_exit, ev,
+                             g_free);
+}
+
+static void stop_scanning(ScannerChannel* self) {
+  self->generation++;
+  if (!self->listening) {
+    return;
+  }
+  scan_engine_stop(&self->engine);
+  if (self->replaying) {
+    scan_replay_close(&self->replay);
+  }
+  self->listening = false;
+}
+
+// Artifact table from the listen arguments: [{"id": int, "name": String}].
+static bool parse_artifacts(FlValue* args, scan_artifacts_t* artifacts) {
+  scan_artifacts_init(artifacts);
+  if (args == nullptr || fl_value_get_type(args) != FL_VALUE_TYPE_LIST) {
+    return false;
+  }
+  for (size_t i = 0; i < fl_value_get_length(args); i++) {
+    FlValue* entry = fl_value_get_list_value(args, i);
+    if (fl_value_get_type(entry) != FL_VALUE_TYPE_MAP) {
+      return false;
+    }
+    FlValue* id = fl_value_lookup_string(entry, "id");
+    FlValue* name = fl_value_lookup_string(entry, "name");
+    if (id == nullptr || name == nullptr ||
+        fl_value_get_type(id) != FL_VALUE_TYPE_INT ||
+        fl_value_get_type(name) != FL_VALUE_TYPE_STRING ||
+        scan_artifacts_add(artifacts,
+                           static_cast<uint32_t>(fl_value_get_int(id)),
+                           fl_value_get_string(name)) < 0) {
+      return false;
+    }
+  }
+  return artifacts->count > 0;
+}
+
+static FlMethodErrorResponse* listen_cb(FlEventChannel* channel, FlValue* args,
+                                        gpointer user_data) {
+  ScannerChannel* self = static_cast<ScannerChannel*>(user_data);
+  stop_scanning(self);
+
+  scan_artifacts_t artifacts;
+  if (!parse_artifacts(args, &artifacts)) {
+    return fl_method_error_response_new(
+        "bad_artifacts", "expected [{id: int, name: String}]", nullptr);
+  }
+
+  // Replay a capture if one is configured, otherwise the live adapter.
+  const gchar* replay_path = g_getenv("CHAM_SCAN_REPLAY");
+  scan_backend_t backend;
+  self->replaying = replay_path != nullptr && replay_path[0] != '\0';
+  if (self->replaying) {
+    const gchar* speed = g_getenv("CHAM_SCAN_REPLAY_SPEED");
+    scan_err_t err = scan_replay_open(&self->replay, replay_path,
+                                      speed ? g_ascii_strtod(speed, nullptr) : 1.0);
+    if (err != SCAN_OK) {
+      return fl_method_error_response_new("scan_unavailable",
+                                          scan_err_name(err), nullptr);
+    }
+    backend = scan_replay_backend(&self->replay);
+    g_message("Replaying BLE scan from %s", replay_path);
+  } else {
+    const gchar* dev = g_getenv("CHAM_SCAN_HCI");
+    scan_hci_init(&self->hci, dev ? atoi(dev) : 0);
+    backend = scan_hci_backend(&self->hci);
+  }
+
+  scan_prox_config_t proximity = scan_proximity_defaults(SCAN_PROX_KALMAN);
+  scan_batch_init(&self->batch, kBatchWindowUs, &proximity);
+  scan_engine_init(&self->engine, backend, &artifacts, on_match, on_exit,
+                   self);
+  scan_err_t err = scan_engine_start(&self->engine);
+  if (err != SCAN_OK) {
+    if (self->replaying) {
+      scan_replay_close(&self->replay);
+    }
+    return fl_method_error_response_new("scan_unavailable", scan_err_name(err),
+                                        nullptr);
+  }
+  if (!self->replaying && !self->hci.scan_owned) {
+    g_message("hci%d: scan parameters refused, listening to the running scan",
+              self->hci.dev);
+  }
+  self->listening = true;
+  return nullptr;
+}
+
+static FlMethodErrorResponse* cancel_cb(FlEventChannel* channel, FlValue* args,
+                                        gpointer user_data) {
+  stop_scanning(static_cast<ScannerChannel*>(user_data));
+  return nullptr;
+}
+
+static void view_destroyed(GtkWidget* widget, gpointer user_data) {
+  stop_scanning(static_cast<ScannerChannel*>(user_data));
+}
+
+void scanner_channel_register(FlView* view) {
+  if (scanner == nullptr) {
+    scanner = new ScannerChannel();
+  }
+  FlBinaryMessenger* messenger =
+      fl_engine_get_binary_messenger(fl_view_get_engine(view));
+  g_autoptr(FlStandardMethodCodec) codec = fl_standard_method_codec_new();
+  g_clear_object(&scanner->channel);
+  scanner->channel =
+      fl_event_channel_new(messenger, kChannelName, FL_METHOD_CODEC(codec));
+  fl_event_channel_set_stream_handlers(scanner->channel, listen_cb, cancel_cb,
+                                       scanner, nullptr);
+  g_signal_connect(view, "destroy", G_CALLBACK(view_destroyed), scanner);
+}
@@ -0,0 +1,24 @@
+#ifndef RUNNER_SCANNER_CHANNEL_H_
+#define RUNNER_SCANNER_CHANNEL_H_
+
+#include <flutter_linux/flutter_linux.h>
+
+// Event channel "cham_story/scanner" backed by the native scanner engine
+// (native/include/scan_engine.h).
+//
+// Listening with the artifact table as argument, a list of
+// {"id": int, "name": String} maps, starts the engine. Matched
+// advertisements are batched on the reader thread (native/include/
+// scan_batch.h, 250 ms windows) and an event reaches Dart only when the
+// proximity engine's decision changes or a beacon's manufacturer data is new
+// to the app: {"nearest": String?, "beacons": [{"artifact": String,
+// "reports": int, "rssi": int (window mean), "address": String,
+// "manufacturerData": Uint8List}]}, "beacons" listing only those with new
+// manufacturer data. Unrelated advertisements never leave the reader thread.
+//
+// Source: the adapter CHAM_SCAN_HCI (index, default 0) through a raw HCI
+// socket, or the btsnoop capture CHAM_SCAN_REPLAY played back at
+// CHAM_SCAN_REPLAY_SPEED (default 1, 0 = as fast as possible).
+void scanner_channel_register(FlView* view);
+
+#endif  // RUNNER_SCANNER_CHANNEL_H_
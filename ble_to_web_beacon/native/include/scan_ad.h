@@ -0,0 +1,119 @@
+/*
+COS10025 BLE-to-Web Cultural Storytelling System
+Advertising-data walk and artifact matching for the native scanner.
+- Works in place on the AD bytes of an advertising report: nothing is copied,
+  views point into the caller's buffer and are valid as long as it is
+- Only two AD types can identify an artifact: the compact manufacturer data
+  (beacon_payload.h) and the Complete/Shortened Local Name of name-mode
+  beacons. Every other AD structure is skipped after reading its length byte
+- The artifact table is fixed-size and filled once from the app's mapping.
+  IDs and names are looked up through perfect hashes (scan_phash.h): a
+  compact payload costs three byte compares, an ID decode and one probe; a
+  name is hashed only if some artifact name has its length
+- Table building is constexpr, so the built-in catalogue (scan_catalog.h) is
+  hashed at compile time
+*/
+
+#pragma once
+
+#include "beacon_payload.h"
+#include "scan_phash.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Error codes of the native scanner
+typedef enum {
+    SCAN_OK = 0,
+    SCAN_ERR_FAIL,          // Generic failure (socket or controller error)
+    SCAN_ERR_INVALID_ARG,   // Bad parameter (e.g. name longer than an AD can carry)
+    SCAN_ERR_NO_PERMISSION, // Raw HCI needs CAP_NET_RAW (and CAP_NET_ADMIN to scan)
+    SCAN_ERR_FORMAT,        // Capture file is not btsnoop H4 or monitor
+    SCAN_ERR_END,           // Replay reached the end of the capture
+    SCAN_ERR_NOT_SUPPORTED, // Backend not available on this platform
+} scan_err_t;
+
+const char* scan_err_name(scan_err_t err);
+
+#define SCAN_AD_TYPE_SHORT_NAME 0x08
+#define SCAN_NAME_MAX           (BEACON_ADV_PAYLOAD_MAX - 2) // One AD holding only the name
+#define SCAN_ARTIFACTS_MAX      32
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Artifact table (the app's beaconIdToName / beaconToUrl)
+typedef struct {
+    uint32_t id;       // Compact artifact ID, 0 = name-mode beacon only
+    uint8_t  name_len;
+    char     name[SCAN_NAME_MAX + 1];
+} scan_artifact_t;
+
+typedef struct {
+    scan_artifact_t items[SCAN_ARTIFACTS_MAX];
+    uint8_t  count;
+    uint32_t name_lens; // Bit n set: some artifact name is n bytes long (cheap reject)
+    bool     hashed;    // Hashes below are valid (false: linear search, never seen in practice)
+    scan_phash_t ids;   // Artifact ID → index
+    scan_phash_t names; // FNV-1a of the name → index
+} scan_artifacts_t;
+
+constexpr void scan_artifacts_init(scan_artifacts_t* t) {
+    *t = scan_artifacts_t{};
+}
+
+// Rebuild both hashes from the items
+constexpr bool scan_artifacts_rehash(scan_artifacts_t* t) {
+    uint32_t ids[SCAN_ARTIFACTS_MAX] = {};
+    uint8_t id_values[SCAN_ARTIFACTS_MAX] = {};
+    uint32_t names[SCAN_ARTIFACTS_MAX] = {};
+    uint8_t name_values[SCAN_ARTIFACTS_MAX] = {};
+    size_t n_ids = 0;
+    for (uint8_t i = 0; i < t->count; i++) {
+        const scan_artifact_t& a = t->items[i];
+        uint8_t bytes[SCAN_NAME_MAX] = {};
+        for (uint8_t b = 0; b < a.name_len; b++) bytes[b] = static_cast<uint8_t>(a.name[b]);
+        names[i] = scan_fnv1a(bytes, a.name_len);
+        name_values[i] = i;
+        if (a.id != 0) {
+            ids[n_ids] = a.id;
+            id_values[n_ids++] = i;
+        }
+    }
+    t->hashed = scan_phash_build(&t->ids, ids, id_values, n_ids) &&
+                scan_phash_build(&t->names, names, name_values, t->count);
+    return t->hashed;
+}
+
+// Returns the index of the entry, or -1 (table full, name too long or empty)
+constexpr int scan_artifacts_add(scan_artifacts_t* t, uint32_t id, const char* name) {
+    size_t len = 0;
+    while (name && name[len] && len <= SCAN_NAME_MAX) len++;
+    if (t->count >= SCAN_ARTIFACTS_MAX || len == 0 || len > SCAN_NAME_MAX) return -1;
+    scan_artifact_t& a = t->items[t->count];
+    a.id = id;
+    a.name_len = static_cast<uint8_t>(len);
+    for (size_t i = 0; i <= len; i++) a.name[i] = name[i];
+    t->name_lens |= 1u << len;
+    t->count++;
+    scan_artifacts_rehash(t);
+    return t->count - 1;
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Matching
+typedef struct {
+    int            artifact; // Index into the table
+    const uint8_t* mfr;      // Compact manufacturer AD (company ID onwards), null for a name match
+    uint8_t        mfr_len;
+} scan_ad_match_t;
+
+// Walk `len` AD bytes; true and `out` filled if they identify a known artifact
+// - A compact ID wins over a name in the same payload; ephemeral IDs are not
+//   matched here (they need the resolver, host/eid_resolver.h)
+bool scan_ad_match(const scan_artifacts_t* t, const uint8_t* ad, uint8_t len, scan_ad_match_t* out);
+
+// Same matching on fields a scanning plugin has already split out (phones):
+// manufacturer data from the company ID on, and the advertised name
+// - Returns the artifact index, -1 if neither identifies a known artifact
+int scan_match_fields(const scan_artifacts_t* t, const uint8_t* mfr, uint8_t mfr_len, const uint8_t* name,
+                      uint8_t name_len);
@@ -0,0 +1,73 @@
+/*
+COS10025 BLE-to-Web Cultural Storytelling System
+Scan batcher: what of the matched report stream the UI needs to hear.
+- Reports are collected for window_us per beacon (count, RSSI mean and peak,
+  latest address and manufacturer data) and every report goes through the
+  proximity engine (scan_proximity.h) as it arrives
+- A window is flushed when it is over or as soon as the decision changes;
+  the flush is only worth a UI notification when the nearest artifact
+  changed or a beacon's manufacturer data differs from what the UI was last
+  shown (telemetry). Everything else stays native
+- Fixed-size state; single-threaded (the reader thread in the runner, the
+  caller's isolate through dart:ffi)
+*/
+
+#pragma once
+
+#include "scan_engine.h"
+#include "scan_proximity.h"
+
+#define SCAN_BATCH_BEACONS SCAN_PROX_TRACKS
+#define SCAN_BATCH_MFR_MAX BEACON_ADV_PAYLOAD_MAX
+
+typedef struct {
+    int16_t  artifact;
+    uint16_t reports;  // In this window
+    int32_t  rssi_sum;
+    int8_t   rssi_max;
+    uint8_t  addr_type;
+    uint8_t  addr[6];
+    uint8_t  mfr_len;
+    uint8_t  mfr[SCAN_BATCH_MFR_MAX];
+} scan_batch_beacon_t;
+
+typedef struct {
+    uint64_t reports;       // Matched reports in
+    uint64_t windows;       // Flushes
+    uint64_t notifications; // Flushes the UI had to hear about
+} scan_batch_stats_t;
+
+typedef struct {
+    uint32_t            window_us;
+    bool                open;
+    uint64_t            opened_us;
+    scan_batch_beacon_t beacons[SCAN_BATCH_BEACONS];
+    uint8_t             count;
+    scan_proximity_t    proximity;
+    int                 notified_nearest;  // Decision the UI last heard (-1 = none)
+    uint8_t             sent_len[SCAN_ARTIFACTS_MAX];  // Manufacturer data the UI last heard per artifact
+    bool                sent[SCAN_ARTIFACTS_MAX];
+    uint8_t             sent_mfr[SCAN_ARTIFACTS_MAX][SCAN_BATCH_MFR_MAX];
+    scan_batch_stats_t  stats;
+} scan_batch_t;
+
+typedef struct {
+    int      nearest;          // -1 = none
+    bool     nearest_changed;
+    uint8_t  changed;          // Beacons whose manufacturer data the UI has not seen
+    const scan_batch_beacon_t* beacons[SCAN_BATCH_BEACONS];  // Valid until the next add
+} scan_batch_notice_t;
+
+void scan_batch_init(scan_batch_t* b, uint32_t window_us, const scan_prox_config_t* proximity);
+
+// One matched report; true when the caller should flush now
+bool scan_batch_add(scan_batch_t* b, const scan_match_t* match);
+
+// Window over? For callers that also see unmatched traffic or a clock
+bool scan_batch_due(const scan_batch_t* b, uint64_t now_us);
+
+// Close the window; true when the notice has something for the UI. The
+// caller marks each changed beacon it delivered with scan_batch_sent() (one
+// left unmarked is offered again by a later window)
+bool scan_batch_flush(scan_batch_t* b, uint64_t now_us, scan_batch_notice_t* notice);
+void scan_batch_sent(scan_batch_t* b, const scan_batch_beacon_t* beacon);
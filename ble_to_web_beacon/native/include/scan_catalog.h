@@ -0,0 +1,38 @@
+/*
+COS10025 BLE-to-Web Cultural Storytelling System
+Built-in artifact catalogue of the native scanner.
+- The museum's artifact IDs and beacon names, as provisioned on the beacons
+  (tools/beacon_nvs.py) and mapped in lib/main.dart (beaconIdToName)
+- SCAN_CATALOG_TABLE is the matcher table with both perfect hashes, built by
+  the compiler; a catalogue the hash cannot separate fails the build
+- Used by the FFI matcher until the app registers its own table, and by the
+  host benches
+*/
+
+#pragma once
+
+#include "scan_ad.h"
+
+struct scan_catalog_entry_t {
+    uint32_t    id;
+    const char* name;
+};
+
+constexpr scan_catalog_entry_t SCAN_CATALOG[] = {
+    {0x0001, "TraKieu_Apsara_Relief"},
+    {0x0002, "Tara_Bodhisattva_Statue"},
+};
+
+constexpr size_t SCAN_CATALOG_COUNT = sizeof(SCAN_CATALOG) / sizeof(SCAN_CATALOG[0]);
+
+constexpr scan_artifacts_t scan_catalog_table(void) {
+    scan_artifacts_t t = {};
+    for (const scan_catalog_entry_t& e : SCAN_CATALOG) scan_artifacts_add(&t, e.id, e.name);
+    return t;
+}
+
+constexpr scan_artifacts_t SCAN_CATALOG_TABLE = scan_catalog_table();
+
+static_assert(SCAN_CATALOG_TABLE.count == SCAN_CATALOG_COUNT, "catalogue entry rejected (empty or long name)");
+static_assert(SCAN_CATALOG_TABLE.hashed, "catalogue IDs or names do not fit a perfect hash");
+static_assert(scan_phash_find(SCAN_CATALOG_TABLE.ids, SCAN_CATALOG[0].id) == 0, "catalogue hash broken");
@@ -0,0 +1,79 @@
+/*
+COS10025 BLE-to-Web Cultural Storytelling System
+Scan duty scheduler: how hard the phone listens, from beacon presence.
+- idle      no artifact heard for idle_after_us: idle_mode (low power)
+- burst     an artifact was heard: present_mode (low latency) until the
+            proximity engine settles and a story opens, for at most
+            burst_max_us; then settle_mode while artifacts stay around
+- cooldown  a story opened: cooldown_mode for cooldown_us (the app's
+            per-artifact cooldown) while the visitor moves to the next case;
+            low latency, as a windowed mode's gaps outlast the proximity
+            engine's stale_us and it then commits to the wrong case
+- Modes use Android's scan mode numbers (flutter_reactive_ble ScanMode);
+  changing mode means restarting the scan, and Android refuses a sixth
+  start within 30 s, so at most max_starts starts per starts_window_us are
+  made and a change is deferred rather than lost
+- Fixed-size state, no clock of its own: time comes with every call
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+typedef enum {
+    SCAN_MODE_LOW_POWER   = 0, // Android: 0.5 s window every 5 s
+    SCAN_MODE_BALANCED    = 1, // 1 s window every 4 s
+    SCAN_MODE_LOW_LATENCY = 2, // Continuous
+} scan_mode_t;
+
+typedef enum {
+    SCAN_DUTY_IDLE     = 0,
+    SCAN_DUTY_BURST    = 1,
+    SCAN_DUTY_COOLDOWN = 2,
+} scan_duty_state_t;
+
+#define SCAN_DUTY_STARTS_MAX 8
+
+typedef struct {
+    scan_mode_t idle_mode;
+    scan_mode_t present_mode;
+    scan_mode_t settle_mode;      // Artifacts around, burst spent without a story
+    scan_mode_t cooldown_mode;
+    uint32_t    idle_after_us;    // Silence before dropping back to idle
+    uint32_t    burst_max_us;
+    uint32_t    cooldown_us;
+    uint8_t     max_starts;       // Scan starts allowed per starts_window_us (<= SCAN_DUTY_STARTS_MAX)
+    uint32_t    starts_window_us;
+} scan_duty_config_t;
+
+typedef struct {
+    scan_duty_config_t config;
+    scan_duty_state_t  state;
+    scan_mode_t        mode;          // Mode the scan was last started in
+    bool               heard;
+    uint64_t           last_heard_us;
+    uint64_t           burst_us;      // When the current burst began
+    bool               launched;
+    uint64_t           launched_us;
+    uint64_t           starts[SCAN_DUTY_STARTS_MAX]; // Ring of recent start times
+    uint8_t            start_next;
+    uint32_t           start_count;   // Starts made (the first one included)
+    uint32_t           deferred;      // Polls that wanted a change the start limit held back
+} scan_duty_t;
+
+scan_duty_config_t scan_duty_defaults(void);
+
+// The caller starts scanning in scan_duty_mode() at now_us
+void scan_duty_init(scan_duty_t* d, const scan_duty_config_t* config, uint64_t now_us);
+
+void scan_duty_heard(scan_duty_t* d, uint64_t now_us);     // A known artifact was heard
+void scan_duty_launched(scan_duty_t* d, uint64_t now_us);  // A story opened
+
+// Mode the scan should run in now. Returns true when the caller must
+// restart the scan in *mode (the start is counted); false to keep scanning
+// as it is
+bool scan_duty_poll(scan_duty_t* d, uint64_t now_us, scan_mode_t* mode);
+
+static inline scan_mode_t scan_duty_mode(const scan_duty_t* d) {
+    return d->mode;
+}
@@ -0,0 +1,81 @@
+/*
+COS10025 BLE-to-Web Cultural Storytelling System
+Native scanner engine: HCI advertising reports in, matched artifacts out.
+- A backend hands over raw HCI event packets: the live adapter (scan_hci.h)
+  or a recorded capture (scan_replay.h)
+- Each report is matched in place against the artifact table (scan_ad.h);
+  only reports from known artifacts reach the callback, everything else is
+  counted and dropped on the reader thread
+- start() runs the reader on its own thread; feed() is the same path called
+  synchronously (benches, replays)
+*/
+
+#pragma once
+
+#include "scan_ad.h"
+
+#include <atomic>
+#include <thread>
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Backend function table (ctx passed back unchanged)
+typedef struct {
+    void* ctx;
+
+    scan_err_t (*start)(void* ctx);
+    // Next HCI event packet into `buf` (event code first, no H4 type byte)
+    // - *len = 0 when nothing arrived within timeout_ms
+    // - SCAN_ERR_END when a replay is exhausted, another error on failure
+    scan_err_t (*read)(void* ctx, uint8_t* buf, size_t cap, size_t* len, uint64_t* ts_us, int timeout_ms);
+    void (*stop)(void* ctx);
+} scan_backend_t;
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Matched artifact report; pointers are valid during the callback only
+typedef struct {
+    uint64_t       ts_us;    // Backend clock (monotonic, or capture time on replay)
+    int            artifact; // Index into the engine's artifact table
+    int8_t         rssi;
+    uint8_t        addr_type;
+    uint8_t        addr[6];  // Least significant byte first
+    const uint8_t* mfr;      // Compact manufacturer data (company ID onwards), null for a name match
+    uint8_t        mfr_len;
+} scan_match_t;
+
+typedef void (*scan_match_cb_t)(void* arg, const scan_match_t* match);
+// Reader thread ended on its own (end of replay or backend failure)
+typedef void (*scan_exit_cb_t)(void* arg, scan_err_t err);
+
+typedef struct {
+    uint64_t events;    // HCI events read
+    uint64_t reports;   // Advertising reports walked
+    uint64_t matched;   // Reports delivered to the callback
+    uint64_t malformed; // Events with a truncated report
+} scan_stats_t;
+
+struct scan_engine_t {
+    scan_backend_t    backend;
+    scan_artifacts_t  artifacts;
+    scan_match_cb_t   on_match;
+    scan_exit_cb_t    on_exit;  // Optional
+    void*             arg;
+    scan_stats_t      stats;    // Written by the reader; read after stop()
+    std::thread       thread;
+    std::atomic<bool> running;
+    scan_err_t        exit_err; // Why the reader stopped (SCAN_OK when stopped by the caller)
+};
+
+void scan_engine_init(scan_engine_t* engine, const scan_backend_t& backend, const scan_artifacts_t* artifacts,
+                      scan_match_cb_t on_match, scan_exit_cb_t on_exit, void* arg);
+
+// Start the backend and the reader thread
+scan_err_t scan_engine_start(scan_engine_t* engine);
+
+// Stop the reader (returns within one read timeout) and the backend
+void scan_engine_stop(scan_engine_t* engine);
+
+// Reader loop on the calling thread, until stop() or the backend ends
+scan_err_t scan_engine_run(scan_engine_t* engine);
+
+// Match one HCI event; returns the reports delivered
+size_t scan_engine_feed(scan_engine_t* engine, const uint8_t* evt, size_t len, uint64_t ts_us);
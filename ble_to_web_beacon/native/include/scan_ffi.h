@@ -0,0 +1,83 @@
+/*
+COS10025 BLE-to-Web Cultural Storytelling System
+C ABI of the artifact matcher for dart:ffi (lib/native_matcher.dart).
+- Built as libcham_scan_ffi (Android through the app's externalNativeBuild)
+- Each matcher owns a CHAM_MATCHER_BUFFER-byte scratch buffer that Dart maps
+  once as a Uint8List: the bytes to match are written there and the call
+  passes only lengths, so a match allocates nothing on either side
+- A new matcher holds the built-in catalogue (scan_catalog.h); the app may
+  replace it with its own table
+- Each matcher also batches what it matched (scan_batch.h: per-beacon
+  windows, payload dedup, the proximity engine) so the app hears only
+  decisions and new telemetry, on the app's monotonic clock
+- And it schedules how hard the phone scans (scan_duty.h): the app restarts
+  its scan when cham_matcher_scan_mode() asks for another mode
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+#define CHAM_MATCHER_BUFFER 64 // Manufacturer data + name, or one raw AD payload
+#define CHAM_MATCHER_WINDOW_US 250000
+
+// cham_matcher_report() results
+#define CHAM_REPORT_NONE    0 // Not an artifact
+#define CHAM_REPORT_MATCHED 1
+#define CHAM_REPORT_FLUSH   2 // Call cham_matcher_flush() now
+
+#if defined(_WIN32)
+#define CHAM_FFI_EXPORT __declspec(dllexport)
+#else
+#define CHAM_FFI_EXPORT __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct cham_matcher cham_matcher;
+
+CHAM_FFI_EXPORT cham_matcher* cham_matcher_new(void);
+CHAM_FFI_EXPORT void cham_matcher_free(cham_matcher* m);
+CHAM_FFI_EXPORT uint8_t* cham_matcher_buffer(cham_matcher* m);
+
+// Table: clear, then add one artifact per call with its name in the buffer
+// - add returns the artifact index, -1 if rejected (table full, bad name)
+CHAM_FFI_EXPORT void cham_matcher_clear(cham_matcher* m);
+CHAM_FFI_EXPORT int32_t cham_matcher_add(cham_matcher* m, uint32_t id, int32_t name_len);
+CHAM_FFI_EXPORT int32_t cham_matcher_count(cham_matcher* m);
+
+// Matching; return the artifact index or -1
+// - fields: manufacturer data (company ID on) at buffer[0], the name right after it
+// - ad: raw advertising data at buffer[0]
+CHAM_FFI_EXPORT int32_t cham_matcher_match_fields(cham_matcher* m, int32_t mfr_len, int32_t name_len);
+CHAM_FFI_EXPORT int32_t cham_matcher_match_ad(cham_matcher* m, int32_t len);
+
+// Batching
+// - report: one advertisement's fields in the buffer (as match_fields) heard
+//   at `rssi` dBm; returns CHAM_REPORT_*
+// - flush: closes the window; 0 when there is nothing for the app, otherwise
+//   the bytes written to the buffer: nearest artifact index + 1 (0 = none),
+//   then for each beacon with manufacturer data the app has not seen: index,
+//   length, data (beacons that do not fit come again with a later window)
+// - tick: from the app's timer, when nothing may be heard; CHAM_REPORT_FLUSH
+//   when a window is over, or when no window is open and the decision has
+//   changed since the app last heard it (beacons gone silent)
+// - nearest: the decision now, forgetting beacons gone silent
+CHAM_FFI_EXPORT int32_t cham_matcher_report(cham_matcher* m, int32_t mfr_len, int32_t name_len, int32_t rssi,
+                                            int64_t now_us);
+CHAM_FFI_EXPORT int32_t cham_matcher_flush(cham_matcher* m, int64_t now_us);
+CHAM_FFI_EXPORT int32_t cham_matcher_tick(cham_matcher* m, int64_t now_us);
+CHAM_FFI_EXPORT int32_t cham_matcher_nearest(cham_matcher* m, int64_t now_us);
+
+// Scan duty (scan_duty.h; the app starts scanning in low power at time 0)
+// - launched: a story opened
+// - scan_mode: the scan_mode_t to restart the scan in, -1 to keep scanning
+//   as it is
+CHAM_FFI_EXPORT void cham_matcher_launched(cham_matcher* m, int64_t now_us);
+CHAM_FFI_EXPORT int32_t cham_matcher_scan_mode(cham_matcher* m, int64_t now_us);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,65 @@
+/*
+COS10025 BLE-to-Web Cultural Storytelling System
+HCI side of the native scanner: advertising report events and the live
+BlueZ backend.
+- Event walk: LE Advertising Report (legacy) and LE Extended Advertising Report
+  meta events, visited report by report in the caller's buffer
+- Live backend (Linux): raw HCI socket bound to one adapter, filtered in the
+  kernel to LE meta and command events. It sets passive scanning with duplicate
+  filtering off, so every advertising event is reported with its RSSI. If the
+  controller refuses (bluetoothd already scanning, or extended scanning in use)
+  the socket keeps listening to the reports of the scan that is running
+- Raw HCI needs CAP_NET_RAW, and CAP_NET_ADMIN to issue the scan commands:
+  sudo setcap cap_net_raw,cap_net_admin+eip <bundle>/ble_to_web_beacon
+*/
+
+#pragma once
+
+#include "scan_engine.h"
+
+// ─────────────────────────────────────────────────────────────────────────────
+// HCI constants (packets as on the raw socket / in H4 captures)
+#define SCAN_HCI_COMMAND_PKT        0x01
+#define SCAN_HCI_EVENT_PKT          0x04
+#define SCAN_HCI_EVT_CMD_COMPLETE   0x0E
+#define SCAN_HCI_EVT_CMD_STATUS     0x0F
+#define SCAN_HCI_EVT_LE_META        0x3E
+#define SCAN_HCI_LE_ADV_REPORT      0x02
+#define SCAN_HCI_LE_EXT_ADV_REPORT  0x0D
+#define SCAN_HCI_EVENT_MAX          (2 + 255) // Event code + length + parameters
+
+// One advertising report, pointing into the event buffer
+typedef struct {
+    uint8_t        addr_type;
+    const uint8_t* addr;     // 6 bytes, least significant first (as on air)
+    int8_t         rssi;     // dBm, 127 = not available
+    const uint8_t* data;     // AD structures
+    uint8_t        data_len;
+} scan_report_t;
+
+typedef void (*scan_report_cb_t)(void* arg, const scan_report_t* report);
+
+// Visit the advertising reports of one HCI event (event code first, no H4 byte)
+// - Returns the number of reports visited, 0 for other events, -1 if the event
+//   is malformed (reports before the damage are still visited)
+// - Extended reports still being reassembled (data status incomplete) are skipped
+int scan_hci_reports(const uint8_t* evt, size_t len, scan_report_cb_t cb, void* arg);
+
+// Build a legacy LE Advertising Report event with one report (captures, benches)
+// - Returns the event length, 0 if `cap` is too small
+size_t scan_hci_build_report(uint8_t* evt, size_t cap, const uint8_t addr[6], uint8_t addr_type, int8_t rssi,
+                             const uint8_t* data, uint8_t data_len);
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Live backend (raw HCI socket)
+typedef struct {
+    int      dev;          // Adapter index (hci0 = 0)
+    uint16_t interval;     // Scan interval and window, 0.625 ms units
+    uint16_t window;
+    int      fd;
+    bool     scan_owned;   // We enabled scanning and disable it on stop
+} scan_hci_t;
+
+// Defaults: continuous passive scan (interval = window = 60 ms)
+void scan_hci_init(scan_hci_t* hci, int dev);
+scan_backend_t scan_hci_backend(scan_hci_t* hci);
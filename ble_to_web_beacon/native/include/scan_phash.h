@@ -0,0 +1,79 @@
+/*
+COS10025 BLE-to-Web Cultural Storytelling System
+Perfect hash for small key sets (artifact IDs, artifact name hashes).
+- slot = (key * mult) >> shift over a power-of-two table at least twice the
+  key count; the builder searches odd multipliers until no two keys share a
+  slot, growing the table if none fits
+- Lookup is one multiply, one shift and one key compare, no probing
+- Everything is constexpr: the built-in catalogue (scan_catalog.h) is hashed
+  by the compiler, tables received at run time use the same builder
+*/
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define SCAN_PHASH_SLOTS_MAX 128
+#define SCAN_PHASH_SLOTS_MIN 4
+#define SCAN_PHASH_EMPTY     0xFF
+#define SCAN_PHASH_TRIES     4096 // Multipliers tried per table size
+
+typedef struct {
+    uint32_t mult;
+    uint8_t  shift; // 32 - log2(slots)
+    uint32_t keys[SCAN_PHASH_SLOTS_MAX];
+    uint8_t  values[SCAN_PHASH_SLOTS_MAX]; // SCAN_PHASH_EMPTY = free slot
+} scan_phash_t;
+
+// FNV-1a, for hashing names into keys
+constexpr uint32_t scan_fnv1a(const uint8_t* p, size_t len) {
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < len; i++) h = (h ^ p[i]) * 16777619u;
+    return h;
+}
+
+constexpr uint32_t scan_phash_slot(const scan_phash_t& h, uint32_t key) {
+    return static_cast<uint32_t>(key * h.mult) >> h.shift;
+}
+
+// Value stored for `key`, -1 if absent
+constexpr int scan_phash_find(const scan_phash_t& h, uint32_t key) {
+    uint32_t s = scan_phash_slot(h, key);
+    return h.values[s] != SCAN_PHASH_EMPTY && h.keys[s] == key ? h.values[s] : -1;
+}
+
+// Hash n keys (values[i] stored for keys[i]; a repeated key keeps its first value)
+// - False if no multiplier separates them within SCAN_PHASH_SLOTS_MAX slots
+constexpr bool scan_phash_build(scan_phash_t* h, const uint32_t* keys, const uint8_t* values, size_t n) {
+    uint32_t slots = SCAN_PHASH_SLOTS_MIN;
+    uint8_t shift = 30;
+    while (slots < 2 * n) {
+        slots <<= 1;
+        shift--;
+    }
+    uint32_t seed = 0x9E3779B9u;
+    for (; slots <= SCAN_PHASH_SLOTS_MAX; slots <<= 1, shift--) {
+        for (uint32_t attempt = 0; attempt < SCAN_PHASH_TRIES; attempt++) {
+            seed = seed * 1664525u + 1013904223u;
+            h->mult = seed | 1u;
+            h->shift = shift;
+            for (uint32_t s = 0; s < SCAN_PHASH_SLOTS_MAX; s++) {
+                h->keys[s] = 0;
+                h->values[s] = SCAN_PHASH_EMPTY;
+            }
+            bool ok = true;
+            for (size_t i = 0; i < n && ok; i++) {
+                uint32_t s = scan_phash_slot(*h, keys[i]);
+                if (h->values[s] == SCAN_PHASH_EMPTY) {
+                    h->keys[s] = keys[i];
+                    h->values[s] = values[i];
+                } else {
+                    ok = h->keys[s] == keys[i]; // Same key again: first value stays
+                }
+            }
+            if (ok) return true;
+        }
+    }
+    return false;
+}
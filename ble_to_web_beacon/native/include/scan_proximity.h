@@ -0,0 +1,69 @@
+/*
+COS10025 BLE-to-Web Cultural Storytelling System
+Proximity engine: which artifact is the visitor standing at.
+- One track per beacon heard (fixed table; when it is full the weakest
+  beacon gives way to a stronger one),
+  smoothing its RSSI with a 1-D Kalman filter (random-walk model: the true
+  level drifts as the visitor moves, each report adds fading noise) or an
+  EMA with its own variance estimate
+- The nearest artifact is committed as soon as the strongest candidate leads
+  the runner-up by z standard deviations of the difference of their
+  estimates; no fixed wait. A committed artifact is only replaced by one
+  that leads it by margin_db as well (hysteresis between adjacent cases)
+- A beacon estimated below floor_dbm is never chosen; a committed beacon not
+  heard for stale_us is dropped
+- No allocation, no clock of its own: time comes with every call
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+#define SCAN_PROX_TRACKS 16
+
+typedef enum {
+    SCAN_PROX_KALMAN = 0,
+    SCAN_PROX_EMA    = 1,
+} scan_prox_filter_t;
+
+typedef struct {
+    scan_prox_filter_t filter;
+    float    meas_var;        // dB² of one report (fading); Kalman R
+    float    drift_var_per_s; // dB² per second the true level may wander; Kalman Q
+    float    ema_alpha;       // Weight of a new report (EMA)
+    float    floor_dbm;       // Weaker estimates are never chosen
+    float    margin_db;       // Lead a challenger needs over the committed artifact
+    float    z;               // Lead needed in standard deviations (1.64 ≈ 95 % one-sided)
+    uint8_t  min_reports;     // Reports before a beacon can be chosen
+    uint32_t stale_us;        // Silence after which a beacon is forgotten
+} scan_prox_config_t;
+
+typedef struct {
+    int16_t  artifact;  // -1 = free slot
+    uint16_t reports;
+    float    est;       // Smoothed RSSI, dBm
+    float    var;       // Variance of `est`, dB²
+    float    ema_sq;    // EMA of squared deviation (EMA filter only)
+    uint64_t last_us;
+} scan_prox_track_t;
+
+typedef struct {
+    scan_prox_config_t config;
+    scan_prox_track_t  tracks[SCAN_PROX_TRACKS];
+    int      nearest;       // Committed artifact, -1 = none
+    uint64_t nearest_us;    // When it was committed
+    uint32_t commits;       // Changes of the committed artifact (to another artifact)
+} scan_proximity_t;
+
+scan_prox_config_t scan_proximity_defaults(scan_prox_filter_t filter);
+void scan_proximity_init(scan_proximity_t* p, const scan_prox_config_t* config);
+
+// One report of `artifact` at `rssi` dBm; returns the committed artifact
+// afterwards (-1 if none). *changed is set when the decision changed
+int scan_proximity_update(scan_proximity_t* p, int artifact, int8_t rssi, uint64_t now_us, bool* changed);
+
+// Expire silent beacons without a report (call now and then when nothing is heard)
+int scan_proximity_tick(scan_proximity_t* p, uint64_t now_us, bool* changed);
+
+// Smoothed RSSI of `artifact`, false if it has no live track
+bool scan_proximity_estimate(const scan_proximity_t* p, int artifact, float* est_dbm);
@@ -0,0 +1,50 @@
+/*
+COS10025 BLE-to-Web Cultural Storytelling System
+Replay backend and capture writer for the native scanner (no radio needed).
+- Captures are btsnoop files: `btmon -w scan.btsnoop` on a kiosk (monitor
+  format, datalink 2001) or files written by scan_capture_* (HCI UART/H4,
+  datalink 1002). Only received HCI events are replayed; commands, ACL data
+  and other adapters' traffic are skipped
+- speed 1 keeps the recorded timing, 10 plays ten times faster, 0 delivers
+  events as fast as the engine takes them
+- Timestamps are capture time relative to the first record
+*/
+
+#pragma once
+
+#include "scan_hci.h"
+
+#include <stdio.h>
+
+#define SCAN_BTSNOOP_H4       1002
+#define SCAN_BTSNOOP_MONITOR  2001
+
+typedef struct {
+    FILE*    f;
+    uint32_t datalink;
+    double   speed;
+    uint64_t first_ts_us;  // Capture time of the first record
+    uint64_t start_us;     // Wall clock at start()
+    bool     started;
+    int      monitor_index; // Monitor captures: adapter replayed (first one with an event)
+    bool     has_pending;  // Record read but not due yet
+    uint8_t  pending[SCAN_HCI_EVENT_MAX];
+    size_t   pending_len;
+    uint64_t pending_ts_us;
+    uint64_t records;      // Records read, events or not
+} scan_replay_t;
+
+scan_err_t scan_replay_open(scan_replay_t* replay, const char* path, double speed);
+void scan_replay_close(scan_replay_t* replay);
+scan_backend_t scan_replay_backend(scan_replay_t* replay);
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Capture writer (btsnoop, H4 datalink)
+typedef struct {
+    FILE* f;
+} scan_capture_t;
+
+scan_err_t scan_capture_open(scan_capture_t* capture, const char* path);
+// One received HCI event (event code first); ts_us relative to the capture start
+void scan_capture_event(scan_capture_t* capture, const uint8_t* evt, size_t len, uint64_t ts_us);
+void scan_capture_close(scan_capture_t* capture);
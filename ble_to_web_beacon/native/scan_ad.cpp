@@ -0,0 +1,87 @@
+/*
+COS10025 BLE-to-Web Cultural Storytelling System
+In-place AD walk and artifact matching (see include/scan_ad.h).
+*/
+
+#include "scan_ad.h"
+
+#include <string.h>
+
+const char* scan_err_name(scan_err_t err) {
+    switch (err) {
+    case SCAN_OK:                return "ok";
+    case SCAN_ERR_FAIL:          return "failed";
+    case SCAN_ERR_INVALID_ARG:   return "invalid argument";
+    case SCAN_ERR_NO_PERMISSION: return "no permission";
+    case SCAN_ERR_FORMAT:        return "bad capture format";
+    case SCAN_ERR_END:           return "end of capture";
+    case SCAN_ERR_NOT_SUPPORTED: return "not supported";
+    default:                     return "?";
+    }
+}
+
+// Compact manufacturer data (company ID onwards) → artifact index, -1 if not one of ours
+static int match_compact(const scan_artifacts_t* t, const uint8_t* m, uint8_t len) {
+    if (len < 3 + BEACON_ARTIFACT_ID_MIN_LEN + 1 || m[0] != (BEACON_COMPANY_ID & 0xFF) ||
+        m[1] != (BEACON_COMPANY_ID >> 8) || (m[2] >> 4) != BEACON_PAYLOAD_VERSION) {
+        return -1;
+    }
+    uint8_t id_len = m[2] & 0x0F;
+    if (id_len < BEACON_ARTIFACT_ID_MIN_LEN || id_len > BEACON_ARTIFACT_ID_MAX_LEN || len < 3 + id_len + 1) {
+        return -1;
+    }
+    uint32_t id = 0;
+    for (uint8_t b = 0; b < id_len; b++) id |= static_cast<uint32_t>(m[3 + b]) << (8 * b);
+    if (t->hashed) return id ? scan_phash_find(t->ids, id) : -1;
+    for (uint8_t i = 0; i < t->count; i++) {
+        if (t->items[i].id == id && id != 0) return i;
+    }
+    return -1;
+}
+
+static int match_name(const scan_artifacts_t* t, const uint8_t* name, uint8_t len) {
+    if (!(t->name_lens & (1u << len))) return -1;
+    if (t->hashed) {
+        int i = scan_phash_find(t->names, scan_fnv1a(name, len));
+        return i >= 0 && t->items[i].name_len == len && memcmp(t->items[i].name, name, len) == 0 ? i : -1;
+    }
+    for (uint8_t i = 0; i < t->count; i++) {
+        if (t->items[i].name_len == len && memcmp(t->items[i].name, name, len) == 0) return i;
+    }
+    return -1;
+}
+
+bool scan_ad_match(const scan_artifacts_t* t, const uint8_t* ad, uint8_t len, scan_ad_match_t* out) {
+    int by_name = -1;
+    uint8_t i = 0;
+    while (i < len) {
+        uint8_t ad_len = ad[i];
+        if (ad_len == 0 || i + 1 + ad_len > len) break; // Padding or truncated: keep what was found
+        const uint8_t* p = &ad[i + 1];                  // p[0] = AD type
+        if (p[0] == BEACON_AD_TYPE_MANUFACTURER) {
+            int hit = match_compact(t, p + 1, static_cast<uint8_t>(ad_len - 1));
+            if (hit >= 0) {
+                out->artifact = hit;
+                out->mfr = p + 1;
+                out->mfr_len = static_cast<uint8_t>(ad_len - 1);
+                return true;
+            }
+        } else if ((p[0] == BEACON_AD_TYPE_COMPLETE_NAME || p[0] == SCAN_AD_TYPE_SHORT_NAME) && by_name < 0 &&
+                   ad_len - 1 <= SCAN_NAME_MAX) {
+            by_name = match_name(t, p + 1, static_cast<uint8_t>(ad_len - 1));
+        }
+        i = static_cast<uint8_t>(i + 1 + ad_len);
+    }
+    if (by_name < 0) return false;
+    out->artifact = by_name;
+    out->mfr = nullptr;
+    out->mfr_len = 0;
+    return true;
+}
+
+int scan_match_fields(const scan_artifacts_t* t, const uint8_t* mfr, uint8_t mfr_len, const uint8_t* name,
+                      uint8_t name_len) {
+    int hit = mfr_len ? match_compact(t, mfr, mfr_len) : -1;
+    if (hit < 0 && name_len && name_len <= SCAN_NAME_MAX) hit = match_name(t, name, name_len);
+    return hit;
+}
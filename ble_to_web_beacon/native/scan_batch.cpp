@@ -0,0 +1,83 @@
+/*
+COS10025 BLE-to-Web Cultural Storytelling System
+Scan batcher (see include/scan_batch.h).
+*/
+
+#include "scan_batch.h"
+
+#include <string.h>
+
+void scan_batch_init(scan_batch_t* b, uint32_t window_us, const scan_prox_config_t* proximity) {
+    memset(b, 0, sizeof(*b));
+    b->window_us = window_us;
+    scan_proximity_init(&b->proximity, proximity);
+    b->notified_nearest = -1;
+}
+
+static scan_batch_beacon_t* beacon_for(scan_batch_t* b, int artifact) {
+    for (uint8_t i = 0; i < b->count; i++) {
+        if (b->beacons[i].artifact == artifact) return &b->beacons[i];
+    }
+    if (b->count == SCAN_BATCH_BEACONS) return nullptr; // Counted by proximity, not summarised
+    scan_batch_beacon_t* s = &b->beacons[b->count++];
+    memset(s, 0, sizeof(*s));
+    s->artifact = static_cast<int16_t>(artifact);
+    s->rssi_max = INT8_MIN;
+    return s;
+}
+
+bool scan_batch_add(scan_batch_t* b, const scan_match_t* match) {
+    b->stats.reports++;
+    if (!b->open) {
+        b->open = true;
+        b->opened_us = match->ts_us;
+    }
+
+    scan_batch_beacon_t* s = match->artifact < SCAN_ARTIFACTS_MAX ? beacon_for(b, match->artifact) : nullptr;
+    if (s) {
+        s->reports++;
+        s->rssi_sum += match->rssi;
+        if (match->rssi > s->rssi_max) s->rssi_max = match->rssi;
+        s->addr_type = match->addr_type;
+        memcpy(s->addr, match->addr, sizeof(s->addr));
+        s->mfr_len = match->mfr && match->mfr_len <= SCAN_BATCH_MFR_MAX ? match->mfr_len : 0;
+        if (s->mfr_len) memcpy(s->mfr, match->mfr, s->mfr_len);
+    }
+
+    int nearest = scan_proximity_update(&b->proximity, match->artifact, match->rssi, match->ts_us, nullptr);
+    return nearest != b->notified_nearest || scan_batch_due(b, match->ts_us);
+}
+
+bool scan_batch_due(const scan_batch_t* b, uint64_t now_us) {
+    return b->open && now_us - b->opened_us >= b->window_us;
+}
+
+static bool payload_new(const scan_batch_t* b, const scan_batch_beacon_t& s) {
+    if (!s.mfr_len) return false; // Name-mode beacons carry no telemetry
+    return !b->sent[s.artifact] || b->sent_len[s.artifact] != s.mfr_len ||
+           memcmp(b->sent_mfr[s.artifact], s.mfr, s.mfr_len) != 0;
+}
+
+bool scan_batch_flush(scan_batch_t* b, uint64_t now_us, scan_batch_notice_t* notice) {
+    b->stats.windows++;
+    notice->nearest = scan_proximity_tick(&b->proximity, now_us, nullptr);
+    notice->nearest_changed = notice->nearest != b->notified_nearest;
+    b->notified_nearest = notice->nearest;
+    notice->changed = 0;
+    for (uint8_t i = 0; i < b->count; i++) {
+        if (payload_new(b, b->beacons[i])) notice->beacons[notice->changed++] = &b->beacons[i];
+    }
+    // The summaries stay readable through the notice until the next add
+    b->count = 0;
+    b->open = false;
+
+    bool notify = notice->nearest_changed || notice->changed;
+    if (notify) b->stats.notifications++;
+    return notify;
+}
+
+void scan_batch_sent(scan_batch_t* b, const scan_batch_beacon_t* beacon) {
+    b->sent[beacon->artifact] = true;
+    b->sent_len[beacon->artifact] = beacon->mfr_len;
+    memcpy(b->sent_mfr[beacon->artifact], beacon->mfr, beacon->mfr_len);
+}
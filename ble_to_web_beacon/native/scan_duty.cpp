@@ -0,0 +1,86 @@
+/*
+COS10025 BLE-to-Web Cultural Storytelling System
+Scan duty scheduler (see include/scan_duty.h).
+*/
+
+#include "scan_duty.h"
+
+#include <string.h>
+
+scan_duty_config_t scan_duty_defaults(void) {
+    scan_duty_config_t c;
+    c.idle_mode = SCAN_MODE_LOW_POWER;
+    c.present_mode = SCAN_MODE_LOW_LATENCY;
+    c.settle_mode = SCAN_MODE_BALANCED;
+    c.cooldown_mode = SCAN_MODE_LOW_LATENCY; // Balanced here misses a quarter of the visits (host/bench_duty)
+    c.idle_after_us = 8000000;
+    c.burst_max_us = 20000000;
+    c.cooldown_us = 30000000;        // lib/main.dart _cooldown
+    c.max_starts = 4;                // One below Android's five per 30 s
+    c.starts_window_us = 30000000;
+    return c;
+}
+
+static void count_start(scan_duty_t* d, uint64_t now_us) {
+    d->starts[d->start_next] = now_us;
+    d->start_next = static_cast<uint8_t>((d->start_next + 1) % d->config.max_starts);
+    d->start_count++;
+}
+
+void scan_duty_init(scan_duty_t* d, const scan_duty_config_t* config, uint64_t now_us) {
+    memset(d, 0, sizeof(*d));
+    d->config = *config;
+    if (d->config.max_starts == 0) d->config.max_starts = 1;
+    if (d->config.max_starts > SCAN_DUTY_STARTS_MAX) d->config.max_starts = SCAN_DUTY_STARTS_MAX;
+    d->state = SCAN_DUTY_IDLE;
+    d->mode = d->config.idle_mode;
+    count_start(d, now_us);
+}
+
+void scan_duty_heard(scan_duty_t* d, uint64_t now_us) {
+    d->heard = true;
+    d->last_heard_us = now_us;
+}
+
+void scan_duty_launched(scan_duty_t* d, uint64_t now_us) {
+    d->launched = true;
+    d->launched_us = now_us;
+}
+
+// Step 1 of poll: state from what was heard and launched
+static void update_state(scan_duty_t* d, uint64_t now_us) {
+    const scan_duty_config_t& c = d->config;
+    bool present = d->heard && now_us - d->last_heard_us < c.idle_after_us;
+    if (d->launched && now_us - d->launched_us < c.cooldown_us) {
+        d->state = SCAN_DUTY_COOLDOWN;
+    } else if (!present) {
+        d->state = SCAN_DUTY_IDLE;
+    } else if (d->state != SCAN_DUTY_BURST) {
+        // A new burst: artifacts appeared, or a cooldown ended among them
+        d->state = SCAN_DUTY_BURST;
+        d->burst_us = now_us;
+    }
+}
+
+bool scan_duty_poll(scan_duty_t* d, uint64_t now_us, scan_mode_t* mode) {
+    const scan_duty_config_t& c = d->config;
+    update_state(d, now_us);
+
+    // Step 2: Mode for the state
+    scan_mode_t want = c.idle_mode;
+    if (d->state == SCAN_DUTY_COOLDOWN) want = c.cooldown_mode;
+    else if (d->state == SCAN_DUTY_BURST) want = now_us - d->burst_us < c.burst_max_us ? c.present_mode : c.settle_mode;
+    *mode = d->mode;
+    if (want == d->mode) return false;
+
+    // Step 3: Android's start limit; the oldest of the last max_starts
+    // starts must have left the window
+    if (d->start_count >= c.max_starts && now_us - d->starts[d->start_next] < c.starts_window_us) {
+        d->deferred++;
+        return false;
+    }
+    d->mode = want;
+    count_start(d, now_us);
+    *mode = want;
+    return true;
+}
@@ -0,0 +1,94 @@
+/*
+COS10025 BLE-to-Web Cultural Storytelling System
+Native scanner engine (see include/scan_engine.h).
+*/
+
+#include "scan_engine.h"
+#include "scan_hci.h"
+
+#include <string.h>
+
+#define READ_TIMEOUT_MS 100 // Bounds how long stop() waits for the reader
+
+struct feed_ctx_t {
+    scan_engine_t* engine;
+    uint64_t       ts_us;
+    size_t         matched;
+};
+
+static void on_report(void* arg, const scan_report_t* report) {
+    feed_ctx_t* ctx = static_cast<feed_ctx_t*>(arg);
+    scan_engine_t* engine = ctx->engine;
+    engine->stats.reports++;
+
+    scan_ad_match_t hit;
+    if (!scan_ad_match(&engine->artifacts, report->data, report->data_len, &hit)) return;
+
+    scan_match_t match;
+    match.ts_us = ctx->ts_us;
+    match.artifact = hit.artifact;
+    match.rssi = report->rssi;
+    match.addr_type = report->addr_type;
+    memcpy(match.addr, report->addr, sizeof(match.addr));
+    match.mfr = hit.mfr;
+    match.mfr_len = hit.mfr_len;
+    engine->stats.matched++;
+    ctx->matched++;
+    engine->on_match(engine->arg, &match);
+}
+
+void scan_engine_init(scan_engine_t* engine, const scan_backend_t& backend, const scan_artifacts_t* artifacts,
+                      scan_match_cb_t on_match, scan_exit_cb_t on_exit, void* arg) {
+    engine->backend = backend;
+    engine->artifacts = *artifacts;
+    engine->on_match = on_match;
+    engine->on_exit = on_exit;
+    engine->arg = arg;
+    engine->stats = {};
+    engine->running = false;
+    engine->exit_err = SCAN_OK;
+}
+
+size_t scan_engine_feed(scan_engine_t* engine, const uint8_t* evt, size_t len, uint64_t ts_us) {
+    feed_ctx_t ctx = {engine, ts_us, 0};
+    engine->stats.events++;
+    if (scan_hci_reports(evt, len, on_report, &ctx) < 0) engine->stats.malformed++;
+    return ctx.matched;
+}
+
+scan_err_t scan_engine_run(scan_engine_t* engine) {
+    uint8_t buf[SCAN_HCI_EVENT_MAX];
+    scan_err_t err = SCAN_OK;
+    while (engine->running.load(std::memory_order_relaxed)) {
+        size_t len = 0;
+        uint64_t ts_us = 0;
+        err = engine->backend.read(engine->backend.ctx, buf, sizeof(buf), &len, &ts_us, READ_TIMEOUT_MS);
+        if (err != SCAN_OK) break;
+        if (len) scan_engine_feed(engine, buf, len, ts_us);
+    }
+    engine->exit_err = err;
+    return err;
+}
+
+scan_err_t scan_engine_start(scan_engine_t* engine) {
+    if (engine->running) return SCAN_ERR_INVALID_ARG;
+    scan_err_t err = engine->backend.start(engine->backend.ctx);
+    if (err != SCAN_OK) return err;
+
+    engine->stats = {};
+    engine->exit_err = SCAN_OK;
+    engine->running = true;
+    engine->thread = std::thread([engine] {
+        scan_err_t exit_err = scan_engine_run(engine);
+        if (exit_err != SCAN_OK && engine->on_exit) engine->on_exit(engine->arg, exit_err);
+    });
+    return SCAN_OK;
+}
+
+void scan_engine_stop(scan_engine_t* engine) {
+    engine->running = false;
+    if (engine->thread.joinable()) {
+        engine->thread.join();
+        engine->backend.stop(engine->backend.ctx);
+    }
+}
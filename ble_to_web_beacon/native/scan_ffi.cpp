@@ -0,0 +1,127 @@
+/*
+COS10025 BLE-to-Web Cultural Storytelling System
+dart:ffi matcher (see include/scan_ffi.h).
+*/
+
+#include "scan_ffi.h"
+#include "scan_catalog.h"
+#include "scan_batch.h"
+#include "scan_duty.h"
+
+#include <string.h>
+
+struct cham_matcher {
+    scan_artifacts_t artifacts;
+    uint8_t buffer[CHAM_MATCHER_BUFFER];
+    scan_batch_t batch;
+    scan_duty_t duty;
+};
+
+static void reset_state(cham_matcher* m) {
+    scan_prox_config_t config = scan_proximity_defaults(SCAN_PROX_KALMAN);
+    scan_batch_init(&m->batch, CHAM_MATCHER_WINDOW_US, &config);
+    scan_duty_config_t duty = scan_duty_defaults();
+    scan_duty_init(&m->duty, &duty, 0);
+}
+
+cham_matcher* cham_matcher_new(void) {
+    cham_matcher* m = new cham_matcher();
+    m->artifacts = SCAN_CATALOG_TABLE;
+    reset_state(m);
+    return m;
+}
+
+void cham_matcher_free(cham_matcher* m) {
+    delete m;
+}
+
+uint8_t* cham_matcher_buffer(cham_matcher* m) {
+    return m->buffer;
+}
+
+void cham_matcher_clear(cham_matcher* m) {
+    scan_artifacts_init(&m->artifacts);
+    reset_state(m);
+}
+
+int32_t cham_matcher_add(cham_matcher* m, uint32_t id, int32_t name_len) {
+    if (name_len <= 0 || name_len > SCAN_NAME_MAX) return -1;
+    char name[SCAN_NAME_MAX + 1];
+    for (int32_t i = 0; i < name_len; i++) name[i] = static_cast<char>(m->buffer[i]);
+    name[name_len] = '\0';
+    return scan_artifacts_add(&m->artifacts, id, name);
+}
+
+int32_t cham_matcher_count(cham_matcher* m) {
+    return m->artifacts.count;
+}
+
+int32_t cham_matcher_match_fields(cham_matcher* m, int32_t mfr_len, int32_t name_len) {
+    if (mfr_len < 0 || name_len < 0 || mfr_len + name_len > CHAM_MATCHER_BUFFER || mfr_len > 0xFF) return -1;
+    return scan_match_fields(&m->artifacts, m->buffer, static_cast<uint8_t>(mfr_len), m->buffer + mfr_len,
+                             static_cast<uint8_t>(name_len));
+}
+
+int32_t cham_matcher_match_ad(cham_matcher* m, int32_t len) {
+    if (len <= 0 || len > CHAM_MATCHER_BUFFER) return -1;
+    scan_ad_match_t hit;
+    return scan_ad_match(&m->artifacts, m->buffer, static_cast<uint8_t>(len), &hit) ? hit.artifact : -1;
+}
+
+int32_t cham_matcher_report(cham_matcher* m, int32_t mfr_len, int32_t name_len, int32_t rssi, int64_t now_us) {
+    if (now_us < 0) return CHAM_REPORT_NONE;
+    int32_t artifact = cham_matcher_match_fields(m, mfr_len, name_len);
+    if (artifact < 0) return scan_batch_due(&m->batch, static_cast<uint64_t>(now_us)) ? CHAM_REPORT_FLUSH : CHAM_REPORT_NONE;
+
+    scan_match_t match = {};
+    match.ts_us = static_cast<uint64_t>(now_us);
+    match.artifact = artifact;
+    match.rssi = static_cast<int8_t>(rssi < -127 ? -127 : rssi > 20 ? 20 : rssi);
+    match.mfr = mfr_len > 0 ? m->buffer : nullptr;
+    match.mfr_len = static_cast<uint8_t>(mfr_len);
+    scan_duty_heard(&m->duty, match.ts_us);
+    return scan_batch_add(&m->batch, &match) ? CHAM_REPORT_FLUSH : CHAM_REPORT_MATCHED;
+}
+
+int32_t cham_matcher_flush(cham_matcher* m, int64_t now_us) {
+    if (now_us < 0) return 0;
+    scan_batch_notice_t notice;
+    if (!scan_batch_flush(&m->batch, static_cast<uint64_t>(now_us), &notice)) return 0;
+    int32_t n = 0;
+    m->buffer[n++] = static_cast<uint8_t>(notice.nearest + 1);
+    for (uint8_t i = 0; i < notice.changed; i++) {
+        const scan_batch_beacon_t* s = notice.beacons[i];
+        if (n + 2 + s->mfr_len > CHAM_MATCHER_BUFFER) break;
+        m->buffer[n++] = static_cast<uint8_t>(s->artifact);
+        m->buffer[n++] = s->mfr_len;
+        memcpy(&m->buffer[n], s->mfr, s->mfr_len);
+        n += s->mfr_len;
+        scan_batch_sent(&m->batch, s);
+    }
+    return n;
+}
+
+int32_t cham_matcher_tick(cham_matcher* m, int64_t now_us) {
+    if (now_us < 0) return CHAM_REPORT_NONE;
+    uint64_t now = static_cast<uint64_t>(now_us);
+    if (scan_batch_due(&m->batch, now)) return CHAM_REPORT_FLUSH;
+    if (!m->batch.open && scan_proximity_tick(&m->batch.proximity, now, nullptr) != m->batch.notified_nearest) {
+        return CHAM_REPORT_FLUSH;
+    }
+    return CHAM_REPORT_NONE;
+}
+
+int32_t cham_matcher_nearest(cham_matcher* m, int64_t now_us) {
+    if (now_us < 0) return m->batch.proximity.nearest;
+    return scan_proximity_tick(&m->batch.proximity, static_cast<uint64_t>(now_us), nullptr);
+}
+
+void cham_matcher_launched(cham_matcher* m, int64_t now_us) {
+    if (now_us >= 0) scan_duty_launched(&m->duty, static_cast<uint64_t>(now_us));
+}
+
+int32_t cham_matcher_scan_mode(cham_matcher* m, int64_t now_us) {
+    scan_mode_t mode;
+    if (now_us < 0 || !scan_duty_poll(&m->duty, static_cast<uint64_t>(now_us), &mode)) return -1;
+    return mode;
+}
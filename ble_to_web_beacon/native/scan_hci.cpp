@@ -0,0 +1,232 @@
+/*
+COS10025 BLE-to-Web Cultural Storytelling System
+HCI advertising report walk and raw-socket backend (see include/scan_hci.h).
+- The BlueZ socket ABI is declared here so the runner builds without the
+  libbluetooth development headers
+*/
+
+#include "scan_hci.h"
+
+#include <string.h>
+
+#define LEGACY_REPORT_FIXED   10 // Event type, address type, address, data length (+ RSSI after data)
+#define EXT_REPORT_FIXED      24 // Up to and including data length
+#define EXT_DATA_STATUS_MASK  0x0060
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Event walk
+int scan_hci_reports(const uint8_t* evt, size_t len, scan_report_cb_t cb, void* arg) {
+    if (len < 4 || evt[0] != SCAN_HCI_EVT_LE_META || static_cast<size_t>(evt[1]) + 2 > len) return 0;
+    uint8_t subevent = evt[2];
+    if (subevent != SCAN_HCI_LE_ADV_REPORT && subevent != SCAN_HCI_LE_EXT_ADV_REPORT) return 0;
+
+    const uint8_t* p = &evt[4];
+    const uint8_t* end = &evt[2 + evt[1]];
+    uint8_t count = evt[3];
+    scan_report_t r;
+    for (uint8_t n = 0; n < count; n++) {
+        if (subevent == SCAN_HCI_LE_ADV_REPORT) {
+            // Event type | address type | address | data length | data | RSSI
+            if (end - p < LEGACY_REPORT_FIXED || end - p < LEGACY_REPORT_FIXED + p[8]) return -1;
+            r.addr_type = p[1];
+            r.addr = &p[2];
+            r.data_len = p[8];
+            r.data = &p[9];
+            r.rssi = static_cast<int8_t>(p[9 + r.data_len]);
+            p += LEGACY_REPORT_FIXED + r.data_len;
+            cb(arg, &r);
+        } else {
+            // Event type (2) | address type | address | PHYs (2) | SID | TX power | RSSI |
+            // periodic interval (2) | direct address type | direct address | data length | data
+            if (end - p < EXT_REPORT_FIXED || end - p < EXT_REPORT_FIXED + p[23]) return -1;
+            uint16_t type = static_cast<uint16_t>(p[0] | p[1] << 8);
+            r.addr_type = p[2];
+            r.addr = &p[3];
+            r.rssi = static_cast<int8_t>(p[13]);
+            r.data_len = p[23];
+            r.data = &p[24];
+            p += EXT_REPORT_FIXED + r.data_len;
+            if ((type & EXT_DATA_STATUS_MASK) == 0) cb(arg, &r);
+        }
+    }
+    return count;
+}
+
+size_t scan_hci_build_report(uint8_t* evt, size_t cap, const uint8_t addr[6], uint8_t addr_type, int8_t rssi,
+                             const uint8_t* data, uint8_t data_len) {
+    size_t len = 4 + LEGACY_REPORT_FIXED + data_len;
+    if (len > cap || len - 2 > 255) return 0;
+    evt[0] = SCAN_HCI_EVT_LE_META;
+    evt[1] = static_cast<uint8_t>(len - 2);
+    evt[2] = SCAN_HCI_LE_ADV_REPORT;
+    evt[3] = 1;
+    uint8_t* p = &evt[4];
+    p[0] = 0x03; // ADV_NONCONN_IND
+    p[1] = addr_type;
+    memcpy(&p[2], addr, 6);
+    p[8] = data_len;
+    memcpy(&p[9], data, data_len);
+    p[9 + data_len] = static_cast<uint8_t>(rssi);
+    return len;
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Live backend
+void scan_hci_init(scan_hci_t* hci, int dev) {
+    hci->dev = dev;
+    hci->interval = 96; // 60 ms
+    hci->window = 96;
+    hci->fd = -1;
+    hci->scan_owned = false;
+}
+
+#if defined(__linux__)
+#include <errno.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#define BTPROTO_HCI         1
+#define SOL_HCI             0
+#define HCI_FILTER          2
+#define HCI_CHANNEL_RAW     0
+
+#define OPCODE_LE_SET_SCAN_PARAMS 0x200B
+#define OPCODE_LE_SET_SCAN_ENABLE 0x200C
+#define CMD_TIMEOUT_MS            1000
+
+struct sockaddr_hci {
+    sa_family_t    hci_family;
+    unsigned short hci_dev;
+    unsigned short hci_channel;
+};
+
+struct hci_filter {
+    uint32_t type_mask;
+    uint32_t event_mask[2];
+    uint16_t opcode;
+};
+
+static uint64_t monotonic_us(void) {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000u + static_cast<uint64_t>(ts.tv_nsec) / 1000u;
+}
+
+static void filter_event(hci_filter* f, uint8_t evt) {
+    f->event_mask[evt >> 5] |= 1u << (evt & 31);
+}
+
+// Raw read of one packet; returns bytes after the H4 type byte, 0 on timeout, -1 on error
+static ssize_t read_event(int fd, uint8_t* buf, size_t cap, int timeout_ms) {
+    pollfd pfd = {fd, POLLIN, 0};
+    int ready = poll(&pfd, 1, timeout_ms);
+    if (ready == 0 || (ready < 0 && errno == EINTR)) return 0;
+    if (ready < 0 || (pfd.revents & (POLLERR | POLLHUP | POLLNVAL))) return -1;
+
+    uint8_t pkt[1 + SCAN_HCI_EVENT_MAX];
+    ssize_t n = read(fd, pkt, sizeof(pkt));
+    if (n < 0) return errno == EAGAIN || errno == EINTR ? 0 : -1;
+    if (n < 3 || pkt[0] != SCAN_HCI_EVENT_PKT || static_cast<size_t>(n - 1) > cap) return 0;
+    memcpy(buf, &pkt[1], static_cast<size_t>(n - 1));
+    return n - 1;
+}
+
+// Send one command and wait for its completion; advertising reports that
+// arrive meanwhile are dropped (the reader has not started yet)
+static bool command(int fd, uint16_t opcode, const uint8_t* params, uint8_t plen) {
+    uint8_t pkt[4 + 8];
+    pkt[0] = SCAN_HCI_COMMAND_PKT;
+    pkt[1] = static_cast<uint8_t>(opcode);
+    pkt[2] = static_cast<uint8_t>(opcode >> 8);
+    pkt[3] = plen;
+    memcpy(&pkt[4], params, plen);
+    if (write(fd, pkt, 4u + plen) != 4 + plen) return false;
+
+    uint64_t deadline = monotonic_us() + CMD_TIMEOUT_MS * 1000u;
+    uint8_t evt[SCAN_HCI_EVENT_MAX];
+    while (monotonic_us() < deadline) {
+        ssize_t n = read_event(fd, evt, sizeof(evt), CMD_TIMEOUT_MS);
+        if (n < 0) return false;
+        // Command Complete: code, len, credits, opcode (2), status
+        if (n >= 6 && evt[0] == SCAN_HCI_EVT_CMD_COMPLETE && (evt[3] | evt[4] << 8) == opcode) return evt[5] == 0;
+        // Command Status: code, len, status, credits, opcode (2)
+        if (n >= 6 && evt[0] == SCAN_HCI_EVT_CMD_STATUS && (evt[4] | evt[5] << 8) == opcode) return false;
+    }
+    return false;
+}
+
+static bool set_scan(int fd, bool enable) {
+    uint8_t params[2] = {static_cast<uint8_t>(enable), 0}; // Duplicate filtering off
+    return command(fd, OPCODE_LE_SET_SCAN_ENABLE, params, sizeof(params));
+}
+
+static scan_err_t hci_start(void* ctx) {
+    scan_hci_t* hci = static_cast<scan_hci_t*>(ctx);
+    int fd = socket(AF_BLUETOOTH, SOCK_RAW | SOCK_CLOEXEC, BTPROTO_HCI);
+    if (fd < 0) return errno == EPERM || errno == EACCES ? SCAN_ERR_NO_PERMISSION : SCAN_ERR_NOT_SUPPORTED;
+
+    // Step 1: Bind to the adapter and let only the events we read through
+    sockaddr_hci addr = {};
+    addr.hci_family = AF_BLUETOOTH;
+    addr.hci_dev = static_cast<unsigned short>(hci->dev);
+    addr.hci_channel = HCI_CHANNEL_RAW;
+    hci_filter filter = {};
+    filter.type_mask = 1u << SCAN_HCI_EVENT_PKT;
+    filter_event(&filter, SCAN_HCI_EVT_CMD_COMPLETE);
+    filter_event(&filter, SCAN_HCI_EVT_CMD_STATUS);
+    filter_event(&filter, SCAN_HCI_EVT_LE_META);
+    if (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 ||
+        setsockopt(fd, SOL_HCI, HCI_FILTER, &filter, sizeof(filter)) < 0) {
+        scan_err_t err = errno == EPERM || errno == EACCES ? SCAN_ERR_NO_PERMISSION : SCAN_ERR_FAIL;
+        close(fd);
+        return err;
+    }
+
+    // Step 2: Passive scan, no duplicate filter. The controller refuses new
+    // parameters while a scan is running (bluetoothd's discovery): that scan is
+    // left alone and the socket listens to its reports instead
+    uint8_t params[7] = {0x00,                                   // Passive
+                         static_cast<uint8_t>(hci->interval), static_cast<uint8_t>(hci->interval >> 8),
+                         static_cast<uint8_t>(hci->window), static_cast<uint8_t>(hci->window >> 8),
+                         0x00,                                   // Own address public
+                         0x00};                                  // Accept all advertisers
+    hci->scan_owned = command(fd, OPCODE_LE_SET_SCAN_PARAMS, params, sizeof(params)) && set_scan(fd, true);
+    hci->fd = fd;
+    return SCAN_OK;
+}
+
+static scan_err_t hci_read(void* ctx, uint8_t* buf, size_t cap, size_t* len, uint64_t* ts_us, int timeout_ms) {
+    scan_hci_t* hci = static_cast<scan_hci_t*>(ctx);
+    ssize_t n = read_event(hci->fd, buf, cap, timeout_ms);
+    if (n < 0) return SCAN_ERR_FAIL; // Adapter removed or powered down
+    *len = static_cast<size_t>(n);
+    *ts_us = monotonic_us();
+    return SCAN_OK;
+}
+
+static void hci_stop(void* ctx) {
+    scan_hci_t* hci = static_cast<scan_hci_t*>(ctx);
+    if (hci->fd < 0) return;
+    if (hci->scan_owned) set_scan(hci->fd, false);
+    close(hci->fd);
+    hci->fd = -1;
+    hci->scan_owned = false;
+}
+#else
+static scan_err_t hci_start(void* ctx) { return SCAN_ERR_NOT_SUPPORTED; }
+static scan_err_t hci_read(void* ctx, uint8_t* buf, size_t cap, size_t* len, uint64_t* ts_us, int timeout_ms) {
+    return SCAN_ERR_NOT_SUPPORTED;
+}
+static void hci_stop(void* ctx) {}
+#endif
+
+scan_backend_t scan_hci_backend(scan_hci_t* hci) {
+    scan_backend_t b = {};
+    b.ctx = hci;
+    b.start = hci_start;
+    b.read = hci_read;
+    b.stop = hci_stop;
+    return b;
+}
@@ -0,0 +1,157 @@
+/*
+COS10025 BLE-to-Web Cultural Storytelling System
+Proximity engine (see include/scan_proximity.h).
+*/
+
+#include "scan_proximity.h"
+
+#include <math.h>
+#include <string.h>
+
+scan_prox_config_t scan_proximity_defaults(scan_prox_filter_t filter) {
+    scan_prox_config_t c;
+    c.filter = filter;
+    c.meas_var = 30.0f;       // ~5.5 dB fading on a handheld phone
+    c.drift_var_per_s = 8.0f; // Walking past a case moves the level by a few dB per second
+    c.ema_alpha = 0.2f;
+    c.floor_dbm = -80.0f;     // ~6 m from a 0 dBm beacon behind glass
+    c.margin_db = 3.0f;
+    c.z = 1.64f;
+    c.min_reports = 3;
+    c.stale_us = 3000000;
+    return c;
+}
+
+void scan_proximity_init(scan_proximity_t* p, const scan_prox_config_t* config) {
+    memset(p, 0, sizeof(*p));
+    p->config = *config;
+    for (scan_prox_track_t& t : p->tracks) t.artifact = -1;
+    p->nearest = -1;
+}
+
+static bool live(const scan_proximity_t* p, const scan_prox_track_t& t, uint64_t now_us) {
+    return t.artifact >= 0 && now_us - t.last_us <= p->config.stale_us;
+}
+
+// Variance of a track's estimate now: a Kalman estimate loses certainty while
+// the beacon is not heard
+static float variance_at(const scan_proximity_t* p, const scan_prox_track_t& t, uint64_t now_us) {
+    if (p->config.filter != SCAN_PROX_KALMAN) return t.var;
+    return t.var + p->config.drift_var_per_s * static_cast<float>(now_us - t.last_us) * 1e-6f;
+}
+
+// Track for `artifact`, taking a free or silent slot. With every slot live
+// the weakest beacon gives way to a stronger one (never the committed one),
+// so a hall with more beacons than slots keeps the nearest ones
+static scan_prox_track_t* track_for(scan_proximity_t* p, int artifact, int8_t rssi, uint64_t now_us) {
+    scan_prox_track_t* reuse = nullptr;
+    for (scan_prox_track_t& t : p->tracks) {
+        if (t.artifact == artifact) return &t;
+        if (!live(p, t, now_us)) reuse = &t;
+    }
+    if (!reuse) {
+        for (scan_prox_track_t& t : p->tracks) {
+            if (t.artifact == p->nearest) continue;
+            if (!reuse || t.est < reuse->est) reuse = &t;
+        }
+        if (!reuse || reuse->est >= rssi) return nullptr;
+    }
+    memset(reuse, 0, sizeof(*reuse));
+    reuse->artifact = static_cast<int16_t>(artifact);
+    return reuse;
+}
+
+static void filter_report(const scan_prox_config_t& c, scan_prox_track_t* t, float rssi, uint64_t now_us) {
+    if (t->reports == 0) {
+        t->est = rssi;
+        t->var = c.meas_var;
+        t->ema_sq = c.meas_var;
+    } else if (c.filter == SCAN_PROX_KALMAN) {
+        float predicted = t->var + c.drift_var_per_s * static_cast<float>(now_us - t->last_us) * 1e-6f;
+        float gain = predicted / (predicted + c.meas_var);
+        t->est += gain * (rssi - t->est);
+        t->var = (1.0f - gain) * predicted;
+    } else {
+        // Exponentially weighted mean and variance; the mean of n reports is
+        // no better known than a plain average of n
+        float d = rssi - t->est;
+        t->est += c.ema_alpha * d;
+        t->ema_sq = (1.0f - c.ema_alpha) * (t->ema_sq + c.ema_alpha * d * d);
+        float n = static_cast<float>(t->reports + 1);
+        float weight = c.ema_alpha / (2.0f - c.ema_alpha);
+        t->var = t->ema_sq * (weight > 1.0f / n ? weight : 1.0f / n);
+    }
+    if (t->reports < UINT16_MAX) t->reports++;
+    t->last_us = now_us;
+}
+
+// Does `a` lead `b` (nullptr: the floor) by `margin` plus z standard deviations
+static bool leads(const scan_proximity_t* p, const scan_prox_track_t& a, const scan_prox_track_t* b, float margin,
+                  uint64_t now_us) {
+    float rival = b ? b->est : p->config.floor_dbm;
+    float var = variance_at(p, a, now_us) + (b ? variance_at(p, *b, now_us) : 0.0f);
+    return a.est - rival >= margin + p->config.z * sqrtf(var);
+}
+
+static int decide(scan_proximity_t* p, uint64_t now_us, bool* changed) {
+    const scan_prox_config_t& c = p->config;
+    int before = p->nearest;
+
+    // Step 1: Forget silent beacons (the committed one included)
+    const scan_prox_track_t* committed = nullptr;
+    for (scan_prox_track_t& t : p->tracks) {
+        if (t.artifact < 0) continue;
+        if (!live(p, t, now_us)) t.artifact = -1;
+        else if (t.artifact == p->nearest) committed = &t;
+    }
+    if (!committed) p->nearest = -1;
+
+    // Step 2: Strongest candidate and the strongest beacon behind it
+    const scan_prox_track_t* best = nullptr;
+    for (const scan_prox_track_t& t : p->tracks) {
+        if (t.artifact < 0 || t.reports < c.min_reports || t.est < c.floor_dbm) continue;
+        if (!best || t.est > best->est) best = &t;
+    }
+    if (best && best != committed) {
+        const scan_prox_track_t* second = nullptr;
+        for (const scan_prox_track_t& t : p->tracks) {
+            if (t.artifact < 0 || &t == best) continue;
+            if (!second || t.est > second->est) second = &t;
+        }
+
+        // Step 3: Commit when confident; replacing a committed artifact also
+        // takes the hysteresis margin over it
+        bool confident = leads(p, *best, second, 0.0f, now_us) && leads(p, *best, nullptr, 0.0f, now_us);
+        if (confident && committed) confident = leads(p, *best, committed, c.margin_db, now_us);
+        if (confident) {
+            p->nearest = best->artifact;
+            p->nearest_us = now_us;
+            p->commits++;
+        }
+    }
+
+    if (changed) *changed = p->nearest != before;
+    return p->nearest;
+}
+
+int scan_proximity_update(scan_proximity_t* p, int artifact, int8_t rssi, uint64_t now_us, bool* changed) {
+    if (artifact >= 0 && artifact <= INT16_MAX) {
+        scan_prox_track_t* t = track_for(p, artifact, rssi, now_us);
+        if (t) filter_report(p->config, t, rssi, now_us);
+    }
+    return decide(p, now_us, changed);
+}
+
+int scan_proximity_tick(scan_proximity_t* p, uint64_t now_us, bool* changed) {
+    return decide(p, now_us, changed);
+}
+
+bool scan_proximity_estimate(const scan_proximity_t* p, int artifact, float* est_dbm) {
+    for (const scan_prox_track_t& t : p->tracks) {
+        if (t.artifact >= 0 && t.artifact == artifact) {
+            *est_dbm = t.est;
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,188 @@
+/*
+COS10025 BLE-to-Web Cultural Storytelling System
+btsnoop replay backend and capture writer (see include/scan_replay.h).
+- btsnoop: 16-byte file header ("btsnoop\0", version 1, datalink), then one
+  24-byte record header per packet, all fields big-endian; timestamps are
+  microseconds since year 0
+*/
+
+#include "scan_replay.h"
+
+#include <chrono>
+#include <string.h>
+#include <thread>
+
+#define BTSNOOP_MAGIC          "btsnoop"
+#define BTSNOOP_VERSION        1
+#define BTSNOOP_EPOCH_DELTA_US 0x00dcddb30f2f8000ULL // Year 0 → 1970
+#define H4_FLAG_RECEIVED       0x01
+#define H4_FLAG_COMMAND_EVENT  0x02
+#define MONITOR_OPCODE_EVENT   3
+
+static uint32_t get_be32(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) << 24 | static_cast<uint32_t>(p[1]) << 16 |
+           static_cast<uint32_t>(p[2]) << 8 | p[3];
+}
+
+static void put_be32(uint8_t* p, uint32_t v) {
+    p[0] = static_cast<uint8_t>(v >> 24);
+    p[1] = static_cast<uint8_t>(v >> 16);
+    p[2] = static_cast<uint8_t>(v >> 8);
+    p[3] = static_cast<uint8_t>(v);
+}
+
+static uint64_t wall_us(void) {
+    using namespace std::chrono;
+    return static_cast<uint64_t>(duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count());
+}
+
+scan_err_t scan_replay_open(scan_replay_t* replay, const char* path, double speed) {
+    memset(replay, 0, sizeof(*replay));
+    replay->speed = speed;
+    replay->monitor_index = -1;
+    replay->f = fopen(path, "rb");
+    if (!replay->f) return SCAN_ERR_FAIL;
+
+    uint8_t hdr[16];
+    if (fread(hdr, 1, sizeof(hdr), replay->f) != sizeof(hdr) || memcmp(hdr, BTSNOOP_MAGIC, 8) != 0 ||
+        get_be32(&hdr[8]) != BTSNOOP_VERSION) {
+        scan_replay_close(replay);
+        return SCAN_ERR_FORMAT;
+    }
+    replay->datalink = get_be32(&hdr[12]);
+    if (replay->datalink != SCAN_BTSNOOP_H4 && replay->datalink != SCAN_BTSNOOP_MONITOR) {
+        scan_replay_close(replay);
+        return SCAN_ERR_FORMAT;
+    }
+    return SCAN_OK;
+}
+
+void scan_replay_close(scan_replay_t* replay) {
+    if (replay->f) fclose(replay->f);
+    replay->f = nullptr;
+}
+
+// Next received HCI event into replay->pending; SCAN_ERR_END at the end of the file
+static scan_err_t next_event(scan_replay_t* replay) {
+    uint8_t rec[24];
+    uint8_t pkt[1 + SCAN_HCI_EVENT_MAX];
+    while (fread(rec, 1, sizeof(rec), replay->f) == sizeof(rec)) {
+        uint32_t incl = get_be32(&rec[4]);
+        uint32_t flags = get_be32(&rec[8]);
+        uint64_t ts = static_cast<uint64_t>(get_be32(&rec[16])) << 32 | get_be32(&rec[20]);
+        replay->records++;
+        if (incl > sizeof(pkt)) {
+            if (fseek(replay->f, incl, SEEK_CUR) != 0) break;
+            continue;
+        }
+        if (fread(pkt, 1, incl, replay->f) != incl) break;
+
+        const uint8_t* evt = pkt;
+        size_t len = incl;
+        if (replay->datalink == SCAN_BTSNOOP_H4) {
+            if ((flags & (H4_FLAG_RECEIVED | H4_FLAG_COMMAND_EVENT)) != (H4_FLAG_RECEIVED | H4_FLAG_COMMAND_EVENT) ||
+                len < 3 || pkt[0] != SCAN_HCI_EVENT_PKT) {
+                continue;
+            }
+            evt++;
+            len--;
+        } else {
+            int index = static_cast<int>(flags >> 16);
+            if ((flags & 0xFFFF) != MONITOR_OPCODE_EVENT || len < 2) continue;
+            if (replay->monitor_index < 0) replay->monitor_index = index;
+            if (index != replay->monitor_index) continue;
+        }
+        // Monitor records keep every byte; reject anything that does not fit or disagrees with its own header
+        if (len > sizeof(replay->pending) || len != static_cast<size_t>(evt[1]) + 2) continue;
+
+        if (!replay->started) {
+            replay->first_ts_us = ts;
+            replay->started = true;
+        }
+        memcpy(replay->pending, evt, len);
+        replay->pending_len = len;
+        replay->pending_ts_us = ts - replay->first_ts_us;
+        replay->has_pending = true;
+        return SCAN_OK;
+    }
+    return SCAN_ERR_END;
+}
+
+static scan_err_t replay_start(void* ctx) {
+    scan_replay_t* replay = static_cast<scan_replay_t*>(ctx);
+    replay->start_us = wall_us();
+    return replay->f ? SCAN_OK : SCAN_ERR_FAIL;
+}
+
+static scan_err_t replay_read(void* ctx, uint8_t* buf, size_t cap, size_t* len, uint64_t* ts_us, int timeout_ms) {
+    scan_replay_t* replay = static_cast<scan_replay_t*>(ctx);
+    *len = 0;
+    if (!replay->has_pending) {
+        scan_err_t err = next_event(replay);
+        if (err != SCAN_OK) return err;
+    }
+
+    // Recorded timing: wait until the event is due, at most timeout_ms per call
+    if (replay->speed > 0) {
+        uint64_t due = replay->start_us + static_cast<uint64_t>(replay->pending_ts_us / replay->speed);
+        uint64_t now = wall_us();
+        if (due > now) {
+            uint64_t wait = due - now;
+            if (wait > static_cast<uint64_t>(timeout_ms) * 1000) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(timeout_ms));
+                return SCAN_OK;
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(wait));
+        }
+    }
+
+    if (replay->pending_len > cap) return SCAN_ERR_INVALID_ARG;
+    memcpy(buf, replay->pending, replay->pending_len);
+    *len = replay->pending_len;
+    *ts_us = replay->pending_ts_us;
+    replay->has_pending = false;
+    return SCAN_OK;
+}
+
+static void replay_stop(void*) {}
+
+scan_backend_t scan_replay_backend(scan_replay_t* replay) {
+    scan_backend_t b = {};
+    b.ctx = replay;
+    b.start = replay_start;
+    b.read = replay_read;
+    b.stop = replay_stop;
+    return b;
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Capture writer
+scan_err_t scan_capture_open(scan_capture_t* capture, const char* path) {
+    capture->f = fopen(path, "wb");
+    if (!capture->f) return SCAN_ERR_FAIL;
+    uint8_t hdr[16] = {'b', 't', 's', 'n', 'o', 'o', 'p', 0};
+    put_be32(&hdr[8], BTSNOOP_VERSION);
+    put_be32(&hdr[12], SCAN_BTSNOOP_H4);
+    fwrite(hdr, 1, sizeof(hdr), capture->f);
+    return SCAN_OK;
+}
+
+void scan_capture_event(scan_capture_t* capture, const uint8_t* evt, size_t len, uint64_t ts_us) {
+    uint8_t rec[24 + 1 + SCAN_HCI_EVENT_MAX];
+    if (len > SCAN_HCI_EVENT_MAX) return;
+    uint64_t ts = BTSNOOP_EPOCH_DELTA_US + ts_us;
+    put_be32(&rec[0], static_cast<uint32_t>(len + 1));
+    put_be32(&rec[4], static_cast<uint32_t>(len + 1));
+    put_be32(&rec[8], H4_FLAG_RECEIVED | H4_FLAG_COMMAND_EVENT);
+    put_be32(&rec[12], 0);
+    put_be32(&rec[16], static_cast<uint32_t>(ts >> 32));
+    put_be32(&rec[20], static_cast<uint32_t>(ts));
+    rec[24] = SCAN_HCI_EVENT_PKT;
+    memcpy(&rec[25], evt, len);
+    fwrite(rec, 1, 25 + len, capture->f);
+}
+
+void scan_capture_close(scan_capture_t* capture) {
+    if (capture->f) fclose(capture->f);
+    capture->f = nullptr;
+}
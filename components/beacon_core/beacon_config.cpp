@@ -0,0 +1,59 @@
+/*
+COS10025 BLE-to-Web Cultural Storytelling System
+Beacon runtime configuration helpers (see include/beacon_config.h).
+*/
+
+#include "beacon_config.h"
+
+#include <string.h>
+
+// Legal ADV_NONCONN_IND interval range (Core spec, 0.625 ms units)
+#define ADV_INTERVAL_LOWEST  0x0020
+#define ADV_INTERVAL_HIGHEST 0x4000
+
+beacon_config_t beacon_config_defaults(uint32_t artifact_id, const char* name,
+                                       beacon_payload_format_t format) {
+    beacon_config_t config = {};
+    config.version        = BEACON_CONFIG_VERSION;
+    config.payload_format = static_cast<uint8_t>(format);
+    config.channel_map    = BEACON_ADV_CHANNEL_ALL;
+    config.tx_power_dbm   = BEACON_DEFAULT_TX_POWER_DBM;
+    config.artifact_id    = artifact_id;
+    config.interval_min   = BEACON_DEFAULT_INTERVAL_MIN;
+    config.interval_max   = BEACON_DEFAULT_INTERVAL_MAX;
+    if (name) strncpy(config.name, name, BEACON_CONFIG_NAME_MAX);
+    return config;
+}
+
+bool beacon_config_is_valid(const beacon_config_t* config) {
+    if (config->version != BEACON_CONFIG_VERSION) return false;
+    if (config->channel_map == 0 || (config->channel_map & ~BEACON_ADV_CHANNEL_ALL)) return false;
+    if (config->interval_min < ADV_INTERVAL_LOWEST || config->interval_max > ADV_INTERVAL_HIGHEST) return false;
+    if (config->interval_min > config->interval_max) return false;
+    if (memchr(config->name, '\0', sizeof(config->name)) == nullptr) return false;
+
+    switch (config->payload_format) {
+    case BEACON_PAYLOAD_COMPACT:
+        return beacon_encode_compact(config->artifact_id).len != 0;
+    case BEACON_PAYLOAD_NAME:
+        return config->name[0] != '\0';
+    default:
+        return false;
+    }
+}
+
+beacon_payload_t beacon_config_payload(const beacon_config_t* config) {
+    if (config->payload_format == BEACON_PAYLOAD_COMPACT) return beacon_encode_compact(config->artifact_id);
+
+    beacon_payload_t payload = {};
+    payload.len = beacon_build_name_adv_data(config->name, payload.bytes, sizeof(payload.bytes));
+    return payload;
+}
+
+beacon_adv_params_t beacon_config_adv_params(const beacon_config_t* config) {
+    beacon_adv_params_t params = {};
+    params.interval_min = config->interval_min;
+    params.interval_max = config->interval_max;
+    params.channel_map  = config->channel_map;
+    return params;
+}
@@ -0,0 +1,497 @@
+/*
+COS10025 BLE-to-Web Cultural Storytelling System
+Beacon core implementation (see include/beacon_core.h).
+*/
+
+#include "beacon_core.h"
+#include "beacon_config.h"
+
+#include <string.h>
+
+// Spec upper bound of the pseudo-random advDelay added to every interval
+#define ADV_DELAY_MAX_US 10000
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Event sink registered with the backend
+// - Forwards every backend event to the beacon state handler
+static void beacon_event_sink(void* arg, const beacon_event_t* event) {
+    beacon_handle_event(static_cast<beacon_t*>(arg), event);
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Build the raw advertising payload
+// - AD 1: Flags (general discoverable, BR/EDR not supported)
+// - AD 2: Complete Local Name (artifact name, as matched by the mobile app)
+uint8_t beacon_build_name_adv_data(const char* name, uint8_t* out, uint8_t cap) {
+    size_t name_len = name ? strlen(name) : 0;
+    size_t total = 3 + 2 + name_len;
+    if (name_len == 0 || total > cap || total > BEACON_ADV_PAYLOAD_MAX) return 0;
+
+    uint8_t* p = out;
+    *p++ = 2;                                   // Length of flags AD
+    *p++ = BEACON_AD_TYPE_FLAGS;
+    *p++ = BEACON_AD_FLAGS_GEN_DISC_NO_BREDR;
+    *p++ = static_cast<uint8_t>(name_len + 1);  // Length of name AD (type + name)
+    *p++ = BEACON_AD_TYPE_COMPLETE_NAME;
+    memcpy(p, name, name_len);
+    return static_cast<uint8_t>(total);
+}
+
+beacon_adv_params_t beacon_default_adv_params(void) {
+    beacon_adv_params_t params = {};
+    params.interval_min = BEACON_DEFAULT_INTERVAL_MIN;
+    params.interval_max = BEACON_DEFAULT_INTERVAL_MAX;
+    params.channel_map  = BEACON_ADV_CHANNEL_ALL;
+    return params;
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// State machine helpers
+static uint64_t now_us(const beacon_t* beacon) {
+    return beacon->backend->now_us(beacon->backend->ctx);
+}
+
+static void set_state(beacon_t* beacon, beacon_state_t state) {
+    beacon->state = state;
+    if (beacon->on_state) beacon->on_state(beacon, state, beacon->on_state_arg);
+}
+
+static void mark(beacon_t* beacon, beacon_mark_t m, uint64_t t_us) {
+    beacon->marks_us[m] = t_us;
+}
+
+// A step failed: arm the backoff timer, or give up once retries are exhausted
+static void fail_step(beacon_t* beacon, beacon_step_t step, beacon_err_t err) {
+    beacon->retry_step = step;
+    beacon->last_error = err;
+    if (beacon->retry_count >= BEACON_RETRY_MAX) {
+        set_state(beacon, BEACON_STATE_ERROR);
+        return;
+    }
+
+    uint64_t backoff = static_cast<uint64_t>(BEACON_RETRY_BASE_US) << beacon->retry_count;
+    if (backoff > BEACON_RETRY_MAX_US) backoff = BEACON_RETRY_MAX_US;
+    beacon->retry_count++;
+    beacon->retry_total++;
+
+    set_state(beacon, BEACON_STATE_RETRY_WAIT);
+    beacon->backend->schedule(beacon->backend->ctx, backoff);
+}
+
+static void push_start(beacon_t* beacon) {
+    const beacon_backend_t* be = beacon->backend;
+    set_state(beacon, BEACON_STATE_START_PENDING);
+    beacon_err_t ret = be->start_advertising(be->ctx, &beacon->adv_params);
+    if (ret != BEACON_OK) fail_step(beacon, BEACON_STEP_START, ret);
+}
+
+static void push_config(beacon_t* beacon) {
+    const beacon_backend_t* be = beacon->backend;
+    set_state(beacon, BEACON_STATE_CONFIG_PENDING);
+    beacon_err_t ret = be->set_adv_data(be->ctx, beacon_adv_data(beacon), beacon_adv_len(beacon));
+    if (ret != BEACON_OK) fail_step(beacon, BEACON_STEP_CONFIG, ret);
+}
+
+// Hand the standby buffer to the controller; it becomes active on completion
+static beacon_err_t issue_swap(beacon_t* beacon) {
+    const beacon_backend_t* be = beacon->backend;
+    uint8_t standby = beacon->adv_active ^ 1;
+    beacon_swap_t* swap = &beacon->swap;
+    swap->queued = false;
+    swap->issued_us = now_us(beacon);
+    // The TX power travels with its payload; one already in flight carries over
+    // to a later payload that brings none
+    if (swap->tx_queued) {
+        swap->tx_pending = true;
+        swap->tx_pending_dbm = swap->tx_queued_dbm;
+        swap->tx_queued = false;
+    }
+    beacon_err_t ret = be->set_adv_data(be->ctx, beacon->adv_buf[standby], beacon->adv_buf_len[standby]);
+    if (ret != BEACON_OK) {
+        swap->failed++;
+        swap->tx_pending = false;
+        return ret;
+    }
+    swap->pending = true;
+    return BEACON_OK;
+}
+
+static void complete_swap(beacon_t* beacon, const beacon_event_t* event) {
+    beacon_swap_t* swap = &beacon->swap;
+    swap->pending = false;
+    if (event->status == BEACON_OK) {
+        beacon_hist_add(&swap->latency, static_cast<uint32_t>(event->timestamp_us - swap->issued_us));
+        swap->completed++;
+        swap->gap_armed = true;
+        // With a newer payload queued the standby buffer no longer holds what
+        // went on air; the flip waits for the queued swap
+        if (!swap->queued) {
+            beacon->adv_active ^= 1;
+            // Its TX power goes with it, now that the payload is on air
+            if (swap->tx_pending && swap->tx_pending_dbm != beacon->tx_power_dbm) {
+                const beacon_backend_t* be = beacon->backend;
+                beacon->tx_power_dbm = swap->tx_pending_dbm;
+                be->set_tx_power(be->ctx, beacon->tx_power_dbm);
+            }
+            swap->tx_pending = false;
+        }
+    } else {
+        swap->failed++;
+    }
+    // A TX power whose payload was overtaken waits for the queued one
+    if (swap->tx_pending && swap->queued && !swap->tx_queued) {
+        swap->tx_queued = true;
+        swap->tx_queued_dbm = swap->tx_pending_dbm;
+    }
+    swap->tx_pending = false;
+    if (swap->queued && beacon->state == BEACON_STATE_ADVERTISING) issue_swap(beacon);
+}
+
+// Gap between two advertising events while a swap was in flight or just completed
+static void record_swap_gap(beacon_t* beacon, uint32_t gap_us) {
+    beacon_swap_t* swap = &beacon->swap;
+    if (!swap->pending && !swap->gap_armed) return;
+    swap->gap_armed = false;
+    if (gap_us > swap->gap_max_us) swap->gap_max_us = gap_us;
+    if (gap_us > beacon->adv_params.interval_max * 625u + ADV_DELAY_MAX_US) swap->gaps_missed++;
+}
+
+// Run the remaining stack stages; a failed stage is resumed, not restarted
+static void run_stack(beacon_t* beacon) {
+    const beacon_backend_t* be = beacon->backend;
+    set_state(beacon, BEACON_STATE_STACK_INIT);
+    while (beacon->next_stage < BEACON_STAGE_COUNT) {
+        beacon_stack_stage_t stage = static_cast<beacon_stack_stage_t>(beacon->next_stage);
+        beacon_err_t ret = be->stack_stage(be->ctx, stage);
+        if (ret != BEACON_OK) {
+            fail_step(beacon, BEACON_STEP_STACK, ret);
+            return;
+        }
+        mark(beacon, static_cast<beacon_mark_t>(BEACON_MARK_CONTROLLER_INIT + stage), now_us(beacon));
+        beacon->next_stage++;
+        beacon->retry_count = 0;
+    }
+
+    // TX power is a local controller setting: a failure keeps the default level
+    be->set_tx_power(be->ctx, beacon->tx_power_dbm);
+    push_config(beacon);
+}
+
+static void resume_step(beacon_t* beacon) {
+    switch (beacon->retry_step) {
+    case BEACON_STEP_STACK:  run_stack(beacon); break;
+    case BEACON_STEP_CONFIG: push_config(beacon); break;
+    case BEACON_STEP_START:  push_start(beacon); break;
+    }
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Beacon lifecycle
+beacon_err_t beacon_init(beacon_t* beacon, const beacon_backend_t* backend,
+                         const uint8_t* adv_data, uint8_t adv_len) {
+    if (!beacon || !backend || !adv_data) return BEACON_ERR_INVALID_ARG;
+    if (adv_len == 0 || adv_len > BEACON_ADV_PAYLOAD_MAX) return BEACON_ERR_INVALID_ARG;
+
+    memset(beacon, 0, sizeof(*beacon));
+    beacon->backend = backend;
+    beacon->adv_params = beacon_default_adv_params();
+    beacon->tx_power_dbm = BEACON_DEFAULT_TX_POWER_DBM;
+    memcpy(beacon->adv_buf[0], adv_data, adv_len);
+    beacon->adv_buf_len[0] = adv_len;
+    beacon->adv_active = 0;
+    beacon_hist_init(&beacon->swap.latency, 0, BEACON_SWAP_LATENCY_BUCKET_US);
+
+    beacon->state = BEACON_STATE_IDLE;
+    return BEACON_OK;
+}
+
+void beacon_set_state_callback(beacon_t* beacon, beacon_state_cb_t cb, void* arg) {
+    beacon->on_state = cb;
+    beacon->on_state_arg = arg;
+}
+
+void beacon_set_profile(beacon_t* beacon, const beacon_adv_params_t* params, int8_t tx_power_dbm) {
+    beacon->adv_params = *params;
+    beacon->tx_power_dbm = tx_power_dbm;
+}
+
+beacon_err_t beacon_start(beacon_t* beacon) {
+    if (beacon->state != BEACON_STATE_IDLE) return BEACON_ERR_INVALID_STATE;
+
+    const beacon_backend_t* be = beacon->backend;
+    mark(beacon, BEACON_MARK_START, now_us(beacon));
+    beacon_hist_init_adv_gap(&beacon->adv_gap_hist, beacon->adv_params.interval_min,
+                             beacon->adv_params.interval_max);
+
+    // Events (GAP completions, backoff timer) are routed to the state machine
+    be->register_event_sink(be->ctx, beacon_event_sink, beacon);
+
+    // Stack stages run synchronously here; payload and enable complete through events
+    beacon->next_stage = 0;
+    run_stack(beacon);
+    return BEACON_OK;
+}
+
+beacon_err_t beacon_stop(beacon_t* beacon) {
+    if (beacon->state != BEACON_STATE_ADVERTISING) return BEACON_ERR_INVALID_STATE;
+
+    const beacon_backend_t* be = beacon->backend;
+    set_state(beacon, BEACON_STATE_STOP_PENDING);
+    beacon_err_t ret = be->stop_advertising(be->ctx);
+    if (ret != BEACON_OK) set_state(beacon, BEACON_STATE_ADVERTISING);
+    return ret;
+}
+
+beacon_err_t beacon_change_profile(beacon_t* beacon, const beacon_adv_params_t* params) {
+    if (!params || params->interval_min == 0 || params->interval_min > params->interval_max) {
+        return BEACON_ERR_INVALID_ARG;
+    }
+    beacon->adv_params = *params;
+    if (beacon->state != BEACON_STATE_ADVERTISING) return BEACON_OK; // Used by the next push_start
+
+    beacon->restart_pending = true;
+    beacon_err_t ret = beacon_stop(beacon);
+    if (ret != BEACON_OK) beacon->restart_pending = false;
+    return ret;
+}
+
+beacon_err_t beacon_resume(beacon_t* beacon) {
+    if (beacon->state != BEACON_STATE_STOPPED) return BEACON_ERR_INVALID_STATE;
+    push_start(beacon);
+    return BEACON_OK;
+}
+
+beacon_err_t beacon_restart(beacon_t* beacon) {
+    if (beacon->state == BEACON_STATE_IDLE) return BEACON_ERR_INVALID_STATE;
+
+    const beacon_backend_t* be = beacon->backend;
+    beacon_err_t ret = be->stack_reset(be->ctx);
+    if (ret != BEACON_OK) return ret;
+
+    // Completions still in flight died with the stack: a swap that was
+    // pending is pushed again once advertising is back
+    beacon_swap_t* swap = &beacon->swap;
+    if (swap->pending) {
+        swap->pending = false;
+        swap->queued = true;
+        if (swap->tx_pending && !swap->tx_queued) {
+            swap->tx_queued = true;
+            swap->tx_queued_dbm = swap->tx_pending_dbm;
+        }
+        swap->tx_pending = false;
+    }
+    beacon->restart_pending = false;
+    beacon->retry_count = 0;
+    beacon->restarts++;
+
+    // The startup timeline is that of the restart
+    memset(beacon->marks_us, 0, sizeof(beacon->marks_us));
+    mark(beacon, BEACON_MARK_START, now_us(beacon));
+    beacon->next_stage = 0;
+    run_stack(beacon);
+    return BEACON_OK;
+}
+
+beacon_err_t beacon_probe(beacon_t* beacon) {
+    const beacon_backend_t* be = beacon->backend;
+    if (!be->probe) return BEACON_ERR_NOT_SUPPORTED;
+    if (beacon->state != BEACON_STATE_ADVERTISING) return BEACON_ERR_INVALID_STATE;
+    return be->probe(be->ctx);
+}
+
+// tx_dbm: TX power to apply with the payload, nullptr to keep the current one
+static beacon_err_t update_payload(beacon_t* beacon, const uint8_t* adv_data, uint8_t adv_len,
+                                   const int8_t* tx_dbm) {
+    if (!adv_data || adv_len == 0 || adv_len > BEACON_ADV_PAYLOAD_MAX) return BEACON_ERR_INVALID_ARG;
+    beacon_swap_t* swap = &beacon->swap;
+    swap->requested++;
+
+    // Step 1: Payload not pushed yet (or pushed again on retry): replace it directly
+    beacon_state_t state = beacon->state;
+    bool pushed = state == BEACON_STATE_CONFIG_PENDING || state == BEACON_STATE_START_PENDING ||
+                  state == BEACON_STATE_ADVERTISING || state == BEACON_STATE_STOP_PENDING ||
+                  state == BEACON_STATE_STOPPED ||
+                  (state == BEACON_STATE_RETRY_WAIT && beacon->retry_step == BEACON_STEP_START);
+    if (!pushed) {
+        memcpy(beacon->adv_buf[beacon->adv_active], adv_data, adv_len);
+        beacon->adv_buf_len[beacon->adv_active] = adv_len;
+        if (tx_dbm) beacon->tx_power_dbm = *tx_dbm; // Set by run_stack() with the first push
+        return BEACON_OK;
+    }
+
+    // Step 2: Stage into the standby buffer; the active one stays untouched on air
+    uint8_t standby = beacon->adv_active ^ 1;
+    if (swap->queued) swap->coalesced++;
+    memcpy(beacon->adv_buf[standby], adv_data, adv_len);
+    beacon->adv_buf_len[standby] = adv_len;
+    swap->queued = true;
+    if (tx_dbm) {
+        swap->tx_queued = true;
+        swap->tx_queued_dbm = *tx_dbm;
+    }
+
+    // Step 3: Swap now, or after the in-flight swap / advertising start completes
+    if (state != BEACON_STATE_ADVERTISING || swap->pending) return BEACON_OK;
+    return issue_swap(beacon);
+}
+
+beacon_err_t beacon_update_payload(beacon_t* beacon, const uint8_t* adv_data, uint8_t adv_len) {
+    return update_payload(beacon, adv_data, adv_len, nullptr);
+}
+
+beacon_err_t beacon_update_payload_tx(beacon_t* beacon, const uint8_t* adv_data, uint8_t adv_len,
+                                      int8_t tx_power_dbm) {
+    return update_payload(beacon, adv_data, adv_len, &tx_power_dbm);
+}
+
+void beacon_handle_event(beacon_t* beacon, const beacon_event_t* event) {
+    switch (event->type) {
+    case BEACON_EVT_ADV_DATA_SET_COMPLETE:
+        // Completions arrive in issue order: a pending swap owns the next one
+        if (beacon->swap.pending) {
+            complete_swap(beacon, event);
+            break;
+        }
+        if (beacon->state != BEACON_STATE_CONFIG_PENDING) break; // Stale
+        if (event->status != BEACON_OK) {
+            fail_step(beacon, BEACON_STEP_CONFIG, event->status);
+            break;
+        }
+        mark(beacon, BEACON_MARK_ADV_DATA_SET, event->timestamp_us);
+        beacon->retry_count = 0;
+        push_start(beacon);
+        break;
+
+    case BEACON_EVT_ADV_START_COMPLETE:
+        if (beacon->state != BEACON_STATE_START_PENDING) break;
+        if (event->status != BEACON_OK) {
+            fail_step(beacon, BEACON_STEP_START, event->status);
+            break;
+        }
+        mark(beacon, BEACON_MARK_ADV_STARTED, event->timestamp_us);
+        beacon->retry_count = 0;
+        set_state(beacon, BEACON_STATE_ADVERTISING);
+        if (beacon->swap.queued && !beacon->swap.pending) issue_swap(beacon); // Updated during startup
+        break;
+
+    case BEACON_EVT_ADV_STOP_COMPLETE:
+        if (beacon->state != BEACON_STATE_STOP_PENDING) break;
+        if (event->status != BEACON_OK) {
+            beacon->restart_pending = false; // Old profile keeps running
+            set_state(beacon, BEACON_STATE_ADVERTISING);
+        } else if (beacon->restart_pending) {
+            beacon->restart_pending = false;
+            push_start(beacon);
+        } else {
+            set_state(beacon, BEACON_STATE_STOPPED);
+        }
+        break;
+
+    case BEACON_EVT_ADV_SENT:
+        if (beacon->adv_event_count == 0) {
+            mark(beacon, BEACON_MARK_FIRST_ADV, event->timestamp_us);
+        } else {
+            uint32_t gap = static_cast<uint32_t>(event->timestamp_us - beacon->last_adv_us);
+            beacon_hist_add(&beacon->adv_gap_hist, gap);
+            record_swap_gap(beacon, gap);
+        }
+        beacon->last_adv_us = event->timestamp_us;
+        beacon->adv_event_count++;
+        break;
+
+    case BEACON_EVT_TIMER:
+        if (beacon->state == BEACON_STATE_RETRY_WAIT) resume_step(beacon);
+        break;
+
+    case BEACON_EVT_PROBE_COMPLETE:
+        if (event->status == BEACON_OK) beacon->probes_completed++;
+        break;
+    }
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Reporting helpers
+const uint8_t* beacon_adv_data(const beacon_t* beacon) {
+    return beacon->adv_buf[beacon->adv_active];
+}
+
+uint8_t beacon_adv_len(const beacon_t* beacon) {
+    return beacon->adv_buf_len[beacon->adv_active];
+}
+
+void beacon_swap_print(const beacon_t* beacon, FILE* out) {
+    const beacon_swap_t* swap = &beacon->swap;
+    fprintf(out, "payload swaps: %lu requested, %lu completed, %lu coalesced, %lu failed, "
+                 "latency p50 %lu us p99 %lu us, gap max %lu us, %lu missed events\n",
+            (unsigned long)swap->requested, (unsigned long)swap->completed, (unsigned long)swap->coalesced,
+            (unsigned long)swap->failed, (unsigned long)beacon_hist_percentile(&swap->latency, 0.50),
+            (unsigned long)beacon_hist_percentile(&swap->latency, 0.99), (unsigned long)swap->gap_max_us,
+            (unsigned long)swap->gaps_missed);
+}
+
+uint64_t beacon_mark_elapsed_us(const beacon_t* beacon, beacon_mark_t m) {
+    if (beacon->marks_us[m] == 0) return 0;
+    return beacon->marks_us[m] - beacon->marks_us[BEACON_MARK_START];
+}
+
+const char* beacon_mark_name(beacon_mark_t m) {
+    switch (m) {
+    case BEACON_MARK_START:             return "start";
+    case BEACON_MARK_CONTROLLER_INIT:   return "controller_init";
+    case BEACON_MARK_CONTROLLER_ENABLE: return "controller_enable";
+    case BEACON_MARK_HOST_INIT:         return "host_init";
+    case BEACON_MARK_HOST_ENABLE:       return "host_enable";
+    case BEACON_MARK_GAP_REGISTER:      return "gap_register";
+    case BEACON_MARK_ADV_DATA_SET:      return "adv_data_set";
+    case BEACON_MARK_ADV_STARTED:       return "adv_started";
+    case BEACON_MARK_FIRST_ADV:         return "first_adv";
+    default:                            return "?";
+    }
+}
+
+const char* beacon_state_name(beacon_state_t state) {
+    switch (state) {
+    case BEACON_STATE_IDLE:           return "IDLE";
+    case BEACON_STATE_STACK_INIT:     return "STACK_INIT";
+    case BEACON_STATE_CONFIG_PENDING: return "CONFIG_PENDING";
+    case BEACON_STATE_START_PENDING:  return "START_PENDING";
+    case BEACON_STATE_ADVERTISING:    return "ADVERTISING";
+    case BEACON_STATE_STOP_PENDING:   return "STOP_PENDING";
+    case BEACON_STATE_STOPPED:        return "STOPPED";
+    case BEACON_STATE_RETRY_WAIT:     return "RETRY_WAIT";
+    case BEACON_STATE_ERROR:          return "ERROR";
+    default:                          return "?";
+    }
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Signalling
+static const beacon_signal_pattern_t s_signal_patterns[BEACON_SIGNAL_COUNT] = {
+    {"off",         0,   1000},
+    {"heartbeat",   500, 2500},
+    {"low_battery", 100, 4900},
+    {"fault",       250, 250},
+};
+
+const beacon_signal_pattern_t* beacon_signal_pattern(beacon_signal_id_t id) {
+    return id < BEACON_SIGNAL_COUNT ? &s_signal_patterns[id] : nullptr;
+}
+
+beacon_err_t beacon_signal_init(beacon_signal_t* signal, const beacon_backend_t* backend) {
+    if (!signal || !backend) return BEACON_ERR_INVALID_ARG;
+
+    signal->backend = backend;
+    signal->active = BEACON_SIGNAL_OFF;
+    return backend->signal_output(backend->ctx, &s_signal_patterns[BEACON_SIGNAL_OFF]);
+}
+
+beacon_err_t beacon_signal_set(beacon_signal_t* signal, beacon_signal_id_t id) {
+    const beacon_signal_pattern_t* pattern = beacon_signal_pattern(id);
+    if (!pattern) return BEACON_ERR_INVALID_ARG;
+    if (id == signal->active) return BEACON_OK;
+
+    const beacon_backend_t* be = signal->backend;
+    beacon_err_t ret = be->signal_output(be->ctx, pattern);
+    if (ret == BEACON_OK) signal->active = id;
+    return ret;
+}
@@ -0,0 +1,85 @@
+/*
+COS10025 BLE-to-Web Cultural Storytelling System
+Rotating ephemeral artifact IDs (see include/beacon_eid.h).
+*/
+
+#include "beacon_eid.h"
+
+#include <string.h>
+
+// Temporary key input: 11 zero bytes, salt, 2 zero bytes, counter bits 31–16 (big-endian)
+#define EID_TK_SALT 0xFF
+
+void beacon_eid_compute(beacon_aes128_fn_t aes, const uint8_t identity_key[BEACON_EID_KEY_LEN],
+                        uint8_t rotation_exp, uint32_t counter, uint8_t eid[BEACON_EID_LEN]) {
+    uint8_t block[16] = {};
+    uint8_t temporary_key[16];
+    block[11] = EID_TK_SALT;
+    block[14] = static_cast<uint8_t>(counter >> 24);
+    block[15] = static_cast<uint8_t>(counter >> 16);
+    aes(identity_key, block, temporary_key);
+
+    // ID input: 11 zero bytes, K, slot counter (big-endian)
+    uint32_t slot = beacon_eid_slot(counter, rotation_exp);
+    memset(block, 0, sizeof(block));
+    block[11] = rotation_exp;
+    block[12] = static_cast<uint8_t>(slot >> 24);
+    block[13] = static_cast<uint8_t>(slot >> 16);
+    block[14] = static_cast<uint8_t>(slot >> 8);
+    block[15] = static_cast<uint8_t>(slot);
+    uint8_t out[16];
+    aes(temporary_key, block, out);
+    memcpy(eid, out, BEACON_EID_LEN);
+}
+
+beacon_err_t beacon_eid_init(beacon_eid_t* eid, beacon_aes128_fn_t aes, const uint8_t key[BEACON_EID_KEY_LEN],
+                             uint8_t rotation_exp) {
+    if (!aes || rotation_exp > BEACON_EID_ROTATION_EXP_MAX) return BEACON_ERR_INVALID_ARG;
+    memset(eid, 0, sizeof(*eid));
+    eid->aes = aes;
+    memcpy(eid->key, key, BEACON_EID_KEY_LEN);
+    eid->rotation_exp = rotation_exp;
+    return BEACON_OK;
+}
+
+static const beacon_eid_entry_t* find(const beacon_eid_t* eid, uint32_t slot) {
+    for (const beacon_eid_entry_t& e : eid->ahead) {
+        if (e.valid && e.slot == slot) return &e;
+    }
+    return nullptr;
+}
+
+void beacon_eid_fill(beacon_eid_t* eid, uint32_t counter) {
+    uint32_t period = 1u << eid->rotation_exp;
+    uint32_t first = beacon_eid_slot(counter, eid->rotation_exp);
+
+    // Step 1: Drop entries outside [first, first + AHEAD periods)
+    for (beacon_eid_entry_t& e : eid->ahead) {
+        if (e.valid && (e.slot - first) / period >= BEACON_EID_AHEAD) e.valid = false;
+    }
+
+    // Step 2: Derive the missing slots into free entries
+    for (uint32_t i = 0; i < BEACON_EID_AHEAD; i++) {
+        uint32_t slot = first + i * period;
+        if (find(eid, slot)) continue;
+        for (beacon_eid_entry_t& e : eid->ahead) {
+            if (e.valid) continue;
+            uint8_t id[BEACON_EID_LEN];
+            beacon_eid_compute(eid->aes, eid->key, eid->rotation_exp, slot, id);
+            e.payload = beacon_encode_eid(id);
+            e.slot = slot;
+            e.valid = true;
+            eid->computed++;
+            break;
+        }
+    }
+}
+
+const beacon_payload_t* beacon_eid_payload(const beacon_eid_t* eid, uint32_t counter) {
+    const beacon_eid_entry_t* e = find(eid, beacon_eid_slot(counter, eid->rotation_exp));
+    return e ? &e->payload : nullptr;
+}
+
+uint32_t beacon_eid_next_rotation_s(const beacon_eid_t* eid, uint32_t counter) {
+    return beacon_eid_slot(counter, eid->rotation_exp) + (1u << eid->rotation_exp) - counter;
+}
@@ -0,0 +1,113 @@
+/*
+COS10025 BLE-to-Web Cultural Storytelling System
+Energy model (see include/beacon_energy.h).
+*/
+
+#include "beacon_energy.h"
+#include "beacon_payload.h"
+
+// Mean and maximum of the spec's pseudo-random 0–10 ms advDelay added to every interval
+#define ADV_DELAY_MEAN_US 5000.0
+#define ADV_DELAY_MAX_US  10000
+
+beacon_power_profile_t beacon_power_profile_always_on(void) {
+    beacon_power_profile_t p = {};
+    p.name              = "always-on 160 MHz";
+    p.supply_v          = 3.3f;
+    p.tx_ma             = 130.0f;
+    p.active_ma         = 40.0f;
+    p.idle_ma           = 30.0f; // Modem sleep, CPU idle at 160 MHz
+    p.radio_overhead_us = 150;
+    p.wake_us           = 0;     // CPU never sleeps, nothing to wake
+    return p;
+}
+
+beacon_power_profile_t beacon_power_profile_light_sleep(void) {
+    beacon_power_profile_t p = {};
+    p.name              = "light-sleep DFS 80/40 MHz";
+    p.supply_v          = 3.3f;
+    p.tx_ma             = 130.0f;
+    p.active_ma         = 22.0f;
+    p.idle_ma           = 2.0f;  // Light sleep with main XTAL kept on for the BT low-power clock
+    p.radio_overhead_us = 150;
+    p.wake_us           = 1200;
+    return p;
+}
+
+beacon_power_profile_t beacon_power_profile_deep_sleep_burst(void) {
+    beacon_power_profile_t p = {};
+    p.name              = "deep-sleep burst 80 MHz";
+    p.supply_v          = 3.3f;
+    p.tx_ma             = 130.0f;
+    p.active_ma         = 40.0f; // Boot, flash load and stack bring-up
+    p.idle_ma           = 25.0f; // Between events inside the burst, modem sleep at 80 MHz
+    p.radio_overhead_us = 150;
+    p.wake_us           = 0;     // Wake cost is the measured wake-to-first-packet time
+    p.deep_sleep_ma     = 0.01f; // RTC timer + RTC slow memory retained
+    return p;
+}
+
+static uint32_t channel_count(uint8_t channel_map) {
+    return (channel_map & BEACON_ADV_CHANNEL_37 ? 1 : 0) +
+           (channel_map & BEACON_ADV_CHANNEL_38 ? 1 : 0) +
+           (channel_map & BEACON_ADV_CHANNEL_39 ? 1 : 0);
+}
+
+beacon_energy_estimate_t beacon_energy_estimate(const beacon_power_profile_t* profile,
+                                                const beacon_adv_params_t* params, uint8_t adv_len,
+                                                double extra_wakeups_per_s, double battery_mah) {
+    beacon_energy_estimate_t e = {};
+    uint32_t channels = channel_count(params->channel_map);
+
+    // Step 1: Time budget per advertising event
+    e.event_interval_us = params->interval_min * 625.0 + ADV_DELAY_MEAN_US;
+    e.tx_us_per_event = beacon_adv_airtime_us(adv_len, params->channel_map) +
+                        channels * static_cast<double>(profile->radio_overhead_us);
+    double wake_us = profile->wake_us;
+
+    // Step 2: Charge above the idle floor (mA * us = nC)
+    double event_nc = e.tx_us_per_event * (profile->tx_ma - profile->idle_ma) +
+                      wake_us * (profile->active_ma - profile->idle_ma);
+    double extra_nc_per_s = extra_wakeups_per_s * profile->wake_us * (profile->active_ma - profile->idle_ma);
+
+    // Step 3: Long-run average and battery life
+    double events_per_s = 1e6 / e.event_interval_us;
+    e.avg_current_ma = profile->idle_ma + (event_nc * events_per_s + extra_nc_per_s) / 1e6;
+    e.charge_uc_per_event = event_nc / 1000.0;
+    e.energy_uj_per_event = e.charge_uc_per_event * profile->supply_v;
+    e.battery_hours = e.avg_current_ma > 0 ? battery_mah / e.avg_current_ma : 0;
+    return e;
+}
+
+uint64_t beacon_burst_window_us(const beacon_adv_params_t* params, uint32_t events) {
+    return static_cast<uint64_t>(events) * (params->interval_max * 625ULL + ADV_DELAY_MAX_US);
+}
+
+beacon_energy_estimate_t beacon_energy_estimate_burst(const beacon_power_profile_t* profile,
+                                                      const beacon_adv_params_t* params, uint8_t adv_len,
+                                                      uint32_t events, double sleep_s,
+                                                      double wake_to_adv_us, double battery_mah) {
+    beacon_energy_estimate_t e = {};
+    if (events == 0) return e;
+
+    // Step 1: One burst period = wake + advertising window + deep sleep
+    double window_us = static_cast<double>(beacon_burst_window_us(params, events));
+    double sleep_us = sleep_s * 1e6;
+    double period_us = wake_to_adv_us + window_us + sleep_us;
+    e.event_interval_us = period_us / events;
+    e.tx_us_per_event = beacon_adv_airtime_us(adv_len, params->channel_map) +
+                        channel_count(params->channel_map) * static_cast<double>(profile->radio_overhead_us);
+
+    // Step 2: Charge per burst period (mA * us = nC)
+    double period_nc = wake_to_adv_us * profile->active_ma +
+                       window_us * profile->idle_ma +
+                       events * e.tx_us_per_event * (profile->tx_ma - profile->idle_ma) +
+                       sleep_us * profile->deep_sleep_ma;
+
+    // Step 3: Long-run average and battery life
+    e.avg_current_ma = period_nc / period_us;
+    e.charge_uc_per_event = period_nc / events / 1000.0;
+    e.energy_uj_per_event = e.charge_uc_per_event * profile->supply_v;
+    e.battery_hours = e.avg_current_ma > 0 ? battery_mah / e.avg_current_ma : 0;
+    return e;
+}
@@ -0,0 +1,81 @@
+/*
+COS10025 BLE-to-Web Cultural Storytelling System
+Binary event log (see include/beacon_evlog.h).
+*/
+
+#include "beacon_evlog.h"
+
+#include <string.h>
+
+static_assert(sizeof(beacon_evlog_rec_t) == 16, "evlog record layout is read by tools/evlog_decode.py");
+
+uint32_t beacon_evlog_attach(beacon_evlog_t* log, beacon_evlog_rec_t* recs, uint32_t capacity, bool retained) {
+    log->recs = recs;
+    log->mask = capacity - 1;
+    if (!retained) {
+        memset(recs, 0, capacity * sizeof(beacon_evlog_rec_t));
+        log->next.store(1, std::memory_order_relaxed);
+        return 0;
+    }
+
+    // Step 1: Newest sequence number among records sitting in their own slot
+    uint32_t newest = 0;
+    for (uint32_t i = 0; i < capacity; i++) {
+        uint32_t seq = recs[i].seq;
+        if (seq && (seq & log->mask) == i && recs[i].id < BEACON_EV_COUNT && seq > newest) newest = seq;
+    }
+
+    // Step 2: Clear everything that is not part of the last `capacity` records
+    // (power-on garbage, slots torn by the reset)
+    uint32_t kept = 0;
+    for (uint32_t i = 0; i < capacity; i++) {
+        uint32_t seq = recs[i].seq;
+        bool ok = seq && (seq & log->mask) == i && recs[i].id < BEACON_EV_COUNT && seq <= newest &&
+                  newest - seq < capacity;
+        if (ok) kept++;
+        else memset(&recs[i], 0, sizeof(beacon_evlog_rec_t));
+    }
+    log->next.store(newest + 1, std::memory_order_relaxed);
+    return kept;
+}
+
+uint32_t beacon_evlog_snapshot(const beacon_evlog_t* log, beacon_evlog_rec_t* out, uint32_t cap) {
+    uint32_t next = log->next.load(std::memory_order_acquire);
+    uint32_t capacity = log->mask + 1;
+    uint32_t first = next > capacity ? next - capacity : 1;
+    uint32_t n = 0;
+    for (uint32_t seq = first; seq < next && n < cap; seq++) {
+        const volatile beacon_evlog_rec_t* r = &log->recs[seq & log->mask];
+        if (r->seq != seq) continue; // Being written, or overwritten since `next` was read
+        beacon_evlog_rec_t copy;
+        copy.stamp = r->stamp;
+        copy.id = r->id;
+        copy.a = r->a;
+        copy.b = r->b;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        copy.seq = r->seq;
+        if (copy.seq == seq) out[n++] = copy;
+    }
+    return n;
+}
+
+void beacon_evlog_dump(const beacon_evlog_t* log, FILE* out) {
+    fprintf(out, "EVLOG v%d records %lu next %lu stamp_us %d\n", BEACON_EVLOG_VERSION,
+            (unsigned long)(log->mask + 1), (unsigned long)log->next.load(std::memory_order_relaxed),
+            BEACON_EVLOG_STAMP_US);
+    // One record at a time: no buffer the size of the ring on the caller's stack
+    uint32_t next = log->next.load(std::memory_order_acquire);
+    uint32_t capacity = log->mask + 1;
+    uint32_t first = next > capacity ? next - capacity : 1;
+    for (uint32_t seq = first; seq < next; seq++) {
+        const volatile beacon_evlog_rec_t* r = &log->recs[seq & log->mask];
+        if (r->seq != seq) continue;
+        beacon_evlog_rec_t copy = {seq, r->stamp, r->id, r->a, r->b};
+        if (r->seq != seq) continue;
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&copy);
+        char hex[2 * sizeof(copy) + 1];
+        for (size_t i = 0; i < sizeof(copy); i++) snprintf(hex + 2 * i, 3, "%02x", bytes[i]);
+        fprintf(out, "EVLOG %s\n", hex);
+    }
+    fprintf(out, "EVLOG end\n");
+}
@@ -0,0 +1,73 @@
+/*
+COS10025 BLE-to-Web Cultural Storytelling System
+Compact payload decoding and airtime helpers (see include/beacon_payload.h).
+*/
+
+#include "beacon_payload.h"
+
+bool beacon_decode_compact(const uint8_t* adv, uint8_t len, beacon_compact_info_t* out) {
+    uint8_t i = 0;
+    while (i < len) {
+        uint8_t ad_len = adv[i];
+        if (ad_len == 0 || i + 1 + ad_len > len) return false; // Malformed or padding
+
+        const uint8_t* ad = &adv[i + 1]; // ad[0] = AD type
+        if (ad[0] == BEACON_AD_TYPE_MANUFACTURER && ad_len >= 4 + BEACON_ARTIFACT_ID_MIN_LEN + 1 &&
+            ad[1] == (BEACON_COMPANY_ID & 0xFF) && ad[2] == (BEACON_COMPANY_ID >> 8)) {
+            uint8_t version = ad[3] >> 4;
+            uint8_t id_len = ad[3] & 0x0F;
+            bool eid = id_len == BEACON_EID_LEN;
+            if (version != BEACON_PAYLOAD_VERSION || ad_len < 4 + id_len + 1 ||
+                (!eid && (id_len < BEACON_ARTIFACT_ID_MIN_LEN || id_len > BEACON_ARTIFACT_ID_MAX_LEN))) {
+                return false;
+            }
+            if (eid && !(ad[4 + id_len] & BEACON_PAYLOAD_FLAG_EID)) return false;
+
+            uint32_t id = 0;
+            for (uint8_t b = 0; !eid && b < id_len; b++) id |= static_cast<uint32_t>(ad[4 + b]) << (8 * b);
+            out->version = version;
+            out->artifact_id = id;
+            out->flags = ad[4 + id_len];
+            out->has_eid = eid;
+            for (uint8_t b = 0; eid && b < BEACON_EID_LEN; b++) out->eid[b] = ad[4 + b];
+            out->has_telemetry = false;
+            const uint8_t* t = &ad[4 + id_len + 1];
+            if ((out->flags & BEACON_PAYLOAD_FLAG_TELEMETRY) && ad_len >= 4 + id_len + 1 + BEACON_TELEMETRY_LEN) {
+                out->has_telemetry = true;
+                out->telemetry.supply_mv = static_cast<uint16_t>(t[0] * BEACON_TELEMETRY_MV_STEP);
+                out->telemetry.uptime_s = (static_cast<uint32_t>(t[1]) | static_cast<uint32_t>(t[2]) << 8) * 60;
+                out->telemetry.reset_reason = t[3] & 0x0F;
+                out->telemetry.health = t[3] >> 4;
+            }
+            return true;
+        }
+        i += 1 + ad_len;
+    }
+    return false;
+}
+
+beacon_payload_t beacon_encode_eid(const uint8_t eid[BEACON_EID_LEN]) {
+    // Same layout as beacon_encode_compact, with the 8-byte ID length
+    beacon_payload_t p = {};
+    uint8_t n = 0;
+    p.bytes[n++] = 2;
+    p.bytes[n++] = BEACON_AD_TYPE_FLAGS;
+    p.bytes[n++] = BEACON_AD_FLAGS_GEN_DISC_NO_BREDR;
+    p.bytes[n++] = 4 + BEACON_EID_LEN + 1;
+    p.bytes[n++] = BEACON_AD_TYPE_MANUFACTURER;
+    p.bytes[n++] = BEACON_COMPANY_ID & 0xFF;
+    p.bytes[n++] = BEACON_COMPANY_ID >> 8;
+    p.bytes[n++] = static_cast<uint8_t>((BEACON_PAYLOAD_VERSION << 4) | BEACON_EID_LEN);
+    for (uint8_t i = 0; i < BEACON_EID_LEN; i++) p.bytes[n++] = eid[i];
+    p.bytes[n++] = BEACON_PAYLOAD_FLAG_EID;
+    p.len = n;
+    return p;
+}
+
+uint32_t beacon_adv_airtime_us(uint8_t adv_len, uint8_t channel_map) {
+    uint32_t channels = (channel_map & BEACON_ADV_CHANNEL_37 ? 1 : 0) +
+                        (channel_map & BEACON_ADV_CHANNEL_38 ? 1 : 0) +
+                        (channel_map & BEACON_ADV_CHANNEL_39 ? 1 : 0);
+    uint32_t pdu_bytes = 1 + 4 + 2 + 6 + adv_len + 3;
+    return channels * pdu_bytes * 8; // 1 Mbit/s → 8 us per byte
+}
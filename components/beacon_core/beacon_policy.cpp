@@ -0,0 +1,107 @@
+/*
+COS10025 BLE-to-Web Cultural Storytelling System
+Advertising interval policy (see include/beacon_policy.h).
+*/
+
+#include "beacon_policy.h"
+
+#include <string.h>
+
+// Mean of the spec's pseudo-random 0–10 ms advDelay
+#define ADV_DELAY_MEAN_US 5000.0
+
+void beacon_policy_init(beacon_policy_t* policy) {
+    memset(policy, 0, sizeof(*policy));
+    policy->active = -1;
+}
+
+beacon_err_t beacon_policy_add(beacon_policy_t* policy, const beacon_policy_rule_t* rule) {
+    if (policy->count >= BEACON_POLICY_MAX_RULES || rule->interval_min > rule->interval_max) {
+        return BEACON_ERR_INVALID_ARG;
+    }
+    if (rule->match == BEACON_POLICY_DAILY &&
+        (rule->start_min >= BEACON_POLICY_MINUTES_DAY || rule->end_min >= BEACON_POLICY_MINUTES_DAY)) {
+        return BEACON_ERR_INVALID_ARG;
+    }
+    policy->rules[policy->count++] = *rule;
+    return BEACON_OK;
+}
+
+static bool rule_matches(const beacon_policy_rule_t* rule, const beacon_policy_input_t* input) {
+    switch (rule->match) {
+    case BEACON_POLICY_ALWAYS:
+        return true;
+    case BEACON_POLICY_BOOT_WINDOW:
+        return input->uptime_s < rule->until_s;
+    case BEACON_POLICY_DAILY: {
+        if (input->minute_of_day == BEACON_POLICY_CLOCK_UNKNOWN) return false;
+        uint32_t m = static_cast<uint32_t>(input->minute_of_day);
+        if (rule->start_min <= rule->end_min) return m >= rule->start_min && m < rule->end_min;
+        return m >= rule->start_min || m < rule->end_min; // Wraps midnight
+    }
+    }
+    return false;
+}
+
+int beacon_policy_select(const beacon_policy_t* policy, const beacon_policy_input_t* input) {
+    for (int i = 0; i < policy->count; i++) {
+        if (rule_matches(&policy->rules[i], input)) return i;
+    }
+    return -1;
+}
+
+bool beacon_policy_update(beacon_policy_t* policy, const beacon_policy_input_t* input, int* from) {
+    int next = beacon_policy_select(policy, input);
+    if (next == policy->active) return false;
+    if (from) *from = policy->active;
+    policy->active = static_cast<int8_t>(next);
+    policy->transitions++;
+    return true;
+}
+
+// Minutes from `now` to the daily boundary `at` (1–1440)
+static uint32_t minutes_until(uint32_t now, uint32_t at) {
+    return at > now ? at - now : at + BEACON_POLICY_MINUTES_DAY - now;
+}
+
+uint32_t beacon_policy_next_change_s(const beacon_policy_t* policy, const beacon_policy_input_t* input,
+                                     uint32_t max_s) {
+    uint32_t next = max_s;
+    for (int i = 0; i < policy->count; i++) {
+        const beacon_policy_rule_t* rule = &policy->rules[i];
+        uint32_t s = max_s;
+        if (rule->match == BEACON_POLICY_BOOT_WINDOW && input->uptime_s < rule->until_s) {
+            s = rule->until_s - input->uptime_s;
+        } else if (rule->match == BEACON_POLICY_DAILY && input->minute_of_day != BEACON_POLICY_CLOCK_UNKNOWN) {
+            uint32_t m = static_cast<uint32_t>(input->minute_of_day);
+            uint32_t to_start = minutes_until(m, rule->start_min);
+            uint32_t to_end = minutes_until(m, rule->end_min);
+            s = (to_start < to_end ? to_start : to_end) * 60;
+        }
+        if (s < next) next = s;
+    }
+    return next;
+}
+
+bool beacon_policy_params(const beacon_policy_rule_t* rule, uint8_t channel_map, beacon_adv_params_t* out) {
+    if (rule->interval_min == 0) return false;
+    out->interval_min = rule->interval_min;
+    out->interval_max = rule->interval_max;
+    out->channel_map = channel_map;
+    return true;
+}
+
+beacon_policy_cost_t beacon_policy_cost(const beacon_policy_rule_t* rule, const beacon_power_profile_t* profile,
+                                        uint8_t adv_len, uint8_t channel_map) {
+    beacon_policy_cost_t cost = {};
+    beacon_adv_params_t params = {};
+    if (!beacon_policy_params(rule, channel_map, &params)) {
+        cost.avg_current_ma = profile->idle_ma;
+        cost.mean_latency_ms = -1.0;
+        return cost;
+    }
+    beacon_energy_estimate_t e = beacon_energy_estimate(profile, &params, adv_len, 0.0, 1.0);
+    cost.avg_current_ma = e.avg_current_ma;
+    cost.mean_latency_ms = (params.interval_min * 625.0 + ADV_DELAY_MEAN_US) / 2.0 / 1000.0;
+    return cost;
+}
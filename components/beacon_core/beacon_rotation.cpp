@@ -0,0 +1,112 @@
+/*
+COS10025 BLE-to-Web Cultural Storytelling System
+Multi-artifact payload rotation (see include/beacon_rotation.h).
+*/
+
+#include "beacon_rotation.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+// Maximum advDelay the controller adds to every advertising interval
+#define ADV_DELAY_MAX_US 10000
+
+// Smooth weighted round-robin over one full cycle (sum of weights entries)
+static void build_sequence(beacon_rotation_t* rot) {
+    int32_t current[BEACON_ROTATION_MAX_SLOTS] = {};
+    int32_t total = 0;
+    for (uint8_t s = 0; s < rot->count; s++) total += rot->slots[s].weight;
+
+    for (int32_t i = 0; i < total; i++) {
+        uint8_t best = 0;
+        for (uint8_t s = 0; s < rot->count; s++) {
+            current[s] += rot->slots[s].weight;
+            if (current[s] > current[best]) best = s;
+        }
+        current[best] -= total;
+        rot->sequence[i] = best;
+    }
+    rot->seq_len = static_cast<uint8_t>(total);
+    rot->pos = 0;
+}
+
+void beacon_rotation_init(beacon_rotation_t* rot) {
+    memset(rot, 0, sizeof(*rot));
+}
+
+beacon_err_t beacon_rotation_add(beacon_rotation_t* rot, const beacon_payload_t* payload,
+                                 uint8_t weight, int8_t tx_power_dbm) {
+    if (rot->count >= BEACON_ROTATION_MAX_SLOTS || payload->len == 0 || weight == 0) {
+        return BEACON_ERR_INVALID_ARG;
+    }
+    if (rot->seq_len + weight > BEACON_ROTATION_MAX_SEQ) return BEACON_ERR_INVALID_ARG;
+
+    beacon_rotation_slot_t* slot = &rot->slots[rot->count++];
+    slot->payload = *payload;
+    slot->weight = weight;
+    slot->tx_power_dbm = tx_power_dbm;
+    build_sequence(rot);
+    return BEACON_OK;
+}
+
+int beacon_rotation_parse(beacon_rotation_t* rot, const char* spec, int8_t default_tx_dbm) {
+    int added = 0;
+    const char* p = spec;
+    while (*p) {
+        // Step 1: id[:weight[:dbm]]
+        char* end = nullptr;
+        unsigned long id = strtoul(p, &end, 0);
+        if (end == p) return -1;
+        long weight = 1;
+        long dbm = default_tx_dbm;
+        if (*end == ':') {
+            p = end + 1;
+            weight = strtol(p, &end, 0);
+            if (end == p) return -1;
+            if (*end == ':') {
+                p = end + 1;
+                dbm = strtol(p, &end, 0);
+                if (end == p) return -1;
+            }
+        }
+        if (*end != ',' && *end != '\0') return -1;
+        if (weight < 1 || weight > BEACON_ROTATION_MAX_SEQ || dbm < -128 || dbm > 127) return -1;
+
+        // Step 2: Compact payload for the artifact
+        beacon_payload_t payload = beacon_encode_compact(static_cast<uint32_t>(id));
+        if (beacon_rotation_add(rot, &payload, static_cast<uint8_t>(weight), static_cast<int8_t>(dbm)) != BEACON_OK) {
+            return -1;
+        }
+        added++;
+        p = (*end == ',') ? end + 1 : end;
+    }
+    return added;
+}
+
+const beacon_rotation_slot_t* beacon_rotation_first(const beacon_rotation_t* rot) {
+    return rot->count ? &rot->slots[0] : nullptr;
+}
+
+beacon_err_t beacon_rotation_step(beacon_rotation_t* rot, beacon_t* beacon) {
+    if (rot->count < 2) return BEACON_OK;
+
+    uint8_t next = rot->sequence[rot->pos];
+    rot->pos = static_cast<uint8_t>((rot->pos + 1) % rot->seq_len);
+    if (next == rot->active) return BEACON_OK; // Same slot keeps the air for another dwell
+
+    // The slot's TX power is set when the controller confirms its payload, so
+    // neither payload ever goes out at the other one's level
+    const beacon_rotation_slot_t* slot = &rot->slots[next];
+    beacon_err_t ret = beacon_update_payload_tx(beacon, slot->payload.bytes, slot->payload.len, slot->tx_power_dbm);
+    if (ret != BEACON_OK) {
+        rot->failures++;
+        return ret;
+    }
+    rot->active = next;
+    rot->rotations++;
+    return BEACON_OK;
+}
+
+uint64_t beacon_rotation_dwell_us(const beacon_adv_params_t* params) {
+    return params->interval_max * 625ULL + ADV_DELAY_MAX_US;
+}
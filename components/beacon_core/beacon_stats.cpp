@@ -0,0 +1,105 @@
+/*
+COS10025 BLE-to-Web Cultural Storytelling System
+Fixed-bucket timing histograms (see include/beacon_stats.h).
+*/
+
+#include "beacon_stats.h"
+
+#include <string.h>
+
+// Maximum advDelay the controller adds to every advertising interval
+#define ADV_DELAY_MAX_US 10000
+
+// Width of the widest bar in beacon_hist_print
+#define HIST_BAR_WIDTH 40
+
+void beacon_hist_init(beacon_hist_t* hist, uint32_t origin_us, uint32_t bucket_us) {
+    memset(hist, 0, sizeof(*hist));
+    hist->origin_us = origin_us;
+    hist->bucket_us = bucket_us ? bucket_us : 1;
+    hist->min_us = UINT32_MAX;
+}
+
+void beacon_hist_add(beacon_hist_t* hist, uint32_t value_us) {
+    if (value_us < hist->origin_us) {
+        hist->under++;
+    } else {
+        uint32_t bucket = (value_us - hist->origin_us) / hist->bucket_us;
+        if (bucket < BEACON_HIST_BUCKETS) hist->counts[bucket]++;
+        else hist->over++;
+    }
+    if (value_us < hist->min_us) hist->min_us = value_us;
+    if (value_us > hist->max_us) hist->max_us = value_us;
+    hist->sum_us += value_us;
+    hist->n++;
+}
+
+void beacon_hist_merge(beacon_hist_t* into, const beacon_hist_t* from) {
+    for (int b = 0; b < BEACON_HIST_BUCKETS; b++) into->counts[b] += from->counts[b];
+    into->under += from->under;
+    into->over += from->over;
+    if (from->n) {
+        if (from->min_us < into->min_us) into->min_us = from->min_us;
+        if (from->max_us > into->max_us) into->max_us = from->max_us;
+    }
+    into->sum_us += from->sum_us;
+    into->n += from->n;
+}
+
+uint32_t beacon_hist_percentile(const beacon_hist_t* hist, double p) {
+    if (hist->n == 0) return 0;
+    uint64_t target = static_cast<uint64_t>(p * hist->n + 0.5);
+    if (target == 0) target = 1;
+    uint64_t seen = hist->under;
+    if (seen >= target) return hist->origin_us;
+    for (int b = 0; b < BEACON_HIST_BUCKETS; b++) {
+        seen += hist->counts[b];
+        if (seen >= target) {
+            uint32_t edge = hist->origin_us + (b + 1) * hist->bucket_us;
+            return edge < hist->max_us ? edge : hist->max_us;
+        }
+    }
+    return hist->max_us;
+}
+
+void beacon_hist_print(const beacon_hist_t* hist, const char* label, FILE* out) {
+    if (hist->n == 0) {
+        fprintf(out, "%s: no samples\n", label);
+        return;
+    }
+    fprintf(out, "%s: n %lu  min %lu  mean %lu  p50 %lu  p99 %lu  max %lu us  (under %lu, over %lu)\n",
+            label, (unsigned long)hist->n, (unsigned long)hist->min_us,
+            (unsigned long)(hist->sum_us / hist->n), (unsigned long)beacon_hist_percentile(hist, 0.50),
+            (unsigned long)beacon_hist_percentile(hist, 0.99), (unsigned long)hist->max_us,
+            (unsigned long)hist->under, (unsigned long)hist->over);
+
+    uint32_t peak = 1;
+    for (int b = 0; b < BEACON_HIST_BUCKETS; b++) {
+        if (hist->counts[b] > peak) peak = hist->counts[b];
+    }
+    for (int b = 0; b < BEACON_HIST_BUCKETS; b++) {
+        if (hist->counts[b] == 0) continue;
+        char bar[HIST_BAR_WIDTH + 1];
+        int len = static_cast<int>((static_cast<uint64_t>(hist->counts[b]) * HIST_BAR_WIDTH + peak - 1) / peak);
+        memset(bar, '#', len);
+        bar[len] = '\0';
+        uint32_t lo = hist->origin_us + b * hist->bucket_us;
+        fprintf(out, "  %7lu-%-7lu %8lu %s\n", (unsigned long)lo, (unsigned long)(lo + hist->bucket_us),
+                (unsigned long)hist->counts[b], bar);
+    }
+}
+
+void beacon_hist_set_init(beacon_hist_set_t* set, uint32_t origin_us, uint32_t bucket_us) {
+    for (int c = 0; c < BEACON_STATS_MAX_CORES; c++) beacon_hist_init(&set->cores[c], origin_us, bucket_us);
+}
+
+void beacon_hist_set_merge(const beacon_hist_set_t* set, beacon_hist_t* out) {
+    beacon_hist_init(out, set->cores[0].origin_us, set->cores[0].bucket_us);
+    for (int c = 0; c < BEACON_STATS_MAX_CORES; c++) beacon_hist_merge(out, &set->cores[c]);
+}
+
+void beacon_hist_init_adv_gap(beacon_hist_t* hist, uint16_t interval_min, uint16_t interval_max) {
+    uint32_t origin = interval_min * 625u;
+    uint32_t span = (interval_max - interval_min) * 625u + ADV_DELAY_MAX_US;
+    beacon_hist_init(hist, origin, (span + BEACON_HIST_BUCKETS - 1) / BEACON_HIST_BUCKETS);
+}
@@ -0,0 +1,113 @@
+/*
+COS10025 BLE-to-Web Cultural Storytelling System
+Advertising supervisor (see include/beacon_supervisor.h).
+*/
+
+#include "beacon_supervisor.h"
+
+#include <string.h>
+
+#define SUP_DEFAULT_QUIET_US    5000000
+#define SUP_DEFAULT_STALL_US    10000000
+#define SUP_DEFAULT_RESTART_MAX 3
+
+beacon_sup_config_t beacon_supervisor_defaults(void) {
+    beacon_sup_config_t config = {};
+    config.quiet_us = SUP_DEFAULT_QUIET_US;
+    config.stall_us = SUP_DEFAULT_STALL_US;
+    config.restart_max = SUP_DEFAULT_RESTART_MAX;
+    return config;
+}
+
+void beacon_supervisor_init(beacon_supervisor_t* sup, const beacon_sup_config_t* config,
+                            const beacon_t* beacon, uint64_t now_us) {
+    memset(sup, 0, sizeof(*sup));
+    sup->config = *config;
+    sup->ok_us = now_us;
+    sup->acted_us = now_us;
+    sup->seen_adv_events = beacon->adv_event_count;
+    sup->seen_swaps = beacon->swap.completed;
+    sup->seen_probes = beacon->probes_completed;
+    sup->seen_started_us = beacon->marks_us[BEACON_MARK_ADV_STARTED];
+    beacon_hist_init(&sup->recovery, 0, BEACON_SUP_RECOVERY_BUCKET_US);
+}
+
+// Time of the earliest sign of a live controller since the previous check, 0 if none
+// - An advertising start completion is the first sign after a restart; of the
+//   advertising events only the newest one has a timestamp; swaps and probes keep none
+static uint64_t take_evidence(beacon_supervisor_t* sup, const beacon_t* beacon, uint64_t now_us) {
+    uint64_t at = 0;
+    uint64_t started = beacon->marks_us[BEACON_MARK_ADV_STARTED];
+    if (started && started != sup->seen_started_us) at = started;
+    else if (beacon->adv_event_count != sup->seen_adv_events) at = beacon->last_adv_us;
+    else if (beacon->swap.completed != sup->seen_swaps || beacon->probes_completed != sup->seen_probes) at = now_us;
+
+    sup->seen_adv_events = beacon->adv_event_count;
+    sup->seen_swaps = beacon->swap.completed;
+    sup->seen_probes = beacon->probes_completed;
+    sup->seen_started_us = started;
+    return at;
+}
+
+beacon_sup_action_t beacon_supervisor_check(beacon_supervisor_t* sup, const beacon_t* beacon, uint64_t now_us) {
+    beacon_state_t state = beacon->state;
+    if (state == BEACON_STATE_IDLE) return BEACON_SUP_NONE;
+
+    // Step 1: Confirmed on air (or deliberately off, or not probed): close an open outage
+    uint64_t evidence_us = take_evidence(sup, beacon, now_us);
+    bool confirmed = evidence_us || !sup->config.quiet_us;
+    if (state == BEACON_STATE_STOPPED || (state == BEACON_STATE_ADVERTISING && confirmed)) {
+        uint64_t at = evidence_us ? evidence_us : now_us;
+        beacon_sup_action_t action = BEACON_SUP_NONE;
+        if (sup->down_us) {
+            sup->last_outage_us = static_cast<uint32_t>(at - sup->ok_us);
+            sup->last_recovery_us = static_cast<uint32_t>(at - sup->down_us);
+            beacon_hist_add(&sup->recovery, sup->last_recovery_us);
+            sup->recoveries++;
+            sup->down_us = 0;
+            action = BEACON_SUP_RECOVERED;
+        }
+        sup->restarts = 0;
+        sup->ok_us = at;
+        sup->acted_us = at;
+        sup->probe_us = 0;
+        return action;
+    }
+
+    // Step 2: Advertising but quiet: one probe per quiet period
+    uint64_t idle_us = now_us - sup->acted_us;
+    if (state == BEACON_STATE_ADVERTISING && !sup->probe_us && idle_us >= sup->config.quiet_us) {
+        sup->probe_us = now_us;
+        sup->probes++;
+        return BEACON_SUP_PROBE;
+    }
+
+    // Step 3: No progress for stall_us, or retries exhausted: restart, then reboot
+    if (state != BEACON_STATE_ERROR && idle_us < sup->config.stall_us) return BEACON_SUP_NONE;
+    if (sup->restarts >= sup->config.restart_max) return BEACON_SUP_REBOOT;
+    if (!sup->down_us) sup->down_us = now_us;
+    sup->restarts++;
+    sup->restarts_total++;
+    sup->acted_us = now_us;
+    sup->probe_us = 0;
+    return BEACON_SUP_RESTART;
+}
+
+const char* beacon_supervisor_action_name(beacon_sup_action_t action) {
+    switch (action) {
+    case BEACON_SUP_NONE:      return "none";
+    case BEACON_SUP_PROBE:     return "probe";
+    case BEACON_SUP_RESTART:   return "restart";
+    case BEACON_SUP_REBOOT:    return "reboot";
+    case BEACON_SUP_RECOVERED: return "recovered";
+    default:                   return "?";
+    }
+}
+
+void beacon_supervisor_print(const beacon_supervisor_t* sup, FILE* out) {
+    fprintf(out, "supervisor: %lu probes, %lu restarts, %lu recoveries, recovery p50 %lu ms max %lu ms, "
+                 "last outage %lu ms\n",
+            (unsigned long)sup->probes, (unsigned long)sup->restarts_total, (unsigned long)sup->recoveries,
+            (unsigned long)(beacon_hist_percentile(&sup->recovery, 0.50) / 1000),
+            (unsigned long)(sup->recovery.max_us / 1000), (unsigned long)(sup->last_outage_us / 1000));
+}
@@ -0,0 +1,115 @@
+/*
+COS10025 BLE-to-Web Cultural Storytelling System
+Beacon core: pluggable radio/GPIO/clock backend interface.
+- The beacon core never includes ESP-IDF headers; everything hardware-specific
+  goes through the function table below
+- ESP32 firmware: main/beacon_backend_esp.cpp (Bluedroid + driver/gpio)
+- Linux host: host/sim_controller.cpp (simulated controller with timestamps)
+*/
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Error codes returned by the core and by every backend operation
+// - Backends map their native error type (e.g. esp_err_t) onto these
+typedef enum {
+    BEACON_OK = 0,
+    BEACON_ERR_FAIL,          // Generic failure reported by the backend
+    BEACON_ERR_INVALID_ARG,   // Bad parameter (e.g. payload longer than 31 bytes)
+    BEACON_ERR_INVALID_STATE, // Operation not allowed in the current beacon state
+    BEACON_ERR_NOT_SUPPORTED, // Backend cannot perform the operation
+} beacon_err_t;
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Advertising parameters in controller units
+// - Intervals in 0.625 ms units (0x0020–0x4000 for ADV_NONCONN_IND)
+// - Channel map bits: 0x01 = ch37, 0x02 = ch38, 0x04 = ch39
+typedef struct {
+    uint16_t interval_min;
+    uint16_t interval_max;
+    uint8_t  channel_map;
+} beacon_adv_params_t;
+
+#define BEACON_ADV_CHANNEL_37   0x01
+#define BEACON_ADV_CHANNEL_38   0x02
+#define BEACON_ADV_CHANNEL_39   0x04
+#define BEACON_ADV_CHANNEL_ALL  0x07
+
+// ─────────────────────────────────────────────────────────────────────────────
+// LED/buzzer on/off pattern, generated by a hardware peripheral (no CPU wakeups)
+// - on_ms == 0: line held low; off_ms == 0: line held high
+typedef struct {
+    const char* name;
+    uint32_t    on_ms;
+    uint32_t    off_ms;
+} beacon_signal_pattern_t;
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Events delivered from the backend to the core (GAP callbacks on ESP32)
+typedef enum {
+    BEACON_EVT_ADV_DATA_SET_COMPLETE, // Advertising payload accepted by the controller
+    BEACON_EVT_ADV_START_COMPLETE,    // Advertising enabled (status tells success/failure)
+    BEACON_EVT_ADV_STOP_COMPLETE,     // Advertising disabled
+    BEACON_EVT_ADV_SENT,              // One advertising event went on air (simulated backends only)
+    BEACON_EVT_TIMER,                 // One-shot timer armed through schedule() expired
+    BEACON_EVT_PROBE_COMPLETE,        // Controller answered probe()
+} beacon_event_type_t;
+
+typedef struct {
+    beacon_event_type_t type;
+    beacon_err_t        status;       // BEACON_OK unless the stack reported an error
+    uint64_t            timestamp_us; // Backend clock at the time of the event
+} beacon_event_t;
+
+typedef void (*beacon_event_sink_t)(void* arg, const beacon_event_t* event);
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Stack bring-up stages, executed in order (blocking calls on ESP-IDF)
+typedef enum {
+    BEACON_STAGE_CONTROLLER_INIT,   // esp_bt_controller_init
+    BEACON_STAGE_CONTROLLER_ENABLE, // esp_bt_controller_enable(BLE)
+    BEACON_STAGE_HOST_INIT,         // esp_bluedroid_init
+    BEACON_STAGE_HOST_ENABLE,       // esp_bluedroid_enable
+    BEACON_STAGE_GAP_REGISTER,      // esp_ble_gap_register_callback
+    BEACON_STAGE_COUNT
+} beacon_stack_stage_t;
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Backend function table
+// - ctx is passed back unchanged to every operation
+// - Operations are asynchronous where the real stack is: completion is reported
+//   later through the registered event sink
+// - Events must be delivered one at a time (the core is not re-entrant)
+typedef struct {
+    void* ctx;
+
+    // Radio
+    beacon_err_t (*stack_stage)(void* ctx, beacon_stack_stage_t stage);
+    // Tear the stack down to before BEACON_STAGE_CONTROLLER_INIT (in-process
+    // recovery); advertising stops, completions still in flight and a pending
+    // schedule() expiry are dropped
+    beacon_err_t (*stack_reset)(void* ctx);
+    void (*register_event_sink)(void* ctx, beacon_event_sink_t sink, void* arg);
+    // Copies `data` before returning; also called while advertising (live update)
+    beacon_err_t (*set_adv_data)(void* ctx, const uint8_t* data, uint8_t len);
+    beacon_err_t (*start_advertising)(void* ctx, const beacon_adv_params_t* params);
+    beacon_err_t (*stop_advertising)(void* ctx);
+    beacon_err_t (*set_tx_power)(void* ctx, int8_t dbm); // Rounds down to a supported level
+    // Controller round trip that changes nothing on air (supervision);
+    // completes with BEACON_EVT_PROBE_COMPLETE. nullptr: not supported
+    beacon_err_t (*probe)(void* ctx);
+
+    // Signalling on the shared LED + buzzer line: hand the pattern to hardware
+    // that keeps it running on its own (LEDC on the ESP32)
+    beacon_err_t (*signal_output)(void* ctx, const beacon_signal_pattern_t* pattern);
+
+    // Monotonic clock in microseconds since boot
+    uint64_t (*now_us)(void* ctx);
+
+    // Arm a one-shot timer; BEACON_EVT_TIMER is delivered when it expires
+    // - Re-arming replaces the pending expiry
+    void (*schedule)(void* ctx, uint64_t delay_us);
+} beacon_backend_t;
@@ -0,0 +1,52 @@
+/*
+COS10025 BLE-to-Web Cultural Storytelling System
+Beacon runtime configuration (artifact identity + advertising profile).
+- One packed struct, read once at boot before the first advertisement
+- Stored on the ESP32 as a single NVS blob (namespace "beacon", key "cfg"),
+  written by tools/beacon_nvs.py into an NVS partition image
+- Missing or invalid blobs fall back to the compiled defaults
+*/
+
+#pragma once
+
+#include "beacon_core.h"
+#include "beacon_payload.h"
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Storage layout identifiers (keep in sync with tools/beacon_nvs.py)
+#define BEACON_CONFIG_NAMESPACE     "beacon"
+#define BEACON_CONFIG_KEY           "cfg"
+#define BEACON_CONFIG_EID_KEY       "eik" // Ephemeral-ID identity key, 16-byte blob
+#define BEACON_CONFIG_VERSION       1
+
+// Longest name that still fits flags (3) + name AD header (2) into 31 bytes
+#define BEACON_CONFIG_NAME_MAX      26
+
+// TX power used when nothing is provisioned (ESP32 default level)
+#define BEACON_DEFAULT_TX_POWER_DBM 3
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Packed on-flash layout (39 bytes, little-endian)
+typedef struct __attribute__((packed)) {
+    uint8_t  version;        // BEACON_CONFIG_VERSION
+    uint8_t  payload_format; // beacon_payload_format_t
+    uint8_t  channel_map;    // BEACON_ADV_CHANNEL_* bits
+    int8_t   tx_power_dbm;   // Requested advertising TX power (rounded down by the backend)
+    uint32_t artifact_id;    // Compact payload artifact ID
+    uint16_t interval_min;   // 0.625 ms units
+    uint16_t interval_max;   // 0.625 ms units
+    char     name[BEACON_CONFIG_NAME_MAX + 1]; // Name payload, NUL-terminated
+} beacon_config_t;
+
+static_assert(sizeof(beacon_config_t) == 39, "beacon_config_t layout is shared with tools/beacon_nvs.py");
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Config helpers
+// - beacon_config_defaults: compiled defaults for `artifact_id` / `name`
+// - beacon_config_is_valid: layout version and value ranges
+// - beacon_config_payload / beacon_config_adv_params: derive what the beacon needs
+beacon_config_t beacon_config_defaults(uint32_t artifact_id, const char* name,
+                                       beacon_payload_format_t format);
+bool beacon_config_is_valid(const beacon_config_t* config);
+beacon_payload_t beacon_config_payload(const beacon_config_t* config);
+beacon_adv_params_t beacon_config_adv_params(const beacon_config_t* config);
@@ -0,0 +1,227 @@
+/*
+COS10025 BLE-to-Web Cultural Storytelling System
+Beacon core: hardware-independent beacon logic.
+- Builds the raw advertising payload (flags + artifact name, or the compact
+  artifact-ID format in beacon_payload.h)
+- Owns the advertising parameters and tracks GAP event state
+- Double-buffers the payload so it can be updated live while advertising
+- Selects the LED/buzzer pattern, which the backend runs in hardware
+- Builds both for ESP-IDF (components/beacon_core) and for the Linux host (host/)
+*/
+
+#pragma once
+
+#include "beacon_backend.h"
+#include "beacon_stats.h"
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Legacy advertising PDU payload limit and AD types used by the beacon
+#define BEACON_ADV_PAYLOAD_MAX          31
+#define BEACON_AD_TYPE_FLAGS            0x01
+#define BEACON_AD_TYPE_COMPLETE_NAME    0x09
+
+// Flags AD value: LE General Discoverable + BR/EDR Not Supported
+#define BEACON_AD_FLAGS_GEN_DISC_NO_BREDR 0x06
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Default advertising parameters (unchanged from the original firmware)
+// - 0x00A0 * 0.625 ms = 100 ms, 0x00C8 * 0.625 ms = 125 ms
+// - All three advertising channels
+#define BEACON_DEFAULT_INTERVAL_MIN     0x00A0
+#define BEACON_DEFAULT_INTERVAL_MAX     0x00C8
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Startup retry policy
+// - Each failed step is retried after a backoff that doubles from BASE up to MAX
+// - After RETRY_MAX consecutive failures the beacon gives up (BEACON_STATE_ERROR)
+#define BEACON_RETRY_BASE_US            20000
+#define BEACON_RETRY_MAX_US             2000000
+#define BEACON_RETRY_MAX                8
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Advertising startup state machine (driven by GAP events)
+//
+//   IDLE → STACK_INIT → CONFIG_PENDING → START_PENDING → ADVERTISING
+//                 ↘            ↘               ↘  ↑           ↓ beacon_stop()
+//                   RETRY_WAIT (backoff timer)  │  └── STOP_PENDING → STOPPED
+//                       ↓ retries exhausted     │  (profile change)     │
+//                     ERROR                     └────── beacon_resume() ┘
+//
+//   beacon_restart(): any state → STACK_INIT (stack torn down, all stages again)
+typedef enum {
+    BEACON_STATE_IDLE,           // beacon_start() not called yet
+    BEACON_STATE_STACK_INIT,     // Controller + host bring-up in progress
+    BEACON_STATE_CONFIG_PENDING, // Payload pushed, waiting for data-set complete
+    BEACON_STATE_START_PENDING,  // Advertising enable issued, waiting for start complete
+    BEACON_STATE_ADVERTISING,    // Advertising enabled
+    BEACON_STATE_STOP_PENDING,   // Advertising disable issued
+    BEACON_STATE_STOPPED,        // Advertising disabled on request
+    BEACON_STATE_RETRY_WAIT,     // A step failed, waiting for the backoff timer
+    BEACON_STATE_ERROR,          // Retries exhausted
+} beacon_state_t;
+
+// Step resumed when the backoff timer expires
+typedef enum {
+    BEACON_STEP_STACK,
+    BEACON_STEP_CONFIG,
+    BEACON_STEP_START,
+} beacon_step_t;
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Startup timeline marks (backend clock, microseconds; 0 until reached)
+// - Stack stage N completes at mark N + 1
+typedef enum {
+    BEACON_MARK_START,              // beacon_start() called
+    BEACON_MARK_CONTROLLER_INIT,
+    BEACON_MARK_CONTROLLER_ENABLE,
+    BEACON_MARK_HOST_INIT,
+    BEACON_MARK_HOST_ENABLE,
+    BEACON_MARK_GAP_REGISTER,
+    BEACON_MARK_ADV_DATA_SET,       // Data-set complete event
+    BEACON_MARK_ADV_STARTED,        // Start complete event
+    BEACON_MARK_FIRST_ADV,          // First advertising event on air (simulated backends)
+    BEACON_MARK_COUNT
+} beacon_mark_t;
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Live payload swaps (beacon_update_payload while advertising)
+// - The standby buffer is handed to the controller; the data-set completion
+//   flips it to active. A failed swap leaves the previous payload on air
+// - Updates that arrive while a swap is in flight overwrite the standby buffer
+//   and are pushed once that swap completes (only the newest one is sent)
+// - A TX power given with the payload (beacon_update_payload_tx) rides along
+//   and is applied when the controller confirms that payload, never before
+#define BEACON_SWAP_LATENCY_BUCKET_US   500 // Latency histogram: 0–8 ms
+
+typedef struct {
+    bool          pending;     // Standby buffer handed to the controller, no completion yet
+    bool          queued;      // Standby buffer holds a payload not yet handed over
+    bool          tx_queued;   // TX power to apply with the queued payload
+    bool          tx_pending;  // TX power to apply with the in-flight payload
+    int8_t        tx_queued_dbm;
+    int8_t        tx_pending_dbm;
+    uint64_t      issued_us;
+    uint32_t      requested;   // beacon_update_payload() calls
+    uint32_t      completed;   // Swaps confirmed by the controller
+    uint32_t      coalesced;   // Updates replaced before they reached the controller
+    uint32_t      failed;      // Swaps rejected on issue or completion
+    beacon_hist_t latency;     // Issue → data-set complete
+
+    // Advertising gaps spanning a swap (backends that report BEACON_EVT_ADV_SENT)
+    bool          gap_armed;   // A swap completed since the last advertising event
+    uint32_t      gap_max_us;  // Longest such gap
+    uint32_t      gaps_missed; // Such gaps longer than interval_max + the 10 ms advDelay
+} beacon_swap_t;
+
+typedef struct beacon beacon_t;
+typedef void (*beacon_state_cb_t)(beacon_t* beacon, beacon_state_t state, void* arg);
+
+struct beacon {
+    const beacon_backend_t* backend;
+    beacon_adv_params_t     adv_params;
+    int8_t                  tx_power_dbm;
+    // Raw payload, double-buffered: adv_buf[adv_active] is the payload the
+    // controller last confirmed, the other buffer stages the next one
+    uint8_t                 adv_buf[2][BEACON_ADV_PAYLOAD_MAX];
+    uint8_t                 adv_buf_len[2];
+    uint8_t                 adv_active;
+    beacon_swap_t           swap;
+    volatile beacon_state_t state;
+
+    // Optional observer, called on every state change
+    beacon_state_cb_t       on_state;
+    void*                   on_state_arg;
+
+    // Startup progress and retries
+    uint8_t                 next_stage;    // Next stack stage to run
+    beacon_step_t           retry_step;    // Step resumed after RETRY_WAIT
+    beacon_err_t            last_error;    // Error that caused the last retry
+    bool                    restart_pending; // Profile change: start again once the stop completes
+    uint32_t                retry_count;   // Consecutive failures of the current step
+    uint32_t                retry_total;   // All retries since beacon_start()
+    uint32_t                restarts;      // In-process stack restarts (beacon_restart)
+
+    // Timing counters (backend clock, microseconds)
+    uint64_t marks_us[BEACON_MARK_COUNT];
+    uint64_t last_adv_us;      // Most recent BEACON_EVT_ADV_SENT
+    uint32_t adv_event_count;  // Number of BEACON_EVT_ADV_SENT seen
+    uint32_t probes_completed; // Successful BEACON_EVT_PROBE_COMPLETE seen
+    beacon_hist_t adv_gap_hist; // Gaps between BEACON_EVT_ADV_SENT (backends that report them)
+};
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Named LED/buzzer patterns (table in beacon_core.cpp)
+typedef enum {
+    BEACON_SIGNAL_OFF,         // Line held low
+    BEACON_SIGNAL_HEARTBEAT,   // 0.5 s on, 2.5 s off (original 3 s cycle)
+    BEACON_SIGNAL_LOW_BATTERY, // 0.1 s blip every 5 s
+    BEACON_SIGNAL_FAULT,       // 0.25 s on, 0.25 s off
+    BEACON_SIGNAL_COUNT
+} beacon_signal_id_t;
+
+typedef struct {
+    const beacon_backend_t* backend;
+    beacon_signal_id_t      active;
+} beacon_signal_t;
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Payload construction
+// - Returns the payload length, or 0 if it does not fit into `cap` bytes
+uint8_t beacon_build_name_adv_data(const char* name, uint8_t* out, uint8_t cap);
+
+beacon_adv_params_t beacon_default_adv_params(void);
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Beacon lifecycle
+// - beacon_init: bind the backend and copy the raw advertising payload
+// - beacon_start: bring up the stack, then push the payload; advertising is
+//   enabled only once the controller confirms the payload
+// - beacon_stop: disable advertising (completes with BEACON_STATE_STOPPED)
+// - beacon_handle_event: state machine, called from the backend event sink
+beacon_err_t beacon_init(beacon_t* beacon, const beacon_backend_t* backend,
+                         const uint8_t* adv_data, uint8_t adv_len);
+void beacon_set_state_callback(beacon_t* beacon, beacon_state_cb_t cb, void* arg);
+// Advertising profile applied by beacon_start() (defaults: 100–125 ms, all channels, +3 dBm)
+void beacon_set_profile(beacon_t* beacon, const beacon_adv_params_t* params, int8_t tx_power_dbm);
+beacon_err_t beacon_start(beacon_t* beacon);
+beacon_err_t beacon_stop(beacon_t* beacon);
+// Apply a new advertising profile at any time; legacy advertising parameters
+// cannot change while enabled, so a running beacon is stopped and restarted
+// (one STOP_PENDING → START_PENDING round trip, the payload stays in place)
+beacon_err_t beacon_change_profile(beacon_t* beacon, const beacon_adv_params_t* params);
+// Re-enable advertising after beacon_stop() (STOPPED only)
+beacon_err_t beacon_resume(beacon_t* beacon);
+// Tear the stack down and bring it up again from the first stage, in any state
+// after beacon_start() (ERROR included); payload and profile are kept
+beacon_err_t beacon_restart(beacon_t* beacon);
+// Ask the controller for a round trip that leaves advertising untouched
+// (ADVERTISING only); the answer counts in probes_completed, not as a swap
+beacon_err_t beacon_probe(beacon_t* beacon);
+// Replace the payload (fixed storage, no allocation)
+// - While advertising: swapped through the standby buffer without stopping
+//   advertising (see beacon_swap_t); before that: used by the initial push
+beacon_err_t beacon_update_payload(beacon_t* beacon, const uint8_t* adv_data, uint8_t adv_len);
+// Same, with the TX power the payload is to go out at: set (and kept in
+// tx_power_dbm) once the controller confirms the payload
+beacon_err_t beacon_update_payload_tx(beacon_t* beacon, const uint8_t* adv_data, uint8_t adv_len,
+                                      int8_t tx_power_dbm);
+void beacon_handle_event(beacon_t* beacon, const beacon_event_t* event);
+
+// Payload the controller last confirmed (the initial one before advertising starts)
+const uint8_t* beacon_adv_data(const beacon_t* beacon);
+uint8_t beacon_adv_len(const beacon_t* beacon);
+// One-line swap summary: counters, latency p50/p99 and gaps spanning a swap
+void beacon_swap_print(const beacon_t* beacon, FILE* out);
+
+// Time from beacon_start() to `mark`, or 0 if the mark has not been reached
+uint64_t beacon_mark_elapsed_us(const beacon_t* beacon, beacon_mark_t mark);
+const char* beacon_mark_name(beacon_mark_t mark);
+const char* beacon_state_name(beacon_state_t state);
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Signalling
+// - beacon_signal_set: hand the named pattern to the backend hardware; the
+//   pattern keeps running without any task or CPU wakeup
+const beacon_signal_pattern_t* beacon_signal_pattern(beacon_signal_id_t id);
+beacon_err_t beacon_signal_init(beacon_signal_t* signal, const beacon_backend_t* backend);
+beacon_err_t beacon_signal_set(beacon_signal_t* signal, beacon_signal_id_t id);
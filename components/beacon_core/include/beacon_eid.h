@@ -0,0 +1,66 @@
+/*
+COS10025 BLE-to-Web Cultural Storytelling System
+Rotating ephemeral artifact IDs (Eddystone-EID derivation).
+- Each beacon holds a 16-byte identity key; the advertised ID is the first 8
+  bytes of AES-128(temporary key, rotation exponent K | counter), where the
+  temporary key is AES-128(identity key, salt | upper 16 counter bits) and the
+  counter's low K bits are cleared, so the ID changes every 2^K seconds
+- Counter: Unix seconds once the wall clock is set, seconds since boot before
+  that (host/eid_resolver.h searches both)
+- AES-128 comes from the platform (beacon_aes128_fn_t): the ESP32 AES
+  accelerator on the firmware, OpenSSL on the host
+- Up to BEACON_EID_AHEAD IDs are precomputed into ready payloads; handing one
+  to beacon_update_payload() at rotation time needs no crypto
+*/
+
+#pragma once
+
+#include "beacon_core.h"
+#include "beacon_payload.h"
+
+#define BEACON_EID_KEY_LEN          16
+#define BEACON_EID_ROTATION_EXP_MIN 0
+#define BEACON_EID_ROTATION_EXP_MAX 15
+#define BEACON_EID_AHEAD            4
+
+// Encrypt one 16-byte block with a 16-byte key (AES-128 ECB)
+typedef void (*beacon_aes128_fn_t)(const uint8_t key[16], const uint8_t in[16], uint8_t out[16]);
+
+// First counter value of the rotation slot holding `counter`
+constexpr uint32_t beacon_eid_slot(uint32_t counter, uint8_t rotation_exp) {
+    return counter & ~((1u << rotation_exp) - 1u);
+}
+
+// Ephemeral ID for `counter` (two AES-128 blocks)
+void beacon_eid_compute(beacon_aes128_fn_t aes, const uint8_t identity_key[BEACON_EID_KEY_LEN],
+                        uint8_t rotation_exp, uint32_t counter, uint8_t eid[BEACON_EID_LEN]);
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Precomputed IDs, one per rotation slot
+typedef struct {
+    uint32_t         slot;    // First counter value of the slot
+    bool             valid;
+    beacon_payload_t payload; // beacon_encode_eid() of the slot's ID
+} beacon_eid_entry_t;
+
+typedef struct {
+    beacon_aes128_fn_t aes;
+    uint8_t            key[BEACON_EID_KEY_LEN];
+    uint8_t            rotation_exp;
+    beacon_eid_entry_t ahead[BEACON_EID_AHEAD];
+    uint32_t           computed; // IDs derived so far (crypto work done)
+} beacon_eid_t;
+
+// Returns BEACON_ERR_INVALID_ARG for a missing AES function or an exponent above the maximum
+beacon_err_t beacon_eid_init(beacon_eid_t* eid, beacon_aes128_fn_t aes, const uint8_t key[BEACON_EID_KEY_LEN],
+                             uint8_t rotation_exp);
+
+// Make sure the slot holding `counter` and the next BEACON_EID_AHEAD - 1 are
+// precomputed (crypto runs here, only for slots not already held)
+void beacon_eid_fill(beacon_eid_t* eid, uint32_t counter);
+
+// Precomputed payload for the slot holding `counter`; nullptr if not held (no crypto)
+const beacon_payload_t* beacon_eid_payload(const beacon_eid_t* eid, uint32_t counter);
+
+// Seconds from `counter` to the next rotation (1 – 2^K)
+uint32_t beacon_eid_next_rotation_s(const beacon_eid_t* eid, uint32_t counter);
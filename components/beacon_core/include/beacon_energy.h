@@ -0,0 +1,61 @@
+/*
+COS10025 BLE-to-Web Cultural Storytelling System
+Energy model for one beacon: average current, charge/energy per advertising
+event and battery life, from a per-profile current table and the advertising
+schedule. Used by host/bench_power and by the firmware power report to quote
+battery life per unit; tools/energy_per_event.py gives the measured
+counterpart from a current-probe trace.
+*/
+
+#pragma once
+
+#include "beacon_core.h"
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Current table for one operating profile (ESP32-D0WD-V3 datasheet figures, mA)
+typedef struct {
+    const char* name;
+    float    supply_v;          // Rail voltage (3.3 V regulator output)
+    float    tx_ma;             // Radio transmitting (0 dBm)
+    float    active_ma;         // CPU running at max frequency, radio idle
+    float    idle_ma;           // Between events: CPU idle at full clock, or light sleep
+    uint32_t radio_overhead_us; // Per-channel PLL ramp + channel switch around each PDU
+    uint32_t wake_us;           // CPU awake per wakeup (light-sleep exit/entry + ISR work)
+    float    deep_sleep_ma;     // Between bursts (deep-sleep burst profile only)
+} beacon_power_profile_t;
+
+// Shipped profile: CPU locked at 160 MHz, modem sleep only, no light sleep
+beacon_power_profile_t beacon_power_profile_always_on(void);
+// sdkconfig.defaults.lowpower: DFS 80/40 MHz + automatic light sleep + modem sleep
+beacon_power_profile_t beacon_power_profile_light_sleep(void);
+// CONFIG_BEACON_BURST_MODE: awake at 80 MHz for the burst, deep sleep (RTC timer only) between
+beacon_power_profile_t beacon_power_profile_deep_sleep_burst(void);
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Estimate for one advertising configuration
+typedef struct {
+    double event_interval_us;   // Mean time between advertising events (interval + mean advDelay)
+    double tx_us_per_event;     // Radio on-air + overhead per event
+    double avg_current_ma;      // Long-run average supply current
+    double charge_uc_per_event; // Charge attributable to one advertising event (above idle)
+    double energy_uj_per_event; // Same, as energy at supply_v
+    double battery_hours;       // Runtime on `battery_mah` at the average current
+} beacon_energy_estimate_t;
+
+// - extra_wakeups_per_s: application wakeups besides advertising (e.g. a software-toggled GPIO)
+beacon_energy_estimate_t beacon_energy_estimate(const beacon_power_profile_t* profile,
+                                                const beacon_adv_params_t* params, uint8_t adv_len,
+                                                double extra_wakeups_per_s, double battery_mah);
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Deep-sleep burst mode: wake, send `events` advertising events, deep sleep `sleep_s`
+// - beacon_burst_window_us: advertising time that guarantees `events` events
+//   (interval_max plus the full 10 ms advDelay per event)
+// - wake_to_adv_us: measured wake-to-first-packet time (ROM + bootloader + app
+//   init + stack bring-up), charged at active_ma on every burst
+// - Per-event figures are totals (wake + burst + sleep share), not above idle
+uint64_t beacon_burst_window_us(const beacon_adv_params_t* params, uint32_t events);
+beacon_energy_estimate_t beacon_energy_estimate_burst(const beacon_power_profile_t* profile,
+                                                      const beacon_adv_params_t* params, uint8_t adv_len,
+                                                      uint32_t events, double sleep_s,
+                                                      double wake_to_adv_us, double battery_mah);
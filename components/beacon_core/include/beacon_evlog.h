@@ -0,0 +1,97 @@
+/*
+COS10025 BLE-to-Web Cultural Storytelling System
+Binary event log: fixed 16-byte records in a ring, decoded on the host.
+- A record is a sequence number, a timestamp, an event ID and two arguments;
+  nothing is formatted on the device
+- Lock-free for any number of writers: one atomic fetch-add hands out the
+  sequence number (and with it the slot), the record is filled in and the
+  sequence number is stored last, so readers skip slots being written
+- The records can live in memory that survives resets (RTC memory on the
+  ESP32): the write position is recovered from the newest sequence number, and
+  the atomic counter itself stays in ordinary RAM
+- Event IDs and their host-side formats are listed below; tools/evlog_decode.py
+  reads them from this header, so a new event needs no decoder change
+*/
+
+#pragma once
+
+#include <atomic>
+#include <stdint.h>
+#include <stdio.h>
+
+#define BEACON_EVLOG_VERSION  1
+#define BEACON_EVLOG_STAMP_US 1024 // Timestamp unit: boot clock >> 10, wraps after ~51 days
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Event IDs
+// - The comment after each ID is its decoder format: {a} and {b} print the
+//   arguments, {a:state} / {b:err} look them up in the named enum (state, step,
+//   err, init, sup, reset), {b:x} prints hex
+typedef enum {
+    BEACON_EV_NONE = 0,
+    BEACON_EV_BOOT = 1,        // boot {b}, reset reason {a:reset}
+    BEACON_EV_INIT_FAIL = 2,   // init step {a:init} failed, error {b}
+    BEACON_EV_STATE = 3,       // beacon state {a:state}
+    BEACON_EV_RETRY = 4,       // startup step {a:step} failed ({b:err}), backing off
+    BEACON_EV_PROFILE = 5,     // advertising interval {a} x 0.625 ms (0 = off), rule {b}
+    BEACON_EV_CLOCK_SET = 6,   // clock set to {b} (Unix seconds)
+    BEACON_EV_EID_ROTATE = 7,  // ephemeral ID slot {b}, derived late {a}
+    BEACON_EV_SUPPLY = 8,      // supply {a} mV, health flags {b:x}
+    BEACON_EV_SLEEP = 9,       // deep sleep for {b} ms
+    BEACON_EV_HEAP_TRACE = 10, // steady-state heap trace: {a} allocations, {b} still held
+    BEACON_EV_SUPERVISOR = 11, // watchdog {a:sup}: no advertising confirmed for {b} ms
+    BEACON_EV_RECOVERED = 12,  // advertising recovered {b} ms after the first restart ({a} restarts so far)
+    BEACON_EV_COUNT
+} beacon_event_id_t;
+
+// Start-up steps reported by BEACON_EV_INIT_FAIL
+typedef enum {
+    BEACON_INIT_POWER,    // Power management configuration
+    BEACON_INIT_CONFIG,   // NVS configuration rejected, defaults used
+    BEACON_INIT_ROTATION, // Rotation list rejected, single artifact
+    BEACON_INIT_EID,      // No identity key, fixed artifact ID
+    BEACON_INIT_CORE,     // beacon_init(); the firmware stops here
+    BEACON_INIT_SIGNAL,   // Signal pattern not supported
+} beacon_init_step_t;
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Ring
+typedef struct {
+    uint32_t seq;   // 0 = empty or being written; record n is at slot n & mask
+    uint32_t stamp; // BEACON_EVLOG_STAMP_US units since boot
+    uint16_t id;    // beacon_event_id_t
+    uint16_t a;
+    uint32_t b;
+} beacon_evlog_rec_t;
+
+typedef struct {
+    beacon_evlog_rec_t*   recs;
+    uint32_t              mask; // Capacity - 1 (capacity is a power of two)
+    std::atomic<uint32_t> next; // Sequence number of the next record
+} beacon_evlog_t;
+
+// Attach `capacity` records (power of two) at `recs`
+// - retained: the memory holds a previous log (checked record by record);
+//   otherwise it is cleared
+// - Returns the number of records recovered
+uint32_t beacon_evlog_attach(beacon_evlog_t* log, beacon_evlog_rec_t* recs, uint32_t capacity, bool retained);
+
+// Append one record; safe from any task, core or interrupt
+inline void beacon_evlog_write(beacon_evlog_t* log, uint32_t stamp, uint16_t id, uint16_t a, uint32_t b) {
+    uint32_t seq = log->next.fetch_add(1, std::memory_order_relaxed);
+    volatile beacon_evlog_rec_t* r = &log->recs[seq & log->mask];
+    r->seq = 0;
+    r->stamp = stamp;
+    r->id = id;
+    r->a = a;
+    r->b = b;
+    std::atomic_thread_fence(std::memory_order_release);
+    r->seq = seq;
+}
+
+// Copy the complete records, oldest first, into `out` (up to `cap`)
+uint32_t beacon_evlog_snapshot(const beacon_evlog_t* log, beacon_evlog_rec_t* out, uint32_t cap);
+
+// Dump for tools/evlog_decode.py: a header line, one "EVLOG <hex>" line per
+// record (raw little-endian bytes, oldest first) and an end line
+void beacon_evlog_dump(const beacon_evlog_t* log, FILE* out);
@@ -0,0 +1,161 @@
+/*
+COS10025 BLE-to-Web Cultural Storytelling System
+Compact binary artifact-ID advertising payload.
+- Replaces the Complete Local Name (up to 29 bytes) with an 11–13 byte payload
+- Carried as manufacturer-specific data so scanners can match on an integer
+- Encoder is constexpr: the payload bytes are built at compile time
+
+Layout (all multi-byte fields little-endian):
+
+  02 01 06                     Flags AD (general discoverable, BR/EDR not supported)
+  LL FF                        Manufacturer-specific AD, LL = 4 + id_len + 1
+     CC CC                     Company ID (BEACON_COMPANY_ID)
+     VI                        Version (high nibble) | artifact ID length in bytes (low nibble, 2–4)
+     II II [II II]             Artifact ID, or with ID length 8 and BEACON_PAYLOAD_FLAG_EID
+                               a rotating ephemeral ID (beacon_eid.h)
+     FF                        Payload flags (BEACON_PAYLOAD_FLAG_*)
+     [BB UU UU RH]             Telemetry, only with BEACON_PAYLOAD_FLAG_TELEMETRY:
+                               BB supply rail in 25 mV steps, UU uptime in minutes
+                               (saturating), R reset reason (low nibble), H health
+                               flags (high nibble, BEACON_HEALTH_*)
+
+Scanners that only read the artifact ID ignore the trailing telemetry bytes.
+Decoders that predate ephemeral IDs reject ID length 8, so they ignore those payloads.
+*/
+
+#pragma once
+
+#include "beacon_core.h"
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Format constants
+// - 0xFFFF is the Bluetooth SIG company ID reserved for internal/test use
+#define BEACON_AD_TYPE_MANUFACTURER     0xFF
+#define BEACON_COMPANY_ID               0xFFFF
+#define BEACON_PAYLOAD_VERSION          1
+#define BEACON_ARTIFACT_ID_MIN_LEN      2
+#define BEACON_ARTIFACT_ID_MAX_LEN      4
+
+// Payload flags (bit field, 0 when unused)
+#define BEACON_PAYLOAD_FLAG_NONE        0x00
+#define BEACON_PAYLOAD_FLAG_TELEMETRY   0x01 // BEACON_TELEMETRY_LEN bytes follow the flags
+#define BEACON_PAYLOAD_FLAG_EID         0x02 // ID field is a BEACON_EID_LEN-byte ephemeral ID
+
+// Ephemeral ID length (Eddystone-EID: first 8 bytes of an AES-128 block)
+#define BEACON_EID_LEN                  8
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Supply and health telemetry
+#define BEACON_TELEMETRY_LEN            4
+#define BEACON_TELEMETRY_MV_STEP        25     // 0–6375 mV in one byte
+#define BEACON_TELEMETRY_UPTIME_MAX_MIN 0xFFFF // ~45 days
+
+// Reset reason (low nibble of the status byte)
+typedef enum {
+    BEACON_RESET_UNKNOWN    = 0,
+    BEACON_RESET_POWER_ON   = 1,
+    BEACON_RESET_SOFTWARE   = 2,
+    BEACON_RESET_PANIC      = 3,
+    BEACON_RESET_WATCHDOG   = 4,
+    BEACON_RESET_BROWNOUT   = 5,
+    BEACON_RESET_DEEP_SLEEP = 6,
+    BEACON_RESET_EXTERNAL   = 7,
+} beacon_reset_reason_t;
+
+// Health flags (high nibble of the status byte)
+#define BEACON_HEALTH_LOW_SUPPLY        0x1 // Supply below the configured threshold
+#define BEACON_HEALTH_UNCALIBRATED      0x2 // No eFuse ADC calibration, nominal Vref used
+#define BEACON_HEALTH_SENSE_FAULT       0x4 // Supply could not be sampled; BB is 0
+
+typedef struct {
+    uint16_t supply_mv;
+    uint32_t uptime_s;
+    uint8_t  reset_reason; // beacon_reset_reason_t
+    uint8_t  health;       // BEACON_HEALTH_* bits
+} beacon_telemetry_t;
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Advertising payload selector
+typedef enum {
+    BEACON_PAYLOAD_NAME    = 0, // Complete Local Name (original format)
+    BEACON_PAYLOAD_COMPACT = 1, // Manufacturer data with binary artifact ID
+} beacon_payload_format_t;
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Encoded payload (fixed storage, `len` bytes valid; len == 0 means invalid input)
+struct beacon_payload_t {
+    uint8_t bytes[BEACON_ADV_PAYLOAD_MAX];
+    uint8_t len;
+};
+
+constexpr uint8_t beacon_artifact_id_len(uint32_t artifact_id) {
+    return artifact_id <= 0xFFFF ? 2 : artifact_id <= 0xFFFFFF ? 3 : 4;
+}
+
+// Build the compact payload for `artifact_id`
+// - id_len 0 picks the shortest length that holds the ID
+constexpr beacon_payload_t beacon_encode_compact(uint32_t artifact_id, uint8_t flags = BEACON_PAYLOAD_FLAG_NONE,
+                                                 uint8_t id_len = 0) {
+    beacon_payload_t p = {};
+    if (id_len == 0) id_len = beacon_artifact_id_len(artifact_id);
+    if (id_len < BEACON_ARTIFACT_ID_MIN_LEN || id_len > BEACON_ARTIFACT_ID_MAX_LEN) return p;
+    if (id_len < 4 && (artifact_id >> (8 * id_len)) != 0) return p;
+
+    uint8_t n = 0;
+    p.bytes[n++] = 2;
+    p.bytes[n++] = BEACON_AD_TYPE_FLAGS;
+    p.bytes[n++] = BEACON_AD_FLAGS_GEN_DISC_NO_BREDR;
+    p.bytes[n++] = static_cast<uint8_t>(4 + id_len + 1);
+    p.bytes[n++] = BEACON_AD_TYPE_MANUFACTURER;
+    p.bytes[n++] = BEACON_COMPANY_ID & 0xFF;
+    p.bytes[n++] = BEACON_COMPANY_ID >> 8;
+    p.bytes[n++] = static_cast<uint8_t>((BEACON_PAYLOAD_VERSION << 4) | id_len);
+    for (uint8_t i = 0; i < id_len; i++) p.bytes[n++] = static_cast<uint8_t>(artifact_id >> (8 * i));
+    p.bytes[n++] = flags;
+    p.len = n;
+    return p;
+}
+
+// Compact payload with the telemetry block appended (15–17 bytes)
+// - Quantisation is lossy: supply rounds down to 25 mV, uptime to whole minutes
+constexpr beacon_payload_t beacon_encode_telemetry(uint32_t artifact_id, const beacon_telemetry_t& t,
+                                                   uint8_t id_len = 0) {
+    beacon_payload_t p = beacon_encode_compact(artifact_id, BEACON_PAYLOAD_FLAG_TELEMETRY, id_len);
+    if (p.len == 0) return p;
+
+    uint32_t supply = t.supply_mv / BEACON_TELEMETRY_MV_STEP;
+    uint32_t uptime_min = t.uptime_s / 60;
+    if (supply > 0xFF) supply = 0xFF;
+    if (uptime_min > BEACON_TELEMETRY_UPTIME_MAX_MIN) uptime_min = BEACON_TELEMETRY_UPTIME_MAX_MIN;
+
+    p.bytes[3] = static_cast<uint8_t>(p.bytes[3] + BEACON_TELEMETRY_LEN); // Manufacturer AD length
+    p.bytes[p.len++] = static_cast<uint8_t>(supply);
+    p.bytes[p.len++] = static_cast<uint8_t>(uptime_min);
+    p.bytes[p.len++] = static_cast<uint8_t>(uptime_min >> 8);
+    p.bytes[p.len++] = static_cast<uint8_t>((t.reset_reason & 0x0F) | (t.health << 4));
+    return p;
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Decoded view of a compact payload
+typedef struct {
+    uint8_t  version;
+    uint8_t  flags;
+    uint32_t artifact_id;
+    bool     has_telemetry;
+    beacon_telemetry_t telemetry; // Quantised values; valid when has_telemetry
+    bool     has_eid;             // artifact_id is 0; resolve `eid` (host/eid_resolver.h)
+    uint8_t  eid[BEACON_EID_LEN];
+} beacon_compact_info_t;
+
+// Compact payload carrying an ephemeral ID instead of the artifact ID (17 bytes)
+beacon_payload_t beacon_encode_eid(const uint8_t eid[BEACON_EID_LEN]);
+
+// Find and decode the compact manufacturer AD inside a raw advertising payload
+// - Returns false if the payload carries no (valid) compact artifact ID
+bool beacon_decode_compact(const uint8_t* adv, uint8_t len, beacon_compact_info_t* out);
+
+// On-air time of one advertising event on the 1M PHY
+// - ADV_NONCONN_IND PDU: preamble 1 + access address 4 + header 2 + AdvA 6 + payload + CRC 3
+// - Counted once per enabled advertising channel
+uint32_t beacon_adv_airtime_us(uint8_t adv_len, uint8_t channel_map);
@@ -0,0 +1,78 @@
+/*
+COS10025 BLE-to-Web Cultural Storytelling System
+Table-driven advertising interval policy.
+- Rules are checked in order; the first one that matches the current uptime and
+  local time of day selects the advertising interval (or advertising off)
+- Typical table: fast discovery window after boot, slow or off during closed
+  hours, the provisioned interval otherwise
+- Pure functions of (uptime, minute of day): host/bench_policy walks a whole
+  day through the same table the firmware runs
+*/
+
+#pragma once
+
+#include "beacon_core.h"
+#include "beacon_energy.h"
+
+#define BEACON_POLICY_MAX_RULES     8
+#define BEACON_POLICY_MINUTES_DAY   1440
+#define BEACON_POLICY_CLOCK_UNKNOWN (-1) // minute_of_day before the clock is set
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Rule conditions
+typedef enum {
+    BEACON_POLICY_ALWAYS,      // Catch-all, put it last
+    BEACON_POLICY_BOOT_WINDOW, // uptime_s < until_s
+    BEACON_POLICY_DAILY,       // start_min <= minute of day < end_min (wraps midnight when start > end);
+                               // never matches while the clock is unknown
+} beacon_policy_match_t;
+
+typedef struct {
+    const char*           name;
+    beacon_policy_match_t match;
+    uint32_t              until_s;      // BOOT_WINDOW
+    uint16_t              start_min;    // DAILY, local minutes since midnight
+    uint16_t              end_min;      // DAILY
+    uint16_t              interval_min; // 0.625 ms units; 0 = advertising off
+    uint16_t              interval_max;
+} beacon_policy_rule_t;
+
+typedef struct {
+    uint32_t uptime_s;      // Since the cold boot
+    int32_t  minute_of_day; // Local time, or BEACON_POLICY_CLOCK_UNKNOWN
+} beacon_policy_input_t;
+
+typedef struct {
+    beacon_policy_rule_t rules[BEACON_POLICY_MAX_RULES];
+    uint8_t  count;
+    int8_t   active;      // Rule in force, -1 before the first update
+    uint32_t transitions;
+} beacon_policy_t;
+
+// Cost of one rule for the transition log
+typedef struct {
+    double avg_current_ma;  // beacon_energy_estimate at the rule's interval (idle floor when off)
+    double mean_latency_ms; // Mean wait of a continuous scanner for the next event; < 0 when off
+} beacon_policy_cost_t;
+
+void beacon_policy_init(beacon_policy_t* policy);
+// Returns BEACON_ERR_INVALID_ARG when the table is full or the interval range is inverted
+beacon_err_t beacon_policy_add(beacon_policy_t* policy, const beacon_policy_rule_t* rule);
+
+// Index of the first matching rule, or -1 if none matches
+int beacon_policy_select(const beacon_policy_t* policy, const beacon_policy_input_t* input);
+
+// Re-evaluate; returns true and sets *from (-1 on the first call) when the
+// selected rule changed
+bool beacon_policy_update(beacon_policy_t* policy, const beacon_policy_input_t* input, int* from);
+
+// Seconds until any rule's condition can change (boot window end, daily
+// boundary), capped at max_s; re-evaluate no later than that
+uint32_t beacon_policy_next_change_s(const beacon_policy_t* policy, const beacon_policy_input_t* input,
+                                     uint32_t max_s);
+
+// Advertising parameters for a rule; false when the rule turns advertising off
+bool beacon_policy_params(const beacon_policy_rule_t* rule, uint8_t channel_map, beacon_adv_params_t* out);
+
+beacon_policy_cost_t beacon_policy_cost(const beacon_policy_rule_t* rule, const beacon_power_profile_t* profile,
+                                        uint8_t adv_len, uint8_t channel_map);
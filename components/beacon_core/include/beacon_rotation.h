@@ -0,0 +1,54 @@
+/*
+COS10025 BLE-to-Web Cultural Storytelling System
+Multi-artifact payload rotation through the single legacy advertising set.
+- Up to BEACON_ROTATION_MAX_SLOTS artifacts per board, each with an interval
+  weight and its own TX power
+- Smooth weighted round-robin: a slot with weight 2 gets every other dwell
+  when paired with two weight-1 slots, instead of two dwells in a row
+- The payload is swapped in place (beacon_update_payload_tx; the slot's TX power
+  is applied once the controller confirms it): advertising is never stopped,
+  and nothing is allocated per rotation
+- Call beacon_rotation_step() once per beacon_rotation_dwell_us()
+*/
+
+#pragma once
+
+#include "beacon_core.h"
+#include "beacon_payload.h"
+
+#define BEACON_ROTATION_MAX_SLOTS 4
+#define BEACON_ROTATION_MAX_SEQ   32 // Sum of weights
+
+typedef struct {
+    beacon_payload_t payload;
+    uint8_t          weight;       // Dwells per rotation cycle (1–BEACON_ROTATION_MAX_SEQ)
+    int8_t           tx_power_dbm;
+} beacon_rotation_slot_t;
+
+typedef struct {
+    beacon_rotation_slot_t slots[BEACON_ROTATION_MAX_SLOTS];
+    uint8_t  count;
+    uint8_t  sequence[BEACON_ROTATION_MAX_SEQ]; // Slot index per dwell, one cycle
+    uint8_t  seq_len;
+    uint8_t  pos;                               // Next entry of `sequence`
+    uint8_t  active;                            // Slot currently on air
+    uint32_t rotations;                         // Payload swaps issued
+    uint32_t failures;                          // Swaps the backend rejected
+} beacon_rotation_t;
+
+void beacon_rotation_init(beacon_rotation_t* rot);
+// Returns BEACON_ERR_INVALID_ARG when the slots or the weight budget are full
+beacon_err_t beacon_rotation_add(beacon_rotation_t* rot, const beacon_payload_t* payload,
+                                 uint8_t weight, int8_t tx_power_dbm);
+// Parse "id:weight:dbm,id:weight:dbm" (weight and dbm optional) into compact-payload slots
+// - Returns the number of slots added, or -1 on a malformed entry
+int beacon_rotation_parse(beacon_rotation_t* rot, const char* spec, int8_t default_tx_dbm);
+
+// Slot 0, for beacon_init()/beacon_set_profile() before advertising starts
+const beacon_rotation_slot_t* beacon_rotation_first(const beacon_rotation_t* rot);
+
+// Put the next slot of the weighted sequence on air (no-op with fewer than two slots)
+beacon_err_t beacon_rotation_step(beacon_rotation_t* rot, beacon_t* beacon);
+
+// Dwell per slot that guarantees at least one advertising event per dwell
+uint64_t beacon_rotation_dwell_us(const beacon_adv_params_t* params);
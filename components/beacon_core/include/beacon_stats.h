@@ -0,0 +1,53 @@
+/*
+COS10025 BLE-to-Web Cultural Storytelling System
+Fixed-bucket timing histograms for the advertising schedule.
+- No allocation, no locks: one writer per histogram. Per-core sets give every
+  core its own histogram; readers merge them and tolerate a torn snapshot
+- Used by the beacon core (gaps between BEACON_EVT_ADV_SENT events), the
+  firmware scheduling probe (beacon_instr.cpp) and the host benchmarks
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+
+#define BEACON_HIST_BUCKETS   16
+#define BEACON_STATS_MAX_CORES 2 // ESP32-D0WD-V3
+
+// ─────────────────────────────────────────────────────────────────────────────
+// One histogram: BEACON_HIST_BUCKETS buckets of bucket_us from origin_us, plus
+// under/over counters for values outside [origin, origin + 16 * bucket)
+typedef struct {
+    uint32_t origin_us;
+    uint32_t bucket_us;
+    uint32_t counts[BEACON_HIST_BUCKETS];
+    uint32_t under;
+    uint32_t over;
+    uint32_t n;
+    uint32_t min_us;
+    uint32_t max_us;
+    uint64_t sum_us;
+} beacon_hist_t;
+
+// Per-core set: core `c` writes only cores[c]
+typedef struct {
+    beacon_hist_t cores[BEACON_STATS_MAX_CORES];
+} beacon_hist_set_t;
+
+void beacon_hist_init(beacon_hist_t* hist, uint32_t origin_us, uint32_t bucket_us);
+void beacon_hist_add(beacon_hist_t* hist, uint32_t value_us);
+// Add `from` into `into` (same origin and bucket width)
+void beacon_hist_merge(beacon_hist_t* into, const beacon_hist_t* from);
+// Upper edge of the bucket holding the p-th percentile (0 < p <= 1), capped at max_us
+uint32_t beacon_hist_percentile(const beacon_hist_t* hist, double p);
+// Multi-line text dump: summary line plus one bar per non-empty bucket
+void beacon_hist_print(const beacon_hist_t* hist, const char* label, FILE* out);
+
+void beacon_hist_set_init(beacon_hist_set_t* set, uint32_t origin_us, uint32_t bucket_us);
+// All cores merged into `out`
+void beacon_hist_set_merge(const beacon_hist_set_t* set, beacon_hist_t* out);
+
+// Histogram layout for gaps between advertising events: interval_min to
+// interval_max plus the full 10 ms advDelay; anything later lands in `over`
+void beacon_hist_init_adv_gap(beacon_hist_t* hist, uint16_t interval_min, uint16_t interval_max);
@@ -0,0 +1,72 @@
+/*
+COS10025 BLE-to-Web Cultural Storytelling System
+Advertising supervisor: decides when a silent beacon needs recovering.
+- Advertising counts as confirmed by any sign of a live controller: an
+  advertising event (backends that report them), a completed payload swap, an
+  answered probe or a completed advertising start. STOPPED (policy off period)
+  is healthy too
+- Quiet while advertising: probe first (beacon_probe, a controller round trip
+  that is not a swap). Still nothing, stuck in a startup state or retries
+  exhausted: restart the stack in-process. Restarts that do not bring
+  advertising back end in a reboot
+- quiet_us = 0 turns probing off: advertising is then taken as healthy and only
+  startup stalls and errors are recovered (hosts where every probe costs a
+  heap allocation)
+- Pure function of (beacon, time), called periodically by the owner, which
+  carries out the returned action: host/bench_recovery runs the same checks
+  against the simulated controller
+*/
+
+#pragma once
+
+#include "beacon_core.h"
+
+#define BEACON_SUP_RECOVERY_BUCKET_US 250000 // Recovery histogram: 0–4 s
+
+typedef enum {
+    BEACON_SUP_NONE,      // Healthy, or still within the allowed time
+    BEACON_SUP_PROBE,     // Controller round trip (beacon_probe)
+    BEACON_SUP_RESTART,   // beacon_restart()
+    BEACON_SUP_REBOOT,    // restart_max restarts did not help: reboot the chip
+    BEACON_SUP_RECOVERED, // Advertising confirmed after a restart (last_recovery_us)
+} beacon_sup_action_t;
+
+typedef struct {
+    uint32_t quiet_us;    // Advertising without confirmation for this long: probe (0: never)
+    uint32_t stall_us;    // No confirmation (or no progress since the last restart) for this long: restart
+    uint8_t  restart_max; // Restarts without recovery before a reboot
+} beacon_sup_config_t;
+
+typedef struct {
+    beacon_sup_config_t config;
+    uint64_t ok_us;       // Advertising last confirmed
+    uint64_t acted_us;    // Last confirmation or restart; the stall timer runs from here
+    uint64_t probe_us;    // Probe in flight since, 0 if none
+    uint64_t down_us;     // First restart of the current outage, 0 when healthy
+
+    // Evidence seen at the previous check
+    uint32_t seen_adv_events;
+    uint32_t seen_swaps;
+    uint32_t seen_probes;
+    uint64_t seen_started_us;
+
+    uint8_t  restarts;    // Since the last recovery
+    uint32_t probes;
+    uint32_t restarts_total;
+    uint32_t recoveries;
+    uint32_t last_outage_us;   // Last confirmation before the outage → confirmed again
+    uint32_t last_recovery_us; // First restart → confirmed again
+    beacon_hist_t recovery;    // last_recovery_us of every outage
+} beacon_supervisor_t;
+
+// Defaults: probe after 5 s quiet, restart after 10 s, reboot after 3 restarts
+beacon_sup_config_t beacon_supervisor_defaults(void);
+// Start supervising a beacon that has been started; advertising counts as
+// confirmed at `now_us`
+void beacon_supervisor_init(beacon_supervisor_t* sup, const beacon_sup_config_t* config,
+                            const beacon_t* beacon, uint64_t now_us);
+// One check; the caller carries out the returned action
+beacon_sup_action_t beacon_supervisor_check(beacon_supervisor_t* sup, const beacon_t* beacon, uint64_t now_us);
+const char* beacon_supervisor_action_name(beacon_sup_action_t action);
+// One-line summary: probes, restarts, recoveries and recovery time p50/max
+void beacon_supervisor_print(const beacon_supervisor_t* sup, FILE* out);
@@ -0,0 +1,267 @@
+/*
+COS10025 BLE-to-Web Cultural Storytelling System
+Advertising-report matcher microbenchmarks (Google Benchmark).
+- Traffic mixes from scan_traffic.h:
+    crowd    2 artifacts among 1000 unrelated devices (a busy foyer)
+    hall     8 artifacts among 300 devices (bench_scan's default)
+    dense    32 artifacts, 16 other devices (a gallery of beacons)
+    names    32 name-mode artifacts among 300 devices (legacy beacons)
+- Matchers over the AD bytes of every report:
+    PerfectHash  scan_ad_match() as the engine runs it
+    Linear       the same walk with the hashes off (linear table search)
+    StringMap    what the app did in Dart: decode the compact ID into a map
+                 lookup, copy the name into a string and look it up in a map
+- HciEvent walks whole HCI events (scan_engine_feed); Ffi is the dart:ffi
+  entry point on fields split out the way a phone plugin delivers them
+- items_per_second is reports per second. Before timing, every matcher must
+  agree with the generator's ground truth on every mix (exit 1 otherwise)
+
+Usage: bench_admatch [--benchmark_filter=REGEX] [--benchmark_min_time=S] ...
+*/
+
+#include "scan_ffi.h"
+#include "scan_traffic.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct mix_t {
+    const char* name;
+    uint32_t artifacts, name_beacons, others;
+};
+
+static const mix_t MIXES[] = {
+    {"crowd", 2, 0, 1000},
+    {"hall", 8, 1, 300},
+    {"dense", 32, 0, 16},
+    {"names", 32, 32, 300},
+};
+
+// One report's AD bytes inside its HCI event
+struct report_view_t {
+    const uint8_t* ad;
+    uint8_t        len;
+};
+
+struct mix_data_t {
+    scan_artifacts_t artifacts;
+    std::vector<scan_traffic_event_t> events;
+    std::vector<report_view_t> reports;
+    std::unordered_map<uint32_t, int> by_id;      // StringMap baseline
+    std::unordered_map<std::string, int> by_name;
+};
+
+static mix_data_t g_mix[sizeof(MIXES) / sizeof(MIXES[0])];
+
+static void load_mixes(void) {
+    for (size_t m = 0; m < sizeof(MIXES) / sizeof(MIXES[0]); m++) {
+        scan_traffic_config_t config;
+        config.artifacts = MIXES[m].artifacts;
+        config.name_beacons = MIXES[m].name_beacons;
+        config.others = MIXES[m].others;
+        config.seconds = 5;
+        mix_data_t& d = g_mix[m];
+        scan_traffic_artifacts(config, &d.artifacts);
+        d.events = scan_traffic_generate(config);
+        for (const scan_traffic_event_t& e : d.events) d.reports.push_back({&e.evt[13], e.evt[12]});
+        for (uint8_t i = 0; i < d.artifacts.count; i++) {
+            d.by_id[d.artifacts.items[i].id] = i;
+            d.by_name[d.artifacts.items[i].name] = i;
+        }
+    }
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Matchers
+static int match_hashed(const mix_data_t& d, const report_view_t& r) {
+    scan_ad_match_t hit;
+    return scan_ad_match(&d.artifacts, r.ad, r.len, &hit) ? hit.artifact : -1;
+}
+
+static int match_linear(const scan_artifacts_t& linear, const report_view_t& r) {
+    scan_ad_match_t hit;
+    return scan_ad_match(&linear, r.ad, r.len, &hit) ? hit.artifact : -1;
+}
+
+static int match_string_map(const mix_data_t& d, const report_view_t& r) {
+    beacon_compact_info_t info;
+    if (beacon_decode_compact(r.ad, r.len, &info) && !info.has_eid) {
+        auto it = d.by_id.find(info.artifact_id);
+        return it == d.by_id.end() ? -1 : it->second;
+    }
+    for (uint8_t i = 0; i + 1 < r.len && r.ad[i]; i = static_cast<uint8_t>(i + 1 + r.ad[i])) {
+        if (i + 1 + r.ad[i] > r.len) break;
+        if (r.ad[i + 1] == BEACON_AD_TYPE_COMPLETE_NAME || r.ad[i + 1] == SCAN_AD_TYPE_SHORT_NAME) {
+            std::string name(reinterpret_cast<const char*>(&r.ad[i + 2]), r.ad[i] - 1);
+            auto it = d.by_name.find(name);
+            return it == d.by_name.end() ? -1 : it->second;
+        }
+    }
+    return -1;
+}
+
+// Manufacturer data and name split out of the AD, as flutter_reactive_ble delivers them
+static void split_fields(const report_view_t& r, uint8_t* buf, int32_t* mfr_len, int32_t* name_len) {
+    *mfr_len = *name_len = 0;
+    const uint8_t* name = nullptr;
+    for (uint8_t i = 0; i + 1 < r.len && r.ad[i]; i = static_cast<uint8_t>(i + 1 + r.ad[i])) {
+        if (i + 1 + r.ad[i] > r.len) break;
+        if (r.ad[i + 1] == BEACON_AD_TYPE_MANUFACTURER && !*mfr_len) {
+            *mfr_len = r.ad[i] - 1;
+            memcpy(buf, &r.ad[i + 2], *mfr_len);
+        } else if (r.ad[i + 1] == BEACON_AD_TYPE_COMPLETE_NAME) {
+            name = &r.ad[i + 2];
+            *name_len = r.ad[i] - 1;
+        }
+    }
+    if (name) memcpy(buf + *mfr_len, name, *name_len);
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Benchmarks (argument = mix index)
+static void BM_PerfectHash(benchmark::State& state) {
+    const mix_data_t& d = g_mix[state.range(0)];
+    for (auto _ : state) {
+        int found = 0;
+        for (const report_view_t& r : d.reports) found += match_hashed(d, r) >= 0;
+        benchmark::DoNotOptimize(found);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * d.reports.size()));
+    state.SetLabel(MIXES[state.range(0)].name);
+}
+
+static void BM_Linear(benchmark::State& state) {
+    const mix_data_t& d = g_mix[state.range(0)];
+    scan_artifacts_t linear = d.artifacts;
+    linear.hashed = false;
+    for (auto _ : state) {
+        int found = 0;
+        for (const report_view_t& r : d.reports) found += match_linear(linear, r) >= 0;
+        benchmark::DoNotOptimize(found);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * d.reports.size()));
+    state.SetLabel(MIXES[state.range(0)].name);
+}
+
+static void BM_StringMap(benchmark::State& state) {
+    const mix_data_t& d = g_mix[state.range(0)];
+    for (auto _ : state) {
+        int found = 0;
+        for (const report_view_t& r : d.reports) found += match_string_map(d, r) >= 0;
+        benchmark::DoNotOptimize(found);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * d.reports.size()));
+    state.SetLabel(MIXES[state.range(0)].name);
+}
+
+static void count_match(void* arg, const scan_match_t*) {
+    (*static_cast<uint64_t*>(arg))++;
+}
+
+static void BM_HciEvent(benchmark::State& state) {
+    const mix_data_t& d = g_mix[state.range(0)];
+    uint64_t found = 0;
+    scan_engine_t engine;
+    scan_engine_init(&engine, scan_backend_t{}, &d.artifacts, count_match, nullptr, &found);
+    for (auto _ : state) {
+        for (const scan_traffic_event_t& e : d.events) scan_engine_feed(&engine, e.evt, e.len, e.ts_us);
+        benchmark::DoNotOptimize(found);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * d.events.size()));
+    state.SetLabel(MIXES[state.range(0)].name);
+}
+
+static void BM_Ffi(benchmark::State& state) {
+    const mix_data_t& d = g_mix[state.range(0)];
+    cham_matcher* m = cham_matcher_new();
+    uint8_t* buf = cham_matcher_buffer(m);
+    cham_matcher_clear(m);
+    for (uint8_t i = 0; i < d.artifacts.count; i++) {
+        memcpy(buf, d.artifacts.items[i].name, d.artifacts.items[i].name_len);
+        cham_matcher_add(m, d.artifacts.items[i].id, d.artifacts.items[i].name_len);
+    }
+    // Split outside the timed loop: the plugin has already done it on the phone
+    std::vector<std::vector<uint8_t>> fields;
+    std::vector<std::pair<int32_t, int32_t>> lens;
+    for (const report_view_t& r : d.reports) {
+        uint8_t tmp[CHAM_MATCHER_BUFFER];
+        int32_t mfr_len, name_len;
+        split_fields(r, tmp, &mfr_len, &name_len);
+        fields.emplace_back(tmp, tmp + mfr_len + name_len);
+        lens.emplace_back(mfr_len, name_len);
+    }
+    for (auto _ : state) {
+        int found = 0;
+        for (size_t i = 0; i < fields.size(); i++) {
+            memcpy(buf, fields[i].data(), fields[i].size()); // Dart writes into the mapped buffer
+            found += cham_matcher_match_fields(m, lens[i].first, lens[i].second) >= 0;
+        }
+        benchmark::DoNotOptimize(found);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * d.reports.size()));
+    state.SetLabel(MIXES[state.range(0)].name);
+    cham_matcher_free(m);
+}
+
+#define MIX_ARGS DenseRange(0, static_cast<int>(sizeof(MIXES) / sizeof(MIXES[0])) - 1)
+BENCHMARK(BM_PerfectHash)->MIX_ARGS;
+BENCHMARK(BM_Linear)->MIX_ARGS;
+BENCHMARK(BM_StringMap)->MIX_ARGS;
+BENCHMARK(BM_HciEvent)->MIX_ARGS;
+BENCHMARK(BM_Ffi)->MIX_ARGS;
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Ground truth check, then the benchmarks
+static int check_mixes(void) {
+    int failures = 0;
+    cham_matcher* m = cham_matcher_new();
+    for (size_t k = 0; k < sizeof(MIXES) / sizeof(MIXES[0]); k++) {
+        const mix_data_t& d = g_mix[k];
+        scan_artifacts_t linear = d.artifacts;
+        linear.hashed = false;
+        uint8_t* buf = cham_matcher_buffer(m);
+        cham_matcher_clear(m);
+        for (uint8_t i = 0; i < d.artifacts.count; i++) {
+            memcpy(buf, d.artifacts.items[i].name, d.artifacts.items[i].name_len);
+            cham_matcher_add(m, d.artifacts.items[i].id, d.artifacts.items[i].name_len);
+        }
+        uint64_t wrong[4] = {};
+        for (size_t i = 0; i < d.reports.size(); i++) {
+            int truth = d.events[i].truth;
+            int32_t mfr_len, name_len;
+            split_fields(d.reports[i], buf, &mfr_len, &name_len);
+            wrong[0] += match_hashed(d, d.reports[i]) != truth;
+            wrong[1] += match_linear(linear, d.reports[i]) != truth;
+            wrong[2] += match_string_map(d, d.reports[i]) != truth;
+            wrong[3] += cham_matcher_match_fields(m, mfr_len, name_len) != truth;
+        }
+        printf("mix %-6s %3u artifacts %5zu reports: wrong %lu hashed, %lu linear, %lu string map, %lu ffi\n",
+               MIXES[k].name, d.artifacts.count, d.reports.size(), (unsigned long)wrong[0],
+               (unsigned long)wrong[1], (unsigned long)wrong[2], (unsigned long)wrong[3]);
+        if (!d.artifacts.hashed) {
+            fprintf(stderr, "CHECK FAILED: %s table not hashed\n", MIXES[k].name);
+            failures++;
+        }
+        if (wrong[0] || wrong[1] || wrong[2] || wrong[3]) {
+            fprintf(stderr, "CHECK FAILED: %s matchers disagree with the ground truth\n", MIXES[k].name);
+            failures++;
+        }
+    }
+    cham_matcher_free(m);
+    return failures;
+}
+
+int main(int argc, char** argv) {
+    load_mixes();
+    if (check_mixes()) return 1;
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 2;
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
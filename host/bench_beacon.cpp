@@ -0,0 +1,136 @@
+/*
+COS10025 BLE-to-Web Cultural Storytelling System
+Host timing benchmark for the beacon core on the simulated controller.
+- Boot-to-first-advert latency across many simulated boots (different seeds)
+- Per-stage startup timeline (controller, host, data-set, start, first advert)
+- Advertising interval jitter: deviation of each event gap from the nominal interval
+- Fixed-bucket gap histogram, as dumped by the firmware instrumentation (beacon_stats.h)
+- Optional fault injection to measure recovery through the retry/backoff path
+- Optional regression gates: exits non-zero when a budget is exceeded
+
+- Payload size and on-air time per advertising event (--payload name|compact|telemetry)
+
+Usage: bench_beacon [--runs N] [--seconds S] [--sched-jitter-us U] [--inject-failures N]
+                    [--payload name|compact|telemetry] [--max-first-adv-us U] [--max-jitter-p99-us U]
+*/
+
+#include "beacon_core.h"
+#include "beacon_payload.h"
+#include "sim_controller.h"
+#include "bench_util.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+int main(int argc, char** argv) {
+    int runs = 200;
+    double seconds = 10.0;
+    uint32_t sched_jitter_us = 0;
+    uint32_t inject_failures = 0;  // Failed data-set + start attempts per boot
+    double max_first_adv_us = 0;   // 0 = no gate
+    double max_jitter_p99_us = 0;  // 0 = no gate
+    const char* format = "compact";
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (!strcmp(argv[i], "--runs")) runs = atoi(argv[i + 1]);
+        else if (!strcmp(argv[i], "--seconds")) seconds = atof(argv[i + 1]);
+        else if (!strcmp(argv[i], "--sched-jitter-us")) sched_jitter_us = atoi(argv[i + 1]);
+        else if (!strcmp(argv[i], "--inject-failures")) inject_failures = atoi(argv[i + 1]);
+        else if (!strcmp(argv[i], "--max-first-adv-us")) max_first_adv_us = atof(argv[i + 1]);
+        else if (!strcmp(argv[i], "--max-jitter-p99-us")) max_jitter_p99_us = atof(argv[i + 1]);
+        else if (!strcmp(argv[i], "--payload")) format = argv[i + 1];
+    }
+
+    beacon_payload_t payload = beacon_encode_compact(0x0002);
+    if (!strcmp(format, "name")) {
+        payload.len = beacon_build_name_adv_data("Tara_Bodhisattva_Statue", payload.bytes, sizeof(payload.bytes));
+    } else if (!strcmp(format, "telemetry")) {
+        // 5 V rail, one day up, power-on reset; must survive quantisation and decoding
+        beacon_telemetry_t t = {5012, 86400, BEACON_RESET_POWER_ON, 0};
+        payload = beacon_encode_telemetry(0x0002, t);
+        beacon_compact_info_t info = {};
+        if (!beacon_decode_compact(payload.bytes, payload.len, &info) || !info.has_telemetry ||
+            info.telemetry.supply_mv != 5000 || info.telemetry.uptime_s != 86400 ||
+            info.telemetry.reset_reason != BEACON_RESET_POWER_ON) {
+            fprintf(stderr, "telemetry payload does not round-trip\n");
+            return 1;
+        }
+    }
+
+    std::vector<double> first_adv_us;
+    std::vector<double> marks_us[BEACON_MARK_COUNT];
+    uint32_t retries = 0;
+    std::vector<double> jitter_us;
+    std::vector<double> gap_us;
+    beacon_hist_t gap_hist;
+    beacon_adv_params_t defaults = beacon_default_adv_params();
+    beacon_hist_init_adv_gap(&gap_hist, defaults.interval_min, defaults.interval_max);
+
+    for (int run = 0; run < runs; run++) {
+        sim_timing_t timing;
+        timing.seed = run + 1;
+        timing.sched_jitter_us = sched_jitter_us;
+
+        sim_controller_t sim;
+        sim_controller_init(&sim, timing);
+        sim.fail_set_adv_data = inject_failures;
+        sim.fail_start = inject_failures;
+
+        beacon_t beacon;
+        beacon_init(&beacon, sim_controller_backend(&sim), payload.bytes, payload.len);
+        if (beacon_start(&beacon) != BEACON_OK) {
+            fprintf(stderr, "run %d: beacon_start failed\n", run);
+            return 1;
+        }
+        sim_controller_run_until(&sim, beacon.marks_us[BEACON_MARK_START] + static_cast<uint64_t>(seconds * 1e6));
+
+        if (beacon.adv_event_count == 0) {
+            fprintf(stderr, "run %d: no advertising events (state %s)\n", run, beacon_state_name(beacon.state));
+            return 1;
+        }
+        first_adv_us.push_back(static_cast<double>(beacon_mark_elapsed_us(&beacon, BEACON_MARK_FIRST_ADV)));
+        for (int m = BEACON_MARK_CONTROLLER_INIT; m < BEACON_MARK_COUNT; m++) {
+            marks_us[m].push_back(static_cast<double>(beacon_mark_elapsed_us(&beacon, static_cast<beacon_mark_t>(m))));
+        }
+        retries += beacon.retry_total;
+        beacon_hist_merge(&gap_hist, &beacon.adv_gap_hist);
+
+        double nominal = beacon.adv_params.interval_min * 625.0;
+        for (size_t i = 1; i < sim.adv_times_us.size(); i++) {
+            double gap = static_cast<double>(sim.adv_times_us[i] - sim.adv_times_us[i - 1]);
+            gap_us.push_back(gap);
+            jitter_us.push_back(std::fabs(gap - nominal));
+        }
+    }
+
+    printf("beacon core timing benchmark: %d runs x %.1f s simulated\n", runs, seconds);
+    printf("payload: %s, %u bytes, %u us on air per advertising event (3 channels)\n",
+           format, payload.len,
+           beacon_adv_airtime_us(payload.len, BEACON_ADV_CHANNEL_ALL));
+    summary_t first = summarise(first_adv_us);
+    summary_t gaps = summarise(gap_us);
+    summary_t jitter = summarise(jitter_us);
+    print_summary("boot-to-first-advert (us)", first);
+    printf("startup timeline (mean us since beacon_start, retries %u):\n", retries);
+    for (int m = BEACON_MARK_CONTROLLER_INIT; m < BEACON_MARK_COUNT; m++) {
+        printf("  %-20s %9.0f\n", beacon_mark_name(static_cast<beacon_mark_t>(m)),
+               summarise(marks_us[m]).mean);
+    }
+    print_summary("advertising gap (us)", gaps);
+    print_summary("interval jitter (us)", jitter);
+    beacon_hist_print(&gap_hist, "advertising gap histogram", stdout);
+
+    int failed = 0;
+    if (max_first_adv_us > 0 && first.p99 > max_first_adv_us) {
+        printf("FAIL: boot-to-first-advert p99 %.0f us > budget %.0f us\n", first.p99, max_first_adv_us);
+        failed = 1;
+    }
+    if (max_jitter_p99_us > 0 && jitter.p99 > max_jitter_p99_us) {
+        printf("FAIL: interval jitter p99 %.0f us > budget %.0f us\n", jitter.p99, max_jitter_p99_us);
+        failed = 1;
+    }
+    return failed;
+}
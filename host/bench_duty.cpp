@@ -0,0 +1,331 @@
+/*
+COS10025 BLE-to-Web Cultural Storytelling System
+Scan duty-cycling on a simulated museum visit: radio-on time vs latency.
+- Visit: entrance (60 s, no beacons), --rooms rooms of --cases cases 1.5 m
+  apart (walk in, 10–30 s at each case, walk out), corridors of 30–120 s
+  between rooms and a 10 min café break halfway. Only the current room's
+  beacons are audible (100 ms interval, half the advertisements lost while
+  scanning, RSSI as in bench_proximity)
+- Radio: Android scan windows per mode (low power 0.5 s every 5 s, balanced
+  1 s every 4 s, low latency continuous), phase reset by every scan start
+- App: proximity engine (Kalman defaults) and the 30 s per-artifact cooldown
+- Policies: fixed low latency (the app before), fixed balanced, fixed low
+  power, and adaptive (scan_duty.h, polled every 250 ms as the app's timer
+  does)
+- Per policy: radio-on share, scan starts, detection latency from entering
+  a room to the first artifact heard, time from stopping at a case to its
+  story, missed visits and wrong triggers
+- Checks: adaptive keeps Android's start limit (5 per 30 s), listens out of
+  beacon range no more than balanced would (radio-on at most the in-range
+  share plus a quarter of the rest) and serves at least 95 % of fixed low
+  latency's visits; optional gates on the adaptive policy
+
+Usage: bench_duty [--rooms N] [--cases N] [--visitors N] [--seed N]
+                  [--idle-after-ms N] [--burst-max-ms N] [--settle-mode M] [--cooldown-mode M]
+                  [--max-radio-share X] [--max-story-p95-ms N]
+*/
+
+#include "scan_duty.h"
+#include "scan_proximity.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#define SPACING_M        1.5
+#define STANDOFF_M       0.7
+#define WALK_M_PER_S     1.0
+#define APPROACH_M       3.0
+#define TX_AT_1M_DBM     -59.0
+#define PATH_LOSS_EXP    2.2
+#define FADING_SIGMA_DB  5.0
+#define RX_P             0.5
+#define SENSITIVITY_DBM  -95
+#define COOLDOWN_US      30000000ULL
+#define TICK_US          250000ULL
+#define ANDROID_STARTS   5
+#define ANDROID_WINDOW_US 30000000ULL
+
+struct mode_timing_t {
+    uint32_t window_us, interval_us;
+};
+
+static const mode_timing_t MODES[] = {
+    {512000, 5120000},  // SCAN_MODE_LOW_POWER
+    {1024000, 4096000}, // SCAN_MODE_BALANCED
+    {4096000, 4096000}, // SCAN_MODE_LOW_LATENCY
+};
+
+struct visit_t {
+    int      artifact;
+    uint64_t arrive_us, leave_us;
+};
+
+struct room_t {
+    uint64_t enter_us, exit_us;
+    int      first;  // Artifact index of the room's first case
+    std::vector<visit_t> visits;
+};
+
+struct advert_t {
+    uint64_t ts_us;
+    int      artifact;
+    int8_t   rssi;
+};
+
+struct outcome_t {
+    uint64_t radio_us, total_us, in_range_us;
+    uint32_t starts, visits, correct, wrong, deferred;
+    bool     start_limit_ok;
+    std::vector<double> detect_ms, story_ms;
+};
+
+static int check(bool ok, const char* what) {
+    if (!ok) fprintf(stderr, "CHECK FAILED: %s\n", what);
+    return ok ? 0 : 1;
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Visit timeline and what the beacons send
+static std::vector<room_t> plan_visit(uint32_t rooms, uint32_t cases, std::mt19937& rng, uint64_t* end_us) {
+    std::vector<room_t> plan;
+    uint64_t t = 60000000ULL; // Entrance
+    uint64_t walk_case_us = static_cast<uint64_t>(SPACING_M / WALK_M_PER_S * 1e6);
+    uint64_t approach_us = static_cast<uint64_t>(APPROACH_M / WALK_M_PER_S * 1e6);
+    for (uint32_t r = 0; r < rooms; r++) {
+        room_t room;
+        room.enter_us = t;
+        room.first = static_cast<int>(r * cases);
+        t += approach_us;
+        for (uint32_t k = 0; k < cases; k++) {
+            if (k) t += walk_case_us;
+            visit_t v = {room.first + static_cast<int>(k), t, t + 10000000ULL + rng() % 20000000ULL};
+            room.visits.push_back(v);
+            t = v.leave_us;
+        }
+        t += approach_us;
+        room.exit_us = t;
+        plan.push_back(room);
+        t += 30000000ULL + rng() % 90000000ULL; // Corridor
+        if (r + 1 == rooms / 2) t += 600000000ULL; // Café
+    }
+    *end_us = t;
+    return plan;
+}
+
+// Visitor position along the room's row of cases at t (inside the room)
+static double position_in(const room_t& room, uint64_t t_us) {
+    double x = -APPROACH_M;
+    uint64_t t = room.enter_us;
+    for (const visit_t& v : room.visits) {
+        double target = (v.artifact - room.first) * SPACING_M;
+        if (t_us < v.arrive_us) return x + (target - x) * (t_us - t) / static_cast<double>(v.arrive_us - t);
+        if (t_us < v.leave_us) return target;
+        x = target;
+        t = v.leave_us;
+    }
+    return x + WALK_M_PER_S * (t_us - t) * 1e-6;
+}
+
+static std::vector<advert_t> adverts(const std::vector<room_t>& plan, uint32_t cases, std::mt19937& rng) {
+    std::normal_distribution<double> fading(0.0, FADING_SIGMA_DB);
+    std::vector<advert_t> out;
+    for (const room_t& room : plan) {
+        for (uint32_t k = 0; k < cases; k++) {
+            for (uint64_t t = room.enter_us + rng() % 100000; t < room.exit_us; t += 100000 + rng() % 10000) {
+                double dx = position_in(room, t) - k * SPACING_M;
+                double d = std::max(0.1, std::sqrt(STANDOFF_M * STANDOFF_M + dx * dx));
+                double rssi = TX_AT_1M_DBM - 10 * PATH_LOSS_EXP * std::log10(d) + fading(rng);
+                if (rssi < SENSITIVITY_DBM) continue;
+                out.push_back({t, room.first + static_cast<int>(k), static_cast<int8_t>(std::lround(rssi))});
+            }
+        }
+    }
+    std::sort(out.begin(), out.end(), [](const advert_t& a, const advert_t& b) { return a.ts_us < b.ts_us; });
+    return out;
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// One visit under a policy (fixed mode, or adaptive when fixed < 0)
+struct radio_t {
+    scan_mode_t mode;
+    uint64_t    since_us;
+    std::vector<uint64_t> starts;
+
+    bool on(uint64_t t_us) const {
+        const mode_timing_t& m = MODES[mode];
+        return (t_us - since_us) % m.interval_us < m.window_us;
+    }
+    // Listening time of the current mode up to t
+    uint64_t listened(uint64_t t_us) const {
+        const mode_timing_t& m = MODES[mode];
+        uint64_t span = t_us - since_us;
+        return span / m.interval_us * m.window_us + std::min<uint64_t>(span % m.interval_us, m.window_us);
+    }
+};
+
+static void run_visit(const std::vector<room_t>& plan, const std::vector<advert_t>& ads, uint64_t end_us,
+                      int fixed, const scan_duty_config_t& duty_config, std::mt19937& rng, outcome_t* out) {
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    scan_duty_t duty;
+    scan_duty_init(&duty, &duty_config, 0);
+    radio_t radio = {fixed >= 0 ? static_cast<scan_mode_t>(fixed) : scan_duty_mode(&duty), 0, {0}};
+    scan_prox_config_t prox_config = scan_proximity_defaults(SCAN_PROX_KALMAN);
+    scan_proximity_t proximity;
+    scan_proximity_init(&proximity, &prox_config);
+    std::vector<uint64_t> last_launch;
+    std::vector<bool> launched;
+    std::vector<std::pair<uint64_t, int>> launches;
+    std::vector<uint64_t> first_heard(plan.size(), 0);
+
+    auto poll = [&](uint64_t now) {
+        scan_mode_t mode;
+        if (fixed >= 0 || !scan_duty_poll(&duty, now, &mode)) return;
+        out->radio_us += radio.listened(now);
+        radio.mode = mode;
+        radio.since_us = now;
+        radio.starts.push_back(now);
+    };
+
+    uint64_t next_tick = TICK_US;
+    for (const advert_t& a : ads) {
+        for (; next_tick <= a.ts_us; next_tick += TICK_US) poll(next_tick);
+        if (!radio.on(a.ts_us) || unit(rng) >= RX_P) continue;
+
+        scan_duty_heard(&duty, a.ts_us);
+        for (size_t r = 0; r < plan.size(); r++) {
+            if (a.ts_us >= plan[r].enter_us && a.ts_us < plan[r].exit_us && !first_heard[r]) first_heard[r] = a.ts_us;
+        }
+        bool changed;
+        int nearest = scan_proximity_update(&proximity, a.artifact, a.rssi, a.ts_us, &changed);
+        if (!changed || nearest < 0) continue;
+        if (static_cast<size_t>(nearest) >= launched.size()) {
+            launched.resize(nearest + 1, false);
+            last_launch.resize(nearest + 1, 0);
+        }
+        if (launched[nearest] && a.ts_us - last_launch[nearest] <= COOLDOWN_US) continue;
+        launched[nearest] = true;
+        last_launch[nearest] = a.ts_us;
+        launches.push_back({a.ts_us, nearest});
+        scan_duty_launched(&duty, a.ts_us);
+    }
+    for (; next_tick <= end_us; next_tick += TICK_US) poll(next_tick);
+    out->radio_us += radio.listened(end_us);
+    out->total_us += end_us;
+    for (const room_t& room : plan) out->in_range_us += room.exit_us - room.enter_us;
+    out->starts += static_cast<uint32_t>(radio.starts.size());
+    out->deferred += duty.deferred;
+    for (size_t i = ANDROID_STARTS; i < radio.starts.size(); i++) {
+        if (radio.starts[i] - radio.starts[i - ANDROID_STARTS] < ANDROID_WINDOW_US) out->start_limit_ok = false;
+    }
+
+    // Scoring, as bench_proximity: the approach to a case counts for it
+    for (size_t r = 0; r < plan.size(); r++) {
+        const room_t& room = plan[r];
+        if (first_heard[r]) out->detect_ms.push_back((first_heard[r] - room.enter_us) / 1000.0);
+        for (size_t i = 0; i < room.visits.size(); i++) {
+            const visit_t& v = room.visits[i];
+            uint64_t from = i ? room.visits[i - 1].leave_us : room.enter_us;
+            out->visits++;
+            for (const auto& l : launches) {
+                if (l.second == v.artifact && l.first >= from && l.first < v.leave_us) {
+                    out->correct++;
+                    out->story_ms.push_back(l.first > v.arrive_us ? (l.first - v.arrive_us) / 1000.0 : 0.0);
+                    break;
+                }
+            }
+            for (const auto& l : launches) {
+                if (l.first >= v.arrive_us && l.first < v.leave_us && l.second != v.artifact) out->wrong++;
+            }
+        }
+    }
+}
+
+static double percentile(std::vector<double> v, double q) {
+    if (v.empty()) return 0;
+    std::sort(v.begin(), v.end());
+    return v[std::min(v.size() - 1, static_cast<size_t>(q * (v.size() - 1) + 0.5))];
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+int main(int argc, char** argv) {
+    uint32_t rooms = 4, cases = 5, visitors = 50, seed = 1;
+    scan_duty_config_t duty = scan_duty_defaults();
+    double max_radio_share = -1, max_story_p95_ms = -1; // -1 = no gate
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (!strcmp(argv[i], "--rooms")) rooms = static_cast<uint32_t>(atoi(argv[i + 1]));
+        else if (!strcmp(argv[i], "--cases")) cases = static_cast<uint32_t>(atoi(argv[i + 1]));
+        else if (!strcmp(argv[i], "--visitors")) visitors = static_cast<uint32_t>(atoi(argv[i + 1]));
+        else if (!strcmp(argv[i], "--seed")) seed = static_cast<uint32_t>(atoi(argv[i + 1]));
+        else if (!strcmp(argv[i], "--idle-after-ms")) duty.idle_after_us = static_cast<uint32_t>(atoi(argv[i + 1])) * 1000;
+        else if (!strcmp(argv[i], "--burst-max-ms")) duty.burst_max_us = static_cast<uint32_t>(atoi(argv[i + 1])) * 1000;
+        else if (!strcmp(argv[i], "--settle-mode")) duty.settle_mode = static_cast<scan_mode_t>(atoi(argv[i + 1]));
+        else if (!strcmp(argv[i], "--cooldown-mode")) duty.cooldown_mode = static_cast<scan_mode_t>(atoi(argv[i + 1]));
+        else if (!strcmp(argv[i], "--max-radio-share")) max_radio_share = atof(argv[i + 1]);
+        else if (!strcmp(argv[i], "--max-story-p95-ms")) max_story_p95_ms = atof(argv[i + 1]);
+    }
+    if (rooms == 0 || cases < 2 || cases > SCAN_PROX_TRACKS || visitors == 0 || duty.settle_mode > SCAN_MODE_LOW_LATENCY ||
+        duty.cooldown_mode > SCAN_MODE_LOW_LATENCY) {
+        fprintf(stderr, "need --rooms > 0, 2 <= --cases <= %d, --visitors > 0 and modes 0-2\n", SCAN_PROX_TRACKS);
+        return 2;
+    }
+
+    static const char* const POLICIES[] = {"low latency", "balanced", "low power", "adaptive"};
+    static const int FIXED[] = {SCAN_MODE_LOW_LATENCY, SCAN_MODE_BALANCED, SCAN_MODE_LOW_POWER, -1};
+    outcome_t out[4];
+    for (outcome_t& o : out) {
+        o = {};
+        o.start_limit_ok = true;
+    }
+    std::mt19937 rng(seed);
+    uint64_t visit_us = 0;
+    for (uint32_t v = 0; v < visitors; v++) {
+        uint64_t end_us;
+        std::vector<room_t> plan = plan_visit(rooms, cases, rng, &end_us);
+        std::vector<advert_t> ads = adverts(plan, cases, rng);
+        visit_us += end_us;
+        for (int p = 0; p < 4; p++) {
+            std::mt19937 rx(seed * 7919u + v); // Same reception luck for every policy
+            run_visit(plan, ads, end_us, FIXED[p], duty, rx, &out[p]);
+        }
+    }
+
+    const outcome_t& adaptive = out[3];
+    const outcome_t& latency = out[0];
+    double in_range = static_cast<double>(adaptive.in_range_us) / adaptive.total_us;
+    printf("%u visitors, %u rooms x %u cases, mean visit %.1f min, %.1f%% of it in beacon range\n", visitors, rooms,
+           cases, visit_us / 60e6 / visitors, 100.0 * in_range);
+    printf("adaptive: idle after %u ms, bursts of %u ms, settle mode %d, cooldown mode %d, %u starts per 30 s\n",
+           duty.idle_after_us / 1000, duty.burst_max_us / 1000, duty.settle_mode, duty.cooldown_mode,
+           duty.max_starts);
+    printf("\n%-12s %7s %9s %9s %9s %9s %8s %7s %7s %9s %9s\n", "policy", "radio", "starts/h", "detect50",
+           "detect95", "correct", "missed", "wrong", "story50", "story95", "deferred");
+    for (int p = 0; p < 4; p++) {
+        const outcome_t& o = out[p];
+        printf("%-12s %6.1f%% %9.1f %8.0fms %8.0fms %9u %8u %7u %6.0fms %8.0fms %9u\n", POLICIES[p],
+               100.0 * o.radio_us / o.total_us, o.starts / (o.total_us / 3600e6), percentile(o.detect_ms, 0.5),
+               percentile(o.detect_ms, 0.95), o.correct, o.visits - o.correct, o.wrong, percentile(o.story_ms, 0.5),
+               percentile(o.story_ms, 0.95), o.deferred);
+    }
+
+    int failures = 0;
+    double share = static_cast<double>(adaptive.radio_us) / adaptive.total_us;
+    double story_p95 = percentile(adaptive.story_ms, 0.95);
+    failures += check(adaptive.start_limit_ok, "adaptive: never more than 5 scan starts in 30 s");
+    failures += check(share <= in_range + 0.25 * (1.0 - in_range), "adaptive: out of range, listens no more than balanced");
+    failures += check(adaptive.correct * 100 >= latency.correct * 95, "adaptive: serves 95% of low latency's visits");
+    if (max_radio_share >= 0 && share > max_radio_share) {
+        fprintf(stderr, "GATE: adaptive radio-on %.3f > %.3f\n", share, max_radio_share);
+        failures++;
+    }
+    if (max_story_p95_ms >= 0 && story_p95 > max_story_p95_ms) {
+        fprintf(stderr, "GATE: adaptive p95 time to the right story %.0f ms > %.0f\n", story_p95, max_story_p95_ms);
+        failures++;
+    }
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,192 @@
+/*
+COS10025 BLE-to-Web Cultural Storytelling System
+Rotating ephemeral IDs: beacon-side precomputation and host-side resolution.
+- AES-128 known-answer check of the OpenSSL block function (FIPS-197 C.1)
+- Beacon side: the firmware's precompute ring (beacon_eid.h) walked across
+  rotation boundaries; every boundary must find its payload ready, so no
+  crypto runs at swap time
+- Host side: --beacons registered with random keys (or --keys from
+  tools/beacon_nvs.py --keys-out); advertised payloads from clock-set and
+  clock-less beacons are decoded and resolved, random IDs must not resolve
+- Throughput: table probes per second over a mix of valid and random IDs, and
+  the cost of sliding the window over --hours
+- Optional gate: exits non-zero on any mismatch, or below --min-resolves-per-s
+
+Usage: bench_eid [--beacons N] [--rotation-exp K] [--window-slots W] [--boot-slots B]
+                 [--lookups N] [--hours H] [--keys keys.csv] [--min-resolves-per-s R]
+*/
+
+#include "beacon_eid.h"
+#include "beacon_payload.h"
+#include "eid_resolver.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#define BENCH_EPOCH 1760000000u // Fixed "now" so runs are reproducible
+
+static double seconds_since(std::chrono::steady_clock::time_point t0) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+static int check(bool ok, const char* what) {
+    if (!ok) fprintf(stderr, "CHECK FAILED: %s\n", what);
+    return ok ? 0 : 1;
+}
+
+int main(int argc, char** argv) {
+    uint32_t beacons = 5000;
+    int rotation_exp = 10;
+    uint32_t window_slots = 1;
+    uint32_t boot_slots = 24;
+    uint32_t lookups = 2000000;
+    double hours = 24.0;
+    const char* keys = nullptr;
+    double min_rate = 0; // 0 = no gate
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (!strcmp(argv[i], "--beacons")) beacons = static_cast<uint32_t>(atoi(argv[i + 1]));
+        else if (!strcmp(argv[i], "--rotation-exp")) rotation_exp = atoi(argv[i + 1]);
+        else if (!strcmp(argv[i], "--window-slots")) window_slots = static_cast<uint32_t>(atoi(argv[i + 1]));
+        else if (!strcmp(argv[i], "--boot-slots")) boot_slots = static_cast<uint32_t>(atoi(argv[i + 1]));
+        else if (!strcmp(argv[i], "--lookups")) lookups = static_cast<uint32_t>(atoi(argv[i + 1]));
+        else if (!strcmp(argv[i], "--hours")) hours = atof(argv[i + 1]);
+        else if (!strcmp(argv[i], "--keys")) keys = argv[i + 1];
+        else if (!strcmp(argv[i], "--min-resolves-per-s")) min_rate = atof(argv[i + 1]);
+    }
+    if (rotation_exp < BEACON_EID_ROTATION_EXP_MIN || rotation_exp > BEACON_EID_ROTATION_EXP_MAX) {
+        fprintf(stderr, "--rotation-exp must be %d–%d\n", BEACON_EID_ROTATION_EXP_MIN, BEACON_EID_ROTATION_EXP_MAX);
+        return 2;
+    }
+    uint8_t exp = static_cast<uint8_t>(rotation_exp);
+    uint32_t period = 1u << exp;
+    int failures = 0;
+
+    // Step 1: AES-128 known answer
+    const uint8_t kat_key[16] = {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+                                 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f};
+    const uint8_t kat_in[16] = {0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77,
+                                0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff};
+    const uint8_t kat_out[16] = {0x69, 0xc4, 0xe0, 0xd8, 0x6a, 0x7b, 0x04, 0x30,
+                                 0xd8, 0xcd, 0xb7, 0x80, 0x70, 0xb4, 0xc5, 0x5a};
+    uint8_t out[16];
+    eid_aes128_openssl(kat_key, kat_in, out);
+    failures += check(memcmp(out, kat_out, 16) == 0, "AES-128 FIPS-197 known answer");
+
+    // Step 2: Registry
+    std::mt19937 rng(12345);
+    eid_resolver_t resolver;
+    eid_resolver_init(&resolver, exp, window_slots, boot_slots);
+    auto t0 = std::chrono::steady_clock::now();
+    if (keys) {
+        if (eid_resolver_load_keys(&resolver, keys) <= 0) {
+            fprintf(stderr, "no beacons in %s\n", keys);
+            return 2;
+        }
+    } else {
+        for (uint32_t b = 0; b < beacons; b++) {
+            uint8_t key[BEACON_EID_KEY_LEN];
+            for (uint8_t& k : key) k = static_cast<uint8_t>(rng());
+            char unit[16];
+            snprintf(unit, sizeof(unit), "unit%05lu", (unsigned long)b + 1);
+            eid_resolver_add(&resolver, unit, 0x0100 + b, key);
+        }
+    }
+    eid_resolver_advance(&resolver, BENCH_EPOCH);
+    double build_s = seconds_since(t0);
+    uint32_t n = static_cast<uint32_t>(resolver.beacons.size());
+
+    printf("ephemeral IDs: %lu beacons, rotation 2^%u = %lu s, window ±%lu slots, %lu boot slots\n",
+           (unsigned long)n, exp, (unsigned long)period, (unsigned long)window_slots, (unsigned long)boot_slots);
+    printf("table: %zu IDs, built in %.3f s (%.0f IDs derived/s)\n", resolver.table.size(), build_s,
+           resolver.derived / build_s);
+
+    // Step 3: Beacon side, as the firmware runs it: ring filled ahead, boundary swaps
+    // must find their payload without deriving, and every payload must resolve
+    uint32_t boundaries = 0, late = 0, wrong = 0;
+    for (uint32_t b = 0; b < n && b < 64; b++) {
+        const eid_registration_t& reg = resolver.beacons[b];
+        bool clock_set = b % 4 != 0; // Every fourth beacon runs on uptime
+        uint32_t counter = clock_set ? BENCH_EPOCH - period / 2 + static_cast<uint32_t>(rng() % period)
+                                     : static_cast<uint32_t>(rng() % (boot_slots > 1 ? (boot_slots - 1) * period : 1));
+        beacon_eid_t eid;
+        beacon_eid_init(&eid, eid_aes128_openssl, reg.key, exp);
+        beacon_eid_fill(&eid, counter);
+        uint32_t end = counter + period; // Cross one rotation boundary each
+        for (;;) {
+            const beacon_payload_t* p = beacon_eid_payload(&eid, counter);
+            beacon_compact_info_t info = {};
+            eid_match_t m = {};
+            if (!p || !beacon_decode_compact(p->bytes, p->len, &info) || !info.has_eid ||
+                !eid_resolver_resolve(&resolver, info.eid, &m) || m.beacon != b || m.artifact_id != reg.artifact_id ||
+                m.slot != beacon_eid_slot(counter, exp) || m.boot_clock == clock_set) {
+                wrong++;
+            }
+            uint32_t next = counter + beacon_eid_next_rotation_s(&eid, counter);
+            if (next > end) break;
+            uint32_t before = eid.computed;
+            counter = next;
+            if (!beacon_eid_payload(&eid, counter)) late++;
+            failures += check(eid.computed == before, "boundary lookup derives nothing");
+            beacon_eid_fill(&eid, counter);
+            boundaries++;
+        }
+    }
+    printf("beacon side: %lu rotation boundaries, %lu without a precomputed ID, %lu payloads not resolved\n",
+           (unsigned long)boundaries, (unsigned long)late, (unsigned long)wrong);
+    failures += check(late == 0 && wrong == 0, "every boundary precomputed and every payload resolved");
+
+    // Step 4: Probe throughput: 90 % IDs on air now, 10 % random
+    std::vector<uint64_t> probes;
+    probes.reserve(lookups);
+    std::vector<uint64_t> valid;
+    for (const auto& e : resolver.table) valid.push_back(e.first);
+    uint32_t random_probes = 0;
+    for (uint32_t i = 0; i < lookups; i++) {
+        if (i % 10 == 9) {
+            probes.push_back((static_cast<uint64_t>(rng()) << 32) | rng());
+            random_probes++;
+        } else {
+            probes.push_back(valid[rng() % valid.size()]);
+        }
+    }
+    t0 = std::chrono::steady_clock::now();
+    uint32_t resolved = 0;
+    for (uint64_t id : probes) {
+        uint8_t eid[BEACON_EID_LEN];
+        memcpy(eid, &id, sizeof(eid));
+        eid_match_t m;
+        resolved += eid_resolver_resolve(&resolver, eid, &m) ? 1 : 0;
+    }
+    double probe_s = seconds_since(t0);
+    double rate = lookups / probe_s;
+    uint32_t false_positives = resolved - (lookups - random_probes);
+    printf("resolve: %lu lookups in %.3f s = %.2f M/s, %lu random IDs resolved\n", (unsigned long)lookups, probe_s,
+           rate / 1e6, (unsigned long)false_positives);
+    failures += check(false_positives == 0, "random IDs do not resolve");
+
+    // Step 5: Window slides over --hours
+    uint64_t derived_before = resolver.derived;
+    uint32_t steps = 0;
+    t0 = std::chrono::steady_clock::now();
+    for (uint32_t t = BENCH_EPOCH + period; t <= BENCH_EPOCH + hours * 3600; t += period) {
+        eid_resolver_advance(&resolver, t);
+        steps++;
+    }
+    double slide_s = seconds_since(t0);
+    if (steps) {
+        printf("window: %lu slides over %.0f h, %.1f ms and %.0f IDs each, table %zu IDs\n", (unsigned long)steps,
+               hours, 1000.0 * slide_s / steps, static_cast<double>(resolver.derived - derived_before) / steps,
+               resolver.table.size());
+    }
+
+    if (min_rate > 0 && rate < min_rate) {
+        fprintf(stderr, "GATE: %.0f resolves/s < %.0f\n", rate, min_rate);
+        failures++;
+    }
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,306 @@
+/*
+COS10025 BLE-to-Web Cultural Storytelling System
+Task layouts under synthetic application load (CONFIG_BEACON_APP_CORE).
+- Fixed-priority preemptive scheduler model of the ESP32 at 1 us resolution:
+  BT controller interrupt work per advertising event, Bluedroid host and
+  esp_timer tasks on core 0, --app-tasks busy tasks at the layout's core and
+  priority, each spending --crit-us of every period with interrupts masked
+- Layouts: unpinned (xTaskCreate at priority 5, the old toggle task),
+  core1 (shipped default: core 1, priority 2), unicore (one core at 80 MHz,
+  sdkconfig.defaults.unicore)
+- Per layout: controller interrupt latency, advertising events whose
+  interrupt was blocked and those that went out late,
+  esp_timer probe latency (the firmware's schedule probe), wake latency of an
+  application-priority probe task, load per core and load periods overrun
+- Same probes as CONFIG_BEACON_INSTRUMENTATION; CONFIG_BEACON_INSTR_LOAD_PERCENT
+  reproduces the load on the board
+- Optional gate on the --gate-layout layout: exits non-zero above
+  --max-ctrl-latency-us or --max-timer-p99-us, or when core1 shows a worse
+  controller latency than unpinned
+
+Usage: bench_layout [--layouts a,b,..] [--seconds S] [--app-tasks N] [--load-percent P]
+                    [--crit-us U] [--seed N] [--gate-layout L] [--max-ctrl-latency-us U]
+                    [--max-timer-p99-us U]
+*/
+
+#include "beacon_core.h"
+#include "bench_util.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <random>
+#include <string>
+#include <vector>
+
+#define BASE_MHZ       160 // Shipped sdkconfig; work figures below are at this clock
+#define ANY_CORE       -1
+#define ISR_PRIORITY   32  // Above every task
+
+// Fixed system work (us at BASE_MHZ)
+#define CTRL_LEAD_US        300  // Controller interrupt ahead of each advertising event
+#define CTRL_WORK_US        40
+#define HOST_PERIOD_US      10000
+#define HOST_WORK_US        30
+#define PROBE_TIMER_WORK_US 15
+#define TELEMETRY_PERIOD_US 1000000 // ADC burst in an esp_timer callback
+#define TELEMETRY_WORK_US   600
+#define PROBE_TASK_WORK_US  5
+#define LOAD_PERIOD_US      10000
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Scheduler model
+enum job_kind_t { JOB_CTRL, JOB_HOST, JOB_TIMER_PROBE, JOB_TELEMETRY, JOB_PROBE_TASK, JOB_LOAD };
+
+struct job_t {
+    job_kind_t kind;
+    uint64_t release_us;
+    uint64_t deadline_us; // Advertising event time for JOB_CTRL
+    double work_left;
+    double crit_from;     // Interrupts masked on the running core while crit_to < work_left <= crit_from
+    double crit_to;
+    bool started;
+};
+
+struct task_t {
+    const char* name;
+    int prio;
+    int core;             // ANY_CORE = no affinity
+    std::deque<job_t> jobs;
+    uint64_t busy_us = 0;
+};
+
+struct layout_t {
+    const char* name;
+    int cores;
+    int mhz;
+    int app_core;
+    int app_prio;
+};
+
+struct result_t {
+    std::vector<double> ctrl_latency, timer_latency, probe_latency;
+    uint32_t adv_events = 0, adv_blocked = 0, adv_late = 0;
+    uint32_t load_periods = 0, load_overruns = 0;
+    double core_load[2] = {};
+};
+
+static const layout_t LAYOUTS[] = {
+    {"unpinned", 2, BASE_MHZ, ANY_CORE, 5},
+    {"core1", 2, BASE_MHZ, 1, 2},
+    {"unicore", 1, 80, 0, 2},
+};
+
+struct bench_opts_t {
+    double seconds = 30.0;
+    int app_tasks = 2;
+    int load_percent = 20;
+    uint32_t crit_us = 50;
+    uint32_t seed = 1;
+};
+
+static result_t run_layout(const layout_t& lay, const bench_opts_t& opt) {
+    std::mt19937 rng(opt.seed);
+    double speed = static_cast<double>(lay.mhz) / BASE_MHZ;
+    uint64_t end = static_cast<uint64_t>(opt.seconds * 1e6);
+    uint64_t adv_period = BEACON_DEFAULT_INTERVAL_MIN * 625u;
+
+    // Step 1: Tasks (index order breaks priority ties)
+    std::vector<task_t> tasks;
+    tasks.push_back({"controller", ISR_PRIORITY, 0, {}});
+    tasks.push_back({"esp_timer", 22, 0, {}});
+    tasks.push_back({"btu", 20, 0, {}});
+    tasks.push_back({"probe", lay.app_prio, lay.app_core, {}});
+    for (int a = 0; a < opt.app_tasks; a++) tasks.push_back({"load", lay.app_prio, lay.app_core, {}});
+    const size_t CTRL = 0, TIMER = 1, HOST = 2, PROBE = 3, LOAD0 = 4;
+
+    uint64_t next_adv = 20000, next_host = 5000, next_probe = 10000, next_telemetry = 500000;
+    std::vector<uint64_t> next_load(opt.app_tasks);
+    for (auto& t : next_load) t = rng() % LOAD_PERIOD_US;
+    std::uniform_int_distribution<uint32_t> adv_delay(0, 10000); // advDelay, 0–10 ms per event
+    double load_work = LOAD_PERIOD_US * opt.load_percent / 100.0;
+    double crit = opt.crit_us < load_work ? opt.crit_us : load_work;
+
+    result_t r;
+    std::vector<uint64_t> core_busy(lay.cores, 0);
+    std::vector<int> on_core(lay.cores, -1);
+
+    for (uint64_t now = 0; now < end; now++) {
+        // Step 2: Releases
+        if (now == next_adv) {
+            uint64_t event = next_adv + CTRL_LEAD_US;
+            tasks[CTRL].jobs.push_back({JOB_CTRL, now, event, CTRL_WORK_US, 0, 0, false});
+            next_adv += adv_period + adv_delay(rng);
+        }
+        if (now == next_host) {
+            tasks[HOST].jobs.push_back({JOB_HOST, now, 0, HOST_WORK_US, 0, 0, false});
+            next_host += HOST_PERIOD_US;
+        }
+        if (now == next_probe) {
+            tasks[TIMER].jobs.push_back({JOB_TIMER_PROBE, now, 0, PROBE_TIMER_WORK_US, 0, 0, false});
+            next_probe += adv_period;
+        }
+        if (now == next_telemetry) {
+            tasks[TIMER].jobs.push_back({JOB_TELEMETRY, now, 0, TELEMETRY_WORK_US, 0, 0, false});
+            next_telemetry += TELEMETRY_PERIOD_US;
+        }
+        for (int a = 0; a < opt.app_tasks; a++) {
+            if (now != next_load[a]) continue;
+            task_t& t = tasks[LOAD0 + a];
+            if (!t.jobs.empty()) r.load_overruns++; // Previous period still running
+            r.load_periods++;
+            // Work varies ±50 % around the mean, the critical section sits anywhere in it
+            double work = load_work * std::uniform_real_distribution<double>(0.5, 1.5)(rng);
+            double crit_from = crit + std::uniform_real_distribution<double>(0, work > crit ? work - crit : 0)(rng);
+            t.jobs.push_back({JOB_LOAD, now, 0, work, crit_from, crit_from - crit, false});
+            next_load[a] += LOAD_PERIOD_US;
+        }
+
+        // Step 3: Dispatch; a job inside a critical section keeps its core
+        std::vector<int> pick(lay.cores, -1);
+        for (int c = 0; c < lay.cores; c++) {
+            int cur = on_core[c];
+            if (cur < 0 || tasks[cur].jobs.empty()) continue;
+            const job_t& j = tasks[cur].jobs.front();
+            if (j.started && j.work_left <= j.crit_from && j.work_left > j.crit_to) pick[c] = cur;
+        }
+        for (int k = 0; k < lay.cores; k++) {
+            int c = (k + static_cast<int>(now)) % lay.cores; // No core gets first pick of unpinned work
+            if (pick[c] >= 0) continue;
+            int best = -1;
+            for (size_t i = 0; i < tasks.size(); i++) {
+                const task_t& t = tasks[i];
+                if (t.jobs.empty() || t.jobs.front().release_us > now) continue;
+                if (t.core != ANY_CORE && t.core % lay.cores != c) continue;
+                bool taken = false;
+                for (int o = 0; o < lay.cores; o++) taken |= pick[o] == static_cast<int>(i);
+                if (taken) continue;
+                // Stay on the core it already runs on at equal priority
+                if (best < 0 || t.prio > tasks[best].prio ||
+                    (t.prio == tasks[best].prio && static_cast<int>(i) == on_core[c])) {
+                    best = static_cast<int>(i);
+                }
+            }
+            pick[c] = best;
+        }
+
+        // Step 4: Run one microsecond on every core
+        for (int c = 0; c < lay.cores; c++) {
+            on_core[c] = pick[c];
+            if (pick[c] < 0) continue;
+            task_t& t = tasks[pick[c]];
+            job_t& j = t.jobs.front();
+            if (!j.started) {
+                j.started = true;
+                double latency = static_cast<double>(now - j.release_us);
+                if (j.kind == JOB_CTRL) {
+                    r.ctrl_latency.push_back(latency);
+                    if (latency > 0) r.adv_blocked++;
+                }
+                else if (j.kind == JOB_TIMER_PROBE) r.timer_latency.push_back(latency);
+                else if (j.kind == JOB_PROBE_TASK) r.probe_latency.push_back(latency);
+            }
+            j.work_left -= speed;
+            core_busy[c]++;
+            t.busy_us++;
+            if (j.work_left > 0) continue;
+
+            // Completion
+            if (j.kind == JOB_CTRL) {
+                r.adv_events++;
+                if (now + 1 > j.deadline_us) r.adv_late++;
+            } else if (j.kind == JOB_TIMER_PROBE) {
+                tasks[PROBE].jobs.push_back({JOB_PROBE_TASK, now + 1, 0, PROBE_TASK_WORK_US, 0, 0, false});
+            }
+            t.jobs.pop_front();
+        }
+    }
+    for (int c = 0; c < lay.cores; c++) r.core_load[c] = 100.0 * core_busy[c] / end;
+    return r;
+}
+
+int main(int argc, char** argv) {
+    bench_opts_t opt;
+    std::string layouts = "unpinned,core1,unicore";
+    std::string gate_layout = "core1";
+    double max_ctrl_us = 0;  // 0 = no gate
+    double max_timer_p99 = 0;
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (!strcmp(argv[i], "--layouts")) layouts = argv[i + 1];
+        else if (!strcmp(argv[i], "--seconds")) opt.seconds = atof(argv[i + 1]);
+        else if (!strcmp(argv[i], "--app-tasks")) opt.app_tasks = atoi(argv[i + 1]);
+        else if (!strcmp(argv[i], "--load-percent")) opt.load_percent = atoi(argv[i + 1]);
+        else if (!strcmp(argv[i], "--crit-us")) opt.crit_us = static_cast<uint32_t>(atoi(argv[i + 1]));
+        else if (!strcmp(argv[i], "--seed")) opt.seed = static_cast<uint32_t>(atoi(argv[i + 1]));
+        else if (!strcmp(argv[i], "--gate-layout")) gate_layout = argv[i + 1];
+        else if (!strcmp(argv[i], "--max-ctrl-latency-us")) max_ctrl_us = atof(argv[i + 1]);
+        else if (!strcmp(argv[i], "--max-timer-p99-us")) max_timer_p99 = atof(argv[i + 1]);
+    }
+    if (opt.app_tasks < 0 || opt.load_percent < 0 || opt.load_percent > 100 || opt.seconds <= 0) {
+        fprintf(stderr, "--app-tasks, --load-percent (0–100) and --seconds out of range\n");
+        return 2;
+    }
+
+    printf("task layouts: %d load task(s) at %d%% of a %d MHz core, %lu us critical section per %d ms, %.0f s\n",
+           opt.app_tasks, opt.load_percent, BASE_MHZ, (unsigned long)opt.crit_us, LOAD_PERIOD_US / 1000,
+           opt.seconds);
+    printf("%-9s %5s %4s %4s %4s | %-16s %-12s | %-16s | %-16s | %7s %7s | %-11s\n", "layout", "cores", "MHz",
+           "core", "prio", "ctrl us p99/max", "blocked/late", "timer us p99/max", "probe us p99/max", "core0 %",
+           "core1 %", "overruns");
+
+    int failures = 0;
+    double ctrl_max_unpinned = -1, ctrl_max_core1 = -1;
+    size_t start = 0;
+    while (start <= layouts.size()) {
+        size_t comma = layouts.find(',', start);
+        std::string name = layouts.substr(start, comma == std::string::npos ? std::string::npos : comma - start);
+        start = comma == std::string::npos ? layouts.size() + 1 : comma + 1;
+        const layout_t* lay = nullptr;
+        for (const layout_t& l : LAYOUTS) {
+            if (name == l.name) lay = &l;
+        }
+        if (!lay) {
+            fprintf(stderr, "unknown layout \"%s\" (unpinned, core1, unicore)\n", name.c_str());
+            return 2;
+        }
+
+        result_t r = run_layout(*lay, opt);
+        summary_t ctrl = summarise(r.ctrl_latency);
+        summary_t timer = summarise(r.timer_latency);
+        summary_t probe = summarise(r.probe_latency);
+        char core_str[4];
+        snprintf(core_str, sizeof(core_str), "%s", lay->app_core == ANY_CORE ? "any" : lay->app_core ? "1" : "0");
+        char core1[16] = "-";
+        if (lay->cores > 1) snprintf(core1, sizeof(core1), "%7.1f", r.core_load[1]);
+        char blocked[24];
+        snprintf(blocked, sizeof(blocked), "%lu/%lu", (unsigned long)r.adv_blocked, (unsigned long)r.adv_late);
+        char overruns[24];
+        snprintf(overruns, sizeof(overruns), "%lu/%lu", (unsigned long)r.load_overruns,
+                 (unsigned long)r.load_periods);
+        printf("%-9s %5d %4d %4s %4d | %7.0f/%-8.0f %-12s | %7.0f/%-8.0f | %7.0f/%-8.0f | %7.1f %7s | %-11s\n",
+               lay->name, lay->cores, lay->mhz, core_str, lay->app_prio, ctrl.p99, ctrl.max, blocked, timer.p99,
+               timer.max, probe.p99, probe.max, r.core_load[0], core1, overruns);
+
+        if (!strcmp(lay->name, "unpinned")) ctrl_max_unpinned = ctrl.max;
+        if (!strcmp(lay->name, "core1")) ctrl_max_core1 = ctrl.max;
+        if (gate_layout == lay->name) {
+            if (max_ctrl_us > 0 && ctrl.max > max_ctrl_us) {
+                fprintf(stderr, "GATE: %s controller latency %.0f us > %.0f us\n", lay->name, ctrl.max, max_ctrl_us);
+                failures++;
+            }
+            if (max_timer_p99 > 0 && timer.p99 > max_timer_p99) {
+                fprintf(stderr, "GATE: %s esp_timer probe p99 %.0f us > %.0f us\n", lay->name, timer.p99,
+                        max_timer_p99);
+                failures++;
+            }
+        }
+    }
+    if (ctrl_max_unpinned >= 0 && ctrl_max_core1 > ctrl_max_unpinned) {
+        fprintf(stderr, "GATE: core1 controller latency %.0f us worse than unpinned %.0f us\n", ctrl_max_core1,
+                ctrl_max_unpinned);
+        failures++;
+    }
+    return failures ? 1 : 0;
+}
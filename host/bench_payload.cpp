@@ -0,0 +1,108 @@
+/*
+COS10025 BLE-to-Web Cultural Storytelling System
+Live payload updates on the simulated controller (double-buffered swaps).
+- Telemetry-style updates every --update-ms while advertising; each payload
+  carries an increasing counter as its compact artifact ID
+- --burst N issues N updates back to back per tick (exercises coalescing)
+- Checks every advertising event on air: malformed payloads (no compact ID)
+  and stale ones (older counter after a newer one was on air)
+- Reports swap latency and the advertising gaps spanning a swap; --restart-gap-us
+  models a controller that restarts the advertising set on a data change
+- Optional gate: exits non-zero on malformed/stale events or more missed events
+  than --max-missed
+
+Usage: bench_payload [--update-ms MS] [--burst N] [--seconds S] [--restart-gap-us U]
+                     [--max-missed N]
+*/
+
+#include "beacon_core.h"
+#include "beacon_payload.h"
+#include "sim_controller.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+int main(int argc, char** argv) {
+    double update_ms = 2000.0;
+    int burst = 1;
+    double seconds = 600.0;
+    uint32_t restart_gap_us = 0;
+    long max_missed = -1; // -1 = no gate
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (!strcmp(argv[i], "--update-ms")) update_ms = atof(argv[i + 1]);
+        else if (!strcmp(argv[i], "--burst")) burst = atoi(argv[i + 1]);
+        else if (!strcmp(argv[i], "--seconds")) seconds = atof(argv[i + 1]);
+        else if (!strcmp(argv[i], "--restart-gap-us")) restart_gap_us = static_cast<uint32_t>(atoi(argv[i + 1]));
+        else if (!strcmp(argv[i], "--max-missed")) max_missed = atol(argv[i + 1]);
+    }
+    if (update_ms <= 0 || burst < 1) {
+        fprintf(stderr, "--update-ms and --burst must be positive\n");
+        return 2;
+    }
+
+    sim_timing_t timing;
+    timing.data_update_gap_us = restart_gap_us;
+    sim_controller_t sim;
+    sim_controller_init(&sim, timing);
+
+    // Step 1: Boot to advertising with counter 1 on air
+    uint32_t counter = 1;
+    beacon_payload_t payload = beacon_encode_compact(counter);
+    beacon_t beacon;
+    beacon_init(&beacon, sim_controller_backend(&sim), payload.bytes, payload.len);
+    if (beacon_start(&beacon) != BEACON_OK) return 1;
+    uint64_t t = beacon.marks_us[BEACON_MARK_START];
+    uint64_t end = t + static_cast<uint64_t>(seconds * 1e6);
+    sim_controller_run_until(&sim, t + 1000000);
+    if (beacon.state != BEACON_STATE_ADVERTISING) {
+        fprintf(stderr, "beacon not advertising (state %s)\n", beacon_state_name(beacon.state));
+        return 1;
+    }
+
+    // Step 2: Telemetry ticks
+    uint64_t step_us = static_cast<uint64_t>(update_ms * 1000.0);
+    uint32_t rejected = 0;
+    for (t = sim.now_us + step_us; t < end; t += step_us) {
+        sim_controller_run_until(&sim, t);
+        for (int b = 0; b < burst; b++) {
+            payload = beacon_encode_compact(++counter);
+            if (beacon_update_payload(&beacon, payload.bytes, payload.len) != BEACON_OK) rejected++;
+        }
+    }
+    sim_controller_run_until(&sim, end + 1000000); // Let the last swap land
+
+    // Step 3: Check what went on air
+    uint32_t malformed = 0, stale = 0, distinct = 0, newest = 0;
+    for (uint32_t id : sim.adv_artifacts) {
+        if (id == 0) malformed++;
+        else if (id < newest) stale++;
+        else if (id > newest) {
+            distinct++;
+            newest = id;
+        }
+    }
+
+    printf("live payload updates: every %.0f ms x %d, %.0f s, %s controller\n", update_ms, burst, seconds,
+           restart_gap_us ? "set-restart" : "seamless");
+    printf("advertising events: %zu, distinct payloads on air %lu, malformed %lu, stale %lu\n",
+           sim.adv_artifacts.size(), (unsigned long)distinct, (unsigned long)malformed, (unsigned long)stale);
+    printf("final payload on air: %lu (last requested %lu), %lu updates rejected\n", (unsigned long)newest,
+           (unsigned long)counter, (unsigned long)rejected);
+    beacon_swap_print(&beacon, stdout);
+    beacon_hist_print(&beacon.adv_gap_hist, "advertising event gap", stdout);
+    beacon_hist_print(&beacon.swap.latency, "swap latency", stdout);
+
+    int rc = 0;
+    if (malformed || stale || newest != counter) {
+        fprintf(stderr, "GATE: payload on air was malformed, stale or not the last update\n");
+        rc = 1;
+    }
+    if (max_missed >= 0 && beacon.swap.gaps_missed > static_cast<uint32_t>(max_missed)) {
+        fprintf(stderr, "GATE: %lu missed events around swaps > %ld\n", (unsigned long)beacon.swap.gaps_missed,
+                max_missed);
+        rc = 1;
+    }
+    return rc;
+}
@@ -0,0 +1,279 @@
+/*
+COS10025 BLE-to-Web Cultural Storytelling System
+Scan-event pipeline on dense beacon traffic: per report vs batched.
+- Traffic: scan_traffic.h mixes (gallery, dense, crowd). A visitor walks the
+  row of artifact beacons (2 m apart, 2 s walk then 5 s at each), so artifact
+  RSSI follows log-distance path loss plus fading and the nearest artifact
+  keeps changing
+- Paths from the scanner engine to the UI:
+    per report  what the app did: every matched advertisement crossed to
+                Dart and called setState, every advertisement was printed
+    batched     scan_batch.h (250 ms windows, proximity engine inside): the
+                UI hears only changed decisions and new telemetry
+- Throughput (measured): nanoseconds per report for engine + path, best of
+  three passes; UI messages and rebuilds per second (counted)
+- Frame time (modelled, the UI cannot run here): a 60 Hz UI thread spending
+  --message-us per message reaching Dart, --print-us per print and
+  --build-us per frame rebuilt after setState; reports busy share, p99 frame
+  work and frames over the 16.7 ms budget
+- Checks: the batched path ends on the same decision as the proximity
+  engine fed directly, shows every artifact's telemetry, and never misses a
+  frame; optional gate --min-reports-per-s on the batched path
+
+Usage: bench_pipeline [--seconds S] [--message-us N] [--print-us N] [--build-us N]
+                      [--min-reports-per-s N]
+*/
+
+#include "scan_batch.h"
+#include "scan_traffic.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#define WINDOW_US     250000
+#define FRAME_US      16667
+#define SPACING_M     2.0
+#define WALK_US       2000000ULL
+#define DWELL_US      5000000ULL
+
+struct mix_t {
+    const char* name;
+    uint32_t artifacts, others;
+};
+
+static const mix_t MIXES[] = {
+    {"gallery", 8, 60},
+    {"dense", 32, 16},
+    {"crowd", 32, 300},
+};
+
+struct ui_cost_t {
+    double message_us = 60;  // Platform channel decode + Dart handler
+    double print_us = 40;    // print() to the device log
+    double build_us = 1500;  // Rebuild, layout and paint of the app's one screen
+};
+
+// What reaches the UI thread, in time order
+struct ui_event_t {
+    uint64_t ts_us;
+    bool     message;
+    bool     print;
+    bool     build;  // setState
+};
+
+struct path_result_t {
+    double   ns_per_report;
+    uint64_t messages, prints, builds;
+    int      final_nearest;
+    std::vector<bool> telemetry_seen;
+    std::vector<ui_event_t> ui;
+};
+
+struct frame_result_t {
+    double busy_share, p99_ms;
+    uint64_t late;
+};
+
+static int check(bool ok, const char* what) {
+    if (!ok) fprintf(stderr, "CHECK FAILED: %s\n", what);
+    return ok ? 0 : 1;
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Visitor walk: artifact k stands at k * SPACING_M, 0.7 m from the path
+static double visitor_x(uint64_t t_us, uint32_t artifacts) {
+    uint64_t leg = WALK_US + DWELL_US;
+    uint32_t k = static_cast<uint32_t>(t_us / leg) % artifacts;
+    uint64_t into = t_us % leg;
+    double to = k * SPACING_M;
+    double from = k ? (k - 1) * SPACING_M : to - SPACING_M;
+    return into >= WALK_US ? to : from + (to - from) * into / static_cast<double>(WALK_US);
+}
+
+static void walk_rssi(std::vector<scan_traffic_event_t>& traffic, uint32_t artifacts, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::normal_distribution<double> fading(0.0, 4.0);
+    for (scan_traffic_event_t& e : traffic) {
+        if (e.truth < 0) continue;
+        double dx = visitor_x(e.ts_us, artifacts) - e.truth * SPACING_M;
+        double d = std::sqrt(0.49 + dx * dx);
+        double rssi = -59.0 - 22.0 * std::log10(d) + fading(rng);
+        e.evt[e.len - 1] = static_cast<uint8_t>(static_cast<int8_t>(std::lround(std::max(-100.0, rssi))));
+    }
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Paths
+struct per_report_ctx_t {
+    path_result_t*   out;
+    scan_proximity_t proximity;
+};
+
+static void per_report_match(void* arg, const scan_match_t* match) {
+    per_report_ctx_t* ctx = static_cast<per_report_ctx_t*>(arg);
+    // The UI got the report itself; the decision is only tracked for the check
+    ctx->out->final_nearest = scan_proximity_update(&ctx->proximity, match->artifact, match->rssi, match->ts_us, nullptr);
+    ctx->out->messages++;
+    ctx->out->builds++;
+    ctx->out->ui.push_back({match->ts_us, true, false, true});
+}
+
+struct batched_ctx_t {
+    path_result_t* out;
+    scan_batch_t   batch;
+};
+
+static void batched_match(void* arg, const scan_match_t* match) {
+    batched_ctx_t* ctx = static_cast<batched_ctx_t*>(arg);
+    if (!scan_batch_add(&ctx->batch, match)) return;
+    scan_batch_notice_t notice;
+    if (!scan_batch_flush(&ctx->batch, match->ts_us, &notice)) return;
+    for (uint8_t i = 0; i < notice.changed; i++) {
+        ctx->out->telemetry_seen[notice.beacons[i]->artifact] = true;
+        scan_batch_sent(&ctx->batch, notice.beacons[i]);
+    }
+    ctx->out->messages++;
+    ctx->out->builds += notice.nearest_changed;
+    ctx->out->final_nearest = notice.nearest;
+    ctx->out->ui.push_back({match->ts_us, true, false, notice.nearest_changed});
+}
+
+static path_result_t run_path(bool batched, const scan_artifacts_t& artifacts,
+                              const std::vector<scan_traffic_event_t>& traffic) {
+    path_result_t best = {};
+    scan_prox_config_t config = scan_proximity_defaults(SCAN_PROX_KALMAN);
+    for (int pass = 0; pass < 3; pass++) {
+        path_result_t r = {};
+        r.final_nearest = -1;
+        r.telemetry_seen.assign(artifacts.count, false);
+        r.ui.reserve(traffic.size() + 1);
+        per_report_ctx_t per_report = {&r, {}};
+        scan_proximity_init(&per_report.proximity, &config);
+        static batched_ctx_t batch; // Too large for the stack in some sanitizer builds
+        batch.out = &r;
+        scan_batch_init(&batch.batch, WINDOW_US, &config);
+
+        scan_engine_t engine;
+        if (batched) scan_engine_init(&engine, scan_backend_t{}, &artifacts, batched_match, nullptr, &batch);
+        else scan_engine_init(&engine, scan_backend_t{}, &artifacts, per_report_match, nullptr, &per_report);
+        auto t0 = std::chrono::steady_clock::now();
+        for (const scan_traffic_event_t& e : traffic) {
+            scan_engine_feed(&engine, e.evt, e.len, e.ts_us);
+            if (!batched) r.prints++; // The listen callback printed every device
+        }
+        r.ns_per_report = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count() /
+                          traffic.size();
+        if (pass == 0 || r.ns_per_report < best.ns_per_report) best = std::move(r);
+    }
+    if (!batched) {
+        // Prints land on the UI thread with the reports they belong to
+        std::vector<ui_event_t> ui;
+        ui.reserve(best.ui.size() + traffic.size());
+        for (const scan_traffic_event_t& e : traffic) ui.push_back({e.ts_us, false, true, false});
+        ui.insert(ui.end(), best.ui.begin(), best.ui.end());
+        std::stable_sort(ui.begin(), ui.end(), [](const ui_event_t& a, const ui_event_t& b) { return a.ts_us < b.ts_us; });
+        best.ui = std::move(ui);
+    }
+    return best;
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// UI thread model: work arriving in a frame is done in that frame, plus one
+// rebuild when anything called setState
+static frame_result_t frames(const std::vector<ui_event_t>& ui, const ui_cost_t& cost, double seconds) {
+    uint64_t n = static_cast<uint64_t>(seconds * 1e6 / FRAME_US);
+    std::vector<double> work(n, 0.0);
+    std::vector<bool> dirty(n, false);
+    for (const ui_event_t& e : ui) {
+        uint64_t f = std::min(n - 1, e.ts_us / FRAME_US);
+        work[f] += (e.message ? cost.message_us : 0) + (e.print ? cost.print_us : 0);
+        if (e.build) dirty[f] = true;
+    }
+    frame_result_t r = {};
+    double total = 0;
+    for (uint64_t f = 0; f < n; f++) {
+        if (dirty[f]) work[f] += cost.build_us;
+        total += work[f];
+        r.late += work[f] > FRAME_US;
+    }
+    r.busy_share = total / (n * FRAME_US);
+    std::sort(work.begin(), work.end());
+    r.p99_ms = work[static_cast<size_t>(0.99 * (n - 1))] / 1000.0;
+    return r;
+}
+
+int main(int argc, char** argv) {
+    double seconds = 60;
+    ui_cost_t cost;
+    double min_rps = 0; // 0 = no gate
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (!strcmp(argv[i], "--seconds")) seconds = atof(argv[i + 1]);
+        else if (!strcmp(argv[i], "--message-us")) cost.message_us = atof(argv[i + 1]);
+        else if (!strcmp(argv[i], "--print-us")) cost.print_us = atof(argv[i + 1]);
+        else if (!strcmp(argv[i], "--build-us")) cost.build_us = atof(argv[i + 1]);
+        else if (!strcmp(argv[i], "--min-reports-per-s")) min_rps = atof(argv[i + 1]);
+    }
+    if (seconds < 10) {
+        fprintf(stderr, "need --seconds >= 10\n");
+        return 2;
+    }
+
+    printf("UI model: %.0f us per message, %.0f us per print, %.0f us per rebuild, 60 Hz\n", cost.message_us,
+           cost.print_us, cost.build_us);
+    printf("\n%-8s %9s %9s  %-10s %9s %9s %9s %9s %7s %8s %6s\n", "mix", "reports/s", "matched/s", "path",
+           "ns/report", "msgs/s", "prints/s", "builds/s", "busy", "p99 ms", "late");
+
+    int failures = 0;
+    double worst_rps = 0;
+    for (const mix_t& mix : MIXES) {
+        scan_traffic_config_t config;
+        config.artifacts = mix.artifacts;
+        config.name_beacons = 0;
+        config.others = mix.others;
+        config.seconds = seconds;
+        scan_artifacts_t artifacts;
+        scan_traffic_artifacts(config, &artifacts);
+        std::vector<scan_traffic_event_t> traffic = scan_traffic_generate(config);
+        walk_rssi(traffic, artifacts.count, config.seed);
+        uint64_t matched = 0;
+        for (const scan_traffic_event_t& e : traffic) matched += e.truth >= 0;
+
+        path_result_t paths[2] = {run_path(false, artifacts, traffic), run_path(true, artifacts, traffic)};
+        static const char* const NAMES[] = {"per report", "batched"};
+        frame_result_t frame[2];
+        for (int p = 0; p < 2; p++) {
+            const path_result_t& r = paths[p];
+            frame[p] = frames(r.ui, cost, seconds);
+            printf("%-8s %9.0f %9.0f  %-10s %9.1f %9.1f %9.1f %9.1f %6.1f%% %8.2f %6lu\n", p ? "" : mix.name,
+                   traffic.size() / seconds, matched / seconds, NAMES[p], r.ns_per_report, r.messages / seconds,
+                   r.prints / seconds, r.builds / seconds, 100.0 * frame[p].busy_share, frame[p].p99_ms,
+                   (unsigned long)frame[p].late);
+        }
+
+        const path_result_t& batched = paths[1];
+        double rps = 1e9 / batched.ns_per_report;
+        if (worst_rps == 0 || rps < worst_rps) worst_rps = rps;
+        char what[96];
+        snprintf(what, sizeof(what), "%s: batched path ends on the engine's decision", mix.name);
+        failures += check(batched.final_nearest == paths[0].final_nearest, what);
+        snprintf(what, sizeof(what), "%s: every artifact's telemetry reaches the app", mix.name);
+        failures += check(std::all_of(batched.telemetry_seen.begin(), batched.telemetry_seen.end(),
+                                      [](bool seen) { return seen; }),
+                          what);
+        snprintf(what, sizeof(what), "%s: batched path never misses a frame", mix.name);
+        failures += check(frame[1].late == 0, what);
+    }
+
+    if (min_rps > 0 && worst_rps < min_rps) {
+        fprintf(stderr, "GATE: batched %.0f reports/s < %.0f\n", worst_rps, min_rps);
+        failures++;
+    }
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,213 @@
+/*
+COS10025 BLE-to-Web Cultural Storytelling System
+Adaptive advertising interval policy over one simulated day.
+- Same rule table as the firmware defaults (CONFIG_BEACON_POLICY): fast window
+  after boot, slow or off during closed hours, normal interval otherwise
+- Table checks: the selected rule at fixed (uptime, time of day) points
+- Day walk: boots at --boot-at, drives the beacon core on the simulated
+  controller through every transition (profile change = stop + restart), logs
+  each transition's energy/latency trade-off and checks the advertising events
+  the controller actually sent against the rule in force
+- Daily charge against a beacon that stays on the normal interval all day
+- Exits non-zero when a check fails
+
+Usage: bench_policy [--boot-at HH:MM] [--fast-s S] [--closed HH:MM-HH:MM] [--closed-off]
+*/
+
+#include "beacon_core.h"
+#include "beacon_config.h"
+#include "beacon_energy.h"
+#include "beacon_payload.h"
+#include "beacon_policy.h"
+#include "sim_controller.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#define DAY_S 86400u
+
+static bool parse_hhmm(const char* s, uint16_t* out) {
+    int h = 0, m = 0;
+    if (sscanf(s, "%d:%d", &h, &m) != 2 || h < 0 || h > 23 || m < 0 || m > 59) return false;
+    *out = static_cast<uint16_t>(h * 60 + m);
+    return true;
+}
+
+static int check(bool ok, const char* what) {
+    if (!ok) fprintf(stderr, "CHECK FAILED: %s\n", what);
+    return ok ? 0 : 1;
+}
+
+int main(int argc, char** argv) {
+    uint16_t boot_at = 6 * 60 + 50;
+    uint32_t fast_s = 30;
+    uint16_t closed_start = 17 * 60 + 30, closed_end = 7 * 60;
+    bool closed_off = false;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--closed-off")) closed_off = true;
+        else if (i + 1 >= argc) break;
+        else if (!strcmp(argv[i], "--boot-at")) parse_hhmm(argv[++i], &boot_at);
+        else if (!strcmp(argv[i], "--fast-s")) fast_s = static_cast<uint32_t>(atoi(argv[++i]));
+        else if (!strcmp(argv[i], "--closed")) {
+            char start[6] = {}, end[6] = {};
+            if (sscanf(argv[++i], "%5[0-9:]-%5[0-9:]", start, end) != 2 ||
+                !parse_hhmm(start, &closed_start) || !parse_hhmm(end, &closed_end)) {
+                fprintf(stderr, "--closed expects HH:MM-HH:MM\n");
+                return 2;
+            }
+        }
+    }
+
+    // Step 1: Rule table (firmware defaults)
+    beacon_policy_t policy;
+    beacon_policy_init(&policy);
+    beacon_policy_rule_t fast = {"boot-fast", BEACON_POLICY_BOOT_WINDOW, fast_s, 0, 0, 0x0020, 0x0030};
+    beacon_policy_rule_t closed = {closed_off ? "closed-off" : "closed-slow", BEACON_POLICY_DAILY, 0,
+                                   closed_start, closed_end, 0, 0};
+    if (!closed_off) {
+        closed.interval_min = 0x0640; // 1 s
+        closed.interval_max = 0x0780; // 1.2 s
+    }
+    beacon_policy_rule_t normal = {"normal", BEACON_POLICY_ALWAYS, 0, 0, 0, BEACON_DEFAULT_INTERVAL_MIN,
+                                   BEACON_DEFAULT_INTERVAL_MAX};
+    beacon_policy_add(&policy, &fast);
+    beacon_policy_add(&policy, &closed);
+    beacon_policy_add(&policy, &normal);
+
+    // Step 2: Table checks
+    int failures = 0;
+    struct { uint32_t uptime_s; int32_t minute; int rule; const char* what; } cases[] = {
+        {0, BEACON_POLICY_CLOCK_UNKNOWN, 0, "boot window with the clock unknown"},
+        {fast_s, BEACON_POLICY_CLOCK_UNKNOWN, 2, "clock unknown: closed hours never match (fail open)"},
+        {fast_s, closed_start, 1, "closed at the start boundary"},
+        {fast_s, closed_end, 2, "open at the end boundary"},
+        {fast_s - 1, closed_start, 0, "boot window wins over closed hours"},
+        {fast_s, (closed_start + 1) % BEACON_POLICY_MINUTES_DAY, 1, "closed just after the start"},
+    };
+    for (const auto& c : cases) {
+        beacon_policy_input_t in = {c.uptime_s, c.minute};
+        failures += check(beacon_policy_select(&policy, &in) == c.rule, c.what);
+    }
+    beacon_policy_input_t in0 = {0, closed_start};
+    failures += check(beacon_policy_next_change_s(&policy, &in0, 3600) == fast_s, "next change = boot window end");
+
+    // Step 3: Day walk on the simulated controller
+    sim_timing_t timing;
+    sim_controller_t sim;
+    sim_controller_init(&sim, timing);
+    beacon_payload_t payload = beacon_encode_compact(0x0002);
+    beacon_t beacon;
+    beacon_init(&beacon, sim_controller_backend(&sim), payload.bytes, payload.len);
+    beacon_power_profile_t profile = beacon_power_profile_light_sleep();
+
+    uint64_t boot_us = sim.now_us;
+    auto input_at = [&](uint64_t t_us) {
+        uint32_t up = static_cast<uint32_t>((t_us - boot_us) / 1000000);
+        beacon_policy_input_t in = {up, static_cast<int32_t>((boot_at + up / 60) % BEACON_POLICY_MINUTES_DAY)};
+        return in;
+    };
+
+    struct segment_t { uint64_t from_us, to_us; int rule; };
+    std::vector<segment_t> segments;
+    double charge_mc = 0, charge_normal_mc = 0;
+    beacon_policy_cost_t normal_cost = beacon_policy_cost(&normal, &profile, payload.len, BEACON_ADV_CHANNEL_ALL);
+
+    printf("adaptive interval policy: boot at %02u:%02u, closed %02u:%02u-%02u:%02u (%s), fast window %lu s\n",
+           boot_at / 60, boot_at % 60, closed_start / 60, closed_start % 60, closed_end / 60, closed_end % 60,
+           closed_off ? "off" : "slow", (unsigned long)fast_s);
+    printf("%-9s %-12s → %-12s %9s %9s %12s %12s\n", "uptime", "from", "to", "mA", "Δ mA", "latency ms",
+           "Δ latency");
+
+    uint64_t t = boot_us;
+    uint64_t end = boot_us + DAY_S * 1000000ULL;
+    bool started = false;
+    while (t < end) {
+        beacon_policy_input_t in = input_at(t);
+        int from = -1;
+        if (beacon_policy_update(&policy, &in, &from)) {
+            const beacon_policy_rule_t* to_rule = &policy.rules[policy.active];
+            beacon_adv_params_t params = {};
+            bool on = beacon_policy_params(to_rule, BEACON_ADV_CHANNEL_ALL, &params);
+
+            // Apply: first boot starts the stack, later changes restart, stop or resume
+            if (!started) {
+                if (on) beacon_set_profile(&beacon, &params, BEACON_DEFAULT_TX_POWER_DBM);
+                beacon_start(&beacon);
+                started = true;
+                if (!on) {
+                    sim_controller_run_until(&sim, sim.now_us + 20000);
+                    beacon_stop(&beacon);
+                }
+            } else if (!on) {
+                beacon_stop(&beacon);
+            } else if (beacon.state == BEACON_STATE_STOPPED) {
+                beacon_change_profile(&beacon, &params);
+                beacon_resume(&beacon);
+            } else {
+                beacon_change_profile(&beacon, &params);
+            }
+
+            beacon_policy_cost_t to_cost = beacon_policy_cost(to_rule, &profile, payload.len, BEACON_ADV_CHANNEL_ALL);
+            beacon_policy_cost_t from_cost = from >= 0
+                ? beacon_policy_cost(&policy.rules[from], &profile, payload.len, BEACON_ADV_CHANNEL_ALL)
+                : to_cost;
+            char latency[16] = "off", delta[16] = "-";
+            if (to_cost.mean_latency_ms >= 0) snprintf(latency, sizeof(latency), "%.1f", to_cost.mean_latency_ms);
+            if (to_cost.mean_latency_ms >= 0 && from_cost.mean_latency_ms >= 0) {
+                snprintf(delta, sizeof(delta), "%+.1f", to_cost.mean_latency_ms - from_cost.mean_latency_ms);
+            }
+            printf("%8lus %-12s → %-12s %9.2f %+9.2f %12s %12s\n", (unsigned long)in.uptime_s,
+                   from >= 0 ? policy.rules[from].name : "-", to_rule->name, to_cost.avg_current_ma,
+                   to_cost.avg_current_ma - from_cost.avg_current_ma, latency, delta);
+            if (!segments.empty()) segments.back().to_us = t;
+            segments.push_back({t, end, policy.active});
+        }
+
+        uint64_t step = beacon_policy_next_change_s(&policy, &in, 3600) * 1000000ULL;
+        uint64_t next = t + step < end ? t + step : end;
+        const beacon_policy_cost_t cost =
+            beacon_policy_cost(&policy.rules[policy.active], &profile, payload.len, BEACON_ADV_CHANNEL_ALL);
+        charge_mc += cost.avg_current_ma * (next - t) / 1e6;
+        charge_normal_mc += normal_cost.avg_current_ma * (next - t) / 1e6;
+        sim_controller_run_until(&sim, next);
+        t = next;
+    }
+
+    // Step 4: Events on air per segment against the rule in force
+    // - Skip the restart round trip at the start of each segment
+    printf("\n%-12s %10s %10s %14s\n", "segment", "length s", "events", "mean gap ms");
+    size_t k = 0;
+    for (const segment_t& seg : segments) {
+        const beacon_policy_rule_t* rule = &policy.rules[seg.rule];
+        uint64_t settle = seg.from_us + 50000;
+        uint64_t last = 0, gaps = 0, gap_sum = 0, n = 0;
+        while (k < sim.adv_times_us.size() && sim.adv_times_us[k] < seg.to_us) {
+            uint64_t at = sim.adv_times_us[k++];
+            if (at < settle) continue;
+            if (last) {
+                gap_sum += at - last;
+                gaps++;
+            }
+            last = at;
+            n++;
+        }
+        double mean_gap_ms = gaps ? gap_sum / 1000.0 / gaps : 0.0;
+        printf("%-12s %10.0f %10lu %14.1f\n", rule->name, (seg.to_us - seg.from_us) / 1e6, (unsigned long)n,
+               mean_gap_ms);
+        if (rule->interval_min == 0) {
+            failures += check(n == 0, "no advertising events while the policy has advertising off");
+        } else if (gaps > 0) {
+            double lo = rule->interval_min * 0.625, hi = rule->interval_max * 0.625 + 10.0;
+            failures += check(mean_gap_ms >= lo && mean_gap_ms <= hi, "event spacing matches the rule in force");
+        }
+    }
+
+    printf("\ndaily charge: %.0f mAh with the policy, %.0f mAh on the normal interval all day (%.0f%%)\n",
+           charge_mc / 3600.0, charge_normal_mc / 3600.0, 100.0 * charge_mc / charge_normal_mc);
+    printf("%lu transitions, %lu startup retries\n", (unsigned long)policy.transitions,
+           (unsigned long)beacon.retry_total);
+    return failures ? 1 : 0;
+}
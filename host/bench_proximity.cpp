@@ -0,0 +1,385 @@
+/*
+COS10025 BLE-to-Web Cultural Storytelling System
+Launch decisions on replayed visitor walks: which story opens, and when.
+- Gallery: --cases display cases in a row, --spacing metres apart (default: a
+  run at 1, 1.5, 2 and 3 m), one compact beacon inside each (100 ms interval)
+- Visitor: walks along the row 0.7 m from the glass at 1 m/s, stops at every
+  case for 10–30 s. The phone hears about half the advertisements; RSSI is
+  log-distance path loss plus slow body shadowing per beacon, fast fading and
+  occasional deep fades
+- Each walk is written as a btsnoop capture and replayed through the replay
+  backend and the scanner engine, exactly as the kiosk runner reads one
+- Policies on the matched reports, all with the app's 30 s per-artifact cooldown:
+    app 2 s   what the app did: launch the first artifact heard if it is
+              still the last one heard 2 s later
+    ema       proximity engine, EMA filter (scan_proximity.h)
+    kalman    proximity engine, Kalman filter (the app's default)
+- Per visit: time from stopping at a case to its story opening (0 if it opened
+  on the approach), missed visits, and wrong triggers: a story other than the
+  case the visitor stands at, or one of a case not adjacent to the walk
+- Checks (Kalman policy against the app, every spacing): no more wrong
+  triggers, more visits served and a faster median; optional gates on the
+  Kalman policy in every scenario
+
+Usage: bench_proximity [--cases N] [--spacing M] [--visitors N] [--seed N]
+                       [--write-capture FILE] [--max-wrong-rate R] [--max-p95-ms N]
+*/
+
+#include "scan_proximity.h"
+#include "scan_replay.h"
+#include "beacon_payload.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <unistd.h>
+#include <vector>
+
+#define STANDOFF_M       0.7
+#define WALK_M_PER_S     1.0
+#define APPROACH_M       3.0
+#define TX_AT_1M_DBM     -59.0
+#define PATH_LOSS_EXP    2.2
+#define SHADOW_SIGMA_DB  3.0
+#define SHADOW_TAU_S     5.0
+#define FADING_SIGMA_DB  4.0
+#define DEEP_FADE_P      0.08
+#define RX_P             0.5
+#define SENSITIVITY_DBM  -95
+#define COOLDOWN_US      30000000ULL
+#define APP_DELAY_US     2000000ULL
+
+struct visit_t {
+    int      artifact;
+    uint64_t arrive_us, leave_us;
+};
+
+struct walk_t {
+    std::vector<visit_t> visits;
+    uint64_t end_us;
+    double   spacing_m;
+};
+
+struct report_t {
+    uint64_t ts_us;
+    int      artifact;
+    int8_t   rssi;
+};
+
+struct launch_t {
+    uint64_t ts_us;
+    int      artifact;
+};
+
+struct outcome_t {
+    uint32_t visits, correct, wrong, transit;
+    std::vector<double> decide_ms;
+};
+
+static int check(bool ok, const char* what) {
+    if (!ok) fprintf(stderr, "CHECK FAILED: %s\n", what);
+    return ok ? 0 : 1;
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Walk → HCI advertising reports as the phone hears them
+static double position_at(const walk_t& w, uint64_t t_us) {
+    double x = -APPROACH_M;
+    uint64_t t = 0;
+    for (const visit_t& v : w.visits) {
+        double target = v.artifact * w.spacing_m;
+        if (t_us < v.arrive_us) return x + (target - x) * (t_us - t) / static_cast<double>(v.arrive_us - t);
+        if (t_us < v.leave_us) return target;
+        x = target;
+        t = v.leave_us;
+    }
+    return x + WALK_M_PER_S * (t_us - t) * 1e-6;
+}
+
+static walk_t plan_walk(uint32_t cases, double spacing_m, std::mt19937& rng) {
+    walk_t w;
+    w.spacing_m = spacing_m;
+    double x = -APPROACH_M;
+    uint64_t t = 0;
+    for (uint32_t k = 0; k < cases; k++) {
+        double target = k * spacing_m;
+        visit_t v;
+        v.artifact = static_cast<int>(k);
+        v.arrive_us = t + static_cast<uint64_t>((target - x) / WALK_M_PER_S * 1e6);
+        v.leave_us = v.arrive_us + 10000000ULL + rng() % 20000000ULL;
+        w.visits.push_back(v);
+        x = target;
+        t = v.leave_us;
+    }
+    w.end_us = t + static_cast<uint64_t>(APPROACH_M / WALK_M_PER_S * 1e6);
+    return w;
+}
+
+struct hci_event_t {
+    uint64_t ts_us;
+    uint8_t  len;
+    uint8_t  evt[4 + 10 + BEACON_ADV_PAYLOAD_MAX];
+};
+
+static std::vector<hci_event_t> hear_walk(const walk_t& w, uint32_t cases, std::mt19937& rng) {
+    std::normal_distribution<double> gauss(0.0, 1.0);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    std::vector<hci_event_t> events;
+    for (uint32_t k = 0; k < cases; k++) {
+        uint8_t addr[6] = {static_cast<uint8_t>(k), 0x42, 0x10, 0xC0, 0xFF, 0xEE};
+        beacon_payload_t p = beacon_encode_compact(k + 1);
+        double shadow = SHADOW_SIGMA_DB * gauss(rng);
+        uint64_t last = 0;
+        for (uint64_t t = rng() % 100000; t < w.end_us; t += 100000 + rng() % 10000) {
+            // Body shadowing: first-order Gauss-Markov with time constant SHADOW_TAU_S
+            double a = std::exp(-static_cast<double>(t - last) * 1e-6 / SHADOW_TAU_S);
+            shadow = a * shadow + std::sqrt(1 - a * a) * SHADOW_SIGMA_DB * gauss(rng);
+            last = t;
+            if (unit(rng) >= RX_P) continue;
+
+            double dx = position_at(w, t) - k * w.spacing_m;
+            double d = std::max(0.1, std::sqrt(STANDOFF_M * STANDOFF_M + dx * dx));
+            double rssi = TX_AT_1M_DBM - 10 * PATH_LOSS_EXP * std::log10(d) + shadow + FADING_SIGMA_DB * gauss(rng);
+            if (unit(rng) < DEEP_FADE_P) rssi -= 8 + 12 * unit(rng);
+            if (rssi < SENSITIVITY_DBM) continue;
+
+            hci_event_t e;
+            e.ts_us = t;
+            e.len = static_cast<uint8_t>(scan_hci_build_report(e.evt, sizeof(e.evt), addr, 0,
+                                                               static_cast<int8_t>(std::lround(rssi)), p.bytes, p.len));
+            events.push_back(e);
+        }
+    }
+    std::sort(events.begin(), events.end(), [](const hci_event_t& a, const hci_event_t& b) { return a.ts_us < b.ts_us; });
+    return events;
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Capture → replay backend → engine → matched reports
+static void on_match(void* arg, const scan_match_t* match) {
+    static_cast<std::vector<report_t>*>(arg)->push_back({match->ts_us, match->artifact, match->rssi});
+}
+
+static bool replay_walk(const std::vector<hci_event_t>& events, const scan_artifacts_t& artifacts, const char* path,
+                        std::vector<report_t>* reports) {
+    scan_capture_t capture;
+    if (scan_capture_open(&capture, path) != SCAN_OK) return false;
+    for (const hci_event_t& e : events) scan_capture_event(&capture, e.evt, e.len, e.ts_us);
+    scan_capture_close(&capture);
+
+    scan_replay_t replay;
+    if (scan_replay_open(&replay, path, 0) != SCAN_OK) return false;
+    scan_backend_t backend = scan_replay_backend(&replay);
+    scan_engine_t engine;
+    scan_engine_init(&engine, backend, &artifacts, on_match, nullptr, reports);
+    reports->clear();
+
+    // The engine's reader loop without its thread: replay times are relative
+    // to the first record, put them back on the walk's clock
+    uint64_t offset = events.empty() ? 0 : events.front().ts_us;
+    uint8_t buf[SCAN_HCI_EVENT_MAX];
+    size_t len;
+    uint64_t ts_us;
+    scan_err_t err = backend.start(backend.ctx);
+    while (err == SCAN_OK && (err = backend.read(backend.ctx, buf, sizeof(buf), &len, &ts_us, 100)) == SCAN_OK) {
+        if (len) scan_engine_feed(&engine, buf, len, ts_us + offset);
+    }
+    backend.stop(backend.ctx);
+    scan_replay_close(&replay);
+    return err == SCAN_ERR_END && engine.stats.events == events.size() && engine.stats.matched == events.size();
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Launch policies
+struct cooldown_t {
+    std::vector<uint64_t> last_us;
+    bool     launched[SCAN_ARTIFACTS_MAX] = {};
+
+    bool ready(int artifact, uint64_t now_us) const {
+        return !launched[artifact] || now_us - last_us[artifact] > COOLDOWN_US;
+    }
+    void mark(int artifact, uint64_t now_us) {
+        launched[artifact] = true;
+        last_us[artifact] = now_us;
+    }
+};
+
+// The app before the proximity engine (lib/main.dart): the cooldown starts
+// when the launch is scheduled, whether or not it then happens
+static std::vector<launch_t> policy_app(const std::vector<report_t>& reports, uint32_t cases) {
+    std::vector<launch_t> launches, pending;
+    cooldown_t cooldown;
+    cooldown.last_us.assign(cases, 0);
+    int last_heard = -1;
+    size_t next = 0;
+    for (const report_t& r : reports) {
+        for (; next < pending.size() && pending[next].ts_us <= r.ts_us; next++) {
+            if (last_heard == pending[next].artifact) launches.push_back(pending[next]);
+        }
+        last_heard = r.artifact;
+        if (cooldown.ready(r.artifact, r.ts_us)) {
+            cooldown.mark(r.artifact, r.ts_us);
+            pending.push_back({r.ts_us + APP_DELAY_US, r.artifact});
+        }
+    }
+    for (; next < pending.size(); next++) {
+        if (last_heard == pending[next].artifact) launches.push_back(pending[next]);
+    }
+    return launches;
+}
+
+static std::vector<launch_t> policy_proximity(const std::vector<report_t>& reports, uint32_t cases,
+                                              scan_prox_filter_t filter) {
+    std::vector<launch_t> launches;
+    cooldown_t cooldown;
+    cooldown.last_us.assign(cases, 0);
+    scan_prox_config_t config = scan_proximity_defaults(filter);
+    scan_proximity_t p;
+    scan_proximity_init(&p, &config);
+    for (const report_t& r : reports) {
+        bool changed;
+        int nearest = scan_proximity_update(&p, r.artifact, r.rssi, r.ts_us, &changed);
+        if (changed && nearest >= 0 && cooldown.ready(nearest, r.ts_us)) {
+            cooldown.mark(nearest, r.ts_us);
+            launches.push_back({r.ts_us, nearest});
+        }
+    }
+    return launches;
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Scoring against the walk
+static void score(const walk_t& w, const std::vector<launch_t>& launches, outcome_t* out) {
+    for (size_t i = 0; i < w.visits.size(); i++) {
+        const visit_t& v = w.visits[i];
+        uint64_t from = i ? w.visits[i - 1].leave_us : 0; // The approach counts
+        out->visits++;
+        for (const launch_t& l : launches) {
+            if (l.artifact == v.artifact && l.ts_us >= from && l.ts_us < v.leave_us) {
+                out->correct++;
+                out->decide_ms.push_back(l.ts_us > v.arrive_us ? (l.ts_us - v.arrive_us) / 1000.0 : 0.0);
+                break;
+            }
+        }
+    }
+    for (const launch_t& l : launches) {
+        int prev = -1, next = -1;
+        bool at_case = false;
+        for (const visit_t& v : w.visits) {
+            if (l.ts_us < v.arrive_us) {
+                next = v.artifact;
+                break;
+            }
+            if (l.ts_us < v.leave_us) {
+                at_case = true;
+                prev = v.artifact;
+                break;
+            }
+            prev = v.artifact;
+        }
+        if (at_case) out->wrong += l.artifact != prev;
+        else if (l.artifact == prev || l.artifact == next) out->transit++;
+        else out->wrong++;
+    }
+}
+
+static double percentile(std::vector<double> v, double q) {
+    if (v.empty()) return 0;
+    std::sort(v.begin(), v.end());
+    return v[std::min(v.size() - 1, static_cast<size_t>(q * (v.size() - 1) + 0.5))];
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+int main(int argc, char** argv) {
+    uint32_t cases = 6, visitors = 100, seed = 1;
+    double spacing = 0; // 0 = the default run
+    const char* capture_path = nullptr;
+    double max_wrong_rate = -1, max_p95_ms = -1; // -1 = no gate
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (!strcmp(argv[i], "--cases")) cases = static_cast<uint32_t>(atoi(argv[i + 1]));
+        else if (!strcmp(argv[i], "--spacing")) spacing = atof(argv[i + 1]);
+        else if (!strcmp(argv[i], "--visitors")) visitors = static_cast<uint32_t>(atoi(argv[i + 1]));
+        else if (!strcmp(argv[i], "--seed")) seed = static_cast<uint32_t>(atoi(argv[i + 1]));
+        else if (!strcmp(argv[i], "--write-capture")) capture_path = argv[i + 1];
+        else if (!strcmp(argv[i], "--max-wrong-rate")) max_wrong_rate = atof(argv[i + 1]);
+        else if (!strcmp(argv[i], "--max-p95-ms")) max_p95_ms = atof(argv[i + 1]);
+    }
+    if (cases < 2 || cases > SCAN_PROX_TRACKS || visitors == 0 || spacing < 0) {
+        fprintf(stderr, "need 2 <= --cases <= %d, --visitors > 0 and --spacing >= 0\n", SCAN_PROX_TRACKS);
+        return 2;
+    }
+    std::vector<double> spacings = {1.0, 1.5, 2.0, 3.0};
+    if (spacing > 0) spacings = {spacing};
+
+    scan_artifacts_t artifacts;
+    scan_artifacts_init(&artifacts);
+    for (uint32_t k = 0; k < cases; k++) {
+        char name[SCAN_NAME_MAX + 1];
+        snprintf(name, sizeof(name), "Cham_Case_%02u", k + 1);
+        scan_artifacts_add(&artifacts, k + 1, name);
+    }
+
+    char tmp_path[] = "/tmp/bench_proximity_XXXXXX";
+    int fd = mkstemp(tmp_path);
+    if (fd < 0) {
+        perror("mkstemp");
+        return 2;
+    }
+    close(fd);
+
+    static const char* const POLICIES[] = {"app 2 s", "ema", "kalman"};
+    int failures = 0;
+    printf("%u cases, %u visitors per spacing, 0.7 m from the glass, dwell 10-30 s\n", cases, visitors);
+    for (double s : spacings) {
+        std::mt19937 rng(seed);
+        outcome_t out[3] = {};
+        uint64_t reports_total = 0;
+        bool replay_ok = true;
+        for (uint32_t v = 0; v < visitors; v++) {
+            walk_t w = plan_walk(cases, s, rng);
+            std::vector<hci_event_t> events = hear_walk(w, cases, rng);
+            std::vector<report_t> reports;
+            replay_ok &= replay_walk(events, artifacts, tmp_path, &reports);
+            if (v == 0 && capture_path && s == spacings.front()) replay_walk(events, artifacts, capture_path, &reports);
+            reports_total += reports.size();
+            score(w, policy_app(reports, cases), &out[0]);
+            score(w, policy_proximity(reports, cases, SCAN_PROX_EMA), &out[1]);
+            score(w, policy_proximity(reports, cases, SCAN_PROX_KALMAN), &out[2]);
+        }
+
+        printf("\nspacing %.1f m: %u visits, %lu reports replayed\n", s, out[0].visits, (unsigned long)reports_total);
+        printf("%-9s %8s %7s %7s %8s %8s %9s %9s %9s\n", "policy", "correct", "missed", "wrong", "wrong/v",
+               "transit", "p50 ms", "p95 ms", "max ms");
+        for (int k = 0; k < 3; k++) {
+            const outcome_t& o = out[k];
+            printf("%-9s %8u %7u %7u %8.3f %8u %9.0f %9.0f %9.0f\n", POLICIES[k], o.correct, o.visits - o.correct,
+                   o.wrong, static_cast<double>(o.wrong) / o.visits, o.transit, percentile(o.decide_ms, 0.5),
+                   percentile(o.decide_ms, 0.95), percentile(o.decide_ms, 1.0));
+        }
+
+        const outcome_t& kalman = out[2];
+        double wrong_rate = static_cast<double>(kalman.wrong) / kalman.visits;
+        double p95 = percentile(kalman.decide_ms, 0.95);
+        failures += check(replay_ok, "every advertisement replayed and matched");
+        failures += check(kalman.wrong <= out[0].wrong, "proximity engine wrong no more often than the app");
+        failures += check(kalman.correct > out[0].correct, "proximity engine opens the right story more often");
+        failures += check(percentile(kalman.decide_ms, 0.5) < percentile(out[0].decide_ms, 0.5),
+                          "proximity engine decides faster than the app");
+        if (max_wrong_rate >= 0 && wrong_rate > max_wrong_rate) {
+            fprintf(stderr, "GATE: spacing %.1f m: %.3f wrong triggers per visit > %.3f\n", s, wrong_rate,
+                    max_wrong_rate);
+            failures++;
+        }
+        if (max_p95_ms >= 0 && p95 > max_p95_ms) {
+            fprintf(stderr, "GATE: spacing %.1f m: p95 time to the right story %.0f ms > %.0f\n", s, p95, max_p95_ms);
+            failures++;
+        }
+    }
+    remove(tmp_path);
+    if (capture_path) printf("\nfirst walk at %.1f m written to %s\n", spacings.front(), capture_path);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,192 @@
+/*
+COS10025 BLE-to-Web Cultural Storytelling System
+Self-healing startup and runtime on the simulated controller.
+- The advertising supervisor (beacon_supervisor.h) runs every --period-ms
+  against one beacon, and its actions are carried out as the firmware does:
+  probe = beacon_probe() (a controller round trip, no swap), restart =
+  beacon_restart()
+- Scenarios: a healthy unit with a policy off period every two minutes, startup
+  failures past the retry budget, controller lock-ups that one or two restarts
+  clear, and one that only a reboot clears
+- Each scenario runs with advertising events reported to the core (NimBLE-like,
+  simulator) and without them (Bluedroid, confirmation by probes only)
+- Off air: longest gap between advertising events actually sent (boot to the
+  first event for startup failures); recovery: first restart to advertising
+  confirmed, as the firmware reports it
+- Optional gate: exits non-zero on a restart of the healthy unit, a probe that
+  counts as a payload swap, an unrecovered fault, a missing reboot, or off-air
+  time above --max-off-air-ms per restart the scenario needs
+
+Usage: bench_recovery [--period-ms MS] [--quiet-ms MS] [--stall-ms MS] [--restart-max N]
+                      [--seconds S] [--max-off-air-ms MS]
+*/
+
+#include "beacon_core.h"
+#include "beacon_payload.h"
+#include "beacon_supervisor.h"
+#include "sim_controller.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#define HANG_AT_US 60000000ULL
+
+struct scenario_t {
+    const char* name;
+    uint32_t    fail_host_enable; // Failures of the Bluedroid-enable stage
+    uint32_t    hang_resets;      // Controller lock-up at HANG_AT_US, cleared by this many resets (0 = none)
+    uint32_t    fail_reset;       // Failed stack teardowns
+    bool        policy_off;       // Stop/resume every two minutes (healthy unit)
+    bool        expect_reboot;
+};
+
+static const scenario_t SCENARIOS[] = {
+    {"healthy",       0,                      0,          0,  true,  false},
+    {"startup",       BEACON_RETRY_MAX + 2,   0,          0,  false, false},
+    {"lock-up",       0,                      1,          0,  false, false},
+    {"lock-up x2",    0,                      2,          0,  false, false},
+    {"stuck",         0,                      UINT32_MAX, 0,  false, true},
+    {"reset fails",   0,                      1,          99, false, true},
+};
+
+struct result_t {
+    uint32_t probes, restarts, recoveries;
+    bool     advertising;  // At the end (or at the reboot)
+    bool     rebooted;
+    double   reboot_s;
+    double   off_air_ms;
+    double   recovery_ms;  // Last recovery as reported, 0 if none
+    uint32_t swaps;        // Payload swaps requested (none: probes are not swaps)
+};
+
+static int check(bool ok, const char* what) {
+    if (!ok) fprintf(stderr, "CHECK FAILED: %s\n", what);
+    return ok ? 0 : 1;
+}
+
+static result_t run_scenario(const scenario_t& sc, bool report_events, const beacon_sup_config_t& config,
+                             uint64_t period_us, uint64_t duration_us) {
+    sim_timing_t timing;
+    timing.report_adv_events = report_events;
+    sim_controller_t sim;
+    sim_controller_init(&sim, timing);
+    sim.fail_stage[BEACON_STAGE_HOST_ENABLE] = sc.fail_host_enable;
+    sim.fail_reset = sc.fail_reset;
+    if (sc.hang_resets) {
+        sim.hang_at_us = HANG_AT_US;
+        sim.hang_resets = sc.hang_resets;
+    }
+
+    beacon_payload_t payload = beacon_encode_compact(1);
+    beacon_t beacon;
+    beacon_init(&beacon, sim_controller_backend(&sim), payload.bytes, payload.len);
+    uint64_t boot_us = sim.now_us;
+    beacon_start(&beacon);
+    beacon_supervisor_t sup;
+    beacon_supervisor_init(&sup, &config, &beacon, sim.now_us);
+
+    result_t r = {};
+    uint64_t end = boot_us + duration_us;
+    for (uint64_t t = boot_us + period_us; t < end; t += period_us) {
+        sim_controller_run_until(&sim, t);
+        if (sc.policy_off && t % 120000000 < period_us) {
+            if (beacon.state == BEACON_STATE_ADVERTISING) beacon_stop(&beacon);
+            else if (beacon.state == BEACON_STATE_STOPPED) beacon_resume(&beacon);
+        }
+        switch (beacon_supervisor_check(&sup, &beacon, sim.now_us)) {
+        case BEACON_SUP_PROBE:
+            beacon_probe(&beacon);
+            break;
+        case BEACON_SUP_RESTART:
+            beacon_restart(&beacon);
+            break;
+        case BEACON_SUP_REBOOT:
+            r.rebooted = true;
+            r.reboot_s = (sim.now_us - boot_us) / 1e6;
+            break;
+        default:
+            break;
+        }
+        if (r.rebooted) break;
+    }
+    sim_controller_run_until(&sim, sim.now_us);
+
+    // Off air: boot → first event, then the longest gap between events
+    // (intentional off periods of the healthy unit excluded)
+    const std::vector<uint64_t>& adv = sim.adv_times_us;
+    r.off_air_ms = adv.empty() ? (sim.now_us - boot_us) / 1e3 : (adv[0] - boot_us) / 1e3;
+    for (size_t i = 1; i < adv.size() && !sc.policy_off; i++) {
+        double gap_ms = (adv[i] - adv[i - 1]) / 1e3;
+        if (gap_ms > r.off_air_ms) r.off_air_ms = gap_ms;
+    }
+    if (!adv.empty() && !r.rebooted && sim.now_us - adv.back() > r.off_air_ms * 1e3) {
+        r.off_air_ms = (sim.now_us - adv.back()) / 1e3; // Still silent at the end
+    }
+    r.probes = sup.probes;
+    r.restarts = sup.restarts_total;
+    r.recoveries = sup.recoveries;
+    r.recovery_ms = sup.last_recovery_us / 1e3;
+    r.swaps = beacon.swap.requested;
+    r.advertising = beacon.state == BEACON_STATE_ADVERTISING || beacon.state == BEACON_STATE_STOPPED;
+    return r;
+}
+
+int main(int argc, char** argv) {
+    beacon_sup_config_t config = beacon_supervisor_defaults();
+    double period_ms = 1000.0;
+    double seconds = 300.0;
+    double max_off_air_ms = 0; // 0 = no gate
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (!strcmp(argv[i], "--period-ms")) period_ms = atof(argv[i + 1]);
+        else if (!strcmp(argv[i], "--quiet-ms")) config.quiet_us = static_cast<uint32_t>(atof(argv[i + 1]) * 1000);
+        else if (!strcmp(argv[i], "--stall-ms")) config.stall_us = static_cast<uint32_t>(atof(argv[i + 1]) * 1000);
+        else if (!strcmp(argv[i], "--restart-max")) config.restart_max = static_cast<uint8_t>(atoi(argv[i + 1]));
+        else if (!strcmp(argv[i], "--seconds")) seconds = atof(argv[i + 1]);
+        else if (!strcmp(argv[i], "--max-off-air-ms")) max_off_air_ms = atof(argv[i + 1]);
+    }
+    if (period_ms <= 0 || config.quiet_us == 0 || config.stall_us <= config.quiet_us ||
+        seconds * 1e6 <= HANG_AT_US) {
+        fprintf(stderr, "need --period-ms > 0, 0 < --quiet-ms < --stall-ms and --seconds > %llu\n",
+                HANG_AT_US / 1000000);
+        return 2;
+    }
+
+    printf("supervisor every %.0f ms: probe after %lu ms quiet, restart after %lu ms, reboot after %u restarts\n",
+           period_ms, (unsigned long)(config.quiet_us / 1000), (unsigned long)(config.stall_us / 1000),
+           config.restart_max);
+    printf("%-12s %-12s %7s %9s %10s %12s %12s  %s\n", "scenario", "adv events", "probes", "restarts",
+           "recovered", "recovery ms", "off air ms", "outcome");
+
+    int failures = 0;
+    for (const scenario_t& sc : SCENARIOS) {
+        for (int report = 1; report >= 0; report--) {
+            result_t r = run_scenario(sc, report, config, static_cast<uint64_t>(period_ms * 1000),
+                                      static_cast<uint64_t>(seconds * 1e6));
+            char outcome[48];
+            if (r.rebooted) snprintf(outcome, sizeof(outcome), "reboot at %.0f s", r.reboot_s);
+            else snprintf(outcome, sizeof(outcome), "%s", r.advertising ? "advertising" : "NOT advertising");
+            printf("%-12s %-12s %7lu %9lu %10lu %12.0f %12.0f  %s\n", sc.name, report ? "reported" : "probed",
+                   (unsigned long)r.probes, (unsigned long)r.restarts, (unsigned long)r.recoveries, r.recovery_ms,
+                   sc.expect_reboot ? 0.0 : r.off_air_ms, outcome);
+
+            failures += check(r.swaps == 0, "probes leave the swap counters alone");
+            if (sc.policy_off) {
+                failures += check(r.restarts == 0 && !r.rebooted, "healthy unit left alone");
+            } else if (sc.expect_reboot) {
+                failures += check(r.rebooted && r.restarts == config.restart_max,
+                                  "reboot only after restart_max restarts");
+            } else {
+                failures += check(r.advertising && !r.rebooted && r.recoveries > 0, "fault recovered in-process");
+                double budget_ms = max_off_air_ms * (sc.hang_resets ? sc.hang_resets : 1);
+                if (max_off_air_ms > 0 && r.off_air_ms > budget_ms) {
+                    fprintf(stderr, "GATE: %s (%s) off air %.0f ms > %.0f\n", sc.name,
+                            report ? "reported" : "probed", r.off_air_ms, budget_ms);
+                    failures++;
+                }
+            }
+        }
+    }
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,165 @@
+/*
+COS10025 BLE-to-Web Cultural Storytelling System
+Discovery latency of rotated artifact payloads on one simulated beacon.
+- The beacon rotates the --artifacts slots (beacon_rotation.h) through the
+  simulated controller, swapping the payload once per dwell
+- A phone scanner listens on one advertising channel per scan interval
+  (37 → 38 → 39) for --scan-window-ms; the visitor walks into range at a
+  random time and a random point of the scanner's own cycle
+- Discovery latency per artifact: arrival → first received PDU carrying it
+- Baseline: the same scanner against a dedicated board per artifact
+- Every advertising event must go out at its own slot's TX power; exits
+  non-zero otherwise
+
+Usage: bench_rotation [--artifacts "0x0001:2:3,0x0002:1:0,0x0003:1:0"] [--trials N]
+                      [--scan-window-ms MS] [--scan-interval-ms MS] [--loss P]
+                      [--horizon-s S] [--max-p95-ms MS]
+*/
+
+#include "beacon_core.h"
+#include "beacon_payload.h"
+#include "beacon_rotation.h"
+#include "sim_controller.h"
+#include "bench_util.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+// ─────────────────────────────────────────────────────────────────────────────
+// One simulated beacon run: returns discovery latency per slot (-1 = not heard)
+// and counts advertising events sent at another slot's TX power into *wrong_tx
+static std::vector<double> run_trial(const beacon_rotation_t& config, uint32_t seed, const scanner_t& scan_template,
+                                     uint64_t horizon_us, uint64_t* wrong_tx) {
+    sim_timing_t timing;
+    timing.seed = seed;
+    sim_controller_t sim;
+    sim_controller_init(&sim, timing);
+    std::mt19937 rng(seed * 7919u);
+
+    beacon_rotation_t rot = config;
+    const beacon_rotation_slot_t* first = beacon_rotation_first(&rot);
+    beacon_t beacon;
+    beacon_init(&beacon, sim_controller_backend(&sim), first->payload.bytes, first->payload.len);
+    beacon_adv_params_t params = beacon_default_adv_params();
+    beacon_set_profile(&beacon, &params, first->tx_power_dbm);
+    beacon_start(&beacon);
+    sim_controller_run_until(&sim, sim.now_us + 2000000); // Startup
+    if (beacon.state != BEACON_STATE_ADVERTISING) return std::vector<double>(rot.count, -1.0);
+
+    // Scanner starts at a random point of the rotation, after a short warm-up
+    scanner_t sc = scan_template;
+    sc.start_us = sim.now_us + 1000000 + std::uniform_int_distribution<uint64_t>(0, 5000000)(rng);
+    sc.phase_us = std::uniform_int_distribution<uint64_t>(0, 3 * sc.interval_us - 1)(rng);
+    uint64_t end_us = sc.start_us + horizon_us;
+
+    uint64_t dwell = beacon_rotation_dwell_us(&params);
+    for (uint64_t t = sim.now_us + dwell; t < end_us; t += dwell) {
+        sim_controller_run_until(&sim, t);
+        beacon_rotation_step(&rot, &beacon);
+    }
+    sim_controller_run_until(&sim, end_us);
+
+    std::vector<double> latency(rot.count, -1.0);
+    for (size_t e = 0; e < sim.adv_times_us.size(); e++) {
+        uint32_t id = sim.adv_artifacts[e];
+        int slot = -1;
+        for (uint8_t s = 0; s < rot.count; s++) {
+            beacon_compact_info_t info;
+            if (beacon_decode_compact(rot.slots[s].payload.bytes, rot.slots[s].payload.len, &info) &&
+                info.artifact_id == id) slot = s;
+        }
+        if (slot >= 0 && sim.adv_tx_dbm[e] != rot.slots[slot].tx_power_dbm) (*wrong_tx)++;
+        if (slot < 0 || latency[slot] >= 0) continue;
+
+        uint32_t pdu_us = beacon_adv_airtime_us(rot.slots[slot].payload.len, BEACON_ADV_CHANNEL_37);
+        for (int ch = 0; ch < 3; ch++) {
+            uint64_t t = sim.adv_times_us[e] + ch * (pdu_us + CHANNEL_HOP_US);
+            if (scanner_hears(sc, t, pdu_us, ch, rng)) {
+                latency[slot] = static_cast<double>(t + pdu_us - sc.start_us);
+                break;
+            }
+        }
+    }
+    return latency;
+}
+
+int main(int argc, char** argv) {
+    const char* artifacts = "0x0001:2:3,0x0002:1:0,0x0003:1:0";
+    int trials = 300;
+    double scan_window_ms = 1024.0;   // Android SCAN_MODE_BALANCED
+    double scan_interval_ms = 4096.0;
+    double loss = 0.0;
+    double horizon_s = 30.0;
+    double max_p95_ms = 0;            // 0 = no gate
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (!strcmp(argv[i], "--artifacts")) artifacts = argv[i + 1];
+        else if (!strcmp(argv[i], "--trials")) trials = atoi(argv[i + 1]);
+        else if (!strcmp(argv[i], "--scan-window-ms")) scan_window_ms = atof(argv[i + 1]);
+        else if (!strcmp(argv[i], "--scan-interval-ms")) scan_interval_ms = atof(argv[i + 1]);
+        else if (!strcmp(argv[i], "--loss")) loss = atof(argv[i + 1]);
+        else if (!strcmp(argv[i], "--horizon-s")) horizon_s = atof(argv[i + 1]);
+        else if (!strcmp(argv[i], "--max-p95-ms")) max_p95_ms = atof(argv[i + 1]);
+    }
+
+    beacon_rotation_t rot;
+    beacon_rotation_init(&rot);
+    if (beacon_rotation_parse(&rot, artifacts, 3) <= 0) {
+        fprintf(stderr, "invalid --artifacts \"%s\"\n", artifacts);
+        return 2;
+    }
+    scanner_t scan = {0, 0, static_cast<uint64_t>(scan_interval_ms * 1000), static_cast<uint64_t>(scan_window_ms * 1000),
+                      loss};
+    uint64_t horizon_us = static_cast<uint64_t>(horizon_s * 1e6);
+
+    // Rotated board vs one dedicated board per artifact (same scanner, same seeds)
+    std::vector<std::vector<double>> rotated(rot.count), dedicated(rot.count);
+    std::vector<int> rotated_missed(rot.count, 0), dedicated_missed(rot.count, 0);
+    uint64_t wrong_tx = 0;
+    for (int trial = 0; trial < trials; trial++) {
+        std::vector<double> lat = run_trial(rot, trial + 1, scan, horizon_us, &wrong_tx);
+        for (uint8_t s = 0; s < rot.count; s++) {
+            if (lat[s] < 0) rotated_missed[s]++;
+            else rotated[s].push_back(lat[s] / 1000.0);
+
+            beacon_rotation_t single;
+            beacon_rotation_init(&single);
+            beacon_rotation_add(&single, &rot.slots[s].payload, 1, rot.slots[s].tx_power_dbm);
+            double d = run_trial(single, trial + 1, scan, horizon_us, &wrong_tx)[0];
+            if (d < 0) dedicated_missed[s]++;
+            else dedicated[s].push_back(d / 1000.0);
+        }
+    }
+
+    beacon_adv_params_t params = beacon_default_adv_params();
+    printf("payload rotation: %u artifacts, dwell %.1f ms, scan %.0f/%.0f ms, loss %.2f, %d trials\n",
+           rot.count, beacon_rotation_dwell_us(&params) / 1000.0, scan_window_ms, scan_interval_ms, loss, trials);
+    printf("%-8s %6s %5s %6s | %-34s | %-34s\n", "artifact", "weight", "dBm", "share",
+           "rotated: p50 / p95 / max ms, miss", "dedicated board: p50 / p95 / max ms");
+
+    int failed = 0;
+    for (uint8_t s = 0; s < rot.count; s++) {
+        beacon_compact_info_t info = {};
+        beacon_decode_compact(rot.slots[s].payload.bytes, rot.slots[s].payload.len, &info);
+        summary_t r = summarise(rotated[s]);
+        summary_t d = summarise(dedicated[s]);
+        printf("0x%04lx   %6u %5d %5.0f%% | %7.0f %7.0f %7.0f %6.1f%% | %7.0f %7.0f %7.0f %6.1f%%\n",
+               (unsigned long)info.artifact_id, rot.slots[s].weight, rot.slots[s].tx_power_dbm,
+               100.0 * rot.slots[s].weight / rot.seq_len, r.p50, r.p95, r.max, 100.0 * rotated_missed[s] / trials,
+               d.p50, d.p95, d.max, 100.0 * dedicated_missed[s] / trials);
+        if (max_p95_ms > 0 && (r.p95 > max_p95_ms || rotated_missed[s] > 0)) {
+            printf("FAIL: artifact 0x%04lx p95 %.0f ms > budget %.0f ms (or missed)\n",
+                   (unsigned long)info.artifact_id, r.p95, max_p95_ms);
+            failed = 1;
+        }
+    }
+    printf("advertising events at another slot's TX power: %llu\n", (unsigned long long)wrong_tx);
+    if (wrong_tx) {
+        printf("FAIL: payload and TX power out of step\n");
+        failed = 1;
+    }
+    return failed;
+}
@@ -0,0 +1,254 @@
+/*
+COS10025 BLE-to-Web Cultural Storytelling System
+Native scanner engine on synthetic hall traffic, in memory and replayed.
+- Traffic: scan_traffic.h (artifact beacons among --others unrelated devices)
+- In memory: every HCI event through scan_engine_feed(); reports per second,
+  nanoseconds per report and what reaches the app
+- Replay: the same traffic written as a btsnoop capture and played back by
+  the replay backend on the engine's reader thread (--speed 0 = as fast as
+  possible), exactly as the kiosk runner does with CHAM_SCAN_REPLAY; a
+  corrupt monitor capture must replay only its well-formed events
+- Every artifact advertisement must be delivered with the right artifact,
+  and nothing else; --write-capture FILE keeps the capture for the runner
+- Optional gate: exits non-zero on a wrong or missed match, or below
+  --min-reports-per-s in memory
+
+Usage: bench_scan [--artifacts N] [--others N] [--seconds S] [--speed X]
+                  [--write-capture FILE] [--min-reports-per-s N]
+*/
+
+#include "scan_replay.h"
+#include "scan_traffic.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+struct tally_t {
+    std::vector<uint64_t> per_artifact;
+    uint64_t delivered;
+    uint64_t with_mfr;
+    std::mutex mutex;
+    std::condition_variable done_cv;
+    bool done;
+    scan_err_t exit_err;
+};
+
+static int check(bool ok, const char* what) {
+    if (!ok) fprintf(stderr, "CHECK FAILED: %s\n", what);
+    return ok ? 0 : 1;
+}
+
+static void on_match(void* arg, const scan_match_t* match) {
+    tally_t* t = static_cast<tally_t*>(arg);
+    t->per_artifact[match->artifact]++;
+    t->delivered++;
+    if (match->mfr) t->with_mfr++;
+}
+
+static void on_exit(void* arg, scan_err_t err) {
+    tally_t* t = static_cast<tally_t*>(arg);
+    std::lock_guard<std::mutex> lock(t->mutex);
+    t->done = true;
+    t->exit_err = err;
+    t->done_cv.notify_all();
+}
+
+static void put_be32(uint8_t* p, uint32_t v) {
+    p[0] = static_cast<uint8_t>(v >> 24);
+    p[1] = static_cast<uint8_t>(v >> 16);
+    p[2] = static_cast<uint8_t>(v >> 8);
+    p[3] = static_cast<uint8_t>(v);
+}
+
+// One monitor-format (datalink 2001) event record of `len` bytes on adapter 0
+static void put_monitor_record(FILE* f, const uint8_t* evt, uint32_t len) {
+    uint8_t rec[24] = {};
+    put_be32(&rec[0], len);
+    put_be32(&rec[4], len);
+    put_be32(&rec[8], 3); // Opcode: event, index 0
+    fwrite(rec, 1, sizeof(rec), f);
+    fwrite(evt, 1, len, f);
+}
+
+// Corrupt monitor capture: an oversized record and one whose length disagrees with
+// its event header must be skipped, the valid event after them replayed intact
+static int check_corrupt_monitor(void) {
+    char path[] = "/tmp/bench_scan_monitor_XXXXXX";
+    int fd = mkstemp(path);
+    if (fd < 0) {
+        perror("mkstemp");
+        return 1;
+    }
+    FILE* f = fdopen(fd, "wb");
+    uint8_t hdr[16] = {'b', 't', 's', 'n', 'o', 'o', 'p', 0};
+    put_be32(&hdr[8], 1);
+    put_be32(&hdr[12], SCAN_BTSNOOP_MONITOR);
+    fwrite(hdr, 1, sizeof(hdr), f);
+    uint8_t big[SCAN_HCI_EVENT_MAX + 1];
+    memset(big, 0xAA, sizeof(big));
+    big[0] = 0x3E;
+    big[1] = 0xFF;
+    put_monitor_record(f, big, sizeof(big));
+    const uint8_t short_evt[] = {0x3E, 0x20, 0x02, 0x01};
+    put_monitor_record(f, short_evt, sizeof(short_evt));
+    const uint8_t good[] = {0x3E, 0x03, 0x02, 0x00, 0x00};
+    put_monitor_record(f, good, sizeof(good));
+    fclose(f);
+
+    scan_replay_t replay;
+    int failures = check(scan_replay_open(&replay, path, 0) == SCAN_OK, "corrupt monitor capture opens");
+    scan_backend_t backend = scan_replay_backend(&replay);
+    uint8_t buf[SCAN_HCI_EVENT_MAX];
+    size_t len = 0;
+    uint64_t ts = 0;
+    unsigned events = 0;
+    bool intact = true;
+    backend.start(backend.ctx);
+    while (backend.read(backend.ctx, buf, sizeof(buf), &len, &ts, 100) == SCAN_OK) {
+        if (len == 0) continue;
+        events++;
+        intact = intact && len == sizeof(good) && !memcmp(buf, good, len);
+    }
+    scan_replay_close(&replay);
+    remove(path);
+    printf("corrupt monitor capture: %lu records, %u replayed\n", (unsigned long)replay.records, events);
+    failures += check(events == 1 && intact, "corrupt monitor capture: only the valid event replayed");
+    return failures;
+}
+
+static scan_err_t no_start(void*) { return SCAN_OK; }
+static scan_err_t no_read(void*, uint8_t*, size_t, size_t* len, uint64_t*, int) {
+    *len = 0;
+    return SCAN_ERR_END;
+}
+static void no_stop(void*) {}
+
+int main(int argc, char** argv) {
+    scan_traffic_config_t config;
+    double speed = 0;
+    const char* capture_path = nullptr;
+    double min_rps = 0; // 0 = no gate
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (!strcmp(argv[i], "--artifacts")) config.artifacts = static_cast<uint32_t>(atoi(argv[i + 1]));
+        else if (!strcmp(argv[i], "--others")) config.others = static_cast<uint32_t>(atoi(argv[i + 1]));
+        else if (!strcmp(argv[i], "--seconds")) config.seconds = atof(argv[i + 1]);
+        else if (!strcmp(argv[i], "--speed")) speed = atof(argv[i + 1]);
+        else if (!strcmp(argv[i], "--write-capture")) capture_path = argv[i + 1];
+        else if (!strcmp(argv[i], "--min-reports-per-s")) min_rps = atof(argv[i + 1]);
+    }
+    if (config.artifacts == 0 || config.artifacts > SCAN_ARTIFACTS_MAX || config.seconds <= 0 || speed < 0) {
+        fprintf(stderr, "need 1 <= --artifacts <= %d, --seconds > 0 and --speed >= 0\n", SCAN_ARTIFACTS_MAX);
+        return 2;
+    }
+
+    scan_artifacts_t artifacts;
+    scan_traffic_artifacts(config, &artifacts);
+    std::vector<scan_traffic_event_t> traffic = scan_traffic_generate(config);
+    std::vector<uint64_t> truth(artifacts.count, 0);
+    for (const scan_traffic_event_t& e : traffic) {
+        if (e.truth >= 0) truth[e.truth]++;
+    }
+    uint64_t truth_total = 0;
+    for (uint64_t n : truth) truth_total += n;
+    printf("traffic: %u artifacts (%u by name) + %u devices, %.0f s, %zu reports (%.0f/s), %.1f%% from artifacts\n",
+           artifacts.count, config.name_beacons, config.others, config.seconds, traffic.size(),
+           traffic.size() / config.seconds, 100.0 * truth_total / traffic.size());
+
+    int failures = 0;
+
+    // Step 1: In memory, best of three passes
+    double best_ns = 0;
+    tally_t mem;
+    for (int pass = 0; pass < 3; pass++) {
+        mem.per_artifact.assign(artifacts.count, 0);
+        mem.delivered = mem.with_mfr = 0;
+        scan_backend_t none = {nullptr, no_start, no_read, no_stop};
+        scan_engine_t engine;
+        scan_engine_init(&engine, none, &artifacts, on_match, nullptr, &mem);
+        auto t0 = std::chrono::steady_clock::now();
+        for (const scan_traffic_event_t& e : traffic) scan_engine_feed(&engine, e.evt, e.len, e.ts_us);
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count() /
+                    traffic.size();
+        if (pass == 0 || ns < best_ns) best_ns = ns;
+        failures += pass ? 0 : check(engine.stats.reports == traffic.size() && engine.stats.malformed == 0,
+                                     "every report walked, none malformed");
+    }
+    double rps = 1e9 / best_ns;
+    printf("\nin memory: %.1f ns/report, %.2f M reports/s, delivered %lu of %zu (%.1f%%)\n", best_ns, rps / 1e6,
+           (unsigned long)mem.delivered, traffic.size(), 100.0 * mem.delivered / traffic.size());
+
+    // Step 2: btsnoop capture → replay backend → reader thread
+    char tmp_path[] = "/tmp/bench_scan_XXXXXX";
+    if (!capture_path) {
+        int fd = mkstemp(tmp_path);
+        if (fd < 0) {
+            perror("mkstemp");
+            return 2;
+        }
+        fclose(fdopen(fd, "wb"));
+    }
+    const char* path = capture_path ? capture_path : tmp_path;
+    scan_capture_t capture;
+    if (scan_capture_open(&capture, path) != SCAN_OK) {
+        fprintf(stderr, "cannot write %s\n", path);
+        return 2;
+    }
+    for (const scan_traffic_event_t& e : traffic) scan_capture_event(&capture, e.evt, e.len, e.ts_us);
+    scan_capture_close(&capture);
+
+    scan_replay_t replay;
+    scan_err_t err = scan_replay_open(&replay, path, speed);
+    if (err != SCAN_OK) {
+        fprintf(stderr, "cannot replay %s: %s\n", path, scan_err_name(err));
+        return 2;
+    }
+    tally_t rep;
+    rep.per_artifact.assign(artifacts.count, 0);
+    rep.delivered = rep.with_mfr = 0;
+    rep.done = false;
+    rep.exit_err = SCAN_OK;
+    scan_engine_t engine;
+    scan_engine_init(&engine, scan_replay_backend(&replay), &artifacts, on_match, on_exit, &rep);
+    auto t0 = std::chrono::steady_clock::now();
+    scan_engine_start(&engine);
+    {
+        std::unique_lock<std::mutex> lock(rep.mutex);
+        rep.done_cv.wait(lock, [&] { return rep.done; });
+    }
+    double replay_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    scan_engine_stop(&engine);
+    scan_replay_close(&replay);
+    if (!capture_path) remove(tmp_path);
+    printf("replay (speed %g): %lu events in %.3f s (%.2f M reports/s), delivered %lu, ended with \"%s\"\n", speed,
+           (unsigned long)engine.stats.events, replay_s, engine.stats.reports / replay_s / 1e6,
+           (unsigned long)rep.delivered, scan_err_name(rep.exit_err));
+    if (capture_path) printf("capture written to %s\n", capture_path);
+
+    failures += check_corrupt_monitor();
+
+    // Step 3: Per-artifact delivery
+    printf("\n%-26s %8s %10s %10s\n", "artifact", "id", "advertised", "delivered");
+    for (uint8_t i = 0; i < artifacts.count; i++) {
+        printf("%-26s %8lu %10lu %10lu\n", artifacts.items[i].name, (unsigned long)artifacts.items[i].id,
+               (unsigned long)truth[i], (unsigned long)rep.per_artifact[i]);
+    }
+
+    failures += check(mem.per_artifact == truth, "in memory: every artifact report delivered, nothing else");
+    failures += check(rep.per_artifact == truth, "replay: every artifact report delivered, nothing else");
+    failures += check(engine.stats.events == traffic.size() && rep.exit_err == SCAN_ERR_END, "replay complete");
+    if (speed > 0) {
+        failures += check(replay_s >= config.seconds / speed * 0.9, "replay keeps the recorded timing");
+    }
+    if (min_rps > 0 && rps < min_rps) {
+        fprintf(stderr, "GATE: %.0f reports/s < %.0f\n", rps, min_rps);
+        failures++;
+    }
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,66 @@
+/*
+COS10025 BLE-to-Web Cultural Storytelling System
+Shared helpers for the host benchmarks.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+// Gap between the PDUs of one advertising event on consecutive channels
+#define CHANNEL_HOP_US 150
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Summary statistics over a sample set
+struct summary_t {
+    double min, mean, p50, p95, p99, max, stddev;
+};
+
+inline summary_t summarise(std::vector<double> v) {
+    summary_t s = {};
+    if (v.empty()) return s;
+    std::sort(v.begin(), v.end());
+    double sum = 0;
+    for (double x : v) sum += x;
+    s.mean = sum / v.size();
+    double sq = 0;
+    for (double x : v) sq += (x - s.mean) * (x - s.mean);
+    s.stddev = std::sqrt(sq / v.size());
+    s.min = v.front();
+    s.max = v.back();
+    s.p50 = v[v.size() / 2];
+    s.p95 = v[std::min(v.size() - 1, static_cast<size_t>(v.size() * 0.95))];
+    s.p99 = v[std::min(v.size() - 1, static_cast<size_t>(v.size() * 0.99))];
+    return s;
+}
+
+inline void print_summary(const char* label, const summary_t& s) {
+    printf("%-28s min %9.0f  mean %9.0f  p50 %9.0f  p99 %9.0f  max %9.0f  sd %8.0f\n",
+           label, s.min, s.mean, s.p50, s.p99, s.max, s.stddev);
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Scanner model
+struct scanner_t {
+    uint64_t start_us;    // Visitor arrives in range
+    uint64_t phase_us;    // Position in the scanner's 3-channel cycle at arrival
+    uint64_t interval_us;
+    uint64_t window_us;
+    double   loss;
+};
+
+// True if a PDU on `channel_index` (0 = 37) occupying [t, t + len) is received
+inline bool scanner_hears(const scanner_t& sc, uint64_t t, uint32_t len_us, int channel_index,
+                          std::mt19937& rng) {
+    if (t < sc.start_us) return false;
+    uint64_t since = t - sc.start_us + sc.phase_us;
+    uint64_t k = since / sc.interval_us;
+    if (static_cast<int>(k % 3) != channel_index) return false;
+    if (since - k * sc.interval_us + len_us > sc.window_us) return false;
+    return std::uniform_real_distribution<double>(0, 1)(rng) >= sc.loss;
+}
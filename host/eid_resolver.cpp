@@ -0,0 +1,137 @@
+/*
+COS10025 BLE-to-Web Cultural Storytelling System
+Host-side ephemeral ID resolver (see eid_resolver.h).
+*/
+
+#include "eid_resolver.h"
+
+#include <openssl/evp.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+void eid_aes128_openssl(const uint8_t key[16], const uint8_t in[16], uint8_t out[16]) {
+    // One context per thread, re-keyed per block (the EID derivation changes key every block)
+    static thread_local EVP_CIPHER_CTX* ctx = EVP_CIPHER_CTX_new();
+    int len = 0;
+    EVP_EncryptInit_ex(ctx, EVP_aes_128_ecb(), nullptr, key, nullptr);
+    EVP_CIPHER_CTX_set_padding(ctx, 0);
+    EVP_EncryptUpdate(ctx, out, &len, in, 16);
+}
+
+static uint64_t id_key(const uint8_t eid[BEACON_EID_LEN]) {
+    uint64_t v = 0;
+    memcpy(&v, eid, sizeof(v));
+    return v;
+}
+
+static void insert_slot(eid_resolver_t* r, uint32_t beacon, uint32_t slot, bool boot) {
+    uint8_t eid[BEACON_EID_LEN];
+    beacon_eid_compute(eid_aes128_openssl, r->beacons[beacon].key, r->rotation_exp, slot, eid);
+    r->derived++;
+    r->table[id_key(eid)] = {r->beacons[beacon].artifact_id, beacon, slot, boot};
+    if (!boot) r->window_ids[slot].push_back(id_key(eid));
+}
+
+// Window slots only; since-boot entries stay for the resolver's lifetime
+static void erase_slot(eid_resolver_t* r, uint32_t slot) {
+    auto ids = r->window_ids.find(slot);
+    if (ids == r->window_ids.end()) return;
+    for (uint64_t id : ids->second) {
+        auto it = r->table.find(id);
+        if (it != r->table.end() && !it->second.boot_clock) r->table.erase(it);
+    }
+    r->window_ids.erase(ids);
+}
+
+void eid_resolver_init(eid_resolver_t* r, uint8_t rotation_exp, uint32_t window_slots, uint32_t boot_slots) {
+    r->rotation_exp = rotation_exp;
+    r->window_slots = window_slots;
+    r->boot_slots = boot_slots;
+    r->beacons.clear();
+    r->table.clear();
+    r->window_ids.clear();
+    r->first_slot = r->last_slot = 0;
+    r->has_window = false;
+    r->derived = 0;
+}
+
+uint32_t eid_resolver_add(eid_resolver_t* r, const std::string& unit, uint32_t artifact_id,
+                          const uint8_t key[BEACON_EID_KEY_LEN]) {
+    eid_registration_t reg = {unit, artifact_id, {}};
+    memcpy(reg.key, key, BEACON_EID_KEY_LEN);
+    r->beacons.push_back(reg);
+    uint32_t b = static_cast<uint32_t>(r->beacons.size() - 1);
+    uint32_t period = 1u << r->rotation_exp;
+    for (uint32_t i = 0; i < r->boot_slots; i++) insert_slot(r, b, i * period, true);
+    for (uint32_t s = r->first_slot; r->has_window && s <= r->last_slot; s += period) insert_slot(r, b, s, false);
+    return b;
+}
+
+static bool parse_key(const char* hex, uint8_t key[BEACON_EID_KEY_LEN]) {
+    if (strlen(hex) != 2 * BEACON_EID_KEY_LEN) return false;
+    for (int i = 0; i < BEACON_EID_KEY_LEN; i++) {
+        char byte[3] = {hex[2 * i], hex[2 * i + 1], 0};
+        char* end = nullptr;
+        key[i] = static_cast<uint8_t>(strtoul(byte, &end, 16));
+        if (*end != '\0') return false;
+    }
+    return true;
+}
+
+int eid_resolver_load_keys(eid_resolver_t* r, const char* path) {
+    FILE* f = fopen(path, "r");
+    if (!f) return -1;
+    char line[256];
+    int added = 0;
+    bool header = true;
+    while (fgets(line, sizeof(line), f)) {
+        line[strcspn(line, "\r\n")] = '\0';
+        if (header || line[0] == '\0' || line[0] == '#') {
+            header = false;
+            continue;
+        }
+        char unit[64] = {}, id[16] = {}, hex[40] = {};
+        uint8_t key[BEACON_EID_KEY_LEN];
+        if (sscanf(line, "%63[^,],%15[^,],%39s", unit, id, hex) != 3 || !parse_key(hex, key)) {
+            fprintf(stderr, "%s: bad key row \"%s\"\n", path, line);
+            fclose(f);
+            return -1;
+        }
+        eid_resolver_add(r, unit, static_cast<uint32_t>(strtoul(id, nullptr, 0)), key);
+        added++;
+    }
+    fclose(f);
+    return added;
+}
+
+void eid_resolver_advance(eid_resolver_t* r, uint32_t now_s) {
+    uint32_t period = 1u << r->rotation_exp;
+    uint32_t now_slot = beacon_eid_slot(now_s, r->rotation_exp);
+    uint32_t span = r->window_slots * period;
+    uint32_t first = now_slot > span ? now_slot - span : 0;
+    uint32_t last = now_slot + span;
+    if (r->has_window && first == r->first_slot) return;
+
+    // Step 1: Drop slots that left the window
+    for (uint32_t s = r->first_slot; r->has_window && s <= r->last_slot; s += period) {
+        if (s < first || s > last) erase_slot(r, s);
+    }
+
+    // Step 2: Derive the slots that entered it
+    for (uint32_t s = first; s <= last; s += period) {
+        if (r->has_window && s >= r->first_slot && s <= r->last_slot) continue;
+        for (uint32_t b = 0; b < r->beacons.size(); b++) insert_slot(r, b, s, false);
+    }
+    r->first_slot = first;
+    r->last_slot = last;
+    r->has_window = true;
+}
+
+bool eid_resolver_resolve(const eid_resolver_t* r, const uint8_t eid[BEACON_EID_LEN], eid_match_t* out) {
+    auto it = r->table.find(id_key(eid));
+    if (it == r->table.end()) return false;
+    *out = it->second;
+    return true;
+}
@@ -0,0 +1,69 @@
+/*
+COS10025 BLE-to-Web Cultural Storytelling System
+Host-side resolver for rotating ephemeral artifact IDs (beacon_eid.h).
+- Registry of beacons (artifact ID + identity key), loaded from the key sheet
+  written by tools/beacon_nvs.py --keys-out
+- Lookup window: every registered beacon's IDs for the rotation slots around
+  "now" (± window_slots) and for the first boot_slots slots after a power-up
+  without a clock, precomputed into one hash table keyed by the 8-byte ID.
+  Resolving is a single table probe; advancing the window derives only the
+  slots that enter it
+- AES-128 from OpenSSL (libcrypto)
+*/
+
+#pragma once
+
+#include "beacon_eid.h"
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct eid_registration_t {
+    std::string unit;
+    uint32_t    artifact_id;
+    uint8_t     key[BEACON_EID_KEY_LEN];
+};
+
+struct eid_match_t {
+    uint32_t artifact_id;
+    uint32_t beacon;     // Index into eid_resolver_t::beacons
+    uint32_t slot;       // First counter value of the matched rotation slot
+    bool     boot_clock; // Matched a since-boot slot: the beacon's clock is not set
+};
+
+// The 8-byte ID is AES output, so its low bits already hash uniformly
+struct eid_hash_t {
+    size_t operator()(uint64_t id) const { return static_cast<size_t>(id); }
+};
+
+struct eid_resolver_t {
+    uint8_t  rotation_exp;
+    uint32_t window_slots;  // Slots either side of the current one
+    uint32_t boot_slots;    // Since-boot slots kept for beacons without a clock
+    std::vector<eid_registration_t> beacons;
+    std::unordered_map<uint64_t, eid_match_t, eid_hash_t> table;
+    std::unordered_map<uint32_t, std::vector<uint64_t>> window_ids; // Window slot → its IDs, for eviction
+    uint32_t first_slot;    // Slot window currently in the table (inclusive)
+    uint32_t last_slot;
+    bool     has_window;
+    uint64_t derived;       // IDs derived so far
+};
+
+void eid_resolver_init(eid_resolver_t* r, uint8_t rotation_exp, uint32_t window_slots, uint32_t boot_slots);
+
+// Register one beacon (its boot slots enter the table straight away); returns its index
+uint32_t eid_resolver_add(eid_resolver_t* r, const std::string& unit, uint32_t artifact_id,
+                          const uint8_t key[BEACON_EID_KEY_LEN]);
+
+// Key sheet CSV: unit,artifact_id,eid_key (32 hex digits); returns beacons added, -1 on error
+int eid_resolver_load_keys(eid_resolver_t* r, const char* path);
+
+// Slide the window to `now_s` (Unix seconds): drops slots that left it, derives the new ones
+void eid_resolver_advance(eid_resolver_t* r, uint32_t now_s);
+
+// Look up an advertised ID; false if it belongs to no registered beacon in the window
+bool eid_resolver_resolve(const eid_resolver_t* r, const uint8_t eid[BEACON_EID_LEN], eid_match_t* out);
+
+// AES-128 block encryption through OpenSSL, for beacon_eid_compute() on the host
+void eid_aes128_openssl(const uint8_t key[16], const uint8_t in[16], uint8_t out[16]);
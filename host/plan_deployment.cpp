@@ -0,0 +1,566 @@
+/*
+COS10025 BLE-to-Web Cultural Storytelling System
+Dense-deployment planner: per-beacon advertising interval, channel map and TX power.
+- Hall: --hall CSV (unit,artifact_id,x_m,y_m[,spot_x_m,spot_y_m,name,format]),
+  where the spot is where visitors stand to view the artifact (default 1.2 m in
+  front, +y). Without --hall a --grid RxC hall with --spacing-m between displays
+- Every beacon runs the beacon core on its own simulated controller (random
+  advDelay, random power-on phase). Two PDUs on the same channel that overlap
+  in time collide at a receiver unless the wanted one is --capture-db stronger
+- Radio: log-distance path loss (40 dB at 1 m, exponent --path-exp), phone
+  sensitivity --sensitivity-dbm; scanner model as in bench_rotation
+- Discovery latency per artifact: visitor arrives at its spot → first
+  collision-free PDU of its beacon heard there
+- Plan: lowest TX power that reaches the own spot with --margin-db, staggered
+  interval offsets, then greedy moves (shorten a late artifact's interval,
+  turn down or thin out the channels of its strongest interferers, lengthen
+  intervals with slack) until every artifact meets --target-p95-ms
+- --out writes the fleet sheet for tools/beacon_nvs.py --from-csv
+- Exits non-zero when the plan misses the target
+
+Usage: plan_deployment [--hall hall.csv | --grid 6x5 --spacing-m 2.5] [--target-p95-ms MS]
+                       [--trials N] [--scan-window-ms MS] [--scan-interval-ms MS]
+                       [--min-interval-ms MS] [--max-interval-ms MS] [--rounds N]
+                       [--path-exp N] [--sensitivity-dbm DBM] [--capture-db DB] [--margin-db DB]
+                       [--out fleet.csv]
+*/
+
+#include "beacon_core.h"
+#include "beacon_payload.h"
+#include "sim_controller.h"
+#include "bench_util.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+// ESP32 advertising TX power levels (the backend rounds down to these)
+static const int8_t TX_LEVELS_DBM[] = {-12, -9, -6, -3, 0, 3, 6, 9};
+#define TX_LEVEL_COUNT (sizeof(TX_LEVELS_DBM) / sizeof(TX_LEVELS_DBM[0]))
+
+#define PATH_LOSS_1M_DB 40.0 // 2.4 GHz free space at 1 m
+#define WARMUP_US       2000000ULL
+#define ARRIVAL_SPAN_US 5000000ULL
+#define MS_TO_UNITS(ms) static_cast<uint16_t>((ms) / 0.625 + 0.5)
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Hall and per-unit parameters
+struct unit_t {
+    std::string unit;
+    uint32_t    artifact_id;
+    double      x, y;           // Beacon position (m)
+    double      spot_x, spot_y; // Viewing spot (m)
+    std::string name, format;   // Passed through to the fleet sheet
+    beacon_payload_t payload;
+};
+
+struct unit_plan_t {
+    uint16_t interval_min; // 0.625 ms units
+    uint16_t interval_max;
+    uint8_t  channel_map;
+    int8_t   tx_dbm;
+};
+
+struct radio_t {
+    double path_exp = 2.5;
+    double sensitivity_dbm = -90.0;
+    double capture_db = 6.0;
+    double margin_db = 10.0;
+};
+
+static double rssi_dbm(const radio_t& radio, int8_t tx_dbm, double x0, double y0, double x1, double y1) {
+    double d = std::max(0.5, std::hypot(x1 - x0, y1 - y0));
+    return tx_dbm - PATH_LOSS_1M_DB - 10.0 * radio.path_exp * std::log10(d);
+}
+
+static double own_rssi(const radio_t& radio, const unit_t& u, int8_t tx_dbm) {
+    return rssi_dbm(radio, tx_dbm, u.x, u.y, u.spot_x, u.spot_y);
+}
+
+static int channel_count(uint8_t map) {
+    return (map & 1) + ((map >> 1) & 1) + ((map >> 2) & 1);
+}
+
+static void format_channels(uint8_t map, char* out, size_t cap) {
+    out[0] = '\0';
+    for (int ch = 0; ch < 3; ch++) {
+        if (!(map & (1 << ch))) continue;
+        size_t len = strlen(out);
+        snprintf(out + len, cap - len, "%s%d", len ? "," : "", 37 + ch);
+    }
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Hall input
+static std::vector<std::string> split_csv(const std::string& line) {
+    std::vector<std::string> fields;
+    size_t start = 0;
+    for (;;) {
+        size_t comma = line.find(',', start);
+        std::string f = line.substr(start, comma == std::string::npos ? std::string::npos : comma - start);
+        while (!f.empty() && (f.back() == '\r' || f.back() == ' ')) f.pop_back();
+        while (!f.empty() && f.front() == ' ') f.erase(0, 1);
+        fields.push_back(f);
+        if (comma == std::string::npos) return fields;
+        start = comma + 1;
+    }
+}
+
+static bool load_hall(const char* path, std::vector<unit_t>* units) {
+    FILE* f = fopen(path, "r");
+    if (!f) return false;
+    char buf[512];
+    std::vector<std::string> header;
+    while (fgets(buf, sizeof(buf), f)) {
+        std::string line(buf);
+        while (!line.empty() && (line.back() == '\n' || line.back() == '\r')) line.pop_back();
+        if (line.empty() || line[0] == '#') continue;
+        std::vector<std::string> fields = split_csv(line);
+        if (header.empty()) {
+            header = fields;
+            continue;
+        }
+        auto col = [&](const char* name) -> const std::string* {
+            for (size_t i = 0; i < header.size() && i < fields.size(); i++) {
+                if (header[i] == name && !fields[i].empty()) return &fields[i];
+            }
+            return nullptr;
+        };
+        const std::string *unit = col("unit"), *id = col("artifact_id"), *x = col("x_m"), *y = col("y_m");
+        if (!unit || !id || !x || !y) {
+            fprintf(stderr, "%s: row needs unit, artifact_id, x_m, y_m: %s\n", path, line.c_str());
+            fclose(f);
+            return false;
+        }
+        unit_t u = {};
+        u.unit = *unit;
+        u.artifact_id = static_cast<uint32_t>(strtoul(id->c_str(), nullptr, 0));
+        u.x = atof(x->c_str());
+        u.y = atof(y->c_str());
+        u.spot_x = col("spot_x_m") ? atof(col("spot_x_m")->c_str()) : u.x;
+        u.spot_y = col("spot_y_m") ? atof(col("spot_y_m")->c_str()) : u.y + 1.2;
+        u.name = col("name") ? *col("name") : "";
+        u.format = col("format") ? *col("format") : "compact";
+        units->push_back(u);
+    }
+    fclose(f);
+    return !units->empty();
+}
+
+static void grid_hall(int rows, int cols, double spacing_m, std::vector<unit_t>* units) {
+    for (int r = 0; r < rows; r++) {
+        for (int c = 0; c < cols; c++) {
+            unit_t u = {};
+            char name[16];
+            snprintf(name, sizeof(name), "unit%02d", r * cols + c + 1);
+            u.unit = name;
+            u.artifact_id = static_cast<uint32_t>(0x0100 + r * cols + c);
+            u.x = c * spacing_m;
+            u.y = r * spacing_m;
+            u.spot_x = u.x;
+            u.spot_y = u.y + 1.2;
+            u.format = "compact";
+            units->push_back(u);
+        }
+    }
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Collision simulation
+struct pdu_t {
+    uint64_t t_us;
+    uint32_t len_us;
+    uint16_t unit;
+    uint8_t  channel; // 0 = 37
+    bool operator<(const pdu_t& o) const { return t_us < o.t_us; }
+};
+
+struct unit_result_t {
+    std::vector<double> latency_ms; // Per trial, heard ones only
+    uint32_t missed;                // Trials without discovery within the horizon
+    uint64_t pdus;                  // PDUs audible at the own spot
+    uint64_t lost;                  // ... of which collided
+};
+
+struct eval_t {
+    std::vector<unit_result_t> units;
+    std::vector<std::vector<uint32_t>> blame; // blame[a][b]: PDUs of a lost to b at a's spot
+    double violation_ms;                      // Sum of p95 overshoot, a miss counts as one target
+    double airtime_per_s;                     // PDUs per second, all beacons (channel load)
+    int    worst;                             // Artifact furthest over the target, -1 if none
+};
+
+struct planner_t {
+    std::vector<unit_t> units;
+    radio_t   radio;
+    scanner_t scan;
+    int       trials;
+    uint64_t  horizon_us;
+    double    target_ms;
+};
+
+// Advertising events of one beacon on its own simulated controller
+static std::vector<uint64_t> run_beacon(const unit_t& u, const unit_plan_t& plan, uint32_t seed, uint64_t end_us) {
+    sim_timing_t timing;
+    timing.seed = seed;
+    sim_controller_t sim;
+    sim_controller_init(&sim, timing);
+    std::mt19937 rng(seed * 2654435761u);
+
+    // Units are powered on at arbitrary points of each other's schedule
+    sim_controller_advance(&sim, std::uniform_int_distribution<uint64_t>(0, plan.interval_max * 625ULL)(rng));
+    beacon_t beacon;
+    beacon_init(&beacon, sim_controller_backend(&sim), u.payload.bytes, u.payload.len);
+    beacon_adv_params_t params = beacon_default_adv_params();
+    params.interval_min = plan.interval_min;
+    params.interval_max = plan.interval_max;
+    params.channel_map = plan.channel_map;
+    beacon_set_profile(&beacon, &params, plan.tx_dbm);
+    beacon_start(&beacon);
+    sim_controller_run_until(&sim, end_us);
+    return sim.adv_times_us;
+}
+
+static eval_t evaluate(const planner_t& p, const std::vector<unit_plan_t>& plans) {
+    size_t n = p.units.size();
+    eval_t ev = {};
+    ev.units.assign(n, unit_result_t{});
+    ev.blame.assign(n, std::vector<uint32_t>(n, 0));
+
+    // Received level of beacon b at the spot of artifact a
+    std::vector<std::vector<double>> rx(n, std::vector<double>(n));
+    for (size_t a = 0; a < n; a++) {
+        for (size_t b = 0; b < n; b++) {
+            rx[a][b] = rssi_dbm(p.radio, plans[b].tx_dbm, p.units[b].x, p.units[b].y, p.units[a].spot_x,
+                                p.units[a].spot_y);
+        }
+    }
+
+    uint64_t end_us = WARMUP_US + ARRIVAL_SPAN_US + p.horizon_us;
+    for (int trial = 0; trial < p.trials; trial++) {
+        // Step 1: Every beacon's PDUs, per channel in time order
+        std::vector<pdu_t> channel_pdus[3];
+        std::vector<std::vector<pdu_t>> own(n);
+        for (size_t u = 0; u < n; u++) {
+            uint32_t seed = static_cast<uint32_t>(trial * 1009 + u + 1);
+            uint32_t len_us = beacon_adv_airtime_us(p.units[u].payload.len, BEACON_ADV_CHANNEL_37);
+            for (uint64_t t : run_beacon(p.units[u], plans[u], seed, end_us)) {
+                int k = 0;
+                for (int ch = 0; ch < 3; ch++) {
+                    if (!(plans[u].channel_map & (1 << ch))) continue;
+                    pdu_t pdu = {t + k++ * (len_us + CHANNEL_HOP_US), len_us, static_cast<uint16_t>(u),
+                                 static_cast<uint8_t>(ch)};
+                    channel_pdus[ch].push_back(pdu);
+                    own[u].push_back(pdu);
+                }
+            }
+        }
+        for (auto& v : channel_pdus) std::sort(v.begin(), v.end());
+        uint32_t max_len_us = 0;
+        for (const auto& v : channel_pdus) {
+            for (const pdu_t& q : v) max_len_us = std::max(max_len_us, q.len_us);
+        }
+
+        // Step 2: Per artifact, a visitor at its spot; first collision-free PDU heard
+        for (size_t a = 0; a < n; a++) {
+            std::mt19937 rng(static_cast<uint32_t>(trial * 7919 + a * 104729 + 17));
+            scanner_t sc = p.scan;
+            sc.start_us = WARMUP_US + std::uniform_int_distribution<uint64_t>(0, ARRIVAL_SPAN_US)(rng);
+            sc.phase_us = std::uniform_int_distribution<uint64_t>(0, 3 * sc.interval_us - 1)(rng);
+            bool audible = rx[a][a] >= p.radio.sensitivity_dbm;
+            double latency = -1;
+
+            for (const pdu_t& pdu : own[a]) {
+                if (!audible) break;
+
+                // Overlapping PDUs on the same channel that are not capture_db weaker
+                const std::vector<pdu_t>& v = channel_pdus[pdu.channel];
+                uint32_t len_us = pdu.len_us;
+                pdu_t from = {pdu.t_us > max_len_us ? pdu.t_us - max_len_us : 0, 0, 0, 0};
+                int blamed = -1;
+                for (auto it = std::lower_bound(v.begin(), v.end(), from); it != v.end() && it->t_us < pdu.t_us + len_us;
+                     ++it) {
+                    if (it->unit == a || it->t_us + it->len_us <= pdu.t_us) continue;
+                    if (rx[a][it->unit] > rx[a][a] - p.radio.capture_db) {
+                        blamed = it->unit;
+                        break;
+                    }
+                }
+                ev.units[a].pdus++;
+                if (blamed >= 0) {
+                    ev.units[a].lost++;
+                    ev.blame[a][blamed]++;
+                    continue;
+                }
+                if (latency < 0 && pdu.t_us + len_us <= sc.start_us + p.horizon_us &&
+                    scanner_hears(sc, pdu.t_us, len_us, pdu.channel, rng)) {
+                    latency = (pdu.t_us + len_us - sc.start_us) / 1000.0;
+                }
+            }
+            if (latency < 0) ev.units[a].missed++;
+            else ev.units[a].latency_ms.push_back(latency);
+        }
+    }
+
+    // Step 3: Score against the target
+    double worst_over = 0;
+    ev.worst = -1;
+    for (size_t a = 0; a < n; a++) {
+        summary_t s = summarise(ev.units[a].latency_ms);
+        double over = std::max(0.0, s.p95 - p.target_ms) + ev.units[a].missed * p.target_ms;
+        ev.violation_ms += over;
+        if (over > worst_over) {
+            worst_over = over;
+            ev.worst = static_cast<int>(a);
+        }
+        ev.airtime_per_s += channel_count(plans[a].channel_map) * 1e6 / (plans[a].interval_min * 625.0 + 5000.0);
+    }
+    return ev;
+}
+
+// Lower violation wins; equal violation: less channel load
+static bool better(const eval_t& a, const eval_t& b) {
+    if (a.violation_ms < b.violation_ms - 1e-6) return true;
+    return a.violation_ms <= b.violation_ms + 1e-6 && a.airtime_per_s < b.airtime_per_s - 1e-6;
+}
+
+static int8_t lowest_tx_reaching(const radio_t& radio, const unit_t& u) {
+    for (int8_t level : TX_LEVELS_DBM) {
+        if (own_rssi(radio, u, level) >= radio.sensitivity_dbm + radio.margin_db) return level;
+    }
+    return TX_LEVELS_DBM[TX_LEVEL_COUNT - 1];
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Report
+static void print_table(const planner_t& p, const eval_t& base, const std::vector<unit_plan_t>& plans,
+                        const eval_t& planned) {
+    printf("%-8s %-8s %5s %9s %-9s | %-29s | %-29s\n", "unit", "artifact", "dBm", "int ms", "channels",
+           "default: p50 / p95 ms miss lost", "planned: p50 / p95 ms miss lost");
+    for (size_t a = 0; a < p.units.size(); a++) {
+        summary_t b = summarise(base.units[a].latency_ms);
+        summary_t s = summarise(planned.units[a].latency_ms);
+        char channels[12];
+        format_channels(plans[a].channel_map, channels, sizeof(channels));
+        auto pct = [](uint64_t part, uint64_t whole) { return whole ? 100.0 * part / whole : 0.0; };
+        printf("%-8s 0x%04lx   %5d %9.1f %-9s | %6.0f %6.0f %4.0f%% %5.1f%% | %6.0f %6.0f %4.0f%% %5.1f%%%s\n",
+               p.units[a].unit.c_str(), (unsigned long)p.units[a].artifact_id, plans[a].tx_dbm,
+               plans[a].interval_min * 0.625, channels, b.p50, b.p95, pct(base.units[a].missed, p.trials),
+               pct(base.units[a].lost, base.units[a].pdus), s.p50, s.p95, pct(planned.units[a].missed, p.trials),
+               pct(planned.units[a].lost, planned.units[a].pdus), s.p95 > p.target_ms ? "  OVER" : "");
+    }
+}
+
+static bool write_fleet(const char* path, const planner_t& p, const std::vector<unit_plan_t>& plans) {
+    FILE* f = fopen(path, "w");
+    if (!f) return false;
+    fprintf(f, "unit,artifact_id,name,format,interval_ms_min,interval_ms_max,tx_power_dbm,channels\n");
+    for (size_t a = 0; a < p.units.size(); a++) {
+        char channels[12];
+        format_channels(plans[a].channel_map, channels, sizeof(channels));
+        fprintf(f, "%s,0x%04lx,%s,%s,%.3f,%.3f,%d,\"%s\"\n", p.units[a].unit.c_str(),
+                (unsigned long)p.units[a].artifact_id, p.units[a].name.c_str(), p.units[a].format.c_str(),
+                plans[a].interval_min * 0.625, plans[a].interval_max * 0.625, plans[a].tx_dbm, channels);
+    }
+    fclose(f);
+    return true;
+}
+
+int main(int argc, char** argv) {
+    const char* hall = nullptr;
+    const char* out = nullptr;
+    int rows = 6, cols = 5;
+    double spacing_m = 2.5;
+    double target_ms = 3500.0;
+    double scan_window_ms = 1024.0;   // Android SCAN_MODE_BALANCED
+    double scan_interval_ms = 4096.0;
+    double min_interval_ms = 60.0;
+    double max_interval_ms = 200.0;   // Upper end of the documented broadcast interval
+    int rounds = 40;
+
+    planner_t p;
+    p.trials = 40;
+    p.horizon_us = 20000000ULL;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (!strcmp(argv[i], "--hall")) hall = argv[i + 1];
+        else if (!strcmp(argv[i], "--grid")) sscanf(argv[i + 1], "%dx%d", &rows, &cols);
+        else if (!strcmp(argv[i], "--spacing-m")) spacing_m = atof(argv[i + 1]);
+        else if (!strcmp(argv[i], "--target-p95-ms")) target_ms = atof(argv[i + 1]);
+        else if (!strcmp(argv[i], "--trials")) p.trials = atoi(argv[i + 1]);
+        else if (!strcmp(argv[i], "--scan-window-ms")) scan_window_ms = atof(argv[i + 1]);
+        else if (!strcmp(argv[i], "--scan-interval-ms")) scan_interval_ms = atof(argv[i + 1]);
+        else if (!strcmp(argv[i], "--min-interval-ms")) min_interval_ms = atof(argv[i + 1]);
+        else if (!strcmp(argv[i], "--max-interval-ms")) max_interval_ms = atof(argv[i + 1]);
+        else if (!strcmp(argv[i], "--rounds")) rounds = atoi(argv[i + 1]);
+        else if (!strcmp(argv[i], "--path-exp")) p.radio.path_exp = atof(argv[i + 1]);
+        else if (!strcmp(argv[i], "--sensitivity-dbm")) p.radio.sensitivity_dbm = atof(argv[i + 1]);
+        else if (!strcmp(argv[i], "--capture-db")) p.radio.capture_db = atof(argv[i + 1]);
+        else if (!strcmp(argv[i], "--margin-db")) p.radio.margin_db = atof(argv[i + 1]);
+        else if (!strcmp(argv[i], "--out")) out = argv[i + 1];
+    }
+    if (p.trials < 1 || rows < 1 || cols < 1 || min_interval_ms < 20.0 || max_interval_ms < min_interval_ms) {
+        fprintf(stderr, "invalid --trials, --grid or interval bounds\n");
+        return 2;
+    }
+    p.target_ms = target_ms;
+    p.scan = {0, 0, static_cast<uint64_t>(scan_interval_ms * 1000), static_cast<uint64_t>(scan_window_ms * 1000), 0.0};
+
+    if (hall ? !load_hall(hall, &p.units) : (grid_hall(rows, cols, spacing_m, &p.units), false)) {
+        fprintf(stderr, "cannot read hall \"%s\"\n", hall);
+        return 2;
+    }
+    for (unit_t& u : p.units) {
+        if (u.format == "name") {
+            u.payload.len = beacon_build_name_adv_data(u.name.c_str(), u.payload.bytes, sizeof(u.payload.bytes));
+        } else {
+            u.payload = beacon_encode_compact(u.artifact_id);
+        }
+        if (u.payload.len == 0) {
+            fprintf(stderr, "unit %s: artifact 0x%lx does not fit the payload\n", u.unit.c_str(),
+                    (unsigned long)u.artifact_id);
+            return 2;
+        }
+    }
+    size_t n = p.units.size();
+
+    // Step 1: Baseline, every unit on the shared default profile
+    std::vector<unit_plan_t> base_plans(n, unit_plan_t{BEACON_DEFAULT_INTERVAL_MIN, BEACON_DEFAULT_INTERVAL_MAX,
+                                                       BEACON_ADV_CHANNEL_ALL, 3});
+    eval_t base = evaluate(p, base_plans);
+
+    // Step 2: Start point: TX power for the own spot only, staggered intervals so
+    // neighbours do not stay in step (offsets of 0–10 ms, 0.625 ms apart)
+    uint16_t min_units = MS_TO_UNITS(min_interval_ms), max_units = MS_TO_UNITS(max_interval_ms);
+    std::vector<unit_plan_t> plans = base_plans;
+    for (size_t a = 0; a < n; a++) {
+        plans[a].tx_dbm = lowest_tx_reaching(p.radio, p.units[a]);
+        uint16_t offset = static_cast<uint16_t>((a * 7) % 17);
+        plans[a].interval_min = std::min<uint16_t>(max_units, BEACON_DEFAULT_INTERVAL_MIN + offset);
+        plans[a].interval_max = plans[a].interval_min + (BEACON_DEFAULT_INTERVAL_MAX - BEACON_DEFAULT_INTERVAL_MIN);
+    }
+    eval_t current = evaluate(p, plans);
+    uint32_t evaluations = 2, accepted = 0;
+
+    // Step 3: Greedy repair, then relax units with slack
+    auto set_interval = [&](unit_plan_t* plan, uint32_t units) {
+        units = std::max<uint32_t>(min_units, std::min<uint32_t>(max_units, units));
+        plan->interval_max = static_cast<uint16_t>(units + (plan->interval_max - plan->interval_min));
+        plan->interval_min = static_cast<uint16_t>(units);
+    };
+    std::vector<bool> stuck(n, false);
+    for (int round = 0; round < rounds; round++) {
+        int a = -1;
+        double worst_over = 0;
+        for (size_t u = 0; u < n; u++) {
+            summary_t s = summarise(current.units[u].latency_ms);
+            double over = std::max(0.0, s.p95 - target_ms) + current.units[u].missed * target_ms;
+            if (over > worst_over && !stuck[u]) {
+                worst_over = over;
+                a = static_cast<int>(u);
+            }
+        }
+
+        std::vector<std::vector<unit_plan_t>> candidates;
+        if (a >= 0) {
+            // Late artifact: advertise more often, quieten its two worst interferers
+            std::vector<unit_plan_t> c = plans;
+            set_interval(&c[a], plans[a].interval_min * 4 / 5);
+            if (c[a].interval_min != plans[a].interval_min) candidates.push_back(c);
+
+            std::vector<size_t> order(n);
+            for (size_t u = 0; u < n; u++) order[u] = u;
+            std::sort(order.begin(), order.end(),
+                      [&](size_t x, size_t y) { return current.blame[a][x] > current.blame[a][y]; });
+            for (size_t k = 0; k < 2 && k < n && current.blame[a][order[k]] > 0; k++) {
+                size_t b = order[k];
+                c = plans;
+                unit_plan_t* pb = &c[b];
+                for (size_t l = 1; l < TX_LEVEL_COUNT; l++) {
+                    if (TX_LEVELS_DBM[l] == pb->tx_dbm &&
+                        own_rssi(p.radio, p.units[b], TX_LEVELS_DBM[l - 1]) >= p.radio.sensitivity_dbm + p.radio.margin_db) {
+                        pb->tx_dbm = TX_LEVELS_DBM[l - 1];
+                        candidates.push_back(c);
+                    }
+                }
+                c = plans;
+                pb = &c[b];
+                if (channel_count(pb->channel_map) > 2) {
+                    // Keep two channels: drop the highest one still in use
+                    for (int ch = 2; ch >= 0; ch--) {
+                        if (pb->channel_map & (1 << ch)) {
+                            pb->channel_map &= static_cast<uint8_t>(~(1 << ch));
+                            break;
+                        }
+                    }
+                    candidates.push_back(c);
+                }
+            }
+        } else {
+            // Everything meets the target: lengthen the interval of the unit with the most slack
+            int slack_unit = -1;
+            double most_slack = 0;
+            for (size_t u = 0; u < n; u++) {
+                summary_t s = summarise(current.units[u].latency_ms);
+                if (!stuck[u] && plans[u].interval_min < max_units && target_ms - s.p95 > most_slack) {
+                    most_slack = target_ms - s.p95;
+                    slack_unit = static_cast<int>(u);
+                }
+            }
+            if (slack_unit < 0) break;
+            std::vector<unit_plan_t> c = plans;
+            set_interval(&c[slack_unit], plans[slack_unit].interval_min * 5 / 4);
+            candidates.push_back(c);
+            a = slack_unit;
+        }
+
+        bool moved = false;
+        for (const auto& c : candidates) {
+            eval_t ev = evaluate(p, c);
+            evaluations++;
+            if (better(ev, current)) {
+                current = ev;
+                plans = c;
+                moved = true;
+            }
+        }
+        if (moved) {
+            accepted++;
+            std::fill(stuck.begin(), stuck.end(), false);
+        } else {
+            stuck[a] = true;
+        }
+    }
+
+    // Step 4: Report
+    printf("deployment plan: %zu beacons, scan %.0f/%.0f ms, target p95 %.0f ms, %d trials, path exponent %.1f\n", n,
+           scan_window_ms, scan_interval_ms, target_ms, p.trials, p.radio.path_exp);
+    print_table(p, base, plans, current);
+    double channel_busy = 0, base_busy = 0;
+    for (size_t a = 0; a < n; a++) {
+        double pdu_us = beacon_adv_airtime_us(p.units[a].payload.len, BEACON_ADV_CHANNEL_37);
+        channel_busy += pdu_us * channel_count(plans[a].channel_map) / (plans[a].interval_min * 625.0 + 5000.0) / 3.0;
+        base_busy += pdu_us * channel_count(base_plans[a].channel_map) / (base_plans[a].interval_min * 625.0 + 5000.0) / 3.0;
+    }
+    printf("\nmean channel occupancy: %.1f%% default → %.1f%% planned; overshoot %.0f → %.0f ms\n",
+           100.0 * base_busy, 100.0 * channel_busy, base.violation_ms, current.violation_ms);
+    printf("%lu evaluations, %lu moves accepted\n", (unsigned long)evaluations, (unsigned long)accepted);
+
+    if (out) {
+        if (!write_fleet(out, p, plans)) {
+            fprintf(stderr, "cannot write %s\n", out);
+            return 2;
+        }
+        printf("fleet sheet: %s (python tools/beacon_nvs.py --from-csv %s --out units/)\n", out, out);
+    }
+    if (current.violation_ms > 0) {
+        fprintf(stderr, "GATE: %s misses the %.0f ms p95 target\n",
+                current.worst >= 0 ? p.units[current.worst].unit.c_str() : "plan", target_ms);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,137 @@
+/*
+COS10025 BLE-to-Web Cultural Storytelling System
+Synthetic advertising traffic (see scan_traffic.h).
+*/
+
+#include "scan_traffic.h"
+#include "beacon_payload.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <random>
+
+static const char* const APP_NAMES[] = {"TraKieu_Apsara_Relief", "Tara_Bodhisattva_Statue"};
+
+void scan_traffic_artifacts(const scan_traffic_config_t& config, scan_artifacts_t* out) {
+    scan_artifacts_init(out);
+    for (uint32_t i = 0; i < config.artifacts && i < SCAN_ARTIFACTS_MAX; i++) {
+        char name[SCAN_NAME_MAX + 1];
+        if (i < 2) snprintf(name, sizeof(name), "%s", APP_NAMES[i]);
+        else snprintf(name, sizeof(name), "Cham_Artifact_%02u", i + 1);
+        scan_artifacts_add(out, i + 1, name);
+    }
+}
+
+struct device_t {
+    uint8_t  addr[6];
+    uint8_t  addr_type;
+    int8_t   rssi;
+    uint8_t  data[BEACON_ADV_PAYLOAD_MAX];
+    uint8_t  len;
+    int      truth;
+    uint32_t interval_us;
+};
+
+static uint8_t put_ad(uint8_t* data, uint8_t n, uint8_t type, const uint8_t* body, uint8_t body_len) {
+    data[n++] = static_cast<uint8_t>(body_len + 1);
+    data[n++] = type;
+    memcpy(&data[n], body, body_len);
+    return static_cast<uint8_t>(n + body_len);
+}
+
+// One unrelated advertiser, the kind picked by `kind`
+static void other_payload(device_t* d, uint32_t kind, std::mt19937& rng, const scan_artifacts_t& artifacts) {
+    uint8_t body[BEACON_ADV_PAYLOAD_MAX];
+    for (uint8_t& b : body) b = static_cast<uint8_t>(rng());
+    uint8_t flags[] = {BEACON_AD_FLAGS_GEN_DISC_NO_BREDR};
+    uint8_t n = put_ad(d->data, 0, BEACON_AD_TYPE_FLAGS, flags, 1);
+    switch (kind % 8) {
+    case 0: case 1: case 2: // Apple continuity (nearby info), the bulk of any crowd
+        body[0] = 0x4C; body[1] = 0x00; body[2] = 0x10; body[3] = 0x05;
+        n = put_ad(d->data, n, BEACON_AD_TYPE_MANUFACTURER, body, 9);
+        break;
+    case 3: // Google Fast Pair service data
+        body[0] = 0x2C; body[1] = 0xFE;
+        n = put_ad(d->data, n, 0x16, body, 6);
+        break;
+    case 4: // Microsoft Swift Pair
+        body[0] = 0x06; body[1] = 0x00; body[2] = 0x03;
+        n = put_ad(d->data, n, BEACON_AD_TYPE_MANUFACTURER, body, 27 - n);
+        break;
+    case 5: // iBeacon
+        body[0] = 0x4C; body[1] = 0x00; body[2] = 0x02; body[3] = 0x15;
+        n = put_ad(d->data, n, BEACON_AD_TYPE_MANUFACTURER, body, 25);
+        break;
+    case 6: { // Named gadget; every other one has an artifact name's length
+        char name[SCAN_NAME_MAX + 1];
+        const scan_artifact_t& a = artifacts.items[kind % (artifacts.count ? artifacts.count : 1)];
+        uint8_t len = (kind / 8) % 2 && artifacts.count ? a.name_len : 10;
+        memcpy(name, "JBL Flip 5", 10);
+        memset(name + 10, 'x', sizeof(name) - 10);
+        n = put_ad(d->data, n, BEACON_AD_TYPE_COMPLETE_NAME, reinterpret_cast<const uint8_t*>(name),
+                   std::min<uint8_t>(len, static_cast<uint8_t>(BEACON_ADV_PAYLOAD_MAX - n - 2)));
+        break;
+    }
+    default: // Near miss: 0xFFFF test company ID, another format version
+        body[0] = 0xFF; body[1] = 0xFF; body[2] = 0x22;
+        n = put_ad(d->data, n, BEACON_AD_TYPE_MANUFACTURER, body, 7);
+        break;
+    }
+    d->len = n;
+    d->truth = -1;
+}
+
+std::vector<scan_traffic_event_t> scan_traffic_generate(const scan_traffic_config_t& config) {
+    std::mt19937 rng(config.seed);
+    scan_artifacts_t artifacts;
+    scan_traffic_artifacts(config, &artifacts);
+
+    // Step 1: Devices
+    std::vector<device_t> devices;
+    for (uint32_t i = 0; i < artifacts.count + config.others; i++) {
+        device_t d = {};
+        for (uint8_t& b : d.addr) b = static_cast<uint8_t>(rng());
+        d.addr_type = i < artifacts.count ? 0 : 1; // Beacons public, phones random
+        d.rssi = static_cast<int8_t>(-40 - static_cast<int>(rng() % 56));
+        if (i < artifacts.count) {
+            const scan_artifact_t& a = artifacts.items[i];
+            if (i >= artifacts.count - std::min(config.name_beacons, static_cast<uint32_t>(artifacts.count))) {
+                uint8_t flags[] = {BEACON_AD_FLAGS_GEN_DISC_NO_BREDR};
+                uint8_t n = put_ad(d.data, 0, BEACON_AD_TYPE_FLAGS, flags, 1);
+                d.len = put_ad(d.data, n, BEACON_AD_TYPE_COMPLETE_NAME, reinterpret_cast<const uint8_t*>(a.name),
+                               a.name_len);
+            } else {
+                beacon_telemetry_t t = {3300, 3600, BEACON_RESET_POWER_ON, 0};
+                beacon_payload_t p = i % 3 == 2 ? beacon_encode_telemetry(a.id, t) : beacon_encode_compact(a.id);
+                memcpy(d.data, p.bytes, p.len);
+                d.len = p.len;
+            }
+            d.truth = static_cast<int>(i);
+            d.interval_us = config.beacon_interval_ms * 1000;
+        } else {
+            other_payload(&d, i, rng, artifacts);
+            uint32_t span = config.other_interval_max_ms - config.other_interval_min_ms + 1;
+            d.interval_us = (config.other_interval_min_ms + rng() % span) * 1000;
+        }
+        devices.push_back(d);
+    }
+
+    // Step 2: Advertising events (interval + 0–10 ms advDelay), time-ordered
+    std::vector<scan_traffic_event_t> events;
+    uint64_t end_us = static_cast<uint64_t>(config.seconds * 1e6);
+    for (const device_t& d : devices) {
+        for (uint64_t t = rng() % d.interval_us; t < end_us; t += d.interval_us + rng() % 10000) {
+            scan_traffic_event_t e;
+            e.ts_us = t;
+            e.truth = d.truth;
+            int8_t rssi = static_cast<int8_t>(d.rssi + static_cast<int>(rng() % 9) - 4);
+            e.len = static_cast<uint8_t>(
+                scan_hci_build_report(e.evt, sizeof(e.evt), d.addr, d.addr_type, rssi, d.data, d.len));
+            events.push_back(e);
+        }
+    }
+    std::sort(events.begin(), events.end(),
+              [](const scan_traffic_event_t& a, const scan_traffic_event_t& b) { return a.ts_us < b.ts_us; });
+    return events;
+}
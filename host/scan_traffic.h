@@ -0,0 +1,40 @@
+/*
+COS10025 BLE-to-Web Cultural Storytelling System
+Synthetic advertising traffic for the native scanner benches.
+- A gallery hall: the artifact beacons (compact payloads, every third one with
+  telemetry, the last name_beacons in name mode) among unrelated devices:
+  phones and earbuds (Apple, Microsoft, Google Fast Pair), iBeacon/Eddystone
+  tags, named gadgets, and near misses that share the 0xFFFF test company ID
+  or an artifact name's length
+- Every advertisement becomes one legacy LE Advertising Report event in HCI
+  wire format, time-ordered, with the artifact it carries (-1 = none)
+*/
+
+#pragma once
+
+#include "scan_hci.h"
+
+#include <vector>
+
+struct scan_traffic_config_t {
+    uint32_t artifacts      = 8;     // Artifact beacons (IDs 1..artifacts)
+    uint32_t name_beacons   = 1;     // Of those, advertising the name instead of the compact ID
+    uint32_t others         = 300;   // Unrelated advertisers
+    uint32_t beacon_interval_ms = 100;
+    uint32_t other_interval_min_ms = 20;
+    uint32_t other_interval_max_ms = 500;
+    double   seconds        = 30.0;
+    uint32_t seed           = 1;
+};
+
+struct scan_traffic_event_t {
+    uint64_t ts_us;
+    int      truth;  // Artifact index carried, -1 for unrelated traffic
+    uint8_t  len;
+    uint8_t  evt[4 + 10 + BEACON_ADV_PAYLOAD_MAX];
+};
+
+// Artifact table the app would pass (IDs 1..n; the first two are the app's own)
+void scan_traffic_artifacts(const scan_traffic_config_t& config, scan_artifacts_t* out);
+
+std::vector<scan_traffic_event_t> scan_traffic_generate(const scan_traffic_config_t& config);
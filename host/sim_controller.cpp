@@ -0,0 +1,222 @@
+/*
+COS10025 BLE-to-Web Cultural Storytelling System
+Simulated BLE controller backend (see sim_controller.h).
+*/
+
+#include "sim_controller.h"
+#include "beacon_payload.h"
+
+#include <cstring>
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Helpers
+static sim_controller_t* as_sim(void* ctx) {
+    return static_cast<sim_controller_t*>(ctx);
+}
+
+// Completion events for HCI commands are serialised like on a real transport
+static void queue_completion(sim_controller_t* sim, beacon_event_type_t type, beacon_err_t status) {
+    if (sim->hung) return; // Commands are accepted but never complete
+    uint64_t issue = sim->now_us > sim->hci_busy_until_us ? sim->now_us : sim->hci_busy_until_us;
+    sim->hci_busy_until_us = issue + sim->timing.hci_cmd_us;
+    sim->queue.push({sim->hci_busy_until_us, type, status, sim->generation});
+}
+
+static uint64_t adv_slip_us(sim_controller_t* sim) {
+    std::uniform_int_distribution<uint32_t> delay(0, sim->timing.adv_delay_max_us);
+    uint64_t slip = delay(sim->rng);
+    if (sim->timing.sched_jitter_us) {
+        std::uniform_int_distribution<uint32_t> jitter(0, sim->timing.sched_jitter_us);
+        slip += jitter(sim->rng);
+    }
+    return slip;
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Backend operations
+static beacon_err_t sim_stack_stage(void* ctx, beacon_stack_stage_t stage) {
+    sim_controller_t* sim = as_sim(ctx);
+    sim->now_us += sim->timing.stage_us[stage]; // Blocking calls on the real stack
+    if (sim->fail_stage[stage]) {
+        sim->fail_stage[stage]--;
+        return BEACON_ERR_FAIL;
+    }
+    return BEACON_OK;
+}
+
+static beacon_err_t sim_stack_reset(void* ctx) {
+    sim_controller_t* sim = as_sim(ctx);
+    sim->now_us += sim->timing.stack_reset_us;
+    if (sim->fail_reset) {
+        sim->fail_reset--;
+        return BEACON_ERR_FAIL;
+    }
+    sim->resets++;
+    if (sim->hung && sim->hang_resets != UINT32_MAX) {
+        if (sim->hang_resets > 0) sim->hang_resets--;
+        if (sim->hang_resets == 0) sim->hung = false;
+    }
+
+    // Advertising stops and everything in flight is dropped, the backoff timer included
+    sim->generation++;
+    sim->advertising = false;
+    sim->hci_busy_until_us = sim->now_us;
+    sim->timer_at_us = 0;
+    sim->queue = {};
+    return BEACON_OK;
+}
+
+static void sim_register_event_sink(void* ctx, beacon_event_sink_t sink, void* arg) {
+    sim_controller_t* sim = as_sim(ctx);
+    sim->sink = sink;
+    sim->sink_arg = arg;
+}
+
+static beacon_err_t sim_set_adv_data(void* ctx, const uint8_t* data, uint8_t len) {
+    sim_controller_t* sim = as_sim(ctx);
+    if (len > 31) return BEACON_ERR_INVALID_ARG;
+    if (sim->fail_set_adv_data) {
+        sim->fail_set_adv_data--;
+        queue_completion(sim, BEACON_EVT_ADV_DATA_SET_COMPLETE, BEACON_ERR_FAIL);
+        return BEACON_OK;
+    }
+    memcpy(sim->staged_data, data, len);
+    sim->staged_len = len;
+    queue_completion(sim, BEACON_EVT_ADV_DATA_SET_COMPLETE, BEACON_OK);
+    return BEACON_OK;
+}
+
+static beacon_err_t sim_start_advertising(void* ctx, const beacon_adv_params_t* params) {
+    sim_controller_t* sim = as_sim(ctx);
+    if (sim->fail_start) {
+        sim->fail_start--;
+        queue_completion(sim, BEACON_EVT_ADV_START_COMPLETE, BEACON_ERR_FAIL);
+        return BEACON_OK;
+    }
+    queue_completion(sim, BEACON_EVT_ADV_START_COMPLETE, BEACON_OK);
+
+    // The controller picks the lower bound of the interval range
+    sim->interval_us = params->interval_min * 625u;
+    sim->advertising = true;
+
+    // First advertising event goes out right after the enable command completes
+    if (sim->hung) return BEACON_OK;
+    sim->queue.push({sim->hci_busy_until_us + adv_slip_us(sim), BEACON_EVT_ADV_SENT,
+                     BEACON_OK, sim->generation});
+    return BEACON_OK;
+}
+
+static beacon_err_t sim_stop_advertising(void* ctx) {
+    sim_controller_t* sim = as_sim(ctx);
+    sim->generation++;
+    sim->advertising = false;
+    queue_completion(sim, BEACON_EVT_ADV_STOP_COMPLETE, BEACON_OK);
+    return BEACON_OK;
+}
+
+static beacon_err_t sim_set_tx_power(void* ctx, int8_t dbm) {
+    as_sim(ctx)->tx_power_dbm = dbm;
+    return BEACON_OK;
+}
+
+static beacon_err_t sim_probe(void* ctx) {
+    queue_completion(as_sim(ctx), BEACON_EVT_PROBE_COMPLETE, BEACON_OK);
+    return BEACON_OK;
+}
+
+static beacon_err_t sim_signal_output(void* ctx, const beacon_signal_pattern_t* pattern) {
+    sim_controller_t* sim = as_sim(ctx);
+    if (pattern != sim->signal_pattern) sim->signal_changes++;
+    sim->signal_pattern = pattern;
+    return BEACON_OK;
+}
+
+static uint64_t sim_now_us(void* ctx) {
+    return as_sim(ctx)->now_us;
+}
+
+static void sim_schedule(void* ctx, uint64_t delay_us) {
+    sim_controller_t* sim = as_sim(ctx);
+    sim->timer_at_us = sim->now_us + delay_us;
+    sim->queue.push({sim->timer_at_us, BEACON_EVT_TIMER, BEACON_OK, sim->generation});
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Simulation control
+void sim_controller_init(sim_controller_t* sim, const sim_timing_t& timing) {
+    *sim = sim_controller_t{};
+    sim->timing = timing;
+    sim->rng.seed(timing.seed);
+
+    sim->backend.ctx                 = sim;
+    sim->backend.stack_stage         = sim_stack_stage;
+    sim->backend.stack_reset         = sim_stack_reset;
+    sim->backend.register_event_sink = sim_register_event_sink;
+    sim->backend.set_adv_data        = sim_set_adv_data;
+    sim->backend.start_advertising   = sim_start_advertising;
+    sim->backend.stop_advertising    = sim_stop_advertising;
+    sim->backend.set_tx_power        = sim_set_tx_power;
+    sim->backend.probe               = sim_probe;
+    sim->backend.signal_output       = sim_signal_output;
+    sim->backend.now_us              = sim_now_us;
+    sim->backend.schedule            = sim_schedule;
+}
+
+const beacon_backend_t* sim_controller_backend(sim_controller_t* sim) {
+    return &sim->backend;
+}
+
+void sim_controller_run_until(sim_controller_t* sim, uint64_t t_us) {
+    while (!sim->queue.empty() && sim->queue.top().at_us <= t_us) {
+        sim_pending_t pending = sim->queue.top();
+        sim->queue.pop();
+
+        // Events from a stopped advertising run and replaced timers are dropped
+        if (pending.type == BEACON_EVT_ADV_SENT && pending.generation != sim->generation) continue;
+        if (pending.type == BEACON_EVT_TIMER) {
+            if (pending.at_us != sim->timer_at_us) continue;
+            sim->timer_at_us = 0;
+        }
+
+        // Lock-up: everything but the host's own timer is lost from here on
+        if (sim->hang_at_us && pending.at_us >= sim->hang_at_us) {
+            sim->hang_at_us = 0;
+            sim->hung = true;
+        }
+        if (sim->hung && pending.type != BEACON_EVT_TIMER) continue;
+
+        if (pending.at_us > sim->now_us) sim->now_us = pending.at_us;
+
+        if (pending.type == BEACON_EVT_ADV_DATA_SET_COMPLETE && pending.status == BEACON_OK) {
+            memcpy(sim->adv_data, sim->staged_data, sim->staged_len);
+            sim->adv_len = sim->staged_len;
+            if (sim->advertising && sim->timing.data_update_gap_us) {
+                // Set restart: the scheduled event is dropped and advertising resumes later
+                sim->generation++;
+                sim->queue.push({pending.at_us + sim->timing.data_update_gap_us + adv_slip_us(sim),
+                                 BEACON_EVT_ADV_SENT, BEACON_OK, sim->generation});
+            }
+        }
+
+        if (pending.type == BEACON_EVT_ADV_SENT) {
+            beacon_compact_info_t info = {};
+            bool compact = beacon_decode_compact(sim->adv_data, sim->adv_len, &info);
+            sim->adv_times_us.push_back(pending.at_us);
+            sim->adv_artifacts.push_back(compact ? info.artifact_id : 0);
+            sim->adv_tx_dbm.push_back(sim->tx_power_dbm);
+            sim->queue.push({pending.at_us + sim->interval_us + adv_slip_us(sim),
+                             BEACON_EVT_ADV_SENT, BEACON_OK, pending.generation});
+        }
+
+        if (pending.type == BEACON_EVT_ADV_SENT && !sim->timing.report_adv_events) continue;
+        if (sim->sink) {
+            beacon_event_t event = {pending.type, pending.status, pending.at_us};
+            sim->sink(sim->sink_arg, &event);
+        }
+    }
+    if (t_us > sim->now_us) sim->now_us = t_us;
+}
+
+void sim_controller_advance(sim_controller_t* sim, uint64_t delta_us) {
+    sim->now_us += delta_us;
+}
@@ -0,0 +1,99 @@
+/*
+COS10025 BLE-to-Web Cultural Storytelling System
+Simulated BLE controller backend for Linux host builds.
+- Virtual microsecond clock, advanced only by the simulation
+- Models stack bring-up time, HCI command round trips and the controller's
+  advertising schedule (advInterval + random advDelay of 0–10 ms)
+- Timestamps every advertising event so host benchmarks can measure
+  boot-to-first-advert latency and interval jitter without hardware
+- Fault injection: failing operations and controller lock-ups
+- Records the artifact ID and TX power on air per event (payload rotation)
+*/
+
+#pragma once
+
+#include "beacon_backend.h"
+
+#include <queue>
+#include <random>
+#include <vector>
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Timing model (defaults are rough ESP32 + Bluedroid figures)
+struct sim_timing_t {
+    // Controller init, controller enable, Bluedroid init, Bluedroid enable, GAP register
+    uint32_t stage_us[BEACON_STAGE_COUNT] = {45000, 110000, 35000, 155000, 500};
+    uint32_t hci_cmd_us       = 1500;   // Command issued → completion event at the host
+    uint32_t adv_delay_max_us = 10000;  // Spec pseudo-random advDelay upper bound
+    uint32_t sched_jitter_us  = 0;      // Extra controller scheduling slip per event
+    // Controllers that restart the advertising set on a data change while
+    // advertising push the next event back by this much (0: seamless update)
+    uint32_t data_update_gap_us = 0;
+    uint32_t stack_reset_us   = 60000;  // Host + controller teardown (beacon_restart)
+    // Deliver BEACON_EVT_ADV_SENT to the core; false models Bluedroid, which
+    // has no per-event callback (events are still recorded on air)
+    bool     report_adv_events = true;
+    uint32_t seed             = 1;
+};
+
+struct sim_pending_t {
+    uint64_t            at_us;
+    beacon_event_type_t type;
+    beacon_err_t        status;
+    uint32_t            generation; // Advertising run the event belongs to
+    bool operator>(const sim_pending_t& o) const { return at_us > o.at_us; }
+};
+
+struct sim_controller_t {
+    sim_timing_t        timing;
+    beacon_backend_t    backend;
+    uint64_t            now_us;
+    std::mt19937        rng;
+
+    beacon_event_sink_t sink;
+    void*               sink_arg;
+
+    std::priority_queue<sim_pending_t, std::vector<sim_pending_t>, std::greater<sim_pending_t>> queue;
+    uint64_t            hci_busy_until_us; // Commands complete in issue order
+    uint32_t            generation;        // Bumped on every stop to cancel queued ADV_SENT
+    uint32_t            interval_us;       // Interval used by the running advertising set
+    uint64_t            timer_at_us;       // Pending schedule() expiry, 0 if none
+    int8_t              tx_power_dbm;      // Last requested TX power
+    bool                advertising;
+
+    // Fault injection: make the next N calls of an operation fail
+    uint32_t            fail_stage[BEACON_STAGE_COUNT];
+    uint32_t            fail_set_adv_data;
+    uint32_t            fail_start;
+    uint32_t            fail_reset;
+    // Controller lock-up at hang_at_us (0 = never): no advertising events and
+    // no command completions until the stack is reset; hang_resets resets
+    // are needed to clear it (UINT32_MAX: only a reboot helps)
+    uint64_t            hang_at_us;
+    uint32_t            hang_resets;
+    bool                hung;
+    uint32_t            resets;
+
+    // Payload on air: set_adv_data stages it, the data-set completion applies it
+    uint8_t             staged_data[31];
+    uint8_t             staged_len;
+    uint8_t             adv_data[31];
+    uint8_t             adv_len;
+
+    std::vector<uint64_t> adv_times_us;    // Every simulated advertising event
+    std::vector<uint32_t> adv_artifacts;   // Compact artifact ID on air per event (0 = none)
+    std::vector<int8_t>   adv_tx_dbm;      // TX power per event
+    const beacon_signal_pattern_t* signal_pattern; // Pattern the signalling peripheral runs
+    uint32_t            signal_changes;
+};
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Simulation control
+void sim_controller_init(sim_controller_t* sim, const sim_timing_t& timing);
+const beacon_backend_t* sim_controller_backend(sim_controller_t* sim);
+
+// Deliver every queued event up to and including `t_us`, advancing the clock
+void sim_controller_run_until(sim_controller_t* sim, uint64_t t_us);
+
+// Advance the clock without delivering events (models CPU time spent elsewhere)
+void sim_controller_advance(sim_controller_t* sim, uint64_t delta_us);
@@ -0,0 +1,170 @@
+/*
+COS10025 BLE-to-Web Cultural Storytelling System
+Adaptive advertising interval (see beacon_adaptive.h).
+- Transitions run in the esp_timer task under the backend lock; a beacon that
+  is mid-startup or mid-restart is re-checked a second later
+- A profile change while advertising is one stop + start round trip
+  (beacon_change_profile); "off" is a plain stop, resumed by the next rule
+*/
+
+#include "beacon_adaptive.h"
+
+#if CONFIG_BEACON_POLICY
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "beacon_backend_esp.h"
+#include "beacon_clock.h"
+#include "beacon_energy.h"
+#include "beacon_events.h"
+#include "beacon_policy.h"
+
+static const char* TAG = "BEACON_POLICY";
+
+// Re-check at least this often (clock set later, drift)
+#define MAX_CHECK_S   3600
+// Re-check delay while the beacon is in a transitional state
+#define BUSY_RETRY_US 1000000ULL
+
+#define MS_TO_UNITS(ms) static_cast<uint16_t>((ms) * 1000 / 625)
+
+static beacon_t* s_beacon = nullptr;
+static beacon_policy_t s_policy;
+static bool s_cold_boot = true;
+static esp_timer_handle_t s_timer = nullptr;
+
+static beacon_policy_input_t current_input(void) {
+    beacon_policy_input_t in = {};
+    // Fast wakes are past the boot window by definition
+    in.uptime_s = s_cold_boot ? static_cast<uint32_t>(esp_timer_get_time() / 1000000) : UINT32_MAX;
+    in.minute_of_day = beacon_clock_minute_of_day();
+    return in;
+}
+
+static beacon_power_profile_t report_profile(void) {
+#if CONFIG_BEACON_LOW_POWER
+    return beacon_power_profile_light_sleep();
+#else
+    return beacon_power_profile_always_on();
+#endif
+}
+
+static void log_transition(int from, int to) {
+    beacon_power_profile_t profile = report_profile();
+    uint8_t len = beacon_adv_len(s_beacon);
+    uint8_t channels = s_beacon->adv_params.channel_map;
+    beacon_policy_cost_t c_to = beacon_policy_cost(&s_policy.rules[to], &profile, len, channels);
+    beacon_policy_cost_t c_from = from >= 0 ? beacon_policy_cost(&s_policy.rules[from], &profile, len, channels) : c_to;
+    if (c_to.mean_latency_ms < 0) {
+        ESP_LOGI(TAG, "%s → %s: advertising off, %.2f mA (%+.2f)", from >= 0 ? s_policy.rules[from].name : "boot",
+                 s_policy.rules[to].name, c_to.avg_current_ma, c_to.avg_current_ma - c_from.avg_current_ma);
+        return;
+    }
+    ESP_LOGI(TAG, "%s → %s: %.2f mA (%+.2f), mean discovery wait %.1f ms",
+             from >= 0 ? s_policy.rules[from].name : "boot", s_policy.rules[to].name, c_to.avg_current_ma,
+             c_to.avg_current_ma - c_from.avg_current_ma, c_to.mean_latency_ms);
+}
+
+// Apply the selected rule; false when the beacon cannot change right now
+static bool apply_rule(const beacon_policy_rule_t* rule) {
+    beacon_adv_params_t params = {};
+    bool on = beacon_policy_params(rule, s_beacon->adv_params.channel_map, &params);
+    beacon_state_t state = s_beacon->state;
+    if (state != BEACON_STATE_ADVERTISING && state != BEACON_STATE_STOPPED) return false;
+
+    if (!on) return state == BEACON_STATE_STOPPED || beacon_stop(s_beacon) == BEACON_OK;
+    if (beacon_change_profile(s_beacon, &params) != BEACON_OK) return false;
+    return state == BEACON_STATE_ADVERTISING || beacon_resume(s_beacon) == BEACON_OK;
+}
+
+static void arm(uint64_t delay_us) {
+    esp_timer_stop(s_timer);
+    esp_timer_start_once(s_timer, delay_us);
+}
+
+static void policy_timer_cb(void* arg) {
+    beacon_policy_input_t in = current_input();
+    int next = beacon_policy_select(&s_policy, &in);
+
+    beacon_backend_esp_lock();
+    bool applied = next == s_policy.active || next < 0 || apply_rule(&s_policy.rules[next]);
+    beacon_backend_esp_unlock();
+    if (!applied) {
+        arm(BUSY_RETRY_US);
+        return;
+    }
+
+    int from = -1;
+    if (beacon_policy_update(&s_policy, &in, &from)) {
+        log_transition(from, s_policy.active);
+        beacon_event(BEACON_EV_PROFILE, s_policy.rules[s_policy.active].interval_min,
+                     static_cast<uint32_t>(s_policy.active));
+    }
+    arm(beacon_policy_next_change_s(&s_policy, &in, MAX_CHECK_S) * 1000000ULL);
+}
+
+static void clock_set(void) {
+    if (s_timer) arm(0);
+}
+
+bool beacon_adaptive_init(beacon_t* beacon, bool cold_boot) {
+    s_beacon = beacon;
+    s_cold_boot = cold_boot;
+
+    // Step 1: Rule table, first match wins
+    beacon_policy_init(&s_policy);
+    beacon_policy_rule_t fast = {"boot-fast", BEACON_POLICY_BOOT_WINDOW, CONFIG_BEACON_POLICY_FAST_S, 0, 0,
+                                 MS_TO_UNITS(CONFIG_BEACON_POLICY_FAST_INTERVAL_MS),
+                                 MS_TO_UNITS(CONFIG_BEACON_POLICY_FAST_INTERVAL_MS + 10)};
+    if (CONFIG_BEACON_POLICY_FAST_S > 0) beacon_policy_add(&s_policy, &fast);
+#if CONFIG_BEACON_POLICY_CLOSED_OFF
+    beacon_policy_rule_t closed = {"closed-off", BEACON_POLICY_DAILY, 0, CONFIG_BEACON_POLICY_CLOSE_MIN,
+                                   CONFIG_BEACON_POLICY_OPEN_MIN, 0, 0};
+#else
+    beacon_policy_rule_t closed = {"closed-slow", BEACON_POLICY_DAILY, 0, CONFIG_BEACON_POLICY_CLOSE_MIN,
+                                   CONFIG_BEACON_POLICY_OPEN_MIN, MS_TO_UNITS(CONFIG_BEACON_POLICY_SLOW_INTERVAL_MS),
+                                   MS_TO_UNITS(CONFIG_BEACON_POLICY_SLOW_INTERVAL_MS * 6 / 5)};
+#endif
+    if (CONFIG_BEACON_POLICY_CLOSE_MIN != CONFIG_BEACON_POLICY_OPEN_MIN) beacon_policy_add(&s_policy, &closed);
+    beacon_policy_rule_t normal = {"normal", BEACON_POLICY_ALWAYS, 0, 0, 0, beacon->adv_params.interval_min,
+                                   beacon->adv_params.interval_max};
+    beacon_policy_add(&s_policy, &normal);
+
+    // Step 2: Initial rule goes straight into the profile used by beacon_start()
+    // - An "off" rule is left unapplied: the first check stops advertising once it is up
+    beacon_policy_input_t in = current_input();
+    beacon_policy_update(&s_policy, &in, nullptr);
+    beacon_adv_params_t params = {};
+    if (!beacon_policy_params(&s_policy.rules[s_policy.active], beacon->adv_params.channel_map, &params)) {
+        s_policy.active = -1;
+        return false;
+    }
+    log_transition(-1, s_policy.active);
+    beacon_set_profile(beacon, &params, beacon->tx_power_dbm);
+    return true;
+}
+
+uint32_t beacon_adaptive_next_change_s(void) {
+    beacon_policy_input_t in = current_input();
+    return beacon_policy_next_change_s(&s_policy, &in, MAX_CHECK_S);
+}
+
+void beacon_adaptive_start(void) {
+    beacon_clock_console_init(clock_set);
+#if !CONFIG_BEACON_BURST_MODE
+    esp_timer_create_args_t args = {};
+    args.callback = policy_timer_cb;
+    args.dispatch_method = ESP_TIMER_TASK;
+    args.name = "beacon_policy";
+    if (esp_timer_create(&args, &s_timer) != ESP_OK) return;
+
+    // An unapplied initial "off" rule is checked like any other busy retry
+    beacon_policy_input_t in = current_input();
+    uint64_t first_us = beacon_policy_next_change_s(&s_policy, &in, MAX_CHECK_S) * 1000000ULL;
+    esp_timer_start_once(s_timer, s_policy.active < 0 ? BUSY_RETRY_US : first_us);
+#endif
+}
+#else
+bool beacon_adaptive_init(beacon_t* beacon, bool cold_boot) { return true; }
+uint32_t beacon_adaptive_next_change_s(void) { return 0; }
+void beacon_adaptive_start(void) {}
+#endif
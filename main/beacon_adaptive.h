@@ -0,0 +1,26 @@
+/*
+COS10025 BLE-to-Web Cultural Storytelling System
+Adaptive advertising interval (CONFIG_BEACON_POLICY).
+- Rule table (beacon_policy.h) built from Kconfig and the provisioned interval:
+  fast discovery window after a cold boot, slow or off during closed hours,
+  the provisioned interval otherwise
+- Closed hours follow the wall clock (beacon_clock.h); until it is set the
+  beacon stays on the normal interval
+- Re-evaluated by one esp_timer armed for the next possible rule change; every
+  transition logs its current and discovery-latency trade-off
+*/
+
+#pragma once
+
+#include "beacon_core.h"
+
+// Build the table and apply the initial rule to the profile (before beacon_start)
+// - cold_boot: false on burst fast wakes, which never get the boot window
+// - Returns false when the initial rule turns advertising off
+bool beacon_adaptive_init(beacon_t* beacon, bool cold_boot);
+
+// Seconds until the current rule can change (burst mode: sleep this long when off)
+uint32_t beacon_adaptive_next_change_s(void);
+
+// Start re-evaluating (after beacon_start; no-op in burst mode, where every wake re-evaluates)
+void beacon_adaptive_start(void);
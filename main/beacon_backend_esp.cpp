@@ -0,0 +1,219 @@
+/*
+COS10025 BLE-to-Web Cultural Storytelling System
+ESP32 backend for the beacon core on the Bluedroid host (default build).
+- Radio: Bluedroid GAP, raw advertising data, ADV_NONCONN_IND
+- Signalling: LEDC on GPIO23 (beacon_signal_ledc.cpp)
+- Clock: esp_timer (microseconds since boot)
+*/
+
+#include "beacon_backend_esp.h"
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "esp_bt.h"
+#include "esp_gap_ble_api.h"
+#include "esp_bt_main.h"
+#include "esp_timer.h"
+#include "beacon_signal_ledc.h"
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Event sink registered by the beacon core
+// - Bluedroid only accepts a plain function pointer, so the sink is kept here
+// - GAP events (BTC task) and the backoff timer (esp_timer task) are serialised
+//   through s_sink_lock because the core is not re-entrant
+static beacon_event_sink_t s_sink = nullptr;
+static void* s_sink_arg = nullptr;
+static StaticSemaphore_t s_sink_lock_buf;
+static SemaphoreHandle_t s_sink_lock = nullptr;
+static esp_timer_handle_t s_retry_timer = nullptr;
+static volatile bool s_resetting = false; // Stack teardown in progress: events are dropped, app calls wait
+
+static beacon_err_t to_beacon_err(esp_err_t err) {
+    switch (err) {
+    case ESP_OK:                return BEACON_OK;
+    case ESP_ERR_INVALID_ARG:   return BEACON_ERR_INVALID_ARG;
+    case ESP_ERR_INVALID_STATE: return BEACON_ERR_INVALID_STATE;
+    default:                    return BEACON_ERR_FAIL;
+    }
+}
+
+static void emit(beacon_event_type_t type, esp_bt_status_t status) {
+    if (!s_sink) return;
+    beacon_event_t event = {};
+    event.type = type;
+    event.status = (status == ESP_BT_STATUS_SUCCESS) ? BEACON_OK : BEACON_ERR_FAIL;
+    event.timestamp_us = static_cast<uint64_t>(esp_timer_get_time());
+
+    xSemaphoreTake(s_sink_lock, portMAX_DELAY);
+    if (!s_resetting) s_sink(s_sink_arg, &event);
+    xSemaphoreGive(s_sink_lock);
+}
+
+static void retry_timer_cb(void* arg) {
+    emit(BEACON_EVT_TIMER, ESP_BT_STATUS_SUCCESS);
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// GAP (Generic Access Profile) event handler
+// - Translates the advertising-related GAP events into beacon core events
+static void gap_event_handler(esp_gap_ble_cb_event_t event, esp_ble_gap_cb_param_t* param) {
+    switch (event) {
+    case ESP_GAP_BLE_ADV_DATA_RAW_SET_COMPLETE_EVT:
+        emit(BEACON_EVT_ADV_DATA_SET_COMPLETE, param->adv_data_raw_cmpl.status);
+        break;
+    case ESP_GAP_BLE_ADV_START_COMPLETE_EVT:
+        emit(BEACON_EVT_ADV_START_COMPLETE, param->adv_start_cmpl.status);
+        break;
+    case ESP_GAP_BLE_ADV_STOP_COMPLETE_EVT:
+        emit(BEACON_EVT_ADV_STOP_COMPLETE, param->adv_stop_cmpl.status);
+        break;
+    case ESP_GAP_BLE_SET_CHANNELS_EVT:
+        emit(BEACON_EVT_PROBE_COMPLETE, param->ble_set_channels.stat);
+        break;
+    default:
+        break; // Other GAP events are irrelevant for a passive beacon
+    }
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Radio operations
+static beacon_err_t esp_stack_stage(void* ctx, beacon_stack_stage_t stage) {
+    switch (stage) {
+    case BEACON_STAGE_CONTROLLER_INIT: {
+        // Classic host code is never linked (BLE-only controller mode); this hands the
+        // controller's unused Classic memory back to the heap
+        esp_bt_controller_mem_release(ESP_BT_MODE_CLASSIC_BT);
+        esp_bt_controller_config_t bt_cfg = BT_CONTROLLER_INIT_CONFIG_DEFAULT();
+        return to_beacon_err(esp_bt_controller_init(&bt_cfg));
+    }
+    case BEACON_STAGE_CONTROLLER_ENABLE:
+        return to_beacon_err(esp_bt_controller_enable(ESP_BT_MODE_BLE)); // BLE-only operation
+    case BEACON_STAGE_HOST_INIT:
+        return to_beacon_err(esp_bluedroid_init());
+    case BEACON_STAGE_HOST_ENABLE:
+        return to_beacon_err(esp_bluedroid_enable());
+    case BEACON_STAGE_GAP_REGISTER:
+        return to_beacon_err(esp_ble_gap_register_callback(gap_event_handler));
+    default:
+        return BEACON_ERR_INVALID_ARG;
+    }
+}
+
+// In-process recovery (beacon_restart), called with the sink lock held
+// - esp_bluedroid_disable() waits for the BTC task, which may itself be waiting
+//   for the lock to deliver a GAP event: the lock is released for the teardown
+//   and whatever is delivered meanwhile is dropped
+// - Each step runs only if the previous start-up got that far
+static beacon_err_t esp_stack_reset(void* ctx) {
+    s_resetting = true;
+    xSemaphoreGive(s_sink_lock);
+    if (esp_bluedroid_get_status() == ESP_BLUEDROID_STATUS_ENABLED) esp_bluedroid_disable();
+    if (esp_bluedroid_get_status() == ESP_BLUEDROID_STATUS_INITIALIZED) esp_bluedroid_deinit();
+    if (esp_bt_controller_get_status() == ESP_BT_CONTROLLER_STATUS_ENABLED) esp_bt_controller_disable();
+    if (esp_bt_controller_get_status() == ESP_BT_CONTROLLER_STATUS_INITED) esp_bt_controller_deinit();
+    if (s_retry_timer) esp_timer_stop(s_retry_timer); // A backoff from before the teardown
+    xSemaphoreTake(s_sink_lock, portMAX_DELAY);
+    s_resetting = false;
+    return esp_bt_controller_get_status() == ESP_BT_CONTROLLER_STATUS_IDLE ? BEACON_OK : BEACON_ERR_FAIL;
+}
+
+static void esp_register_event_sink(void* ctx, beacon_event_sink_t sink, void* arg) {
+    if (!s_sink_lock) s_sink_lock = xSemaphoreCreateMutexStatic(&s_sink_lock_buf);
+    s_sink = sink;
+    s_sink_arg = arg;
+}
+
+static beacon_err_t esp_set_adv_data(void* ctx, const uint8_t* data, uint8_t len) {
+    // Bluedroid copies the payload before returning
+    return to_beacon_err(esp_ble_gap_config_adv_data_raw(const_cast<uint8_t*>(data), len));
+}
+
+static beacon_err_t esp_start_advertising(void* ctx, const beacon_adv_params_t* params) {
+    // BLE Advertisement Parameters Configuration
+    // - Non-connectable advertising type (ADV_NONCONN_IND)
+    // - No filter restrictions on scan/connection requests (though connection is disabled)
+    esp_ble_adv_params_t adv_params = {};
+    adv_params.adv_int_min       = params->interval_min;
+    adv_params.adv_int_max       = params->interval_max;
+    adv_params.adv_type          = ADV_TYPE_NONCONN_IND;
+    adv_params.own_addr_type     = BLE_ADDR_TYPE_PUBLIC;
+    adv_params.peer_addr_type    = BLE_ADDR_TYPE_PUBLIC;
+    adv_params.channel_map       = static_cast<esp_ble_adv_channel_t>(params->channel_map);
+    adv_params.adv_filter_policy = ADV_FILTER_ALLOW_SCAN_ANY_CON_ANY;
+    return to_beacon_err(esp_ble_gap_start_advertising(&adv_params));
+}
+
+static beacon_err_t esp_stop_advertising(void* ctx) {
+    return to_beacon_err(esp_ble_gap_stop_advertising());
+}
+
+static beacon_err_t esp_set_tx_power(void* ctx, int8_t dbm) {
+    // ESP32 levels: ESP_PWR_LVL_N12 (-12 dBm) … ESP_PWR_LVL_P9 (+9 dBm) in 3 dB steps
+    int level = dbm < -12 ? 0 : (dbm + 12) / 3;
+    if (level > ESP_PWR_LVL_P9) level = ESP_PWR_LVL_P9;
+    return to_beacon_err(esp_ble_tx_power_set(ESP_BLE_PWR_TYPE_ADV, static_cast<esp_power_level_t>(level)));
+}
+
+static beacon_err_t esp_probe(void* ctx) {
+    // LE Set Host Channel Classification with every data channel usable: the
+    // controller's default, and only connections use it
+    esp_gap_ble_channels channels = {0xFF, 0xFF, 0xFF, 0xFF, 0x1F};
+    return to_beacon_err(esp_ble_gap_set_channels(channels));
+}
+
+static uint64_t esp_now_us(void* ctx) {
+    return static_cast<uint64_t>(esp_timer_get_time());
+}
+
+static void esp_schedule(void* ctx, uint64_t delay_us) {
+    if (!s_retry_timer) {
+        esp_timer_create_args_t args = {};
+        args.callback = retry_timer_cb;
+        args.dispatch_method = ESP_TIMER_TASK;
+        args.name = "beacon_retry";
+        if (esp_timer_create(&args, &s_retry_timer) != ESP_OK) return;
+    }
+    esp_timer_stop(s_retry_timer); // Re-arming replaces the pending expiry
+    esp_timer_start_once(s_retry_timer, delay_us);
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Application calls into the core, serialised with event delivery
+// - No lock before beacon_start(): app_main is the only caller then
+// - During a stack reset the lock is free but the core is mid-restart: callers
+//   wait until the restart holds it again and has run the stack stages
+void beacon_backend_esp_lock(void) {
+    if (!s_sink_lock) return;
+    while (1) {
+        xSemaphoreTake(s_sink_lock, portMAX_DELAY);
+        if (!s_resetting) return;
+        xSemaphoreGive(s_sink_lock);
+        vTaskDelay(1);
+    }
+}
+
+void beacon_backend_esp_unlock(void) {
+    if (s_sink_lock) xSemaphoreGive(s_sink_lock);
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Backend instance
+static const beacon_backend_t s_backend = {
+    .ctx                 = nullptr,
+    .stack_stage         = esp_stack_stage,
+    .stack_reset         = esp_stack_reset,
+    .register_event_sink = esp_register_event_sink,
+    .set_adv_data        = esp_set_adv_data,
+    .start_advertising   = esp_start_advertising,
+    .stop_advertising    = esp_stop_advertising,
+    .set_tx_power        = esp_set_tx_power,
+    .probe               = esp_probe,
+    .signal_output       = beacon_signal_ledc_output,
+    .now_us              = esp_now_us,
+    .schedule            = esp_schedule,
+};
+
+const beacon_backend_t* beacon_backend_esp(void) {
+    return &s_backend;
+}
@@ -0,0 +1,31 @@
+/*
+COS10025 BLE-to-Web Cultural Storytelling System
+ESP32 backend for the beacon core (GAP + LEDC + esp_timer).
+- Bluedroid host: beacon_backend_esp.cpp (shipped sdkconfig)
+- NimBLE host: beacon_backend_nimble.cpp (sdkconfig.defaults.nimble)
+The implementation is chosen by CONFIG_BT_NIMBLE_ENABLED in main/CMakeLists.txt.
+*/
+
+#pragma once
+
+#include "sdkconfig.h"
+#include "beacon_backend.h"
+
+// Backend instance bound to the configured ESP-IDF Bluetooth host and GPIO23
+const beacon_backend_t* beacon_backend_esp(void);
+
+// Hold around core calls made from application tasks or timers after
+// beacon_start() (e.g. beacon_update_payload): GAP events are delivered from
+// the Bluetooth host task under the same lock, and the core is not re-entrant.
+// While beacon_restart() has the stack torn down, taking the lock waits for it
+void beacon_backend_esp_lock(void);
+void beacon_backend_esp_unlock(void);
+
+// Name and core of the compiled-in Bluetooth host, for the startup report
+#if CONFIG_BT_NIMBLE_ENABLED
+#define BEACON_BLE_HOST_NAME "NimBLE"
+#define BEACON_BLE_HOST_CORE CONFIG_BT_NIMBLE_PINNED_TO_CORE
+#else
+#define BEACON_BLE_HOST_NAME "Bluedroid"
+#define BEACON_BLE_HOST_CORE CONFIG_BT_BLUEDROID_PINNED_TO_CORE
+#endif
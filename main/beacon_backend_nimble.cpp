@@ -0,0 +1,285 @@
+/*
+COS10025 BLE-to-Web Cultural Storytelling System
+ESP32 backend for the beacon core on the NimBLE host (sdkconfig.defaults.nimble).
+- Radio: NimBLE GAP, broadcaster role only, raw advertising data, ADV_NONCONN_IND
+- Signalling: LEDC on GPIO23 (beacon_signal_ledc.cpp)
+- Clock: esp_timer (microseconds since boot)
+
+NimBLE GAP calls complete synchronously, but the beacon core expects completion
+events like Bluedroid's. Completions are therefore posted to the NimBLE host
+task's event queue and delivered from there, the same way Bluedroid delivers
+them from its BTC task.
+*/
+
+#include "beacon_backend_esp.h"
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "esp_bt.h"
+#include "esp_timer.h"
+#include "nimble/nimble_port.h"
+#include "nimble/nimble_port_freertos.h"
+#include "host/ble_hs.h"
+#include "beacon_signal_ledc.h"
+
+// Longest wait for host/controller sync in the GAP_REGISTER stage (retried by the core)
+#define HOST_SYNC_TIMEOUT_MS 1000
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Event sink registered by the beacon core
+// - NimBLE host task and the backoff timer (esp_timer task) are serialised
+//   through s_sink_lock because the core is not re-entrant
+static beacon_event_sink_t s_sink = nullptr;
+static void* s_sink_arg = nullptr;
+static StaticSemaphore_t s_sink_lock_buf;
+static SemaphoreHandle_t s_sink_lock = nullptr;
+static esp_timer_handle_t s_retry_timer = nullptr;
+static volatile bool s_resetting = false; // Stack teardown in progress: events are dropped, app calls wait
+
+// How far the stack got, for the teardown
+static bool s_port_inited = false;
+static bool s_host_started = false;
+
+// Host/controller sync, signalled from the host task
+static StaticSemaphore_t s_sync_sem_buf;
+static SemaphoreHandle_t s_sync_sem = nullptr;
+
+// One deferred completion per GAP operation (at most one of each is in flight)
+typedef struct {
+    struct ble_npl_event ev;
+    beacon_event_type_t  type;
+    int                  rc;
+} deferred_event_t;
+
+static deferred_event_t s_data_set_evt = {{}, BEACON_EVT_ADV_DATA_SET_COMPLETE, 0};
+static deferred_event_t s_start_evt    = {{}, BEACON_EVT_ADV_START_COMPLETE, 0};
+static deferred_event_t s_stop_evt     = {{}, BEACON_EVT_ADV_STOP_COMPLETE, 0};
+static deferred_event_t s_probe_evt    = {{}, BEACON_EVT_PROBE_COMPLETE, 0};
+
+static beacon_err_t to_beacon_err(int rc) {
+    switch (rc) {
+    case 0:                 return BEACON_OK;
+    case BLE_HS_EINVAL:     return BEACON_ERR_INVALID_ARG;
+    case BLE_HS_EALREADY:
+    case BLE_HS_EBUSY:
+    case BLE_HS_ENOTSYNCED: return BEACON_ERR_INVALID_STATE;
+    default:                return BEACON_ERR_FAIL;
+    }
+}
+
+static void emit(beacon_event_type_t type, int rc) {
+    if (!s_sink) return;
+    beacon_event_t event = {};
+    event.type = type;
+    event.status = (rc == 0) ? BEACON_OK : BEACON_ERR_FAIL;
+    event.timestamp_us = static_cast<uint64_t>(esp_timer_get_time());
+
+    xSemaphoreTake(s_sink_lock, portMAX_DELAY);
+    if (!s_resetting) s_sink(s_sink_arg, &event);
+    xSemaphoreGive(s_sink_lock);
+}
+
+static void deferred_event_cb(struct ble_npl_event* ev) {
+    deferred_event_t* deferred = static_cast<deferred_event_t*>(ble_npl_event_get_arg(ev));
+    emit(deferred->type, deferred->rc);
+}
+
+static void defer(deferred_event_t* deferred, int rc) {
+    deferred->rc = rc;
+    ble_npl_eventq_put(nimble_port_get_dflt_eventq(), &deferred->ev);
+}
+
+static void retry_timer_cb(void* arg) {
+    emit(BEACON_EVT_TIMER, 0);
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// NimBLE host callbacks
+static void host_sync_cb(void) {
+    xSemaphoreGive(s_sync_sem);
+}
+
+static void host_reset_cb(int reason) {
+    xSemaphoreTake(s_sync_sem, 0); // Not synced until the next sync callback
+}
+
+static void host_task(void* param) {
+    nimble_port_run(); // Returns only after nimble_port_stop()
+    nimble_port_freertos_deinit();
+}
+
+static int gap_event_handler(struct ble_gap_event* event, void* arg) {
+    return 0; // Non-connectable, unlimited duration: no GAP events to act on
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Radio operations
+static beacon_err_t nimble_stack_stage(void* ctx, beacon_stack_stage_t stage) {
+    switch (stage) {
+    case BEACON_STAGE_CONTROLLER_INIT:
+        // Classic host code is never linked (BLE-only controller mode); this hands the
+        // controller's unused Classic memory back to the heap
+        esp_bt_controller_mem_release(ESP_BT_MODE_CLASSIC_BT);
+        // nimble_port_init() initialises and enables the BLE controller as well
+        if (nimble_port_init() != ESP_OK) return BEACON_ERR_FAIL;
+        s_port_inited = true;
+        return BEACON_OK;
+    case BEACON_STAGE_CONTROLLER_ENABLE:
+        return BEACON_OK; // Done by nimble_port_init()
+    case BEACON_STAGE_HOST_INIT:
+        if (!s_sync_sem) s_sync_sem = xSemaphoreCreateBinaryStatic(&s_sync_sem_buf);
+        ble_hs_cfg.sync_cb = host_sync_cb;
+        ble_hs_cfg.reset_cb = host_reset_cb;
+        return BEACON_OK;
+    case BEACON_STAGE_HOST_ENABLE:
+        nimble_port_freertos_init(host_task);
+        s_host_started = true;
+        return BEACON_OK;
+    case BEACON_STAGE_GAP_REGISTER:
+        // GAP calls fail until host and controller are synced
+        if (ble_hs_synced()) return BEACON_OK;
+        return xSemaphoreTake(s_sync_sem, pdMS_TO_TICKS(HOST_SYNC_TIMEOUT_MS)) == pdTRUE
+                   ? BEACON_OK : BEACON_ERR_INVALID_STATE;
+    default:
+        return BEACON_ERR_INVALID_ARG;
+    }
+}
+
+// In-process recovery (beacon_restart), called with the sink lock held
+// - nimble_port_stop() waits for the host task, which may itself be waiting for
+//   the lock to deliver a deferred completion: the lock is released for the
+//   teardown and whatever is delivered meanwhile is dropped
+// - Deferred events still queued went down with the host's event queue; they
+//   are initialised again so the next put is not mistaken for a duplicate
+static beacon_err_t nimble_stack_reset(void* ctx) {
+    s_resetting = true;
+    xSemaphoreGive(s_sink_lock);
+    if (s_host_started && nimble_port_stop() == 0) s_host_started = false;
+    if (!s_host_started && s_port_inited && nimble_port_deinit() == ESP_OK) s_port_inited = false;
+    if (s_retry_timer) esp_timer_stop(s_retry_timer); // A backoff from before the teardown
+    xSemaphoreTake(s_sink_lock, portMAX_DELAY);
+    s_resetting = false;
+
+    ble_npl_event_init(&s_data_set_evt.ev, deferred_event_cb, &s_data_set_evt);
+    ble_npl_event_init(&s_start_evt.ev, deferred_event_cb, &s_start_evt);
+    ble_npl_event_init(&s_stop_evt.ev, deferred_event_cb, &s_stop_evt);
+    ble_npl_event_init(&s_probe_evt.ev, deferred_event_cb, &s_probe_evt);
+    if (s_sync_sem) xSemaphoreTake(s_sync_sem, 0); // Not synced until the new host says so
+    return s_port_inited ? BEACON_ERR_FAIL : BEACON_OK;
+}
+
+static void nimble_register_event_sink(void* ctx, beacon_event_sink_t sink, void* arg) {
+    if (!s_sink_lock) s_sink_lock = xSemaphoreCreateMutexStatic(&s_sink_lock_buf);
+    ble_npl_event_init(&s_data_set_evt.ev, deferred_event_cb, &s_data_set_evt);
+    ble_npl_event_init(&s_start_evt.ev, deferred_event_cb, &s_start_evt);
+    ble_npl_event_init(&s_stop_evt.ev, deferred_event_cb, &s_stop_evt);
+    ble_npl_event_init(&s_probe_evt.ev, deferred_event_cb, &s_probe_evt);
+    s_sink = sink;
+    s_sink_arg = arg;
+}
+
+static beacon_err_t nimble_set_adv_data(void* ctx, const uint8_t* data, uint8_t len) {
+    // Blocks until the controller acknowledges LE Set Advertising Data
+    int rc = ble_gap_adv_set_data(data, len);
+    if (rc != 0) return to_beacon_err(rc);
+    defer(&s_data_set_evt, rc);
+    return BEACON_OK;
+}
+
+static beacon_err_t nimble_start_advertising(void* ctx, const beacon_adv_params_t* params) {
+    // BLE Advertisement Parameters Configuration
+    // - Non-connectable (ADV_NONCONN_IND), general discoverable flags come from the raw payload
+    struct ble_gap_adv_params adv_params = {};
+    adv_params.conn_mode   = BLE_GAP_CONN_MODE_NON;
+    adv_params.disc_mode   = BLE_GAP_DISC_MODE_NON; // Raw payload already carries the flags AD
+    adv_params.itvl_min    = params->interval_min;
+    adv_params.itvl_max    = params->interval_max;
+    adv_params.channel_map = params->channel_map;
+    int rc = ble_gap_adv_start(BLE_OWN_ADDR_PUBLIC, nullptr, BLE_HS_FOREVER, &adv_params,
+                               gap_event_handler, nullptr);
+    if (rc != 0) return to_beacon_err(rc);
+    defer(&s_start_evt, rc);
+    return BEACON_OK;
+}
+
+static beacon_err_t nimble_stop_advertising(void* ctx) {
+    int rc = ble_gap_adv_stop();
+    if (rc != 0) return to_beacon_err(rc);
+    defer(&s_stop_evt, rc);
+    return BEACON_OK;
+}
+
+static beacon_err_t nimble_set_tx_power(void* ctx, int8_t dbm) {
+    // Controller API, same levels as the Bluedroid build (-12 … +9 dBm in 3 dB steps)
+    int level = dbm < -12 ? 0 : (dbm + 12) / 3;
+    if (level > ESP_PWR_LVL_P9) level = ESP_PWR_LVL_P9;
+    return esp_ble_tx_power_set(ESP_BLE_PWR_TYPE_ADV, static_cast<esp_power_level_t>(level)) == ESP_OK
+               ? BEACON_OK : BEACON_ERR_FAIL;
+}
+
+static beacon_err_t nimble_probe(void* ctx) {
+    // Blocks until the controller acknowledges LE Set Host Channel
+    // Classification (every data channel usable: the default, connections only)
+    static const uint8_t channels[5] = {0xFF, 0xFF, 0xFF, 0xFF, 0x1F};
+    int rc = ble_hs_hci_set_chan_class(channels);
+    if (rc != 0) return to_beacon_err(rc);
+    defer(&s_probe_evt, rc);
+    return BEACON_OK;
+}
+
+static uint64_t nimble_now_us(void* ctx) {
+    return static_cast<uint64_t>(esp_timer_get_time());
+}
+
+static void nimble_schedule(void* ctx, uint64_t delay_us) {
+    if (!s_retry_timer) {
+        esp_timer_create_args_t args = {};
+        args.callback = retry_timer_cb;
+        args.dispatch_method = ESP_TIMER_TASK;
+        args.name = "beacon_retry";
+        if (esp_timer_create(&args, &s_retry_timer) != ESP_OK) return;
+    }
+    esp_timer_stop(s_retry_timer); // Re-arming replaces the pending expiry
+    esp_timer_start_once(s_retry_timer, delay_us);
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Application calls into the core, serialised with event delivery
+// - No lock before beacon_start(): app_main is the only caller then
+// - During a stack reset the lock is free but the core is mid-restart: callers
+//   wait until the restart holds it again and has run the stack stages
+void beacon_backend_esp_lock(void) {
+    if (!s_sink_lock) return;
+    while (1) {
+        xSemaphoreTake(s_sink_lock, portMAX_DELAY);
+        if (!s_resetting) return;
+        xSemaphoreGive(s_sink_lock);
+        vTaskDelay(1);
+    }
+}
+
+void beacon_backend_esp_unlock(void) {
+    if (s_sink_lock) xSemaphoreGive(s_sink_lock);
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Backend instance
+static const beacon_backend_t s_backend = {
+    .ctx                 = nullptr,
+    .stack_stage         = nimble_stack_stage,
+    .stack_reset         = nimble_stack_reset,
+    .register_event_sink = nimble_register_event_sink,
+    .set_adv_data        = nimble_set_adv_data,
+    .start_advertising   = nimble_start_advertising,
+    .stop_advertising    = nimble_stop_advertising,
+    .set_tx_power        = nimble_set_tx_power,
+    .probe               = nimble_probe,
+    .signal_output       = beacon_signal_ledc_output,
+    .now_us              = nimble_now_us,
+    .schedule            = nimble_schedule,
+};
+
+const beacon_backend_t* beacon_backend_esp(void) {
+    return &s_backend;
+}
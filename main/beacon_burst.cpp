@@ -0,0 +1,113 @@
+/*
+COS10025 BLE-to-Web Cultural Storytelling System
+Deep-sleep burst beacon mode (see beacon_burst.h).
+- Wake-to-first-packet is measured on the RTC clock (gettimeofday keeps running
+  through deep sleep): from the scheduled timer expiry to the start-complete
+  event, so it covers ROM + bootloader + app init + stack bring-up
+- The burst ends straight from the window timer: the radio is powered down by
+  deep sleep, a GAP stop round trip would only add awake time
+*/
+
+#include "beacon_burst.h"
+
+#if CONFIG_BEACON_BURST_MODE
+#include <string.h>
+#include <sys/time.h>
+#include "esp_attr.h"
+#include "esp_log.h"
+#include "esp_sleep.h"
+#include "esp_timer.h"
+#include "beacon_energy.h"
+#include "beacon_events.h"
+
+static const char* TAG = "BEACON_BURST";
+
+// Marks a retained block written by this firmware layout
+#define BURST_RTC_MAGIC 0xB5A7C0DEu
+
+typedef struct {
+    uint32_t             magic;
+    beacon_config_t      config;
+    beacon_burst_stats_t stats;
+    int64_t              wake_at_us; // RTC time the timer wakeup was scheduled for
+} burst_rtc_t;
+
+RTC_DATA_ATTR static burst_rtc_t s_rtc;
+
+static esp_timer_handle_t s_window_timer = nullptr;
+static bool s_fast_wake = false;
+
+static int64_t rtc_now_us(void) {
+    struct timeval tv;
+    gettimeofday(&tv, nullptr);
+    return static_cast<int64_t>(tv.tv_sec) * 1000000 + tv.tv_usec;
+}
+
+bool beacon_burst_resume(beacon_config_t* config) {
+    s_fast_wake = esp_sleep_get_wakeup_cause() == ESP_SLEEP_WAKEUP_TIMER &&
+                  s_rtc.magic == BURST_RTC_MAGIC && beacon_config_is_valid(&s_rtc.config);
+    if (!s_fast_wake) {
+        memset(&s_rtc, 0, sizeof(s_rtc)); // Cold boot: counters restart
+        return false;
+    }
+    *config = s_rtc.config;
+    return true;
+}
+
+void beacon_burst_retain(const beacon_config_t* config) {
+    s_rtc.config = *config;
+    s_rtc.magic = BURST_RTC_MAGIC;
+}
+
+const beacon_burst_stats_t* beacon_burst_stats(void) {
+    return &s_rtc.stats;
+}
+
+static void burst_window_cb(void* arg) {
+    const beacon_t* beacon = static_cast<const beacon_t*>(arg);
+    beacon_burst_stats_t* stats = &s_rtc.stats;
+    stats->bursts++;
+
+    // One line per burst; the model uses the measured wake time of this unit
+    beacon_power_profile_t profile = beacon_power_profile_deep_sleep_burst();
+    double wake_us = stats->fast_wakes ? static_cast<double>(stats->wake_to_adv_sum_us) / stats->fast_wakes
+                                       : beacon_mark_elapsed_us(beacon, BEACON_MARK_ADV_STARTED);
+    beacon_energy_estimate_t e = beacon_energy_estimate_burst(
+        &profile, &beacon->adv_params, beacon_adv_len(beacon), CONFIG_BEACON_BURST_EVENTS,
+        CONFIG_BEACON_BURST_SLEEP_MS / 1000.0, wake_us, 10000.0);
+    ESP_LOGI(TAG, "burst %lu: wake→adv %llu us (mean %.0f us over %lu), model %.2f mA, %.1f uC/event",
+             (unsigned long)stats->bursts, (unsigned long long)stats->wake_to_adv_last_us, wake_us,
+             (unsigned long)stats->fast_wakes, e.avg_current_ma, e.charge_uc_per_event);
+
+    beacon_burst_sleep(CONFIG_BEACON_BURST_SLEEP_MS * 1000ULL);
+}
+
+void beacon_burst_sleep(uint64_t sleep_us) {
+    // Schedule the next wake on the RTC clock and power down
+    s_rtc.wake_at_us = rtc_now_us() + static_cast<int64_t>(sleep_us);
+    beacon_event(BEACON_EV_SLEEP, 0, static_cast<uint32_t>(sleep_us / 1000));
+    esp_sleep_enable_timer_wakeup(sleep_us);
+    esp_deep_sleep_start();
+}
+
+void beacon_burst_on_state(beacon_t* beacon, beacon_state_t state) {
+    if (state != BEACON_STATE_ADVERTISING || s_window_timer) return;
+
+    // Step 1: Wake-to-first-packet (fast wakes only; a cold boot has no scheduled expiry)
+    if (s_fast_wake) {
+        int64_t elapsed = rtc_now_us() - s_rtc.wake_at_us;
+        s_rtc.stats.wake_to_adv_last_us = elapsed > 0 ? static_cast<uint64_t>(elapsed) : 0;
+        s_rtc.stats.wake_to_adv_sum_us += s_rtc.stats.wake_to_adv_last_us;
+        s_rtc.stats.fast_wakes++;
+    }
+
+    // Step 2: Keep advertising long enough for CONFIG_BEACON_BURST_EVENTS events
+    esp_timer_create_args_t args = {};
+    args.callback = burst_window_cb;
+    args.arg = beacon;
+    args.dispatch_method = ESP_TIMER_TASK;
+    args.name = "beacon_burst";
+    if (esp_timer_create(&args, &s_window_timer) != ESP_OK) return;
+    esp_timer_start_once(s_window_timer, beacon_burst_window_us(&beacon->adv_params, CONFIG_BEACON_BURST_EVENTS));
+}
+#endif
@@ -0,0 +1,39 @@
+/*
+COS10025 BLE-to-Web Cultural Storytelling System
+Deep-sleep burst beacon mode (CONFIG_BEACON_BURST_MODE).
+- Wake on the RTC timer, advertise CONFIG_BEACON_BURST_EVENTS events, deep sleep
+  for CONFIG_BEACON_BURST_SLEEP_MS
+- Configuration and counters are retained in RTC slow memory, so a timer wake
+  skips the NVS config read and the startup report (fast wake path)
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include "beacon_core.h"
+#include "beacon_config.h"
+
+// Counters kept across deep sleep (RTC slow memory)
+typedef struct {
+    uint32_t bursts;               // Completed bursts since the last cold boot
+    uint32_t fast_wakes;           // Wakes that took the fast path
+    uint64_t wake_to_adv_last_us;  // RTC timer expiry → advertising enabled, last burst
+    uint64_t wake_to_adv_sum_us;   // Sum over `fast_wakes`, for the mean
+} beacon_burst_stats_t;
+
+// Call first in app_main. Returns true on an RTC timer wake with a valid
+// retained configuration, copied into `config`; false on any other reset.
+bool beacon_burst_resume(beacon_config_t* config);
+
+// Retain `config` for the following wakes (cold boot path, after loading it)
+void beacon_burst_retain(const beacon_config_t* config);
+
+// Drive the burst from the beacon state callback: once advertising is up, arm
+// the burst window timer; when it expires, enter deep sleep
+void beacon_burst_on_state(beacon_t* beacon, beacon_state_t state);
+
+// Deep sleep for `sleep_us` without a burst (e.g. the adaptive policy has
+// advertising off); the following wake takes the fast path as usual
+void beacon_burst_sleep(uint64_t sleep_us);
+
+const beacon_burst_stats_t* beacon_burst_stats(void);
@@ -0,0 +1,57 @@
+/*
+COS10025 BLE-to-Web Cultural Storytelling System
+Wall clock (see beacon_clock.h).
+*/
+
+#include "beacon_clock.h"
+
+#include <stdlib.h>
+#include <sys/time.h>
+#include "esp_log.h"
+#include "beacon_console.h"
+#include "beacon_events.h"
+
+static const char* TAG = "BEACON_CLOCK";
+
+#define MAX_LISTENERS 4
+
+static beacon_clock_set_cb_t s_on_set[MAX_LISTENERS];
+static int s_listeners = 0;
+
+static void clock_command(const char* arg) {
+    char* end = nullptr;
+    unsigned long epoch = strtoul(arg, &end, 10);
+    if (end == arg || *end != '\0' || epoch < BEACON_CLOCK_MIN_EPOCH) {
+        ESP_LOGW(TAG, "rejected clock \"%s\"", arg);
+        return;
+    }
+    beacon_clock_set(static_cast<uint32_t>(epoch));
+    beacon_event(BEACON_EV_CLOCK_SET, 0, static_cast<uint32_t>(epoch));
+    ESP_LOGI(TAG, "clock set to %lu, local minute %ld", epoch, (long)beacon_clock_minute_of_day());
+    for (int i = 0; i < s_listeners; i++) s_on_set[i]();
+}
+
+void beacon_clock_console_init(beacon_clock_set_cb_t on_set) {
+    if (s_listeners == 0) beacon_console_register('T', true, clock_command);
+    if (on_set && s_listeners < MAX_LISTENERS) s_on_set[s_listeners++] = on_set;
+}
+
+bool beacon_clock_valid(void) {
+    struct timeval tv;
+    gettimeofday(&tv, nullptr);
+    return tv.tv_sec >= static_cast<time_t>(BEACON_CLOCK_MIN_EPOCH);
+}
+
+void beacon_clock_set(uint32_t epoch_s) {
+    struct timeval tv = {};
+    tv.tv_sec = static_cast<time_t>(epoch_s);
+    settimeofday(&tv, nullptr);
+}
+
+int32_t beacon_clock_minute_of_day(void) {
+    struct timeval tv;
+    gettimeofday(&tv, nullptr);
+    if (tv.tv_sec < static_cast<time_t>(BEACON_CLOCK_MIN_EPOCH)) return -1;
+    int64_t local_min = static_cast<int64_t>(tv.tv_sec) / 60 + CONFIG_BEACON_CLOCK_UTC_OFFSET_MIN;
+    return static_cast<int32_t>(((local_min % 1440) + 1440) % 1440);
+}
@@ -0,0 +1,26 @@
+/*
+COS10025 BLE-to-Web Cultural Storytelling System
+Wall clock for schedule-driven beacon behaviour.
+- ESP-IDF system time (gettimeofday) runs on the RTC timer and survives deep
+  sleep and software resets; it is lost on power-on reset
+- Set over the console UART ("T<unix seconds>", tools/beacon_clock.py)
+- Anything before BEACON_CLOCK_MIN_EPOCH counts as "not set"; schedule rules
+  must fail open in that case
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+#define BEACON_CLOCK_MIN_EPOCH 1704067200u // 2024-01-01 00:00 UTC
+
+typedef void (*beacon_clock_set_cb_t)(void);
+
+// Register the 'T' console command (first call) and add `on_set`, which runs
+// after every accepted set; several modules may each add one listener
+void beacon_clock_console_init(beacon_clock_set_cb_t on_set);
+
+bool beacon_clock_valid(void);
+void beacon_clock_set(uint32_t epoch_s);
+// Local minute of the day (CONFIG_BEACON_CLOCK_UTC_OFFSET_MIN), -1 when not set
+int32_t beacon_clock_minute_of_day(void);
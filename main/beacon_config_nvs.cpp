@@ -0,0 +1,59 @@
+/*
+COS10025 BLE-to-Web Cultural Storytelling System
+Load the beacon runtime configuration from NVS.
+- Namespace "beacon", key "cfg": one packed beacon_config_t blob
+- Key "eik": ephemeral-ID identity key (CONFIG_BEACON_EID), kept apart from the
+  config blob so the layout does not change
+- Provision with tools/beacon_nvs.py + nvs_partition_gen (see README.md)
+*/
+
+#include "beacon_config_nvs.h"
+
+#include <string.h>
+#include "nvs_flash.h"
+#include "nvs.h"
+
+esp_err_t beacon_nvs_init(void) {
+    esp_err_t ret = nvs_flash_init();
+    if (ret == ESP_ERR_NVS_NO_FREE_PAGES || ret == ESP_ERR_NVS_NEW_VERSION_FOUND) {
+        nvs_flash_erase();
+        ret = nvs_flash_init();
+    }
+    return ret;
+}
+
+beacon_config_source_t beacon_config_load_nvs(beacon_config_t* config) {
+    // Step 1: Initialise the default NVS partition (also needed by the BT controller)
+    esp_err_t ret = beacon_nvs_init();
+    if (ret != ESP_OK) return BEACON_CONFIG_SOURCE_DEFAULTS;
+
+    // Step 2: Single blob read into a scratch copy
+    nvs_handle_t handle;
+    if (nvs_open(BEACON_CONFIG_NAMESPACE, NVS_READONLY, &handle) != ESP_OK) {
+        return BEACON_CONFIG_SOURCE_DEFAULTS; // Namespace not provisioned
+    }
+    beacon_config_t stored = {};
+    size_t len = sizeof(stored);
+    ret = nvs_get_blob(handle, BEACON_CONFIG_KEY, &stored, &len);
+    nvs_close(handle);
+    if (ret == ESP_ERR_NVS_NOT_FOUND) return BEACON_CONFIG_SOURCE_DEFAULTS;
+
+    // Step 3: Accept only a complete, valid blob of the current layout
+    if (ret != ESP_OK || len != sizeof(stored) || !beacon_config_is_valid(&stored)) {
+        return BEACON_CONFIG_SOURCE_INVALID;
+    }
+    *config = stored;
+    return BEACON_CONFIG_SOURCE_NVS;
+}
+
+bool beacon_config_load_eid_key(uint8_t key[BEACON_EID_KEY_LEN]) {
+    nvs_handle_t handle;
+    if (nvs_open(BEACON_CONFIG_NAMESPACE, NVS_READONLY, &handle) != ESP_OK) return false;
+    uint8_t stored[BEACON_EID_KEY_LEN];
+    size_t len = sizeof(stored);
+    esp_err_t ret = nvs_get_blob(handle, BEACON_CONFIG_EID_KEY, stored, &len);
+    nvs_close(handle);
+    if (ret != ESP_OK || len != sizeof(stored)) return false;
+    memcpy(key, stored, sizeof(stored));
+    return true;
+}
@@ -0,0 +1,29 @@
+/*
+COS10025 BLE-to-Web Cultural Storytelling System
+Load the beacon runtime configuration from NVS (see beacon_config.h).
+*/
+
+#pragma once
+
+#include "esp_err.h"
+#include "beacon_config.h"
+#include "beacon_eid.h"
+
+// Where the active configuration came from
+typedef enum {
+    BEACON_CONFIG_SOURCE_DEFAULTS, // Nothing provisioned, compiled defaults kept
+    BEACON_CONFIG_SOURCE_NVS,      // Blob read from NVS
+    BEACON_CONFIG_SOURCE_INVALID,  // Blob present but rejected, compiled defaults kept
+} beacon_config_source_t;
+
+// Initialise the default NVS partition (erased and re-initialised if full or
+// from a newer layout). Also holds the PHY calibration data used by the BT controller.
+esp_err_t beacon_nvs_init(void);
+
+// Initialise NVS and overlay `config` (pre-filled with compiled defaults) with
+// the provisioned blob. One nvs_get_blob call; `config` is left untouched on failure.
+beacon_config_source_t beacon_config_load_nvs(beacon_config_t* config);
+
+// Ephemeral-ID identity key (CONFIG_BEACON_EID): 16-byte blob, key "eik" in the
+// same namespace. Call after beacon_config_load_nvs/beacon_nvs_init; false when absent.
+bool beacon_config_load_eid_key(uint8_t key[BEACON_EID_KEY_LEN]);
@@ -0,0 +1,78 @@
+/*
+COS10025 BLE-to-Web Cultural Storytelling System
+Console UART commands (see beacon_console.h).
+- Reader task stack and TCB are static, on the application core (beacon_tasks.h);
+  the UART driver's RX ring is the only allocation, made once at start
+*/
+
+#include "beacon_console.h"
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "driver/uart.h"
+#include "beacon_tasks.h"
+
+#define MAX_COMMANDS 8
+#define MAX_LINE     32
+#define TASK_STACK   3072
+
+typedef struct {
+    char                     cmd;
+    bool                     with_arg;
+    beacon_console_handler_t handler;
+} console_command_t;
+
+static console_command_t s_commands[MAX_COMMANDS];
+static int s_count = 0;
+static StackType_t s_task_stack[TASK_STACK];
+static StaticTask_t s_task_buf;
+
+static const console_command_t* find(char c) {
+    for (int i = 0; i < s_count; i++) {
+        if (s_commands[i].cmd == c) return &s_commands[i];
+    }
+    return nullptr;
+}
+
+static void console_task(void* arg) {
+    const console_command_t* pending = nullptr; // Command collecting its argument
+    char line[MAX_LINE];
+    int len = 0;
+    while (1) {
+        uint8_t c = 0;
+        if (uart_read_bytes(CONFIG_ESP_CONSOLE_UART_NUM, &c, 1, portMAX_DELAY) != 1) continue;
+
+        if (pending) {
+            if (c == '\r' || c == '\n') {
+                line[len] = '\0';
+                pending->handler(line);
+                pending = nullptr;
+            } else if (len < MAX_LINE - 1) {
+                line[len++] = static_cast<char>(c);
+            }
+            continue;
+        }
+
+        const console_command_t* command = find(static_cast<char>(c));
+        if (!command) continue;
+        if (command->with_arg) {
+            pending = command;
+            len = 0;
+        } else {
+            command->handler("");
+        }
+    }
+}
+
+bool beacon_console_register(char cmd, bool with_arg, beacon_console_handler_t handler) {
+    if (s_count >= MAX_COMMANDS || find(cmd)) return false;
+    s_commands[s_count++] = {cmd, with_arg, handler};
+    return true;
+}
+
+void beacon_console_start(void) {
+    if (s_count == 0) return;
+    if (uart_driver_install(CONFIG_ESP_CONSOLE_UART_NUM, 256, 0, 0, nullptr, 0) != ESP_OK) return;
+    beacon_task_create_static(console_task, "beacon_console", TASK_STACK, nullptr, BEACON_APP_PRIORITY, s_task_stack,
+                              &s_task_buf);
+}
@@ -0,0 +1,18 @@
+/*
+COS10025 BLE-to-Web Cultural Storytelling System
+Console UART commands shared by the firmware modules.
+- One reader task blocked on the console UART (no polling, no wakeups while idle)
+- Single-character commands fire on the character ('d' dump, 'r' reset);
+  commands with an argument take the rest of the line ("T1735689600")
+*/
+
+#pragma once
+
+typedef void (*beacon_console_handler_t)(const char* arg);
+
+// Register before beacon_console_start(); returns false when the table is full
+// - with_arg: collect the rest of the line and pass it as `arg` ("" otherwise)
+bool beacon_console_register(char cmd, bool with_arg, beacon_console_handler_t handler);
+
+// Install the UART driver and start the reader (no-op when nothing is registered)
+void beacon_console_start(void);
@@ -0,0 +1,128 @@
+/*
+COS10025 BLE-to-Web Cultural Storytelling System
+Rotating ephemeral artifact IDs on the ESP32 (see beacon_ephemeral.h).
+- esp_aes drives the AES accelerator directly (no software fallback); one
+  ID costs two block operations plus two key loads
+- Counter: Unix seconds once the clock is set, seconds since boot before that.
+  Setting the clock re-syncs straight away instead of at the next boundary
+*/
+
+#include "beacon_ephemeral.h"
+
+#if CONFIG_BEACON_EID
+#include <sys/time.h>
+#include "aes/esp_aes.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "beacon_backend_esp.h"
+#include "beacon_clock.h"
+#include "beacon_config_nvs.h"
+#include "beacon_eid.h"
+#include "beacon_events.h"
+
+static const char* TAG = "BEACON_EID";
+
+// Re-check delay while the beacon is in a transitional state
+#define BUSY_RETRY_US 100000ULL
+
+static beacon_eid_t s_eid;
+static beacon_t* s_beacon = nullptr;
+static esp_timer_handle_t s_timer = nullptr;
+static uint32_t s_swaps = 0;
+static uint32_t s_late = 0; // Boundaries whose ID was not precomputed (clock jumps)
+
+static void aes128_hw(const uint8_t key[16], const uint8_t in[16], uint8_t out[16]) {
+    esp_aes_context ctx;
+    esp_aes_init(&ctx);
+    esp_aes_setkey(&ctx, key, 128);
+    esp_aes_crypt_ecb(&ctx, ESP_AES_ENCRYPT, in, out);
+    esp_aes_free(&ctx);
+}
+
+// Counter and microseconds into the current second
+static uint32_t now_counter(uint32_t* frac_us) {
+    if (beacon_clock_valid()) {
+        struct timeval tv;
+        gettimeofday(&tv, nullptr);
+        *frac_us = static_cast<uint32_t>(tv.tv_usec);
+        return static_cast<uint32_t>(tv.tv_sec);
+    }
+    int64_t up = esp_timer_get_time();
+    *frac_us = static_cast<uint32_t>(up % 1000000);
+    return static_cast<uint32_t>(up / 1000000);
+}
+
+static void rotation_cb(void* arg) {
+    uint32_t frac_us = 0;
+    uint32_t counter = now_counter(&frac_us);
+
+    // Step 1: Swap in the precomputed ID (derive it now only after a clock jump)
+    const beacon_payload_t* payload = beacon_eid_payload(&s_eid, counter);
+    bool late = !payload;
+    if (late) {
+        beacon_eid_fill(&s_eid, counter);
+        payload = beacon_eid_payload(&s_eid, counter);
+        s_late++;
+    }
+    beacon_backend_esp_lock();
+    beacon_state_t state = s_beacon->state;
+    bool ready = state == BEACON_STATE_ADVERTISING || state == BEACON_STATE_STOPPED;
+    if (ready && beacon_update_payload(s_beacon, payload->bytes, payload->len) == BEACON_OK) s_swaps++;
+    beacon_backend_esp_unlock();
+    if (!ready) {
+        esp_timer_start_once(s_timer, BUSY_RETRY_US); // Mid-startup or mid-restart
+        return;
+    }
+
+    beacon_event(BEACON_EV_EID_ROTATE, late ? 1 : 0, beacon_eid_slot(counter, s_eid.rotation_exp));
+
+    // Step 2: Top up the slots ahead, then wait for the next boundary
+    beacon_eid_fill(&s_eid, counter);
+    uint64_t next_us = beacon_eid_next_rotation_s(&s_eid, counter) * 1000000ULL - frac_us;
+    esp_timer_start_once(s_timer, next_us);
+    ESP_LOGD(TAG, "slot %lu on air, %lu swaps, %lu late, %lu derived", (unsigned long)beacon_eid_slot(
+             counter, s_eid.rotation_exp), (unsigned long)s_swaps, (unsigned long)s_late, (unsigned long)s_eid.computed);
+}
+
+static void clock_set(void) {
+    if (!s_timer) return;
+    esp_timer_stop(s_timer);
+    esp_timer_start_once(s_timer, 0);
+}
+
+bool beacon_ephemeral_init(beacon_payload_t* first) {
+    uint8_t key[BEACON_EID_KEY_LEN];
+    if (!beacon_config_load_eid_key(key)) {
+        ESP_LOGW(TAG, "no identity key provisioned, advertising the plain artifact ID");
+        beacon_event(BEACON_EV_INIT_FAIL, BEACON_INIT_EID, 0);
+        return false;
+    }
+    beacon_eid_init(&s_eid, aes128_hw, key, CONFIG_BEACON_EID_ROTATION_EXP);
+
+    uint32_t frac_us = 0;
+    uint32_t counter = now_counter(&frac_us);
+    beacon_eid_fill(&s_eid, counter);
+    *first = *beacon_eid_payload(&s_eid, counter);
+    if (!beacon_clock_valid()) ESP_LOGW(TAG, "clock not set, IDs follow uptime until it is");
+    return true;
+}
+
+void beacon_ephemeral_start(beacon_t* beacon) {
+    s_beacon = beacon;
+#if !CONFIG_BEACON_BURST_MODE
+    esp_timer_create_args_t args = {};
+    args.callback = rotation_cb;
+    args.dispatch_method = ESP_TIMER_TASK;
+    args.name = "beacon_eid";
+    if (esp_timer_create(&args, &s_timer) != ESP_OK) return;
+    beacon_clock_console_init(clock_set);
+
+    uint32_t frac_us = 0;
+    uint32_t counter = now_counter(&frac_us);
+    esp_timer_start_once(s_timer, beacon_eid_next_rotation_s(&s_eid, counter) * 1000000ULL - frac_us);
+#endif
+}
+#else
+bool beacon_ephemeral_init(beacon_payload_t* first) { return false; }
+void beacon_ephemeral_start(beacon_t* beacon) {}
+#endif
@@ -0,0 +1,21 @@
+/*
+COS10025 BLE-to-Web Cultural Storytelling System
+Rotating ephemeral artifact IDs on the ESP32 (CONFIG_BEACON_EID, see beacon_eid.h).
+- Identity key from NVS ("eik", provisioned with tools/beacon_nvs.py)
+- IDs derived on the AES accelerator, BEACON_EID_AHEAD slots ahead of time
+- One esp_timer fires at each rotation boundary and swaps the precomputed
+  payload in; the next slot is derived after the swap, outside the backend lock
+*/
+
+#pragma once
+
+#include "beacon_core.h"
+#include "beacon_payload.h"
+
+// Load the key and precompute the first IDs; `first` is the payload to start with
+// - Returns false (payload untouched) when EID mode is off or no key is provisioned
+bool beacon_ephemeral_init(beacon_payload_t* first);
+
+// Swap each precomputed ID in at its rotation boundary (after beacon_start;
+// burst mode re-derives the current slot on every wake instead)
+void beacon_ephemeral_start(beacon_t* beacon);
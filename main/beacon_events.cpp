@@ -0,0 +1,85 @@
+/*
+COS10025 BLE-to-Web Cultural Storytelling System
+Event log retained across resets (see beacon_events.h).
+- 16 bytes a record in RTC slow memory; CONFIG_BEACON_EVLOG_RECORDS of them
+  (128 = 2 KB of the 8 KB)
+- The write path is one atomic add, five stores and an esp_timer read, in IRAM
+  so it stays usable while the flash cache is off
+*/
+
+#include "beacon_events.h"
+
+#if CONFIG_BEACON_EVLOG
+#include "esp_attr.h"
+#include "esp_log.h"
+#include "esp_system.h"
+#include "esp_timer.h"
+#include "beacon_console.h"
+
+static const char* TAG = "BEACON_EVLOG";
+
+#define EVLOG_MAGIC 0x45564C31u // "EVL1"
+
+static_assert((CONFIG_BEACON_EVLOG_RECORDS & (CONFIG_BEACON_EVLOG_RECORDS - 1)) == 0,
+              "CONFIG_BEACON_EVLOG_RECORDS must be a power of two");
+
+RTC_NOINIT_ATTR static uint32_t s_magic;
+RTC_NOINIT_ATTR static uint32_t s_boots;
+RTC_NOINIT_ATTR static beacon_evlog_rec_t s_recs[CONFIG_BEACON_EVLOG_RECORDS];
+
+static beacon_evlog_t s_log;
+static bool s_ready = false;
+static esp_reset_reason_t s_reason = ESP_RST_UNKNOWN;
+
+void beacon_events_init(void) {
+    // Step 1: RTC memory holds a previous log unless the chip lost power
+    s_reason = esp_reset_reason();
+    bool retained = s_magic == EVLOG_MAGIC && s_reason != ESP_RST_POWERON && s_reason != ESP_RST_BROWNOUT;
+    if (!retained) {
+        s_magic = EVLOG_MAGIC;
+        s_boots = 0;
+    }
+    beacon_evlog_attach(&s_log, s_recs, CONFIG_BEACON_EVLOG_RECORDS, retained);
+    s_ready = true;
+
+    // Step 2: Boot record
+    s_boots = s_boots + 1;
+    beacon_event(BEACON_EV_BOOT, static_cast<uint16_t>(s_reason), s_boots);
+}
+
+void IRAM_ATTR beacon_event(beacon_event_id_t id, uint16_t a, uint32_t b) {
+    if (!s_ready) return;
+    uint32_t stamp = static_cast<uint32_t>(esp_timer_get_time() / BEACON_EVLOG_STAMP_US);
+    beacon_evlog_write(&s_log, stamp, static_cast<uint16_t>(id), a, b);
+}
+
+static void dump_command(const char* arg) {
+    beacon_events_dump(stdout);
+}
+
+void beacon_events_start(void) {
+    beacon_console_register('e', false, dump_command);
+    switch (s_reason) {
+    case ESP_RST_PANIC:
+    case ESP_RST_INT_WDT:
+    case ESP_RST_TASK_WDT:
+    case ESP_RST_WDT:
+        ESP_LOGW(TAG, "abnormal reset (%d), event log follows (tools/evlog_decode.py)", s_reason);
+        beacon_events_dump(stdout);
+        break;
+    default:
+        break;
+    }
+}
+
+void beacon_events_dump(FILE* out) {
+    if (!s_ready) return;
+    beacon_evlog_dump(&s_log, out);
+    fflush(out);
+}
+#else
+void beacon_events_init(void) {}
+void beacon_event(beacon_event_id_t id, uint16_t a, uint32_t b) {}
+void beacon_events_start(void) {}
+void beacon_events_dump(FILE* out) {}
+#endif
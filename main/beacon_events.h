@@ -0,0 +1,29 @@
+/*
+COS10025 BLE-to-Web Cultural Storytelling System
+Event log retained across resets (CONFIG_BEACON_EVLOG).
+- The beacon_evlog.h ring lives in RTC slow memory (RTC_NOINIT): it survives
+  software resets, panics, watchdog resets and deep sleep, and is cleared on
+  power-on and brown-out
+- Every boot appends a boot record with the reset reason; after a panic or
+  watchdog reset the log is dumped once at start-up
+- Send 'e' on the console to dump it; decode the capture on the host with
+  tools/evlog_decode.py
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+#include "beacon_evlog.h"
+
+// Attach the retained ring and append the boot record (no-op unless CONFIG_BEACON_EVLOG)
+// - Call first in app_main
+void beacon_events_init(void);
+
+// Append one record (a few dozen cycles, no locks, any context)
+void beacon_event(beacon_event_id_t id, uint16_t a, uint32_t b);
+
+// Register the 'e' dump command; dumps straight away after an abnormal reset
+void beacon_events_start(void);
+
+void beacon_events_dump(FILE* out);
@@ -0,0 +1,138 @@
+/*
+COS10025 BLE-to-Web Cultural Storytelling System
+Heap checks for unattended units (see beacon_heap.h).
+- Standalone heap tracing into a static record buffer, HEAP_TRACE_ALL mode so
+  transient allocations (allocated and freed inside the window) count as well
+- Both timers are created by beacon_heap_init(), before anything is traced;
+  esp_timer has no static creation API
+*/
+
+#include "beacon_heap.h"
+
+#if CONFIG_BEACON_HEAP_TRACE || CONFIG_BEACON_HEAP_SOAK_PERIOD_S > 0
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "esp_system.h"
+#include "esp_timer.h"
+#include "beacon_backend_esp.h"
+#include "beacon_events.h"
+#if CONFIG_BEACON_HEAP_TRACE
+#include "esp_heap_trace.h"
+#endif
+
+static const char* TAG = "BEACON_HEAP";
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Steady-state trace
+// ─────────────────────────────────────────────────────────────────────────────
+#if CONFIG_BEACON_HEAP_TRACE
+static heap_trace_record_t s_records[CONFIG_BEACON_HEAP_TRACE_RECORDS];
+static esp_timer_handle_t s_trace_timer = nullptr;
+static bool s_advertising = false;
+static bool s_started_up = false;
+static bool s_tracing = false;
+
+static void trace_begin(void) {
+    if (s_tracing || !s_advertising || !s_started_up || !s_trace_timer) return;
+    if (heap_trace_start(HEAP_TRACE_ALL) != ESP_OK) return;
+    s_tracing = true;
+    esp_timer_start_once(s_trace_timer, CONFIG_BEACON_HEAP_TRACE_S * 1000000ULL);
+}
+
+static void trace_end_cb(void* arg) {
+    heap_trace_stop();
+
+    // Step 1: Allocations made in the window, and the ones still held at the end
+    heap_trace_summary_t summary = {};
+    heap_trace_summary(&summary);
+    uint32_t held = 0;
+    for (size_t i = 0; i < summary.count; i++) {
+        heap_trace_record_t rec;
+        if (heap_trace_get(i, &rec) == ESP_OK && rec.address && !rec.freed) held++;
+    }
+
+    // Step 2: Verdict, then the offenders with their callers
+    // - Parsed by tools/heap_soak.py
+    ESP_LOGI(TAG, "heap trace: %lu s of advertising, %lu allocations, %lu frees, %lu still held%s",
+             (unsigned long)CONFIG_BEACON_HEAP_TRACE_S, (unsigned long)summary.total_allocations,
+             (unsigned long)summary.total_frees, (unsigned long)held,
+             summary.has_overflowed ? " (record buffer full)" : "");
+    beacon_event(BEACON_EV_HEAP_TRACE, static_cast<uint16_t>(summary.total_allocations), held);
+    if (summary.total_allocations == 0) {
+        ESP_LOGI(TAG, "heap trace: PASS");
+        return;
+    }
+    ESP_LOGW(TAG, "heap trace: FAIL");
+    heap_trace_dump();
+}
+
+static void trace_init(void) {
+    if (heap_trace_init_standalone(s_records, CONFIG_BEACON_HEAP_TRACE_RECORDS) != ESP_OK) return;
+    esp_timer_create_args_t args = {};
+    args.callback = trace_end_cb;
+    args.dispatch_method = ESP_TIMER_TASK;
+    args.name = "beacon_heap_trace";
+    if (esp_timer_create(&args, &s_trace_timer) != ESP_OK) s_trace_timer = nullptr;
+}
+#endif
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Soak report
+// ─────────────────────────────────────────────────────────────────────────────
+#if CONFIG_BEACON_HEAP_SOAK_PERIOD_S > 0
+static void soak_report_cb(void* arg) {
+    multi_heap_info_t info = {};
+    heap_caps_get_info(&info, MALLOC_CAP_8BIT);
+    // Fragmentation: share of the free heap that the largest block cannot serve
+    double frag = info.total_free_bytes
+        ? 100.0 * (1.0 - static_cast<double>(info.largest_free_block) / info.total_free_bytes)
+        : 0.0;
+    // Parsed by tools/heap_soak.py
+    ESP_LOGI(TAG, "heap soak: uptime %llu s, free %lu, min free %lu, largest block %lu, free blocks %lu, frag %.1f%%",
+             (unsigned long long)(esp_timer_get_time() / 1000000), (unsigned long)info.total_free_bytes,
+             (unsigned long)esp_get_minimum_free_heap_size(), (unsigned long)info.largest_free_block,
+             (unsigned long)info.free_blocks, frag);
+}
+
+static void soak_init(void) {
+    esp_timer_create_args_t args = {};
+    args.callback = soak_report_cb;
+    args.dispatch_method = ESP_TIMER_TASK;
+    args.name = "beacon_heap_soak";
+    args.skip_unhandled_events = true;
+    esp_timer_handle_t timer;
+    if (esp_timer_create(&args, &timer) != ESP_OK) return;
+    esp_timer_start_periodic(timer, CONFIG_BEACON_HEAP_SOAK_PERIOD_S * 1000000ULL);
+}
+#endif
+
+void beacon_heap_init(void) {
+#if CONFIG_BEACON_HEAP_TRACE
+    trace_init();
+#endif
+#if CONFIG_BEACON_HEAP_SOAK_PERIOD_S > 0
+    soak_init();
+#endif
+}
+
+void beacon_heap_on_state(beacon_state_t state) {
+#if CONFIG_BEACON_HEAP_TRACE
+    if (state != BEACON_STATE_ADVERTISING) return;
+    s_advertising = true;
+    trace_begin();
+#endif
+}
+
+void beacon_heap_start(void) {
+#if CONFIG_BEACON_HEAP_TRACE
+    beacon_backend_esp_lock();
+    s_started_up = true;
+    trace_begin();
+    beacon_backend_esp_unlock();
+#endif
+}
+#else
+void beacon_heap_init(void) {}
+void beacon_heap_on_state(beacon_state_t state) {}
+void beacon_heap_start(void) {}
+#endif
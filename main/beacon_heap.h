@@ -0,0 +1,28 @@
+/*
+COS10025 BLE-to-Web Cultural Storytelling System
+Heap checks for unattended units.
+- Steady-state trace (CONFIG_BEACON_HEAP_TRACE): every allocation made once
+  advertising is up and app_main has finished starting things is recorded for
+  CONFIG_BEACON_HEAP_TRACE_S; the result is logged as PASS (none) or FAIL with
+  the trace dump
+- Soak report (CONFIG_BEACON_HEAP_SOAK_PERIOD_S): free heap, minimum free
+  heap, largest free block and fragmentation, parsed by tools/heap_soak.py
+Application tasks, queues and buffers are static; the only heap users after
+start-up are the Bluetooth host and the IDF drivers, which is what the trace
+shows.
+*/
+
+#pragma once
+
+#include "beacon_core.h"
+
+// Create the trace/soak timers (no-op unless either option is enabled)
+// - Call before beacon_start(), so the timers are not the allocations traced
+void beacon_heap_init(void);
+
+// Beacon state change, from the beacon state callback (GAP event lock held)
+void beacon_heap_on_state(beacon_state_t state);
+
+// Start-up finished: call at the end of app_main; the trace begins once this
+// has been called and the beacon is advertising, whichever comes last
+void beacon_heap_start(void);
@@ -0,0 +1,222 @@
+/*
+COS10025 BLE-to-Web Cultural Storytelling System
+On-device timing instrumentation (see beacon_instr.h).
+- Bluedroid reports no per-event callback, so on the ESP32 the radio schedule
+  is observed indirectly: a periodic esp_timer at interval_min stands in for
+  the advertising events and shows what stalls the CPU side (flash writes,
+  BT host tasks, application tasks); the probe tasks show the same per core
+- Every histogram has exactly one writer (lock-free): the esp_timer task owns
+  the timer gap histogram, probe task N owns slot N of the latency set
+- Optional synthetic load on the application core (CONFIG_BEACON_INSTR_LOAD_PERCENT)
+  to compare task layouts on the board, next to host/bench_layout
+*/
+
+#include "beacon_instr.h"
+
+#if CONFIG_BEACON_INSTRUMENTATION
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_rom_sys.h"
+#include "esp_timer.h"
+#include "beacon_console.h"
+#include "beacon_stats.h"
+#include "beacon_tasks.h"
+
+// Wake-up latency histogram: 0–8 ms in 0.5 ms buckets
+#define LATENCY_BUCKET_US 500
+
+// Tasks listed in the dump (IDF + BT host + beacon tasks fit comfortably)
+#define MAX_TASKS 32
+
+#define PROBE_STACK 2048
+
+// Synthetic load: busy share of every period, the first part in a critical section
+#define LOAD_PERIOD_MS 10
+#define LOAD_STACK     2048
+
+static const beacon_t* s_beacon = nullptr;
+static esp_timer_handle_t s_probe_timer = nullptr;
+static TaskHandle_t s_probe_tasks[BEACON_STATS_MAX_CORES];
+static StackType_t s_probe_stacks[BEACON_STATS_MAX_CORES][PROBE_STACK];
+static StaticTask_t s_probe_task_bufs[BEACON_STATS_MAX_CORES];
+#if CONFIG_BEACON_INSTR_LOAD_PERCENT > 0
+static StackType_t s_load_stack[LOAD_STACK];
+static StaticTask_t s_load_task_buf;
+static portMUX_TYPE s_load_mux = portMUX_INITIALIZER_UNLOCKED;
+#endif
+
+static beacon_hist_t s_timer_gap;        // Writer: esp_timer task
+static beacon_hist_set_t s_wake_latency; // Writer: probe task on each core
+static int64_t s_last_tick_us = 0;
+
+// Reset requests: a writer reinitialises its slot when its generation is stale
+static volatile uint32_t s_reset_gen = 0;
+static uint32_t s_timer_gen = 0;
+static uint32_t s_core_gen[BEACON_STATS_MAX_CORES];
+
+// Previous run-time counters, for CPU share since the last dump
+static TaskStatus_t s_tasks[MAX_TASKS];
+static uint32_t s_prev_runtime[MAX_TASKS];
+static UBaseType_t s_prev_number[MAX_TASKS];
+static uint32_t s_prev_total = 0;
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Schedule probe
+static void probe_timer_cb(void* arg) {
+    int64_t now = esp_timer_get_time();
+    if (s_timer_gen != s_reset_gen) {
+        s_timer_gen = s_reset_gen;
+        beacon_hist_init(&s_timer_gap, s_timer_gap.origin_us, s_timer_gap.bucket_us);
+        s_last_tick_us = 0;
+    }
+    if (s_last_tick_us) beacon_hist_add(&s_timer_gap, static_cast<uint32_t>(now - s_last_tick_us));
+    s_last_tick_us = now;
+
+    // Timestamp travels in the notification value (32-bit µs, wraps safely)
+    for (int c = 0; c < BEACON_STATS_MAX_CORES; c++) {
+        if (s_probe_tasks[c]) xTaskNotify(s_probe_tasks[c], static_cast<uint32_t>(now), eSetValueWithOverwrite);
+    }
+}
+
+static void probe_task(void* arg) {
+    int core = static_cast<int>(reinterpret_cast<intptr_t>(arg));
+    beacon_hist_t* hist = &s_wake_latency.cores[core];
+    while (1) {
+        uint32_t tick_us = 0;
+        xTaskNotifyWait(0, 0, &tick_us, portMAX_DELAY);
+        uint32_t latency = static_cast<uint32_t>(esp_timer_get_time()) - tick_us;
+        if (s_core_gen[core] != s_reset_gen) {
+            s_core_gen[core] = s_reset_gen;
+            beacon_hist_init(hist, hist->origin_us, hist->bucket_us);
+        }
+        beacon_hist_add(hist, latency);
+    }
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Synthetic application load
+#if CONFIG_BEACON_INSTR_LOAD_PERCENT > 0
+static void load_task(void* arg) {
+    const uint32_t busy_us = LOAD_PERIOD_MS * 10u * CONFIG_BEACON_INSTR_LOAD_PERCENT;
+    const uint32_t crit_us = CONFIG_BEACON_INSTR_LOAD_CRIT_US < busy_us ? CONFIG_BEACON_INSTR_LOAD_CRIT_US : busy_us;
+    TickType_t wake = xTaskGetTickCount();
+    while (1) {
+        portENTER_CRITICAL(&s_load_mux);
+        esp_rom_delay_us(crit_us);
+        portEXIT_CRITICAL(&s_load_mux);
+        esp_rom_delay_us(busy_us - crit_us);
+        xTaskDelayUntil(&wake, pdMS_TO_TICKS(LOAD_PERIOD_MS));
+    }
+}
+#endif
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Task table
+static void dump_tasks(FILE* out) {
+    uint32_t total = 0;
+    UBaseType_t count = uxTaskGetSystemState(s_tasks, MAX_TASKS, &total);
+    uint32_t window = total - s_prev_total;
+
+    fprintf(out, "%-16s %4s %4s %7s %10s\n", "task", "core", "prio", "cpu %", "stack free");
+    for (UBaseType_t i = 0; i < count; i++) {
+        const TaskStatus_t* t = &s_tasks[i];
+        uint32_t prev = 0;
+        for (int k = 0; k < MAX_TASKS; k++) {
+            if (s_prev_number[k] == t->xTaskNumber) prev = s_prev_runtime[k];
+        }
+        // Task counters are CPU time, the total is wall time: capacity is window x cores
+        double cpu = window ? 100.0 * (t->ulRunTimeCounter - prev) / (window * portNUM_PROCESSORS) : 0.0;
+        int core = t->xCoreID == tskNO_AFFINITY ? -1 : static_cast<int>(t->xCoreID);
+        fprintf(out, "%-16s %4d %4u %7.2f %10lu\n", t->pcTaskName, core, (unsigned)t->uxCurrentPriority,
+                cpu, (unsigned long)t->usStackHighWaterMark);
+    }
+
+    // Core load: what the idle task of each core did not get
+    // - Idle tasks are "IDLE0"/"IDLE1" on dual core, "IDLE" on unicore builds
+    for (int c = 0; c < portNUM_PROCESSORS; c++) {
+        for (UBaseType_t i = 0; i < count; i++) {
+            if (strncmp(s_tasks[i].pcTaskName, "IDLE", 4) != 0 || s_tasks[i].xCoreID != c) continue;
+            uint32_t prev = 0;
+            for (int k = 0; k < MAX_TASKS; k++) {
+                if (s_prev_number[k] == s_tasks[i].xTaskNumber) prev = s_prev_runtime[k];
+            }
+            double idle_pct = window ? 100.0 * (s_tasks[i].ulRunTimeCounter - prev) / window : 100.0;
+            fprintf(out, "core %d load %6.2f %%\n", c, 100.0 - idle_pct);
+        }
+    }
+
+    memset(s_prev_number, 0, sizeof(s_prev_number));
+    for (UBaseType_t i = 0; i < count; i++) {
+        s_prev_number[i] = s_tasks[i].xTaskNumber;
+        s_prev_runtime[i] = s_tasks[i].ulRunTimeCounter;
+    }
+    s_prev_total = total;
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Console commands
+static void dump_command(const char* arg) {
+    beacon_instr_dump(stdout);
+}
+
+static void reset_command(const char* arg) {
+    beacon_instr_reset();
+}
+
+void beacon_instr_start(const beacon_t* beacon) {
+    s_beacon = beacon;
+    uint32_t period_us = beacon->adv_params.interval_min * 625u;
+    beacon_hist_init_adv_gap(&s_timer_gap, beacon->adv_params.interval_min, beacon->adv_params.interval_max);
+    beacon_hist_set_init(&s_wake_latency, 0, LATENCY_BUCKET_US);
+
+    // Step 1: One probe task per core, at the priority an application task would use
+    for (int c = 0; c < portNUM_PROCESSORS && c < BEACON_STATS_MAX_CORES; c++) {
+        s_probe_tasks[c] = xTaskCreateStaticPinnedToCore(
+            probe_task, "beacon_probe", PROBE_STACK, reinterpret_cast<void*>(static_cast<intptr_t>(c)),
+            CONFIG_BEACON_INSTR_PROBE_PRIORITY, s_probe_stacks[c], &s_probe_task_bufs[c], c);
+    }
+
+    // Step 2: Synthetic load in the configured task layout
+#if CONFIG_BEACON_INSTR_LOAD_PERCENT > 0
+    beacon_task_create_static(load_task, "beacon_load", LOAD_STACK, nullptr, BEACON_APP_PRIORITY, s_load_stack,
+                              &s_load_task_buf);
+#endif
+
+    // Step 3: Periodic probe at the advertising interval
+    esp_timer_create_args_t args = {};
+    args.callback = probe_timer_cb;
+    args.dispatch_method = ESP_TIMER_TASK;
+    args.name = "beacon_probe";
+    if (esp_timer_create(&args, &s_probe_timer) == ESP_OK) esp_timer_start_periodic(s_probe_timer, period_us);
+
+    // Step 4: Dump/reset commands (reader started by beacon_console_start)
+    beacon_console_register('d', false, dump_command);
+    beacon_console_register('r', false, reset_command);
+}
+
+void beacon_instr_dump(FILE* out) {
+    fprintf(out, "=== beacon instrumentation (t=%lld us) ===\n", (long long)esp_timer_get_time());
+    if (s_beacon) {
+        beacon_hist_print(&s_beacon->adv_gap_hist, "advertising event gap", out);
+        beacon_swap_print(s_beacon, out);
+        beacon_hist_print(&s_beacon->swap.latency, "payload swap latency", out);
+    }
+    beacon_hist_print(&s_timer_gap, "schedule probe gap", out);
+    for (int c = 0; c < BEACON_STATS_MAX_CORES; c++) {
+        char label[32];
+        snprintf(label, sizeof(label), "probe wake latency core %d", c);
+        beacon_hist_print(&s_wake_latency.cores[c], label, out);
+    }
+    dump_tasks(out);
+    fflush(out);
+}
+
+void beacon_instr_reset(void) {
+    s_reset_gen = s_reset_gen + 1;
+}
+#else
+void beacon_instr_start(const beacon_t* beacon) {}
+void beacon_instr_dump(FILE* out) {}
+void beacon_instr_reset(void) {}
+#endif
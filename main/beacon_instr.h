@@ -0,0 +1,24 @@
+/*
+COS10025 BLE-to-Web Cultural Storytelling System
+On-device timing instrumentation (CONFIG_BEACON_INSTRUMENTATION).
+- Schedule probe: esp_timer at the advertising interval, histogram of its gaps
+  and of the wake-up latency of one probe task pinned to each core
+- Advertising event gaps from the beacon core (backends that report them)
+- Per-task CPU time and stack high-water marks
+Dumped over the console UART on demand: send 'd' to dump, 'r' to reset
+(commands served by beacon_console_start()).
+*/
+
+#pragma once
+
+#include <stdio.h>
+#include "beacon_core.h"
+
+// Start the probes and register the console commands (no-op unless CONFIG_BEACON_INSTRUMENTATION)
+void beacon_instr_start(const beacon_t* beacon);
+
+// Print every histogram and the task table to `out`
+void beacon_instr_dump(FILE* out);
+
+// Restart all histograms; each writer clears its own slot on its next sample
+void beacon_instr_reset(void);
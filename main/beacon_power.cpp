@@ -0,0 +1,76 @@
+/*
+COS10025 BLE-to-Web Cultural Storytelling System
+Power management for the beacon firmware.
+- CONFIG_BEACON_LOW_POWER: esp_pm DFS between the configured frequencies and
+  automatic light sleep; the controller keeps the advertising schedule in
+  modem sleep and wakes the CPU only around its own events
+- Power report: modelled average current / charge per advertising event /
+  battery life (beacon_energy.h), plus the measured time per power mode when
+  CONFIG_PM_PROFILING is enabled
+*/
+
+#include "beacon_power.h"
+
+#include <stdio.h>
+#include "esp_log.h"
+#include "esp_pm.h"
+#include "esp_timer.h"
+#include "beacon_energy.h"
+
+[[maybe_unused]] static const char* TAG = "BEACON_PWR";
+
+// Power bank capacity used to quote battery life in the report
+#define REPORT_BATTERY_MAH 10000.0
+
+
+esp_err_t beacon_power_init(void) {
+#if CONFIG_BEACON_LOW_POWER
+    esp_pm_config_t pm_config = {};
+    pm_config.max_freq_mhz = CONFIG_BEACON_PM_MAX_CPU_FREQ_MHZ;
+    pm_config.min_freq_mhz = CONFIG_BEACON_PM_MIN_CPU_FREQ_MHZ;
+    pm_config.light_sleep_enable = true;
+    esp_err_t ret = esp_pm_configure(&pm_config);
+    if (ret != ESP_OK) ESP_LOGW(TAG, "esp_pm_configure failed: %s", esp_err_to_name(ret));
+    return ret;
+#else
+    return ESP_OK;
+#endif
+}
+
+#if CONFIG_BEACON_POWER_REPORT_PERIOD_S > 0
+static const beacon_t* s_report_beacon = nullptr;
+static double s_extra_wakeups_per_s = 0;
+
+static void power_report_cb(void* arg) {
+#if CONFIG_BEACON_LOW_POWER
+    beacon_power_profile_t profile = beacon_power_profile_light_sleep();
+#else
+    beacon_power_profile_t profile = beacon_power_profile_always_on();
+#endif
+    const beacon_t* beacon = s_report_beacon;
+    beacon_energy_estimate_t e = beacon_energy_estimate(&profile, &beacon->adv_params, beacon_adv_len(beacon),
+                                                        s_extra_wakeups_per_s, REPORT_BATTERY_MAH);
+    ESP_LOGI(TAG, "%s: avg %.2f mA, %.1f uC / %.1f uJ per advertising event, %.0f h on %.0f mAh",
+             profile.name, e.avg_current_ma, e.charge_uc_per_event, e.energy_uj_per_event,
+             e.battery_hours, REPORT_BATTERY_MAH);
+#if CONFIG_PM_PROFILING
+    esp_pm_dump_locks(stdout); // Measured time in each power mode since boot
+#endif
+}
+#endif
+
+void beacon_power_start_report(const beacon_t* beacon, double extra_wakeups_per_s) {
+#if CONFIG_BEACON_POWER_REPORT_PERIOD_S > 0
+    s_report_beacon = beacon;
+    s_extra_wakeups_per_s = extra_wakeups_per_s;
+
+    esp_timer_create_args_t args = {};
+    args.callback = power_report_cb;
+    args.dispatch_method = ESP_TIMER_TASK;
+    args.name = "beacon_power";
+    args.skip_unhandled_events = true; // Do not replay missed periods after long sleeps
+    esp_timer_handle_t timer;
+    if (esp_timer_create(&args, &timer) != ESP_OK) return;
+    esp_timer_start_periodic(timer, CONFIG_BEACON_POWER_REPORT_PERIOD_S * 1000000ULL);
+#endif
+}
@@ -0,0 +1,17 @@
+/*
+COS10025 BLE-to-Web Cultural Storytelling System
+Power management for the beacon firmware (CONFIG_BEACON_LOW_POWER).
+*/
+
+#pragma once
+
+#include "esp_err.h"
+#include "beacon_core.h"
+
+// Configure DFS + automatic light sleep (no-op unless CONFIG_BEACON_LOW_POWER)
+// - Call before the BLE stack is brought up
+esp_err_t beacon_power_init(void);
+
+// Start the periodic power report for `beacon` (CONFIG_BEACON_POWER_REPORT_PERIOD_S)
+// - extra_wakeups_per_s: application wakeups besides advertising
+void beacon_power_start_report(const beacon_t* beacon, double extra_wakeups_per_s);
@@ -0,0 +1,88 @@
+/*
+COS10025 BLE-to-Web Cultural Storytelling System
+LED/buzzer signalling on GPIO23 for both ESP32 backends.
+- LEDC low-speed channel clocked from RC_FAST, so the pattern keeps running
+  in light sleep without any task or CPU wakeup
+*/
+
+#include "beacon_signal_ledc.h"
+
+#if CONFIG_BEACON_FEATURE_SIGNAL
+#include "esp_clk_tree.h"
+#include "driver/ledc.h" // For LED/buzzer pattern generation
+#endif
+
+#if CONFIG_BEACON_FEATURE_SIGNAL
+// ─────────────────────────────────────────────────────────────────────────────
+// Shared LED + buzzer line
+// Reason: Both LED and Buzzer share GPIO_NUM_23 → both toggle together.
+// - The on/off pattern is one LEDC PWM period: 20-bit duty, sub-hertz timer
+#define SIGNAL_GPIO          GPIO_NUM_23
+#define SIGNAL_LEDC_MODE     LEDC_LOW_SPEED_MODE // Only low-speed timers can run from RC_FAST
+#define SIGNAL_LEDC_TIMER    LEDC_TIMER_0
+#define SIGNAL_LEDC_CHANNEL  LEDC_CHANNEL_0
+#define SIGNAL_LEDC_RES_BITS 20
+#define SIGNAL_LEDC_DIV_MAX  ((1u << 18) - 1)    // Q10.8 clock divider field
+
+static bool s_ledc_ready = false;
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Signalling operations
+static esp_err_t signal_ledc_setup(void) {
+    // Low-speed timer on RC_FAST (~8 MHz): survives light sleep, unlike APB/REF_TICK
+    ledc_timer_config_t timer = {};
+    timer.speed_mode = SIGNAL_LEDC_MODE;
+    timer.duty_resolution = static_cast<ledc_timer_bit_t>(SIGNAL_LEDC_RES_BITS);
+    timer.timer_num = SIGNAL_LEDC_TIMER;
+    timer.freq_hz = 1;                      // Placeholder, divider is set per pattern
+    timer.clk_cfg = LEDC_USE_RC_FAST_CLK;
+    esp_err_t ret = ledc_timer_config(&timer);
+    if (ret != ESP_OK) return ret;
+
+    ledc_channel_config_t channel = {};
+    channel.gpio_num = SIGNAL_GPIO;
+    channel.speed_mode = SIGNAL_LEDC_MODE;
+    channel.channel = SIGNAL_LEDC_CHANNEL;
+    channel.timer_sel = SIGNAL_LEDC_TIMER;
+    channel.duty = 0;                       // Line low until a pattern is selected
+    channel.hpoint = 0;                     // Pattern starts with the "on" phase
+    channel.sleep_mode = LEDC_SLEEP_MODE_KEEP_ALIVE;
+    return ledc_channel_config(&channel);
+}
+
+beacon_err_t beacon_signal_ledc_output(void* ctx, const beacon_signal_pattern_t* pattern) {
+    if (!s_ledc_ready) {
+        esp_err_t ret = signal_ledc_setup();
+        if (ret != ESP_OK) return BEACON_ERR_FAIL;
+        s_ledc_ready = true;
+    }
+
+    const uint32_t full = 1u << SIGNAL_LEDC_RES_BITS;
+    uint32_t period_ms = pattern->on_ms + pattern->off_ms;
+    uint32_t duty = 0;
+    if (pattern->on_ms == 0 || pattern->off_ms == 0) {
+        duty = pattern->on_ms ? full : 0;     // Constant level, period irrelevant
+    } else {
+        // f = clk / (div * 2^res)  →  div = clk * period / 2^res, in Q10.8 fixed point
+        uint32_t clk_hz = 0;
+        esp_clk_tree_src_get_freq_hz(SOC_MOD_CLK_RC_FAST, ESP_CLK_TREE_SRC_FREQ_PRECISION_APPROX, &clk_hz);
+        uint64_t div = (static_cast<uint64_t>(clk_hz) * period_ms * 256) / (1000ULL * full);
+        if (div < 256 || div > SIGNAL_LEDC_DIV_MAX) return BEACON_ERR_INVALID_ARG;
+
+        // LEDC_APB_CLK selects the low-speed slow clock path, i.e. RC_FAST as configured above
+        esp_err_t ret = ledc_timer_set(SIGNAL_LEDC_MODE, SIGNAL_LEDC_TIMER, static_cast<uint32_t>(div),
+                                       SIGNAL_LEDC_RES_BITS, LEDC_APB_CLK);
+        if (ret != ESP_OK) return BEACON_ERR_FAIL;
+        ledc_timer_rst(SIGNAL_LEDC_MODE, SIGNAL_LEDC_TIMER);
+        duty = static_cast<uint32_t>((static_cast<uint64_t>(full) * pattern->on_ms) / period_ms);
+    }
+
+    esp_err_t ret = ledc_set_duty(SIGNAL_LEDC_MODE, SIGNAL_LEDC_CHANNEL, duty);
+    if (ret == ESP_OK) ret = ledc_update_duty(SIGNAL_LEDC_MODE, SIGNAL_LEDC_CHANNEL);
+    return ret == ESP_OK ? BEACON_OK : BEACON_ERR_FAIL;
+}
+#else
+beacon_err_t beacon_signal_ledc_output(void* ctx, const beacon_signal_pattern_t* pattern) {
+    return BEACON_ERR_NOT_SUPPORTED; // Compiled out (CONFIG_BEACON_FEATURE_SIGNAL)
+}
+#endif
@@ -0,0 +1,13 @@
+/*
+COS10025 BLE-to-Web Cultural Storytelling System
+LED/buzzer signalling on GPIO23 through the LEDC peripheral.
+*/
+
+#pragma once
+
+#include "sdkconfig.h"
+#include "beacon_backend.h"
+
+// beacon_backend_t::signal_output for the ESP32 backends (ctx unused)
+// - BEACON_ERR_NOT_SUPPORTED when built without CONFIG_BEACON_FEATURE_SIGNAL
+beacon_err_t beacon_signal_ledc_output(void* ctx, const beacon_signal_pattern_t* pattern);
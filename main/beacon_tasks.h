@@ -0,0 +1,33 @@
+/*
+COS10025 BLE-to-Web Cultural Storytelling System
+Task layout for application-owned tasks (Cham Beacon → Task layout).
+- Every application task is static and goes through beacon_task_create_static,
+  so core and priority are set in one place
+- Fixed layout of the IDF side for reference (shipped sdkconfig):
+  BT controller core 0 prio 23, esp_timer core 0 prio 22, Bluedroid BTU/BTC
+  core 0 prio 20/19 (NimBLE host core 0), app_main core 0
+*/
+
+#pragma once
+
+#include "sdkconfig.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#if CONFIG_BEACON_APP_CORE_ANY
+#define BEACON_APP_CORE tskNO_AFFINITY
+#else
+#define BEACON_APP_CORE CONFIG_BEACON_APP_CORE_ID
+#endif
+#define BEACON_APP_PRIORITY CONFIG_BEACON_APP_TASK_PRIORITY
+
+// Application core for the startup report (-1 = no affinity)
+#define BEACON_APP_CORE_REPORT (BEACON_APP_CORE == tskNO_AFFINITY ? -1 : static_cast<int>(BEACON_APP_CORE))
+
+// Create a task on the application core at `priority` from caller-owned
+// stack (stack_bytes long) and TCB; returns nullptr only on bad arguments
+static inline TaskHandle_t beacon_task_create_static(TaskFunction_t fn, const char* name, uint32_t stack_bytes,
+                                                     void* arg, UBaseType_t priority, StackType_t* stack,
+                                                     StaticTask_t* tcb) {
+    return xTaskCreateStaticPinnedToCore(fn, name, stack_bytes, arg, priority, stack, tcb, BEACON_APP_CORE);
+}
@@ -0,0 +1,167 @@
+/*
+COS10025 BLE-to-Web Cultural Storytelling System
+Supply and health telemetry (see beacon_telemetry.h).
+- ADC1 only: ADC2 is shared with the radio on the ESP32
+- The ESP32 supports the line-fitting calibration scheme; units without eFuse
+  calibration fall back to the nominal 1100 mV reference and flag it
+*/
+
+#include "beacon_telemetry.h"
+
+#if CONFIG_BEACON_TELEMETRY
+#include "esp_adc/adc_oneshot.h"
+#include "esp_adc/adc_cali.h"
+#include "esp_adc/adc_cali_scheme.h"
+#include "esp_log.h"
+#include "esp_system.h"
+#include "esp_timer.h"
+#include "beacon_backend_esp.h"
+#include "beacon_events.h"
+
+static const char* TAG = "BEACON_TLM";
+
+// Low-supply flag clears only this far above the threshold (no flapping)
+#define LOW_SUPPLY_HYSTERESIS_MV 100
+
+// Nominal reference for units without eFuse calibration
+#define DEFAULT_VREF_MV 1100
+
+static adc_oneshot_unit_handle_t s_adc = nullptr;
+static adc_cali_handle_t s_cali = nullptr;
+static bool s_calibrated = false;
+
+static beacon_t* s_beacon = nullptr;
+static uint32_t s_artifact_id = 0;
+static beacon_telemetry_cb_t s_cb = nullptr;
+static void* s_cb_arg = nullptr;
+static beacon_telemetry_t s_last = {};
+
+static uint8_t map_reset_reason(esp_reset_reason_t reason) {
+    switch (reason) {
+    case ESP_RST_POWERON:   return BEACON_RESET_POWER_ON;
+    case ESP_RST_SW:        return BEACON_RESET_SOFTWARE;
+    case ESP_RST_PANIC:     return BEACON_RESET_PANIC;
+    case ESP_RST_INT_WDT:
+    case ESP_RST_TASK_WDT:
+    case ESP_RST_WDT:       return BEACON_RESET_WATCHDOG;
+    case ESP_RST_BROWNOUT:  return BEACON_RESET_BROWNOUT;
+    case ESP_RST_DEEPSLEEP: return BEACON_RESET_DEEP_SLEEP;
+    case ESP_RST_EXT:       return BEACON_RESET_EXTERNAL;
+    default:                return BEACON_RESET_UNKNOWN;
+    }
+}
+
+static esp_err_t adc_init(void) {
+    adc_oneshot_unit_init_cfg_t unit_cfg = {};
+    unit_cfg.unit_id = ADC_UNIT_1;
+    unit_cfg.ulp_mode = ADC_ULP_MODE_DISABLE;
+    esp_err_t ret = adc_oneshot_new_unit(&unit_cfg, &s_adc);
+    if (ret != ESP_OK) return ret;
+
+    // 12 dB attenuation: ~150–2450 mV usable at the pin
+    adc_oneshot_chan_cfg_t chan_cfg = {};
+    chan_cfg.atten = ADC_ATTEN_DB_12;
+    chan_cfg.bitwidth = ADC_BITWIDTH_DEFAULT;
+    ret = adc_oneshot_config_channel(s_adc, static_cast<adc_channel_t>(CONFIG_BEACON_TELEMETRY_ADC_CHANNEL), &chan_cfg);
+    if (ret != ESP_OK) return ret;
+
+    adc_cali_line_fitting_efuse_val_t efuse;
+    s_calibrated = adc_cali_scheme_line_fitting_check_efuse(&efuse) == ESP_OK &&
+                   efuse != ADC_CALI_LINE_FITTING_EFUSE_VAL_DEFAULT_VREF;
+    adc_cali_line_fitting_config_t cali_cfg = {};
+    cali_cfg.unit_id = ADC_UNIT_1;
+    cali_cfg.atten = ADC_ATTEN_DB_12;
+    cali_cfg.bitwidth = ADC_BITWIDTH_DEFAULT;
+    cali_cfg.default_vref = DEFAULT_VREF_MV;
+    return adc_cali_create_scheme_line_fitting(&cali_cfg, &s_cali);
+}
+
+// Mean of CONFIG_BEACON_TELEMETRY_SAMPLES conversions without the lowest and
+// highest one, scaled back through the divider; 0 on failure
+static uint16_t sample_supply_mv(void) {
+    int sum = 0, lo = INT32_MAX, hi = 0, n = 0;
+    for (int i = 0; i < CONFIG_BEACON_TELEMETRY_SAMPLES; i++) {
+        int raw = 0, mv = 0;
+        if (adc_oneshot_read(s_adc, static_cast<adc_channel_t>(CONFIG_BEACON_TELEMETRY_ADC_CHANNEL), &raw) != ESP_OK) continue;
+        if (adc_cali_raw_to_voltage(s_cali, raw, &mv) != ESP_OK) continue;
+        sum += mv;
+        if (mv < lo) lo = mv;
+        if (mv > hi) hi = mv;
+        n++;
+    }
+    if (n == 0) return 0;
+    if (n > 2) {
+        sum -= lo + hi;
+        n -= 2;
+    }
+    return static_cast<uint16_t>(sum / n * CONFIG_BEACON_TELEMETRY_DIVIDER_X100 / 100);
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Sample, quantise into the payload and hand it to the double-buffered swap
+static void telemetry_sample(void) {
+    beacon_telemetry_t t = {};
+    t.supply_mv = s_adc ? sample_supply_mv() : 0;
+    t.uptime_s = static_cast<uint32_t>(esp_timer_get_time() / 1000000);
+    t.reset_reason = map_reset_reason(esp_reset_reason());
+
+    t.health = s_last.health & BEACON_HEALTH_LOW_SUPPLY;
+    if (t.supply_mv == 0) {
+        t.health = BEACON_HEALTH_SENSE_FAULT;
+    } else if (t.supply_mv < CONFIG_BEACON_TELEMETRY_LOW_MV) {
+        t.health |= BEACON_HEALTH_LOW_SUPPLY;
+    } else if (t.supply_mv > CONFIG_BEACON_TELEMETRY_LOW_MV + LOW_SUPPLY_HYSTERESIS_MV) {
+        t.health &= ~BEACON_HEALTH_LOW_SUPPLY;
+    }
+    if (!s_calibrated) t.health |= BEACON_HEALTH_UNCALIBRATED;
+    if ((t.health ^ s_last.health) & BEACON_HEALTH_LOW_SUPPLY) {
+        ESP_LOGW(TAG, "supply %u mV: %s", t.supply_mv, (t.health & BEACON_HEALTH_LOW_SUPPLY) ? "low" : "recovered");
+        beacon_event(BEACON_EV_SUPPLY, t.supply_mv, t.health);
+    }
+    s_last = t;
+
+    beacon_payload_t payload = beacon_encode_telemetry(s_artifact_id, t);
+    beacon_backend_esp_lock();
+    beacon_update_payload(s_beacon, payload.bytes, payload.len);
+    beacon_backend_esp_unlock();
+    if (s_cb) s_cb(&t, s_cb_arg);
+}
+
+static void telemetry_timer_cb(void* arg) {
+    telemetry_sample();
+}
+
+void beacon_telemetry_start(beacon_t* beacon, uint32_t artifact_id, beacon_telemetry_cb_t cb, void* arg) {
+    s_beacon = beacon;
+    s_artifact_id = artifact_id;
+    s_cb = cb;
+    s_cb_arg = arg;
+
+    // Step 1: ADC1 + calibration; a failure is advertised as SENSE_FAULT
+    esp_err_t ret = adc_init();
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "ADC init failed: %s", esp_err_to_name(ret));
+        s_adc = nullptr;
+    }
+
+    // Step 2: First sample now, so the first advertisement already carries it
+    telemetry_sample();
+
+    // Step 3: Low-rate timer; missed periods after long sleeps are not replayed
+    esp_timer_create_args_t args = {};
+    args.callback = telemetry_timer_cb;
+    args.dispatch_method = ESP_TIMER_TASK;
+    args.name = "beacon_tlm";
+    args.skip_unhandled_events = true;
+    esp_timer_handle_t timer;
+    if (esp_timer_create(&args, &timer) != ESP_OK) return;
+    esp_timer_start_periodic(timer, CONFIG_BEACON_TELEMETRY_PERIOD_S * 1000000ULL);
+}
+
+double beacon_telemetry_wakeups_per_s(void) {
+    return 1.0 / CONFIG_BEACON_TELEMETRY_PERIOD_S;
+}
+#else
+void beacon_telemetry_start(beacon_t* beacon, uint32_t artifact_id, beacon_telemetry_cb_t cb, void* arg) {}
+double beacon_telemetry_wakeups_per_s(void) { return 0.0; }
+#endif
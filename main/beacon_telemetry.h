@@ -0,0 +1,28 @@
+/*
+COS10025 BLE-to-Web Cultural Storytelling System
+Supply and health telemetry in the advertising payload (CONFIG_BEACON_TELEMETRY).
+- Supply rail sampled on ADC1 through a resistor divider, calibrated with the
+  eFuse reference and averaged over a short burst of conversions
+- Sampled from one low-rate esp_timer (CONFIG_BEACON_TELEMETRY_PERIOD_S); no
+  task, and the payload update rides on the same timer callback
+- Quantised into the compact payload with uptime and reset reason
+  (beacon_encode_telemetry in beacon_payload.h), swapped live while advertising
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include "beacon_core.h"
+#include "beacon_payload.h"
+
+// Called from the esp_timer task after every sample
+typedef void (*beacon_telemetry_cb_t)(const beacon_telemetry_t* telemetry, void* arg);
+
+// Take the first sample, put it into the payload of `beacon` and start the
+// sampling timer (no-op unless CONFIG_BEACON_TELEMETRY)
+// - Call after beacon_init(); the first sample replaces the initial payload
+// - artifact_id: compact artifact ID advertised with the telemetry block
+void beacon_telemetry_start(beacon_t* beacon, uint32_t artifact_id, beacon_telemetry_cb_t cb, void* arg);
+
+// CPU wakeups per second added by the sampling timer (0 when disabled)
+double beacon_telemetry_wakeups_per_s(void);
@@ -0,0 +1,153 @@
+/*
+COS10025 BLE-to-Web Cultural Storytelling System
+Self-healing runtime (see beacon_watchdog.h).
+- Supervisor task stack and TCB are static, on the application core
+  (beacon_tasks.h); checks and actions run under the GAP event lock
+- The task watchdog is reconfigured with this task subscribed and panic on
+  timeout; the idle tasks stay watched as in the IDF default configuration
+*/
+
+#include "beacon_watchdog.h"
+
+#if CONFIG_BEACON_WATCHDOG
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "esp_system.h"
+#include "esp_task_wdt.h"
+#include "esp_timer.h"
+#include "beacon_supervisor.h"
+#include "beacon_backend_esp.h"
+#include "beacon_console.h"
+#include "beacon_events.h"
+#include "beacon_tasks.h"
+
+static const char* TAG = "BEACON_WDOG";
+
+#define TASK_STACK 3072
+
+#if CONFIG_BEACON_WATCHDOG_PROBE
+static_assert(CONFIG_BEACON_WATCHDOG_STALL_S > CONFIG_BEACON_WATCHDOG_QUIET_S,
+              "CONFIG_BEACON_WATCHDOG_STALL_S must be longer than CONFIG_BEACON_WATCHDOG_QUIET_S");
+#define QUIET_US (CONFIG_BEACON_WATCHDOG_QUIET_S * 1000000u)
+#else
+#define QUIET_US 0u // Advertising taken as healthy, no probes
+#endif
+
+#if CONFIG_ESP_TASK_WDT_CHECK_IDLE_TASK_CPU0
+#define IDLE_MASK_CPU0 (1u << 0)
+#else
+#define IDLE_MASK_CPU0 0u
+#endif
+#if CONFIG_ESP_TASK_WDT_CHECK_IDLE_TASK_CPU1 && !CONFIG_FREERTOS_UNICORE
+#define IDLE_MASK_CPU1 (1u << 1)
+#else
+#define IDLE_MASK_CPU1 0u
+#endif
+
+static beacon_t* s_beacon = nullptr;
+static beacon_supervisor_t s_sup;
+static TaskHandle_t s_task = nullptr;
+static StackType_t s_task_stack[TASK_STACK];
+static StaticTask_t s_task_buf;
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Supervisor task
+static void report(beacon_sup_action_t action, beacon_state_t state, uint32_t quiet_ms, beacon_err_t err) {
+    switch (action) {
+    case BEACON_SUP_RESTART:
+        ESP_LOGW(TAG, "no advertising confirmed for %lu ms (%s), restarting the Bluetooth stack (%u/%u)%s",
+                 (unsigned long)quiet_ms, beacon_state_name(state), s_sup.restarts,
+                 CONFIG_BEACON_WATCHDOG_RESTART_MAX, err == BEACON_OK ? "" : ", teardown failed");
+        beacon_event(BEACON_EV_SUPERVISOR, static_cast<uint16_t>(action), quiet_ms);
+        break;
+    case BEACON_SUP_REBOOT:
+        ESP_LOGE(TAG, "no advertising confirmed for %lu ms after %u restarts, rebooting", (unsigned long)quiet_ms,
+                 s_sup.restarts);
+        beacon_event(BEACON_EV_SUPERVISOR, static_cast<uint16_t>(action), quiet_ms);
+        break;
+    case BEACON_SUP_RECOVERED:
+        ESP_LOGI(TAG, "advertising recovered: %lu ms after the first restart, %lu ms off air at most",
+                 (unsigned long)(s_sup.last_recovery_us / 1000), (unsigned long)(s_sup.last_outage_us / 1000));
+        beacon_event(BEACON_EV_RECOVERED, static_cast<uint16_t>(s_sup.restarts_total),
+                     s_sup.last_recovery_us / 1000);
+        break;
+    default:
+        break; // Probes are routine while the host reports no advertising events
+    }
+}
+
+static void watchdog_task(void* arg) {
+    esp_task_wdt_add(nullptr);
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(CONFIG_BEACON_WATCHDOG_PERIOD_MS));
+        esp_task_wdt_reset();
+
+        // Step 1: Check and act under the GAP event lock
+        beacon_backend_esp_lock();
+        uint64_t now_us = static_cast<uint64_t>(esp_timer_get_time());
+        uint32_t quiet_ms = static_cast<uint32_t>((now_us - s_sup.ok_us) / 1000);
+        beacon_state_t state = s_beacon->state;
+        beacon_sup_action_t action = beacon_supervisor_check(&s_sup, s_beacon, now_us);
+        beacon_err_t err = BEACON_OK;
+        if (action == BEACON_SUP_PROBE) {
+            err = beacon_probe(s_beacon);
+        } else if (action == BEACON_SUP_RESTART) {
+            err = beacon_restart(s_beacon); // Returns once the stack stages have run again
+        }
+        beacon_backend_esp_unlock();
+
+        // Step 2: Report; the reboot is the last resort
+        report(action, state, quiet_ms, err);
+        if (action == BEACON_SUP_REBOOT) esp_restart();
+    }
+}
+
+static void status_command(const char* arg) {
+    beacon_backend_esp_lock();
+    beacon_supervisor_t sup = s_sup;
+    beacon_backend_esp_unlock();
+    beacon_supervisor_print(&sup, stdout);
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Task watchdog: this task subscribed, panic (reboot) on timeout
+static esp_err_t twdt_init(void) {
+    esp_task_wdt_config_t config = {};
+    config.timeout_ms = CONFIG_BEACON_WATCHDOG_TWDT_S * 1000;
+    config.idle_core_mask = IDLE_MASK_CPU0 | IDLE_MASK_CPU1;
+    config.trigger_panic = true;
+    esp_err_t err = esp_task_wdt_reconfigure(&config);
+    if (err == ESP_ERR_INVALID_STATE) err = esp_task_wdt_init(&config); // Not started at boot (ESP_TASK_WDT_INIT=n)
+    return err;
+}
+
+void beacon_watchdog_start(beacon_t* beacon) {
+    beacon_sup_config_t config = beacon_supervisor_defaults();
+    config.quiet_us = QUIET_US;
+    config.stall_us = CONFIG_BEACON_WATCHDOG_STALL_S * 1000000u;
+    config.restart_max = CONFIG_BEACON_WATCHDOG_RESTART_MAX;
+
+    if (twdt_init() != ESP_OK) ESP_LOGW(TAG, "task watchdog not available, no reboot if a restart hangs");
+    beacon_backend_esp_lock();
+    s_beacon = beacon;
+    beacon_supervisor_init(&s_sup, &config, beacon, static_cast<uint64_t>(esp_timer_get_time()));
+    beacon_backend_esp_unlock();
+    s_task = beacon_task_create_static(watchdog_task, "beacon_wdog", TASK_STACK, nullptr, BEACON_APP_PRIORITY,
+                                       s_task_stack, &s_task_buf);
+    beacon_console_register('w', false, status_command);
+}
+
+void beacon_watchdog_on_state(beacon_state_t state) {
+    if (!s_task) return;
+    if (state == BEACON_STATE_ADVERTISING || state == BEACON_STATE_ERROR) xTaskNotifyGive(s_task);
+}
+
+double beacon_watchdog_wakeups_per_s(void) {
+    return 1000.0 / CONFIG_BEACON_WATCHDOG_PERIOD_MS;
+}
+#else
+void beacon_watchdog_start(beacon_t* beacon) {}
+void beacon_watchdog_on_state(beacon_state_t state) {}
+double beacon_watchdog_wakeups_per_s(void) { return 0.0; }
+#endif
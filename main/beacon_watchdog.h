@@ -0,0 +1,29 @@
+/*
+COS10025 BLE-to-Web Cultural Storytelling System
+Self-healing runtime: advertising supervisor task and task watchdog.
+- Every CONFIG_BEACON_WATCHDOG_PERIOD_MS the supervisor (beacon_supervisor.h)
+  checks that the controller still confirms advertising. A quiet beacon is
+  probed (CONFIG_BEACON_WATCHDOG_PROBE), a stalled one (or one that ran out of start-up retries) gets its
+  Bluetooth stack restarted in-process, and the chip reboots after
+  CONFIG_BEACON_WATCHDOG_RESTART_MAX restarts without recovery
+- The supervisor task itself is watched by the task watchdog with panic on
+  timeout, so a restart that hangs inside the Bluetooth stack also ends in a
+  reboot
+- Every recovery is logged with its time to recovery and recorded in the event
+  log; 'w' on the console prints the totals
+*/
+
+#pragma once
+
+#include "beacon_core.h"
+
+// Start supervising after beacon_start() (no-op unless CONFIG_BEACON_WATCHDOG)
+void beacon_watchdog_start(beacon_t* beacon);
+
+// Beacon state change, from the beacon state callback (GAP event lock held):
+// advertising confirmed or retries exhausted are acted on without waiting for
+// the next period
+void beacon_watchdog_on_state(beacon_state_t state);
+
+// CPU wakeups per second added by the supervisor task (0 when disabled)
+double beacon_watchdog_wakeups_per_s(void);
@@ -2,151 +2,273 @@
 COS10025 BLE-to-Web Cultural Storytelling System
 Layer 1: ESP32 BLE beacon firmware for non-contact Cham artifact storytelling.
 - Non-connectable BLE advertising only (ADV_NONCONN_IND)
-- Human-readable artifact name (e.g., "TraKieu_Apsara_Relief")
+- Compact binary artifact ID (manufacturer data), or the human-readable
+  artifact name (e.g., "TraKieu_Apsara_Relief") in name payload mode
+- Artifact identity and advertising profile provisioned in NVS (one image for all units)
+- Optional light-sleep mode (sdkconfig.defaults.lowpower): DFS + automatic light sleep
+- Optional multi-artifact rotation (CONFIG_BEACON_ROTATION_ARTIFACTS): several
+  artifacts share one board through one advertising set
+- Optional supply/health telemetry in the compact payload (CONFIG_BEACON_TELEMETRY)
+- Optional rotating ephemeral IDs instead of the artifact ID (CONFIG_BEACON_EID)
+- Optional adaptive advertising interval (CONFIG_BEACON_POLICY): fast window
+  after boot, slow or off during closed hours
+- Optional deep-sleep burst mode (sdkconfig.defaults.burst): RTC timer wakes, short bursts
+- Supervised advertising (CONFIG_BEACON_WATCHDOG): a stalled Bluetooth stack is
+  restarted in-process, with a reboot as the fallback
 - No GATT, no pairing, no connectable services
 - Broadcast interval: 100–200 ms
 - ESP-IDF v5.4.1, ESP32-D0WD-V3
 - See README.md for full project details
 
 ADDED: Blink an LED and buzz a buzzer on GPIO23 every 3 seconds.
+- Pattern generated by the LEDC peripheral (no task, no CPU wakeups)
 - LED anode to GPIO23, cathode to GND via 220Ω resistor.
 - Buzzer I/O to GPIO23, VCC to 3V3 power, GND to Ground.
 */
 
-#include "freertos/FreeRTOS.h"
-#include "freertos/task.h"
-#include "esp_bt.h"
-#include "esp_gap_ble_api.h"
-#include "esp_bt_main.h"
-#include "driver/gpio.h" // For LED control
-#include <string.h>
+#include "esp_log.h"
+#include "esp_system.h"
+#include "esp_heap_caps.h"
+#include "esp_timer.h"
+#include "beacon_core.h"
+#include "beacon_config.h"
+#include "beacon_rotation.h"
+#include "beacon_backend_esp.h"
+#include "beacon_config_nvs.h"
+#include "beacon_power.h"
+#include "beacon_burst.h"
+#include "beacon_instr.h"
+#include "beacon_telemetry.h"
+#include "beacon_adaptive.h"
+#include "beacon_ephemeral.h"
+#include "beacon_console.h"
+#include "beacon_heap.h"
+#include "beacon_tasks.h"
+#include "beacon_events.h"
+#include "beacon_watchdog.h"
 
-// #include "esp_log.h" // Optional: Uncomment if logging is needed during debugging
-// static const char* TAG = "BLE_BEACON"; // Logging tag, only needed if ESP_LOG is used
+static const char* TAG = "BLE_BEACON"; // Logging tag for the startup report
 
 // ─────────────────────────────────────────────────────────────────────────────
-// Define a fixed beacon name corresponding to a Cham artifact.
-// Uncomment to switch to another active DEVICE_NAME compiled by once at a time.
-// #define DEVICE_NAME "TraKieu_Apsara_Relief"
-#define DEVICE_NAME "Tara_Bodhisattva_Statue"
+// Compiled defaults, used only when no configuration is provisioned in NVS.
+// Production units share one firmware image; each unit's artifact identity,
+// interval, TX power and payload format come from the NVS "beacon" namespace
+// (see tools/beacon_nvs.py).
+// - Artifact IDs must match `beaconIdToName` in the Flutter app
+//   0x0001 = TraKieu_Apsara_Relief, 0x0002 = Tara_Bodhisattva_Statue
+// - DEFAULT_PAYLOAD_FORMAT: BEACON_PAYLOAD_COMPACT (11-byte manufacturer data)
+//   or BEACON_PAYLOAD_NAME (complete local name, DEFAULT_DEVICE_NAME)
+#define DEFAULT_ARTIFACT_ID     0x0002
+#define DEFAULT_DEVICE_NAME     "Tara_Bodhisattva_Statue"
+#define DEFAULT_PAYLOAD_FORMAT  BEACON_PAYLOAD_COMPACT
+
+static_assert(beacon_encode_compact(DEFAULT_ARTIFACT_ID).len != 0,
+              "DEFAULT_ARTIFACT_ID does not fit the compact payload");
 
 // ─────────────────────────────────────────────────────────────────────────────
-// No GPIO configuration for LED and Buzzer
-// Reason: Both LED and Buzzer share GPIO_NUM_23 → both LED and Buzzer will toggle together when the toggle_high_low_task runs.
+// Beacon state and signalling state (hardware-independent, see components/beacon_core)
+// - Advertising profile from s_config (default: 100–125 ms, channels 37/38/39, +3 dBm)
+static beacon_config_t s_config;
+static beacon_t s_beacon;
+#if CONFIG_BEACON_FEATURE_SIGNAL
+static beacon_signal_t s_signal;
+#endif
+static bool s_fast_wake = false; // Deep-sleep burst wake with RTC-retained config
 
 // ─────────────────────────────────────────────────────────────────────────────
-// BLE Advertisement Parameters Configuration
-// - Non-connectable advertising type (ADV_NONCONN_IND)
-// - Interval range: 160–200 ms (0x00A0–0x00C8 in 0.625 ms units)
-// - Broadcasts on all 3 advertising channels (37, 38, 39)
-// - No filter restrictions on scan/connection requests (though connection is disabled)
-static esp_ble_adv_params_t adv_params = {
-    .adv_int_min        = 0x00A0, // Minimum advertising interval: 160 * 0.625ms = 100ms
-    .adv_int_max        = 0x00C8, // Maximum advertising interval: 200 * 0.625ms = 125ms
-    .adv_type           = ADV_TYPE_NONCONN_IND, // Non-connectable, undirected advertising
-    .own_addr_type      = BLE_ADDR_TYPE_PUBLIC, // Use the device's public BLE address
-    .peer_addr_type     = BLE_ADDR_TYPE_PUBLIC, // Required to suppress uninitialized warning
-    .channel_map        = ADV_CHNL_ALL,         // Use channels 37, 38, and 39
-    .adv_filter_policy  = ADV_FILTER_ALLOW_SCAN_ANY_CON_ANY // Allow any device to scan
-};
+// Multi-artifact rotation (CONFIG_BEACON_ROTATION_ARTIFACTS, empty = single artifact)
+// - Swaps the payload once per dwell from the esp_timer task; advertising keeps running
+static beacon_rotation_t s_rotation;
+
+// - One-shot, re-armed every step: the dwell follows interval changes made by the policy
+static esp_timer_handle_t s_rotation_timer = nullptr;
+
+static void rotation_timer_cb(void* arg) {
+    beacon_backend_esp_lock();
+    if (s_beacon.state == BEACON_STATE_ADVERTISING) beacon_rotation_step(&s_rotation, &s_beacon);
+    uint64_t dwell_us = beacon_rotation_dwell_us(&s_beacon.adv_params);
+    beacon_backend_esp_unlock();
+    esp_timer_start_once(s_rotation_timer, dwell_us);
+}
+
+static void rotation_start(void) {
+    if (s_rotation.count < 2) return;
+    esp_timer_create_args_t args = {};
+    args.callback = rotation_timer_cb;
+    args.dispatch_method = ESP_TIMER_TASK;
+    args.name = "beacon_rotation";
+    if (esp_timer_create(&args, &s_rotation_timer) != ESP_OK) return;
+    esp_timer_start_once(s_rotation_timer, beacon_rotation_dwell_us(&s_beacon.adv_params));
+}
 
 // ─────────────────────────────────────────────────────────────────────────────
-// GAP (Generic Access Profile) event handler
-// - Required by ESP-IDF BLE stack but unused in this minimal passive beacon
-void gap_event_handler(esp_gap_ble_cb_event_t event, esp_ble_gap_cb_param_t* param) {
-    // No event handling or logging required for passive broadcasting use case
+// Telemetry sample hook (app_main for the first sample, then the esp_timer task)
+// - Low supply switches the signal pattern; signalling is initialised before
+//   telemetry starts (Step 3c), so this is the pattern's only writer afterwards
+static void telemetry_sampled(const beacon_telemetry_t* telemetry, void* arg) {
+#if CONFIG_BEACON_FEATURE_SIGNAL
+    if (s_fast_wake || !s_signal.backend) return;
+    bool low_supply = telemetry->health & BEACON_HEALTH_LOW_SUPPLY;
+    beacon_signal_set(&s_signal, low_supply ? BEACON_SIGNAL_LOW_BATTERY : BEACON_SIGNAL_HEARTBEAT);
+#endif
 }
 
 // ─────────────────────────────────────────────────────────────────────────────
-// Toggle HIGH/LOW Signals Task
-// - Toggles the LED and Buzzer on GPIO23 every 3 seconds
-// - Runs as a FreeRTOS task in parallel with BLE beaconing
-void toggle_high_low_task(void* arg) {
-    // Configure GPIO23 as output
-    gpio_config_t io_conf = {};
-    io_conf.intr_type = GPIO_INTR_DISABLE;      // No interrupt
-    io_conf.mode = GPIO_MODE_OUTPUT;            // Output mode
-    io_conf.pin_bit_mask = (1ULL << GPIO_NUM_23); // Bitmask for GPIO23
-    io_conf.pull_down_en = GPIO_PULLDOWN_DISABLE;
-    io_conf.pull_up_en = GPIO_PULLUP_DISABLE;
-    gpio_config(&io_conf);
-
-    // Main toggle loop
-    while (1) {
-        // Turn LED and Buzzer ON (set GPIO23 high)
-        gpio_set_level(GPIO_NUM_23, 1);
-        vTaskDelay(pdMS_TO_TICKS(500)); // LED and Buzzer on for 0.5 seconds
-
-        // Turn LED and Buzzer OFF (set GPIO23 low)
-        gpio_set_level(GPIO_NUM_23, 0);
-        vTaskDelay(pdMS_TO_TICKS(2500)); // LED and Buzzer off for 2.5 seconds
-
-        // Total cycle: 3 seconds (0.5s ON, 2.5s OFF)
+// Startup report
+// - Called by the beacon core on every state change (GAP/BTC or esp_timer task)
+// - Prints the esp_timer startup timeline once advertising is up or has failed
+//   (skipped on burst-mode fast wakes, where UART time is awake time)
+static void beacon_state_changed(beacon_t* beacon, beacon_state_t state, void* arg) {
+#if CONFIG_BEACON_BURST_MODE
+    beacon_burst_on_state(beacon, state);
+    if (s_fast_wake) return;
+#endif
+    beacon_heap_on_state(state);     // CONFIG_BEACON_HEAP_TRACE only
+    beacon_watchdog_on_state(state); // CONFIG_BEACON_WATCHDOG only
+    beacon_event(BEACON_EV_STATE, static_cast<uint16_t>(state), 0);
+    if (state == BEACON_STATE_RETRY_WAIT) {
+        beacon_event(BEACON_EV_RETRY, static_cast<uint16_t>(beacon->retry_step),
+                     static_cast<uint32_t>(beacon->last_error));
+        ESP_LOGW(TAG, "startup step %d failed (err %d), retry %lu",
+                 beacon->retry_step, beacon->last_error, (unsigned long)beacon->retry_count);
+        return;
+    }
+#if CONFIG_BEACON_FEATURE_STARTUP_REPORT
+    if (state != BEACON_STATE_ADVERTISING && state != BEACON_STATE_ERROR) return;
+
+    ESP_LOGI(TAG, "%s after %lu retries, boot timeline (us since esp_timer start):",
+             beacon_state_name(state), (unsigned long)beacon->retry_total);
+    for (int m = BEACON_MARK_START; m < BEACON_MARK_COUNT; m++) {
+        if (beacon->marks_us[m] == 0) continue;
+        ESP_LOGI(TAG, "  %-18s %llu", beacon_mark_name(static_cast<beacon_mark_t>(m)),
+                 (unsigned long long)beacon->marks_us[m]);
     }
+    // Parsed by tools/ble_host_report.py
+    ESP_LOGI(TAG, "%s heap after init: free %lu, min free %lu, largest block %lu", BEACON_BLE_HOST_NAME,
+             (unsigned long)esp_get_free_heap_size(), (unsigned long)esp_get_minimum_free_heap_size(),
+             (unsigned long)heap_caps_get_largest_free_block(MALLOC_CAP_8BIT));
+#endif
 }
 
 // ─────────────────────────────────────────────────────────────────────────────
 // Entry Point: app_main
-// - Initializes and enables BLE controller and Bluedroid stack
-// - Configures and starts BLE advertising with human-readable artifact name
-// - Starts the toggle high/low task
+// - Initializes the BLE controller and Bluedroid stack through the ESP32 backend
+// - Builds the advertising payload chosen by the configuration: compact binary
+//   artifact ID (default) or human-readable artifact name; advertising starts
+//   once ESP_GAP_BLE_ADV_DATA_RAW_SET_COMPLETE_EVT confirms the payload
+// - Failed steps are retried with bounded backoff by the beacon core; once
+//   retries run out, or advertising stalls later, the watchdog restarts the stack
+// - Hands the GPIO23 heartbeat pattern to the LEDC peripheral
 extern "C" void app_main() {
-    // Step 1: Free memory reserved for Bluetooth Classic, not used in this project
-    esp_bt_controller_mem_release(ESP_BT_MODE_CLASSIC_BT);
-
-    // Step 2: Load default configuration for BLE controller
-    esp_bt_controller_config_t bt_cfg = BT_CONTROLLER_INIT_CONFIG_DEFAULT();
-
-    // Step 3: Initialize BLE controller
-    esp_err_t ret = esp_bt_controller_init(&bt_cfg);
-    if (ret) return;
-
-    // Step 4: Enable BLE mode (BLE-only operation)
-    ret = esp_bt_controller_enable(ESP_BT_MODE_BLE);
-    if (ret) return;
-
-    // Step 5: Initialize the Bluedroid stack (ESP's BLE host stack)
-    ret = esp_bluedroid_init();
-    if (ret) return;
-
-    // Step 6: Enable Bluedroid
-    ret = esp_bluedroid_enable();
-    if (ret) return;
-
-    // Step 7: Register a GAP callback — mandatory even if unused
-    esp_ble_gap_register_callback(gap_event_handler);
-
-    // Step 8: Set the BLE device name (visible in advertising packet)
-    esp_ble_gap_set_device_name(DEVICE_NAME);
-
-    // Step 9: Configure advertising data structure
-    // - No scan response
-    // - Broadcast only the device name (no UUIDs, services, TX power)
-    esp_ble_adv_data_t adv_data = {};
-    adv_data.set_scan_rsp = false;                     // No scan response packet
-    adv_data.include_name = true;                      // Include device name in ADV payload
-    adv_data.include_txpower = false;                  // Do not include TX power
-    adv_data.min_interval = 0x0006;                    // Optional: placeholder for iOS compliance
-    adv_data.max_interval = 0x0010;                    // Optional: placeholder for iOS compliance
-    adv_data.appearance = 0x00;                        // No specific icon/appearance
-    adv_data.manufacturer_len = 0;                     // No manufacturer-specific data
-    adv_data.p_manufacturer_data = nullptr;
-    adv_data.service_data_len = 0;                     // No service-specific data
-    adv_data.p_service_data = nullptr;
-    adv_data.service_uuid_len = 0;                     // No UUIDs advertised
-    adv_data.p_service_uuid = nullptr;
-    adv_data.flag = (ESP_BLE_ADV_FLAG_GEN_DISC | ESP_BLE_ADV_FLAG_BREDR_NOT_SPT);
-    // - General discoverable mode
-    // - BR/EDR (classic Bluetooth) not supported
-
-    // Step 10: Apply advertising data configuration
-    esp_ble_gap_config_adv_data(&adv_data);
-
-    // Step 11: Start advertising immediately (without waiting for config event)
-    // Note: In production systems, wait for ESP_GAP_BLE_ADV_DATA_SET_COMPLETE_EVT
-    esp_ble_gap_start_advertising(&adv_params);
-
-    // Step 12: Start the toggle high/low task (runs independently)
-    // - Stack size: 2048 bytes, Priority: 5 (default)
-    xTaskCreate(toggle_high_low_task, "toggle_high_low_task", 2048, NULL, 5, NULL);
+    // Step 1: DFS + automatic light sleep (CONFIG_BEACON_LOW_POWER profile only)
+    // - The event log comes first, so every later failure is recorded
+    beacon_events_init();
+    esp_err_t pm_err = beacon_power_init();
+    if (pm_err != ESP_OK) beacon_event(BEACON_EV_INIT_FAIL, BEACON_INIT_POWER, static_cast<uint32_t>(pm_err));
+
+    // Step 2: Read the configuration once (RTC memory on a burst wake, else NVS blob or compiled defaults)
+#if CONFIG_BEACON_BURST_MODE
+    s_fast_wake = beacon_burst_resume(&s_config);
+#endif
+    if (s_fast_wake) {
+        beacon_nvs_init(); // PHY calibration data only, no config read
+    } else {
+        s_config = beacon_config_defaults(DEFAULT_ARTIFACT_ID, DEFAULT_DEVICE_NAME, DEFAULT_PAYLOAD_FORMAT);
+#if CONFIG_BEACON_FEATURE_NVS_CONFIG
+        beacon_config_source_t source = beacon_config_load_nvs(&s_config);
+        if (source == BEACON_CONFIG_SOURCE_INVALID) {
+            ESP_LOGW(TAG, "NVS beacon config rejected, using defaults");
+            beacon_event(BEACON_EV_INIT_FAIL, BEACON_INIT_CONFIG, 0);
+        }
+#else
+        beacon_nvs_init(); // Compiled defaults only; NVS still holds the PHY calibration data
+        [[maybe_unused]] beacon_config_source_t source = BEACON_CONFIG_SOURCE_DEFAULTS;
+#endif
+#if CONFIG_BEACON_FEATURE_STARTUP_REPORT
+        ESP_LOGI(TAG, "artifact 0x%04lx (%s payload), interval %u–%u, channels 0x%x, %d dBm, from %s",
+                 (unsigned long)s_config.artifact_id,
+                 s_config.payload_format == BEACON_PAYLOAD_COMPACT ? "compact" : "name",
+                 s_config.interval_min, s_config.interval_max, s_config.channel_map, s_config.tx_power_dbm,
+                 source == BEACON_CONFIG_SOURCE_NVS ? "NVS" : "defaults");
+        ESP_LOGI(TAG, "task layout: %d core(s), controller core %d, %s host core %d, app core %d prio %d",
+                 portNUM_PROCESSORS, CONFIG_BTDM_CTRL_PINNED_TO_CORE, BEACON_BLE_HOST_NAME, BEACON_BLE_HOST_CORE,
+                 BEACON_APP_CORE_REPORT, BEACON_APP_PRIORITY);
+#endif
+#if CONFIG_BEACON_BURST_MODE
+        beacon_burst_retain(&s_config);
+#endif
+    }
+
+    // Step 3: Build the advertising payload and profile from the configuration
+    // - A rotation list replaces the single artifact; its first slot goes on air first
+    // - EID mode replaces a single compact artifact ID with the current ephemeral ID
+    beacon_payload_t payload = beacon_config_payload(&s_config);
+    int8_t tx_power_dbm = s_config.tx_power_dbm;
+    beacon_rotation_init(&s_rotation);
+    int rotated = beacon_rotation_parse(&s_rotation, CONFIG_BEACON_ROTATION_ARTIFACTS, s_config.tx_power_dbm);
+    if (rotated < 0) {
+        ESP_LOGW(TAG, "invalid rotation list \"%s\", single artifact", CONFIG_BEACON_ROTATION_ARTIFACTS);
+        beacon_event(BEACON_EV_INIT_FAIL, BEACON_INIT_ROTATION, 0);
+        beacon_rotation_init(&s_rotation);
+    } else if (rotated > 0) {
+        payload = beacon_rotation_first(&s_rotation)->payload;
+        tx_power_dbm = beacon_rotation_first(&s_rotation)->tx_power_dbm;
+    }
+    bool ephemeral = s_config.payload_format == BEACON_PAYLOAD_COMPACT && s_rotation.count == 0 &&
+                     beacon_ephemeral_init(&payload);
+    beacon_err_t init_err = beacon_init(&s_beacon, beacon_backend_esp(), payload.bytes, payload.len);
+    if (init_err != BEACON_OK) {
+        ESP_LOGE(TAG, "beacon_init failed (err %d), not advertising", init_err);
+        beacon_event(BEACON_EV_INIT_FAIL, BEACON_INIT_CORE, static_cast<uint32_t>(init_err));
+        if (!s_fast_wake) {
+            beacon_events_start();
+            beacon_console_start(); // Keep the event log readable
+        }
+        return;
+    }
+    beacon_adv_params_t params = beacon_config_adv_params(&s_config);
+    beacon_set_profile(&s_beacon, &params, tx_power_dbm);
+    beacon_set_state_callback(&s_beacon, beacon_state_changed, nullptr);
+
+    // Step 3b: Adaptive interval policy picks the starting profile (CONFIG_BEACON_POLICY)
+    // - Burst mode sleeps straight through an "off" period instead of advertising
+    [[maybe_unused]] bool advertise = beacon_adaptive_init(&s_beacon, !s_fast_wake);
+#if CONFIG_BEACON_BURST_MODE
+    if (!advertise) beacon_burst_sleep(beacon_adaptive_next_change_s() * 1000000ULL);
+#endif
+
+    if (!s_fast_wake) beacon_heap_init();   // Heap trace/soak timers, before anything is traced
+
+    // Step 3c: Start the GPIO23 heartbeat (0.5 s ON, 2.5 s OFF, kept alive in light sleep)
+    // - Before telemetry: from then on only telemetry_sampled() touches the pattern
+    //   (low-battery blip on a low supply), first here, then from the esp_timer task
+    // - Not on burst wakes: the pattern would only flash for the burst window
+#if CONFIG_BEACON_FEATURE_SIGNAL
+    if (!s_fast_wake) {
+        beacon_signal_init(&s_signal, beacon_backend_esp());
+        if (beacon_signal_set(&s_signal, BEACON_SIGNAL_HEARTBEAT) != BEACON_OK) {
+            ESP_LOGW(TAG, "signal pattern %s not supported", beacon_signal_pattern(BEACON_SIGNAL_HEARTBEAT)->name);
+            beacon_event(BEACON_EV_INIT_FAIL, BEACON_INIT_SIGNAL, BEACON_SIGNAL_HEARTBEAT);
+        }
+    }
+#endif
+
+    // Step 4: Bring up the stack and push the payload (advertising follows via GAP events)
+    // - Telemetry replaces the payload before the first push, then updates it live
+    bool telemetry = s_config.payload_format == BEACON_PAYLOAD_COMPACT && s_rotation.count == 0 && !ephemeral;
+    if (telemetry) beacon_telemetry_start(&s_beacon, s_config.artifact_id, telemetry_sampled, nullptr);
+    beacon_start(&s_beacon);
+    // Signalling runs in hardware; the telemetry timer and the watchdog are the only extra wakeups
+    beacon_power_start_report(&s_beacon, (telemetry ? beacon_telemetry_wakeups_per_s() : 0.0) +
+                                             beacon_watchdog_wakeups_per_s());
+    beacon_instr_start(&s_beacon);             // CONFIG_BEACON_INSTRUMENTATION only
+    rotation_start();                          // Two or more rotated artifacts only
+    if (ephemeral) beacon_ephemeral_start(&s_beacon);
+    beacon_adaptive_start();                   // CONFIG_BEACON_POLICY, not in burst mode
+    beacon_watchdog_start(&s_beacon);          // CONFIG_BEACON_WATCHDOG, not in burst mode
+    if (!s_fast_wake) beacon_events_start();   // 'e' dumps the event log
+    if (!s_fast_wake) beacon_console_start();  // Commands registered above, if any
+
+    // Step 5: Start-up done; from here on the heap trace expects no allocations
+    if (!s_fast_wake) beacon_heap_start();
 }
@@ -0,0 +1,50 @@
+#!/usr/bin/env python3
+"""
+COS10025 BLE-to-Web Cultural Storytelling System
+Set a beacon's wall clock over its console UART.
+
+The clock drives the closed-hours advertising policy (CONFIG_BEACON_POLICY).
+It survives deep sleep and software resets but not a power cut, so set it
+after installing or re-powering a unit:
+
+    python tools/beacon_clock.py COM5
+    python tools/beacon_clock.py /dev/ttyUSB0 --epoch 1735689600
+
+Sends "T<unix seconds>\\n" (UTC); the firmware applies
+CONFIG_BEACON_CLOCK_UTC_OFFSET_MIN for local time and echoes the result.
+"""
+
+import argparse
+import sys
+import time
+
+try:
+    import serial  # pyserial, installed with ESP-IDF
+except ImportError:
+    print("pyserial is required (pip install pyserial)", file=sys.stderr)
+    sys.exit(1)
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("port")
+    ap.add_argument("--baud", type=int, default=115200)
+    ap.add_argument("--epoch", type=int, help="seconds since 1970 UTC (default: this host's clock)")
+    args = ap.parse_args()
+
+    with serial.Serial(args.port, args.baud, timeout=1) as port:
+        epoch = args.epoch if args.epoch is not None else int(time.time())
+        port.write(b"T%d\n" % epoch)
+        port.flush()
+        deadline = time.time() + 2.0
+        while time.time() < deadline:
+            line = port.readline().decode(errors="replace").strip()
+            if "BEACON_CLOCK" in line:
+                print(line)
+                return 0 if "clock set" in line else 1
+    print("no reply from the beacon (console UART busy or firmware without the clock command)", file=sys.stderr)
+    return 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,166 @@
+#!/usr/bin/env python3
+"""
+COS10025 BLE-to-Web Cultural Storytelling System
+Generate the NVS provisioning CSV for one beacon unit.
+
+The firmware reads a single packed blob (namespace "beacon", key "cfg") at boot,
+laid out as beacon_config_t in components/beacon_core/include/beacon_config.h.
+This script writes an nvs_partition_gen CSV holding that blob; turn it into a
+partition image and flash it to the "nvs" partition (0x9000 in the default
+single-app table):
+
+    python tools/beacon_nvs.py --artifact-id 0x0001 --out unit01.csv
+    python -m esp_idf_nvs_partition_gen generate unit01.csv unit01.bin 0x6000
+    esptool.py -p COMx write_flash 0x9000 unit01.bin
+
+Use --from-csv to generate one CSV per row of a fleet sheet (columns match the
+long option names, e.g. unit,artifact_id,name,format,interval_ms_min,...).
+host/plan_deployment --out fleet.csv writes such a sheet with per-unit
+intervals, channel maps and TX power planned for a dense hall.
+
+Rotating ephemeral IDs (CONFIG_BEACON_EID) need a 16-byte identity key per unit
+(NVS key "eik"): pass --eid-key HEX, an eid_key column, or --eid-secret HEX to
+derive each key as HMAC-SHA256(secret, unit)[:16]. --keys-out writes the key
+sheet (unit,artifact_id,eid_key) that host/eid_resolver loads; keep it private.
+"""
+
+import argparse
+import csv
+import hashlib
+import hmac
+import os
+import struct
+import sys
+
+CONFIG_VERSION = 1
+EID_KEY_LEN = 16
+NAME_MAX = 26
+PAYLOAD_FORMATS = {"name": 0, "compact": 1}
+CHANNELS = {"37": 0x01, "38": 0x02, "39": 0x04}
+# ESP32 advertising TX levels (ESP_PWR_LVL_N12 … ESP_PWR_LVL_P9); the backend
+# rounds down to a 3 dB step and clamps anything outside this range
+TX_POWER_MIN_DBM, TX_POWER_MAX_DBM = -12, 9
+
+# Must match beacon_config_t (packed, little-endian, 39 bytes)
+CONFIG_STRUCT = struct.Struct("<BBBbIHH%ds" % (NAME_MAX + 1))
+assert CONFIG_STRUCT.size == 39
+
+
+def ms_to_units(ms):
+    """Advertising interval in ms → 0.625 ms controller units."""
+    return int(round(float(ms) / 0.625))
+
+
+def parse_channels(text):
+    mask = 0
+    for ch in str(text).replace(" ", "").split(","):
+        if ch not in CHANNELS:
+            raise ValueError("unknown advertising channel %r (use 37,38,39)" % ch)
+        mask |= CHANNELS[ch]
+    return mask
+
+
+def pack_config(artifact_id, name, fmt, interval_ms_min, interval_ms_max, tx_power_dbm, channels):
+    name_bytes = name.encode("ascii")
+    if len(name_bytes) > NAME_MAX:
+        raise ValueError("name %r longer than %d bytes" % (name, NAME_MAX))
+    if fmt not in PAYLOAD_FORMATS:
+        raise ValueError("format must be one of %s" % ", ".join(PAYLOAD_FORMATS))
+    if fmt == "name" and not name_bytes:
+        raise ValueError("name payload format needs --name")
+    int_min, int_max = ms_to_units(interval_ms_min), ms_to_units(interval_ms_max)
+    if not (0x20 <= int_min <= int_max <= 0x4000):
+        raise ValueError("interval must satisfy 20 ms <= min <= max <= 10240 ms")
+    if not (0 <= artifact_id <= 0xFFFFFFFF):
+        raise ValueError("artifact id must fit in 32 bits")
+    tx_power_dbm = int(tx_power_dbm)
+    if not (TX_POWER_MIN_DBM <= tx_power_dbm <= TX_POWER_MAX_DBM):
+        raise ValueError("TX power must satisfy %d dBm <= tx_power <= %+d dBm"
+                         % (TX_POWER_MIN_DBM, TX_POWER_MAX_DBM))
+    return CONFIG_STRUCT.pack(CONFIG_VERSION, PAYLOAD_FORMATS[fmt], parse_channels(channels),
+                              tx_power_dbm, artifact_id, int_min, int_max, name_bytes)
+
+
+def parse_eid_key(text):
+    key = bytes.fromhex(text)
+    if len(key) != EID_KEY_LEN:
+        raise ValueError("EID identity key must be %d bytes (%d hex digits)" % (EID_KEY_LEN, 2 * EID_KEY_LEN))
+    return key
+
+
+def derive_eid_key(secret, unit):
+    """Per-unit identity key from a fleet secret, so the key sheet can be regenerated."""
+    return hmac.new(secret, unit.encode("utf-8"), hashlib.sha256).digest()[:EID_KEY_LEN]
+
+
+def write_csv(path, blob, eid_key=None):
+    with open(path, "w", newline="") as f:
+        w = csv.writer(f)
+        w.writerow(["key", "type", "encoding", "value"])
+        w.writerow(["beacon", "namespace", "", ""])
+        w.writerow(["cfg", "data", "hex2bin", blob.hex()])
+        if eid_key:
+            w.writerow(["eik", "data", "hex2bin", eid_key.hex()])
+
+
+def add_unit_args(p):
+    p.add_argument("--artifact-id", type=lambda v: int(v, 0), required=True)
+    p.add_argument("--name", default="", help="advertised name (name payload format)")
+    p.add_argument("--format", default="compact", choices=sorted(PAYLOAD_FORMATS))
+    p.add_argument("--interval-ms-min", type=float, default=100.0)
+    p.add_argument("--interval-ms-max", type=float, default=125.0)
+    p.add_argument("--tx-power-dbm", type=int, default=3)
+    p.add_argument("--channels", default="37,38,39")
+    p.add_argument("--eid-key", help="ephemeral-ID identity key, 32 hex digits")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--from-csv", help="fleet sheet, one unit per row (needs a 'unit' column)")
+    parser.add_argument("--out", default="beacon_nvs.csv", help="output CSV (or directory with --from-csv)")
+    parser.add_argument("--eid-secret", help="fleet secret (hex) to derive per-unit EID keys with --from-csv")
+    parser.add_argument("--keys-out", help="write the EID key sheet for host/eid_resolver (--from-csv)")
+    args, rest = parser.parse_known_args()
+
+    if not args.from_csv:
+        unit = argparse.ArgumentParser()
+        add_unit_args(unit)
+        u = unit.parse_args(rest)
+        blob = pack_config(u.artifact_id, u.name, u.format, u.interval_ms_min, u.interval_ms_max,
+                           u.tx_power_dbm, u.channels)
+        eid_key = parse_eid_key(u.eid_key) if u.eid_key else None
+        write_csv(args.out, blob, eid_key)
+        print("%s: %d-byte config blob%s" % (args.out, len(blob), ", EID key" if eid_key else ""))
+        return 0
+
+    os.makedirs(args.out, exist_ok=True)
+    secret = bytes.fromhex(args.eid_secret) if args.eid_secret else None
+    key_rows = []
+    with open(args.from_csv, newline="") as f:
+        for row in csv.DictReader(f):
+            blob = pack_config(int(row["artifact_id"], 0), row.get("name", ""),
+                               row.get("format", "compact"),
+                               row.get("interval_ms_min", 100), row.get("interval_ms_max", 125),
+                               row.get("tx_power_dbm", 3), row.get("channels", "37,38,39"))
+            eid_key = None
+            if row.get("eid_key"):
+                eid_key = parse_eid_key(row["eid_key"])
+            elif secret:
+                eid_key = derive_eid_key(secret, row["unit"])
+            if eid_key:
+                key_rows.append([row["unit"], row["artifact_id"], eid_key.hex()])
+            path = os.path.join(args.out, "%s.csv" % row["unit"])
+            write_csv(path, blob, eid_key)
+            print("%s: artifact 0x%04x" % (path, int(row["artifact_id"], 0)))
+
+    if args.keys_out:
+        with open(args.keys_out, "w", newline="") as f:
+            w = csv.writer(f)
+            w.writerow(["unit", "artifact_id", "eid_key"])
+            w.writerows(key_rows)
+        print("%s: %d EID keys" % (args.keys_out, len(key_rows)))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
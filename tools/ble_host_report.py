@@ -0,0 +1,103 @@
+#!/usr/bin/env python3
+"""
+COS10025 BLE-to-Web Cultural Storytelling System
+Side-by-side report of the Bluedroid and NimBLE beacon builds.
+
+Build both variants, flash each one and capture its boot log, then:
+
+    idf.py -B build build
+    idf.py -B build_nimble -D SDKCONFIG=build_nimble/sdkconfig \
+        -D SDKCONFIG_DEFAULTS="sdkconfig.defaults.nimble" build
+    idf.py -B build -p COMx flash monitor | tee bluedroid.log
+    idf.py -B build_nimble -p COMx flash monitor | tee nimble.log
+
+    python tools/ble_host_report.py build:bluedroid.log build_nimble:nimble.log
+
+For each build the report lists:
+- flash: application image size (.bin)
+- static RAM: DRAM + IRAM used at link time (esp_idf_size, if installed)
+- free heap after init, minimum free heap (firmware "heap after init" line)
+- boot-to-first-advert: esp_timer timestamp of the adv_started mark
+The log part is optional; without it the runtime columns are blank.
+"""
+
+import argparse
+import json
+import os
+import re
+import subprocess
+import sys
+
+HEAP_RE = re.compile(r"(\w+) heap after init: free (\d+), min free (\d+), largest block (\d+)")
+ADV_STARTED_RE = re.compile(r"adv_started\s+(\d+)")
+
+
+def image_info(build_dir):
+    """App image size and link-time static RAM for one build directory."""
+    with open(os.path.join(build_dir, "project_description.json")) as f:
+        desc = json.load(f)
+    info = {"flash": os.path.getsize(os.path.join(build_dir, desc["app_bin"])), "static_ram": None}
+
+    map_file = os.path.join(build_dir, desc["project_name"] + ".map")
+    try:
+        out = subprocess.run([sys.executable, "-m", "esp_idf_size", "--format", "json", map_file],
+                             capture_output=True, text=True, check=True).stdout
+        size = json.loads(out)
+        info["static_ram"] = size.get("used_dram", 0) + size.get("used_iram", 0)
+    except (OSError, subprocess.CalledProcessError, ValueError):
+        pass  # esp_idf_size missing or different schema: leave the column blank
+    return info
+
+
+def log_info(path):
+    """Runtime figures from a captured boot log (last occurrence wins)."""
+    info = {"host": None, "free_heap": None, "min_heap": None, "first_adv_us": None}
+    with open(path, errors="replace") as f:
+        for line in f:
+            m = HEAP_RE.search(line)
+            if m:
+                info["host"] = m.group(1)
+                info["free_heap"], info["min_heap"] = int(m.group(2)), int(m.group(3))
+            m = ADV_STARTED_RE.search(line)
+            if m:
+                info["first_adv_us"] = int(m.group(1))
+    return info
+
+
+def fmt(value, scale=1.0, unit=""):
+    return "-" if value is None else "%.1f%s" % (value / scale, unit)
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("builds", nargs="+", metavar="BUILD_DIR[:LOG]")
+    args = ap.parse_args()
+
+    rows = []
+    for spec in args.builds:
+        build_dir, _, log = spec.partition(":")
+        row = {"build": build_dir}
+        row.update(image_info(build_dir))
+        if log:
+            row.update(log_info(log))
+        rows.append(row)
+
+    print("%-16s %-10s %10s %12s %12s %12s %14s" % (
+        "build", "host", "flash KB", "static KB", "free heap KB", "min heap KB", "first adv ms"))
+    for r in rows:
+        print("%-16s %-10s %10s %12s %12s %12s %14s" % (
+            r["build"], r.get("host") or "?", fmt(r["flash"], 1024), fmt(r["static_ram"], 1024),
+            fmt(r.get("free_heap"), 1024), fmt(r.get("min_heap"), 1024), fmt(r.get("first_adv_us"), 1000)))
+
+    if len(rows) == 2:
+        a, b = rows
+        for key, label, scale, unit in (("flash", "flash", 1024, " KB"), ("static_ram", "static RAM", 1024, " KB"),
+                                        ("free_heap", "free heap", 1024, " KB"),
+                                        ("first_adv_us", "first advert", 1000, " ms")):
+            if a.get(key) is not None and b.get(key) is not None:
+                print("%-14s %s → %s (%+.1f%s)" % (label, a["build"], b["build"], (b[key] - a[key]) / scale, unit))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,100 @@
+#!/usr/bin/env python3
+"""
+COS10025 BLE-to-Web Cultural Storytelling System
+Measured energy per advertising event from a current-probe trace.
+
+Record the 3.3 V rail of one beacon with a current probe (e.g. Nordic PPK2,
+Joulescope, INA219 logger), export CSV with a time column and a current column,
+then:
+
+    python tools/energy_per_event.py trace.csv --time-col "Timestamp(ms)" \
+        --current-col "Current(uA)" --time-unit ms --current-unit uA
+
+Advertising events are the bursts where current rises above --threshold-ma
+(radio TX draws >100 mA, light sleep a few mA). The script reports the event
+rate, average current, charge/energy per event above the idle floor, and the
+battery life on --battery-mah. Compare with host/bench_power (model).
+"""
+
+import argparse
+import csv
+import statistics
+import sys
+
+TIME_SCALE = {"s": 1.0, "ms": 1e-3, "us": 1e-6}
+CURRENT_SCALE = {"A": 1e3, "mA": 1.0, "uA": 1e-3, "nA": 1e-6}  # → mA
+
+
+def load(path, time_col, current_col, time_unit, current_unit):
+    t, i = [], []
+    with open(path, newline="") as f:
+        for row in csv.DictReader(f):
+            t.append(float(row[time_col]) * TIME_SCALE[time_unit])
+            i.append(float(row[current_col]) * CURRENT_SCALE[current_unit])
+    return t, i
+
+
+def find_events(t, i, threshold_ma, merge_gap_s):
+    """Group samples above the threshold into bursts; returns (start, end) index pairs."""
+    events = []
+    start = None
+    last_hi = None
+    for k, cur in enumerate(i):
+        if cur >= threshold_ma:
+            if start is None:
+                start = k
+            elif t[k] - t[last_hi] > merge_gap_s:
+                events.append((start, last_hi))
+                start = k
+            last_hi = k
+    if start is not None:
+        events.append((start, last_hi))
+    return events
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("trace")
+    ap.add_argument("--time-col", default="time")
+    ap.add_argument("--current-col", default="current")
+    ap.add_argument("--time-unit", default="s", choices=sorted(TIME_SCALE))
+    ap.add_argument("--current-unit", default="mA", choices=sorted(CURRENT_SCALE))
+    ap.add_argument("--threshold-ma", type=float, default=50.0)
+    ap.add_argument("--merge-gap-ms", type=float, default=3.0, help="bursts closer than this are one event")
+    ap.add_argument("--supply-v", type=float, default=3.3)
+    ap.add_argument("--battery-mah", type=float, default=10000.0)
+    args = ap.parse_args()
+
+    t, i = load(args.trace, args.time_col, args.current_col, args.time_unit, args.current_unit)
+    if len(t) < 2:
+        print("trace too short", file=sys.stderr)
+        return 1
+
+    duration = t[-1] - t[0]
+    charge_mc = sum((t[k + 1] - t[k]) * i[k] for k in range(len(t) - 1))  # mA*s = mC
+    avg_ma = charge_mc / duration
+
+    events = find_events(t, i, args.threshold_ma, args.merge_gap_ms * 1e-3)
+    if not events:
+        print("no advertising events above %.1f mA" % args.threshold_ma, file=sys.stderr)
+        return 1
+
+    below = [cur for cur in i if cur < args.threshold_ma]
+    idle_ma = statistics.median(below) if below else 0.0
+    per_event_uc = []
+    for s, e in events:
+        q = sum((t[k + 1] - t[k]) * (i[k] - idle_ma) for k in range(s, min(e + 1, len(t) - 1)))
+        per_event_uc.append(q * 1e3)  # mC → uC
+    gaps = [t[events[k + 1][0]] - t[events[k][0]] for k in range(len(events) - 1)]
+
+    mean_uc = statistics.mean(per_event_uc)
+    print("trace: %.1f s, %d advertising events (%.1f ms mean spacing)"
+          % (duration, len(events), 1e3 * statistics.mean(gaps) if gaps else 0.0))
+    print("average current: %.3f mA, idle floor %.3f mA" % (avg_ma, idle_ma))
+    print("per advertising event: %.2f uC, %.2f uJ above idle" % (mean_uc, mean_uc * args.supply_v))
+    print("battery life on %.0f mAh: %.0f h" % (args.battery_mah, args.battery_mah / avg_ma))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,143 @@
+#!/usr/bin/env python3
+"""
+COS10025 BLE-to-Web Cultural Storytelling System
+Decode the beacon's binary event log (CONFIG_BEACON_EVLOG).
+
+Capture a dump from the serial monitor (send 'e', or let the unit dump it by
+itself after a panic or watchdog reset), then:
+
+    idf.py -p COMx monitor | tee beacon.log
+    python tools/evlog_decode.py beacon.log
+
+Each "EVLOG <hex>" line is one 16-byte record (beacon_evlog_rec_t). Event
+names, formats and the enums they refer to are read from the firmware
+headers, so events added there decode without touching this script. Records
+are printed oldest first and grouped by boot, with the time since that boot.
+Only the last dump in the capture is decoded unless --all is given.
+"""
+
+import argparse
+import os
+import re
+import struct
+import sys
+
+ROOT = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..")
+INCLUDE = os.path.join(ROOT, "components", "beacon_core", "include")
+RECORD = struct.Struct("<IIHHI")  # seq, stamp, id, a, b
+
+# esp_reset_reason_t (ESP-IDF, esp_system.h)
+RESET_REASONS = ["unknown", "power-on", "external", "software", "panic", "interrupt watchdog",
+                 "task watchdog", "other watchdog", "deep sleep", "brown-out", "SDIO", "USB",
+                 "JTAG", "eFuse", "power glitch", "CPU lockup"]
+
+# Lookup name in a format -> (header, typedef name)
+ENUMS = {
+    "state": ("beacon_core.h", "beacon_state_t"),
+    "step": ("beacon_core.h", "beacon_step_t"),
+    "err": ("beacon_backend.h", "beacon_err_t"),
+    "init": ("beacon_evlog.h", "beacon_init_step_t"),
+    "sup": ("beacon_supervisor.h", "beacon_sup_action_t"),
+}
+
+
+def parse_enum(path, typedef):
+    """Enumerator names by value for `typedef` in a C header, and their trailing comments."""
+    with open(path) as f:
+        text = f.read()
+    # The closing "} name;" first, then the nearest "typedef enum {" before it
+    # (format comments contain braces)
+    end = re.search(r"^\}\s*" + re.escape(typedef) + r"\s*;", text, re.M)
+    start = text.rfind("typedef enum {", 0, end.start()) if end else -1
+    if start < 0:
+        raise SystemExit("%s not found in %s" % (typedef, path))
+    names, comments, value = {}, {}, 0
+    for line in text[start:end.start()].splitlines()[1:]:
+        em = re.match(r"\s*(\w+)\s*(?:=\s*(\w+))?\s*,?\s*(?://\s*(.*))?$", line)
+        if not em or not em.group(1):
+            continue
+        if em.group(2):
+            value = int(em.group(2), 0)
+        names[value] = em.group(1)
+        comments[value] = (em.group(3) or "").strip()
+        value += 1
+    return names, comments
+
+
+def load_tables():
+    events, formats = parse_enum(os.path.join(INCLUDE, "beacon_evlog.h"), "beacon_event_id_t")
+    lookups = {"reset": dict(enumerate(RESET_REASONS))}
+    for key, (header, typedef) in ENUMS.items():
+        names = parse_enum(os.path.join(INCLUDE, header), typedef)[0]
+        # BEACON_STATE_ADVERTISING -> advertising
+        prefix = os.path.commonprefix(list(names.values()))
+        prefix = prefix[:prefix.rfind("_") + 1]
+        lookups[key] = {v: n[len(prefix):].lower() for v, n in names.items()}
+    return events, formats, lookups
+
+
+def render(fmt, a, b, lookups):
+    def field(m):
+        value = a if m.group(1) == "a" else b
+        kind = m.group(2)
+        if kind is None:
+            return str(value)
+        if kind == "x":
+            return "0x%x" % value
+        return lookups.get(kind, {}).get(value, str(value))
+    return re.sub(r"\{([ab])(?::(\w+))?\}", field, fmt)
+
+
+def read_dumps(path):
+    """Header fields and raw records of every dump in a capture."""
+    dumps = []
+    with open(path, errors="replace") as f:
+        for line in f:
+            m = re.search(r"EVLOG v(\d+) records (\d+) next (\d+) stamp_us (\d+)", line)
+            if m:
+                dumps.append({"version": int(m.group(1)), "records": int(m.group(2)),
+                              "stamp_us": int(m.group(4)), "recs": []})
+                continue
+            m = re.search(r"EVLOG ([0-9a-f]{32})\b", line)
+            if m and dumps:
+                dumps[-1]["recs"].append(RECORD.unpack(bytes.fromhex(m.group(1))))
+    return dumps
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("capture")
+    ap.add_argument("--all", action="store_true", help="decode every dump in the capture")
+    args = ap.parse_args()
+
+    dumps = read_dumps(args.capture)
+    if not dumps:
+        print("no EVLOG dump in %s" % args.capture, file=sys.stderr)
+        return 1
+    events, formats, lookups = load_tables()
+    boot_id = [k for k, v in events.items() if v == "BEACON_EV_BOOT"][0]
+
+    for dump in dumps if args.all else dumps[-1:]:
+        if dump["version"] != 1:
+            print("unsupported event log version %d" % dump["version"], file=sys.stderr)
+            return 1
+        print("event log: %d of %d records" % (len(dump["recs"]), dump["records"]))
+        gaps = 0
+        prev_seq = None
+        for seq, stamp, event, a, b in sorted(dump["recs"]):
+            if prev_seq is not None and seq != prev_seq + 1:
+                gaps += seq - prev_seq - 1
+                print("  ... %d record(s) lost or being written" % (seq - prev_seq - 1))
+            prev_seq = seq
+            if event == boot_id:
+                print("-- boot %d (%s)" % (b, lookups["reset"].get(a, str(a))))
+            name = events.get(event, "event %d" % event).replace("BEACON_EV_", "").lower()
+            text = render(formats.get(event, "{a} {b}"), a, b, lookups)
+            print("%8d %12.3f s  %-12s %s" % (seq, stamp * dump["stamp_us"] / 1e6, name, text))
+        if gaps:
+            print("%d record(s) missing inside the window" % gaps)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,110 @@
+#!/usr/bin/env python3
+"""
+COS10025 BLE-to-Web Cultural Storytelling System
+Heap soak report from a captured beacon console log.
+
+Build with the heap test profile, leave the unit running for days with the
+console captured, then:
+
+    idf.py -B build_heap -D SDKCONFIG=build_heap/sdkconfig \
+        -D SDKCONFIG_DEFAULTS="sdkconfig.defaults.nimble;sdkconfig.defaults.heaptrace" build
+    idf.py -B build_heap -p COMx flash monitor | tee heap.log
+    python tools/heap_soak.py heap.log --max-leak-bytes-per-hour 16
+
+Reads the firmware "heap soak:" lines (CONFIG_BEACON_HEAP_SOAK_PERIOD_S) and
+the "heap trace:" verdict (CONFIG_BEACON_HEAP_TRACE). Reports:
+- leak slope: least-squares fit of free heap against uptime, after --warmup-s
+- minimum free heap (the allocator's own low-water mark) and largest block
+- fragmentation (1 - largest block / free) at the start, end and worst
+- reboots: uptime going backwards, e.g. a panic reboot
+Exits non-zero on a leak above the limit, a reboot, a failed steady-state
+trace, or a minimum free heap below --min-free.
+"""
+
+import argparse
+import re
+import sys
+
+SOAK_RE = re.compile(r"heap soak: uptime (\d+) s, free (\d+), min free (\d+), largest block (\d+), "
+                     r"free blocks (\d+), frag ([\d.]+)%")
+TRACE_RE = re.compile(r"heap trace: (\d+) s of advertising, (\d+) allocations, (\d+) frees, (\d+) still held")
+VERDICT_RE = re.compile(r"heap trace: (PASS|FAIL)")
+
+
+def parse(path):
+    """Soak samples split into runs at every reboot, and the trace results."""
+    runs, traces, verdicts = [[]], [], []
+    with open(path, errors="replace") as f:
+        for line in f:
+            m = SOAK_RE.search(line)
+            if m:
+                s = dict(zip(("uptime", "free", "min_free", "largest", "blocks"), map(int, m.groups()[:5])))
+                s["frag"] = float(m.group(6))
+                if runs[-1] and s["uptime"] < runs[-1][-1]["uptime"]:
+                    runs.append([])
+                runs[-1].append(s)
+                continue
+            m = TRACE_RE.search(line)
+            if m:
+                traces.append(tuple(map(int, m.groups())))
+                continue
+            m = VERDICT_RE.search(line)
+            if m:
+                verdicts.append(m.group(1))
+    return [r for r in runs if r], traces, verdicts
+
+
+def slope(xs, ys):
+    """Least-squares slope of ys against xs (0 with fewer than two points)."""
+    n = len(xs)
+    if n < 2:
+        return 0.0
+    mx, my = sum(xs) / n, sum(ys) / n
+    sxx = sum((x - mx) ** 2 for x in xs)
+    return sum((x - mx) * (y - my) for x, y in zip(xs, ys)) / sxx if sxx else 0.0
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("log")
+    ap.add_argument("--warmup-s", type=int, default=600, help="ignore samples before this uptime in the fit")
+    ap.add_argument("--max-leak-bytes-per-hour", type=float, default=16.0)
+    ap.add_argument("--min-free", type=int, default=0, help="fail below this minimum free heap (0 = no check)")
+    args = ap.parse_args()
+
+    runs, traces, verdicts = parse(args.log)
+    if not runs:
+        print("no 'heap soak:' lines in %s (CONFIG_BEACON_HEAP_SOAK_PERIOD_S = 0?)" % args.log, file=sys.stderr)
+        return 1
+
+    failures = 0
+    print("%-4s %8s %9s %14s %9s %9s %18s" % ("run", "samples", "hours", "leak B/h", "min free", "min block",
+                                             "frag % start/end/max"))
+    for n, run in enumerate(runs, 1):
+        fit = [s for s in run if s["uptime"] >= args.warmup_s] or run
+        leak = -3600.0 * slope([s["uptime"] for s in fit], [s["free"] for s in fit])
+        print("%-4d %8d %9.1f %+14.1f %9d %9d %6.1f/%5.1f/%5.1f" % (
+            n, len(run), (run[-1]["uptime"] - run[0]["uptime"]) / 3600.0, leak,
+            min(s["min_free"] for s in run), min(s["largest"] for s in run),
+            run[0]["frag"], run[-1]["frag"], max(s["frag"] for s in run)))
+        if leak > args.max_leak_bytes_per_hour:
+            print("run %d: free heap falls %.1f B/h > %.1f B/h" % (n, leak, args.max_leak_bytes_per_hour),
+                  file=sys.stderr)
+            failures += 1
+        if args.min_free and min(s["min_free"] for s in run) < args.min_free:
+            print("run %d: minimum free heap below %d" % (n, args.min_free), file=sys.stderr)
+            failures += 1
+
+    if len(runs) > 1:
+        print("%d reboot(s) during the soak" % (len(runs) - 1), file=sys.stderr)
+        failures += 1
+    for (window_s, allocs, frees, held), verdict in zip(traces, verdicts):
+        print("steady-state trace: %d s, %d allocations, %d frees, %d still held: %s" % (
+            window_s, allocs, frees, held, verdict))
+        if verdict != "PASS":
+            failures += 1
+    return 1 if failures else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,85 @@
+#!/usr/bin/env python3
+"""
+COS10025 BLE-to-Web Cultural Storytelling System
+Binary-size and static-RAM budget check for one ESP32 build.
+
+Runs after every build of a profile with CONFIG_BEACON_FLASH_BUDGET_KB or
+CONFIG_BEACON_STATIC_RAM_BUDGET_KB set (see the top-level CMakeLists.txt),
+and can be run by hand:
+
+    python tools/size_budget.py build_minimal --max-flash-kb 710
+    python tools/size_budget.py build_minimal --headroom 10   # calibrate a profile
+
+- flash: size of the application .bin
+- static RAM: allocated ELF sections in internal DRAM and IRAM (data, bss,
+  IRAM code), read straight from the ELF section headers
+Exits 1 when a budget is exceeded; a budget of 0 is not checked. --headroom PCT
+prints the sdkconfig budget lines for this build plus PCT percent, rounded up
+to whole KB, for recording in a profile next to the measured figures.
+"""
+
+import argparse
+import json
+import math
+import os
+import struct
+import sys
+
+# ESP32 internal SRAM as seen by the linker (RTC memories excluded)
+RAM_RANGES = (
+    (0x3FFAE000, 0x40000000),  # DRAM
+    (0x40070000, 0x400C0000),  # IRAM
+)
+SHF_ALLOC = 0x2
+
+
+def static_ram_bytes(elf_path):
+    """Sum of allocated ELF32 sections placed in internal DRAM/IRAM."""
+    with open(elf_path, "rb") as f:
+        elf = f.read()
+    if elf[:4] != b"\x7fELF" or elf[4] != 1:
+        raise ValueError("%s is not an ELF32 file" % elf_path)
+    shoff, = struct.unpack_from("<I", elf, 0x20)
+    shentsize, shnum = struct.unpack_from("<HH", elf, 0x2E)
+    total = 0
+    for i in range(shnum):
+        _, _, flags, addr, _, size = struct.unpack_from("<IIIIII", elf, shoff + i * shentsize)
+        if flags & SHF_ALLOC and size and any(lo <= addr < hi for lo, hi in RAM_RANGES):
+            total += size
+    return total
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("build_dir")
+    ap.add_argument("--max-flash-kb", type=int, default=0)
+    ap.add_argument("--max-static-ram-kb", type=int, default=0)
+    ap.add_argument("--headroom", type=float, metavar="PCT",
+                    help="print budgets for this build plus PCT percent headroom")
+    args = ap.parse_args()
+
+    with open(os.path.join(args.build_dir, "project_description.json")) as f:
+        desc = json.load(f)
+    flash = os.path.getsize(os.path.join(args.build_dir, desc["app_bin"]))
+    ram = static_ram_bytes(os.path.join(args.build_dir, desc["app_elf"]))
+
+    if args.headroom is not None:
+        for option, used in (("FLASH", flash), ("STATIC_RAM", ram)):
+            budget_kb = int(math.ceil(used * (1 + args.headroom / 100.0) / 1024.0))
+            print("# measured %d B (%.1f KB), +%g%% headroom" % (used, used / 1024.0, args.headroom))
+            print("CONFIG_BEACON_%s_BUDGET_KB=%d" % (option, budget_kb))
+
+    over = False
+    for label, used, budget_kb in (("flash", flash, args.max_flash_kb),
+                                   ("static RAM", ram, args.max_static_ram_kb)):
+        if budget_kb <= 0:
+            print("size budget: %-10s %7.1f KB (no budget)" % (label, used / 1024.0))
+            continue
+        ok = used <= budget_kb * 1024
+        over |= not ok
+        print("size budget: %-10s %7.1f KB of %d KB %s" % (label, used / 1024.0, budget_kb, "ok" if ok else "EXCEEDED"))
+    return 1 if over else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())